@@ -0,0 +1,113 @@
+// Writes a synthetic allocation trace for pool_tuner. The workload goes through a few phases, each with its own mix of
+// small and large requests; in each step, a block is either allocated or a random live block is deallocated, keeping
+// the number of live blocks around a target.
+
+#include <thrust/mr/pool_tuner.h>
+#include <thrust/mr/memory_resource.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+int main(int argc, char ** argv)
+{
+    std::size_t num_events = 100000;
+    std::size_t num_live = 256;
+    unsigned seed = 0;
+    const char * filename = NULL;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--events") == 0 && i + 1 < argc)
+        {
+            num_events = std::strtoul(argv[++i], NULL, 10);
+        }
+        else if (std::strcmp(argv[i], "--live") == 0 && i + 1 < argc)
+        {
+            num_live = std::strtoul(argv[++i], NULL, 10);
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = static_cast<unsigned>(std::strtoul(argv[++i], NULL, 10));
+        }
+        else if (!filename && argv[i][0] != '-')
+        {
+            filename = argv[i];
+        }
+        else
+        {
+            filename = NULL;
+            break;
+        }
+    }
+
+    if (!filename || num_live == 0)
+    {
+        std::fprintf(stderr, "usage: %s [--events N] [--live N] [--seed N] TRACE\n", argv[0]);
+        return 1;
+    }
+
+    std::FILE * file = std::fopen(filename, "w");
+    if (!file)
+    {
+        std::fprintf(stderr, "cannot open %s\n", filename);
+        return 1;
+    }
+
+    const std::size_t num_phases = 4;
+    // the base 2 logarithms of the sizes of the small and the large requests of each phase
+    const double small_log2[num_phases][2] = { { 4, 10 }, { 6, 14 }, { 8, 16 }, { 4, 12 } };
+    const double large_log2[num_phases][2] = { { 18, 22 }, { 20, 24 }, { 16, 20 }, { 22, 26 } };
+    const double large_fraction[num_phases] = { 0.01, 0.05, 0.10, 0.02 };
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    thrust::mr::allocation_trace trace;
+    std::vector<thrust::mr::allocation_event> live;
+    std::size_t num_blocks = 0;
+
+    for (std::size_t i = 0; i < num_events; ++i)
+    {
+        std::size_t phase = i * num_phases / num_events;
+
+        // allocate more often than deallocate while below the target, and the other way around above it
+        double allocate_probability = live.size() < num_live ? 0.6 : 0.4;
+
+        if (live.empty() || uniform(rng) < allocate_probability)
+        {
+            const double * range = uniform(rng) < large_fraction[phase] ? large_log2[phase] : small_log2[phase];
+
+            thrust::mr::allocation_event event;
+            event.is_allocation = true;
+            event.bytes = static_cast<std::size_t>(std::exp2(range[0] + (range[1] - range[0]) * uniform(rng)));
+            event.alignment = uniform(rng) < 0.01 ? 4096 : THRUST_MR_DEFAULT_ALIGNMENT;
+            event.block = num_blocks++;
+
+            trace.push_back(event);
+            live.push_back(event);
+        }
+        else
+        {
+            std::size_t victim = std::uniform_int_distribution<std::size_t>(0, live.size() - 1)(rng);
+            std::swap(live[victim], live.back());
+
+            thrust::mr::allocation_event event = live.back();
+            event.is_allocation = false;
+            live.pop_back();
+
+            trace.push_back(event);
+        }
+    }
+
+    thrust::mr::write_allocation_trace(file, trace);
+    std::fclose(file);
+
+    std::printf("wrote %zu requests to %s\n", trace.size(), filename);
+
+    return 0;
+}
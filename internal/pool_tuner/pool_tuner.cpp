@@ -0,0 +1,97 @@
+// Replays an allocation trace recorded by thrust::mr::statistics_resource against a pooling resource, searches for the
+// pool_options that minimize the upstream calls and the peak footprint, and prints them as code.
+
+#include <thrust/mr/pool_tuner.h>
+#include <thrust/mr/pool.h>
+#include <thrust/mr/disjoint_pool.h>
+#include <thrust/mr/new.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+typedef thrust::mr::unsynchronized_pool_resource<thrust::mr::new_delete_resource> pool;
+typedef thrust::mr::disjoint_unsynchronized_pool_resource<
+    thrust::mr::new_delete_resource,
+    thrust::mr::new_delete_resource
+> disjoint_pool;
+
+void print_statistics(const char * title, const thrust::mr::allocation_statistics & statistics, double cost)
+{
+    std::printf("%s:\n", title);
+    std::printf("  upstream allocations: %zu, deallocations: %zu\n",
+        statistics.upstream_allocations, statistics.upstream_deallocations);
+    std::printf("  peak upstream bytes: %zu, peak bytes in use: %zu\n",
+        statistics.peak_upstream_bytes_in_use, statistics.peak_bytes_in_use);
+    std::printf("  hit rate: %.4f, cost: %.0f\n", statistics.hit_rate(), cost);
+}
+
+template<typename Pool>
+void tune(const thrust::mr::allocation_trace & trace, double call_cost)
+{
+    thrust::mr::pool_options defaults = Pool::get_default_options();
+    thrust::mr::allocation_statistics statistics = thrust::mr::replay_allocation_trace<Pool>(trace, defaults);
+    print_statistics("default options", statistics, thrust::mr::pool_tuning_cost(statistics, call_cost));
+
+    thrust::mr::pool_tuning_result result = thrust::mr::tune_pool_options<Pool>(trace, call_cost, defaults);
+    print_statistics("tuned options", result.statistics, result.cost);
+
+    std::printf("\n");
+    thrust::mr::print_pool_options(stdout, result.options);
+}
+
+int main(int argc, char ** argv)
+{
+    bool disjoint = false;
+    double call_cost = 65536.0;
+    const char * filename = NULL;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--disjoint") == 0)
+        {
+            disjoint = true;
+        }
+        else if (std::strcmp(argv[i], "--call-cost") == 0 && i + 1 < argc)
+        {
+            call_cost = std::atof(argv[++i]);
+        }
+        else if (!filename && argv[i][0] != '-')
+        {
+            filename = argv[i];
+        }
+        else
+        {
+            filename = NULL;
+            break;
+        }
+    }
+
+    if (!filename)
+    {
+        std::fprintf(stderr, "usage: %s [--disjoint] [--call-cost BYTES] TRACE\n", argv[0]);
+        std::fprintf(stderr, "  --disjoint         tune disjoint_unsynchronized_pool_resource instead of unsynchronized_pool_resource\n");
+        std::fprintf(stderr, "  --call-cost BYTES  the footprint in bytes one upstream call is worth (default: 65536)\n");
+        return 1;
+    }
+
+    thrust::mr::allocation_trace trace;
+    if (!thrust::mr::read_allocation_trace(filename, trace))
+    {
+        std::fprintf(stderr, "cannot read the allocation trace %s\n", filename);
+        return 1;
+    }
+
+    std::printf("%zu requests in %s\n\n", trace.size(), filename);
+
+    if (disjoint)
+    {
+        tune<disjoint_pool>(trace, call_cost);
+    }
+    else
+    {
+        tune<pool>(trace, call_cost);
+    }
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/binary_search.h>
+#include <thrust/sort.h>
+#include <thrust/functional.h>
+#include <thrust/host_vector.h>
+#include <thrust/execution_policy.h>
+
+#include <algorithm>
+
+#include "test_header.hpp"
+#include "test_host_systems.hpp"
+
+HOST_SYSTEM_TESTS_DEFINE(HostBinarySearchTests);
+
+struct greater_int
+{
+    __host__ __device__
+    bool operator()(int lhs, int rhs) const
+    {
+        return lhs > rhs;
+    }
+};
+
+// the orders of the queries: the searches gallop through sorted queries, and
+// fall back to independent binary searches when the order breaks
+enum query_order
+{
+    sorted_queries,
+    reversed_queries,
+    random_queries,
+    nearly_sorted_queries
+};
+
+template <class Compare>
+thrust::host_vector<int> get_queries(size_t size, int max_key, query_order order, int seed, Compare comp)
+{
+    // some of the queries lie outside of the range of the haystack
+    thrust::host_vector<int> queries = get_random_data<int>(size, -2, max_key + 2, seed);
+
+    if(order != random_queries)
+    {
+        std::stable_sort(queries.begin(), queries.end(), comp);
+    }
+    if(order == reversed_queries)
+    {
+        std::reverse(queries.begin(), queries.end());
+    }
+    if(order == nearly_sorted_queries && size > 1)
+    {
+        std::swap(queries[size / 2], queries[size - 1]);
+    }
+    return queries;
+}
+
+template <class Policy, class Compare>
+void TestSearchQueries(Policy policy,
+                       const thrust::host_vector<int>& haystack,
+                       const thrust::host_vector<int>& queries,
+                       Compare comp)
+{
+    const size_t size = queries.size();
+
+    thrust::host_vector<int> expected_lower(size);
+    thrust::host_vector<int> expected_upper(size);
+    thrust::host_vector<bool> expected_found(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        expected_lower[i] = std::lower_bound(haystack.begin(), haystack.end(), queries[i], comp) - haystack.begin();
+        expected_upper[i] = std::upper_bound(haystack.begin(), haystack.end(), queries[i], comp) - haystack.begin();
+        expected_found[i] = std::binary_search(haystack.begin(), haystack.end(), queries[i], comp);
+    }
+
+    thrust::host_vector<int> output(size);
+    thrust::lower_bound(policy, haystack.begin(), haystack.end(), queries.begin(), queries.end(), output.begin(), comp);
+    ASSERT_EQ(output, expected_lower);
+
+    thrust::upper_bound(policy, haystack.begin(), haystack.end(), queries.begin(), queries.end(), output.begin(), comp);
+    ASSERT_EQ(output, expected_upper);
+
+    thrust::host_vector<bool> found(size);
+    thrust::binary_search(policy, haystack.begin(), haystack.end(), queries.begin(), queries.end(), found.begin(), comp);
+    ASSERT_EQ(found, expected_found);
+}
+
+template <class Policy, class Compare>
+void TestSortedSearch(Policy policy, Compare comp)
+{
+    const size_t haystack_sizes[] = {0, 1, 17, 1000, 100000};
+
+    // the sizes around the tiles of queries
+    const size_t sizes[] = {0, 1, 2, 3, 17, 1023, 1024, 1025, 4097, 65537};
+    const int max_keys[] = {3, 1000000};
+    const query_order orders[] = {sorted_queries, reversed_queries, random_queries, nearly_sorted_queries};
+
+    for(auto haystack_size : haystack_sizes)
+    {
+        for(auto max_key : max_keys)
+        {
+            SCOPED_TRACE(testing::Message() << "with haystack size = " << haystack_size
+                         << ", max key = " << max_key);
+
+            thrust::host_vector<int> haystack = get_random_data<int>(haystack_size, 0, max_key, haystack_size);
+            thrust::sort(thrust::seq, haystack.begin(), haystack.end(), comp);
+
+            for(auto size : sizes)
+            {
+                for(auto order : orders)
+                {
+                    SCOPED_TRACE(testing::Message() << "with size = " << size << ", order = " << order);
+
+                    thrust::host_vector<int> queries = get_queries(size, max_key, order, size, comp);
+
+                    TestSearchQueries(policy, haystack, queries, comp);
+                }
+            }
+        }
+    }
+}
+
+TYPED_TEST(HostBinarySearchTests, TestSortedSearch)
+{
+    TestSortedSearch(TestFixture::policy(), thrust::less<int>());
+}
+
+TYPED_TEST(HostBinarySearchTests, TestSortedSearchGreater)
+{
+    TestSortedSearch(TestFixture::policy(), greater_int());
+}
+
+TYPED_TEST(HostBinarySearchTests, TestSortedSearchCustomCompare)
+{
+    TestSortedSearch(TestFixture::policy(), custom_compare_less<int>());
+}
@@ -0,0 +1,253 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/remove.h>
+#include <thrust/unique.h>
+#include <thrust/partition.h>
+#include <thrust/functional.h>
+#include <thrust/host_vector.h>
+#include <thrust/execution_policy.h>
+
+#include "test_header.hpp"
+#include "test_host_systems.hpp"
+
+HOST_SYSTEM_TESTS_DEFINE(HostCompactionTests);
+
+// the moduli of the predicates: every element, every 2nd, ... every 1000th
+// element is removed, from dense to sparse removals
+const int compaction_moduli[] = {1, 2, 7, 1000};
+
+struct is_multiple_of
+{
+    typedef int argument_type;
+
+    int modulus;
+
+    is_multiple_of(int modulus) : modulus(modulus) {}
+
+    __host__ __device__
+    bool operator()(int x) const
+    {
+        return x % modulus == 0;
+    }
+};
+
+struct equal_div_of
+{
+    int divisor;
+
+    equal_div_of(int divisor) : divisor(divisor) {}
+
+    __host__ __device__
+    bool operator()(int lhs, int rhs) const
+    {
+        return lhs / divisor == rhs / divisor;
+    }
+};
+
+TYPED_TEST(HostCompactionTests, TestRemoveIf)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        for(int modulus : compaction_moduli)
+        {
+            SCOPED_TRACE(testing::Message() << "with size = " << size << ", modulus = " << modulus);
+
+            thrust::host_vector<int> input(size);
+            for(size_t i = 0; i < size; i++)
+            {
+                input[i] = static_cast<int>(i);
+            }
+
+            thrust::host_vector<int> expected(input);
+            const size_t expected_size = thrust::remove_if(thrust::seq, expected.begin(), expected.end(), is_multiple_of(modulus)) - expected.begin();
+            expected.resize(expected_size);
+
+            thrust::host_vector<int> output(input);
+            const size_t output_size = thrust::remove_if(policy, output.begin(), output.end(), is_multiple_of(modulus)) - output.begin();
+            output.resize(output_size);
+
+            ASSERT_EQ(output, expected);
+        }
+    }
+}
+
+TYPED_TEST(HostCompactionTests, TestRemoveIfStencil)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        for(int modulus : compaction_moduli)
+        {
+            SCOPED_TRACE(testing::Message() << "with size = " << size << ", modulus = " << modulus);
+
+            thrust::host_vector<int> input = get_random_data<int>(size, -1000, 1000, size);
+            thrust::host_vector<int> stencil(size);
+            for(size_t i = 0; i < size; i++)
+            {
+                stencil[i] = static_cast<int>(i);
+            }
+
+            thrust::host_vector<int> expected(input);
+            const size_t expected_size = thrust::remove_if(thrust::seq, expected.begin(), expected.end(), stencil.begin(), is_multiple_of(modulus)) - expected.begin();
+            expected.resize(expected_size);
+
+            thrust::host_vector<int> output(input);
+            const size_t output_size = thrust::remove_if(policy, output.begin(), output.end(), stencil.begin(), is_multiple_of(modulus)) - output.begin();
+            output.resize(output_size);
+
+            ASSERT_EQ(output, expected);
+        }
+    }
+}
+
+TYPED_TEST(HostCompactionTests, TestUnique)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        for(int modulus : compaction_moduli)
+        {
+            SCOPED_TRACE(testing::Message() << "with size = " << size << ", modulus = " << modulus);
+
+            // runs of modulus equal elements
+            thrust::host_vector<int> input(size);
+            for(size_t i = 0; i < size; i++)
+            {
+                input[i] = static_cast<int>(i) / modulus;
+            }
+
+            thrust::host_vector<int> expected(input);
+            const size_t expected_size = thrust::unique(thrust::seq, expected.begin(), expected.end()) - expected.begin();
+            expected.resize(expected_size);
+
+            thrust::host_vector<int> output(input);
+            const size_t output_size = thrust::unique(policy, output.begin(), output.end()) - output.begin();
+            output.resize(output_size);
+
+            ASSERT_EQ(output, expected);
+
+            // a custom predicate which keeps one of every 10 consecutive values
+            expected = input;
+            const size_t expected_pred_size = thrust::unique(thrust::seq, expected.begin(), expected.end(), equal_div_of(10)) - expected.begin();
+            expected.resize(expected_pred_size);
+
+            output = input;
+            const size_t output_pred_size = thrust::unique(policy, output.begin(), output.end(), equal_div_of(10)) - output.begin();
+            output.resize(output_pred_size);
+
+            ASSERT_EQ(output, expected);
+        }
+    }
+}
+
+TYPED_TEST(HostCompactionTests, TestUniqueByKey)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        for(int modulus : compaction_moduli)
+        {
+            SCOPED_TRACE(testing::Message() << "with size = " << size << ", modulus = " << modulus);
+
+            thrust::host_vector<int> input_keys(size);
+            thrust::host_vector<int> input_values(size);
+            for(size_t i = 0; i < size; i++)
+            {
+                input_keys[i]   = static_cast<int>(i) / modulus;
+                input_values[i] = static_cast<int>(i);
+            }
+
+            thrust::host_vector<int> expected_keys(input_keys);
+            thrust::host_vector<int> expected_values(input_values);
+            const size_t expected_size = thrust::unique_by_key(thrust::seq, expected_keys.begin(), expected_keys.end(), expected_values.begin()).first - expected_keys.begin();
+            expected_keys.resize(expected_size);
+            expected_values.resize(expected_size);
+
+            thrust::host_vector<int> keys(input_keys);
+            thrust::host_vector<int> values(input_values);
+            const size_t output_size = thrust::unique_by_key(policy, keys.begin(), keys.end(), values.begin()).first - keys.begin();
+            keys.resize(output_size);
+            values.resize(output_size);
+
+            ASSERT_EQ(keys, expected_keys);
+            ASSERT_EQ(values, expected_values);
+        }
+    }
+}
+
+TYPED_TEST(HostCompactionTests, TestStablePartition)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        for(int modulus : compaction_moduli)
+        {
+            SCOPED_TRACE(testing::Message() << "with size = " << size << ", modulus = " << modulus);
+
+            thrust::host_vector<int> input(size);
+            for(size_t i = 0; i < size; i++)
+            {
+                input[i] = static_cast<int>(i);
+            }
+
+            // the elements which fail the predicate move to the back
+            thrust::host_vector<int> expected(input);
+            const size_t expected_true = thrust::stable_partition(thrust::seq, expected.begin(), expected.end(), thrust::not1(is_multiple_of(modulus))) - expected.begin();
+
+            thrust::host_vector<int> output(input);
+            const size_t output_true = thrust::stable_partition(policy, output.begin(), output.end(), thrust::not1(is_multiple_of(modulus))) - output.begin();
+
+            ASSERT_EQ(output_true, expected_true);
+            ASSERT_EQ(output, expected);
+        }
+    }
+}
+
+TYPED_TEST(HostCompactionTests, TestStablePartitionStencil)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        for(int modulus : compaction_moduli)
+        {
+            SCOPED_TRACE(testing::Message() << "with size = " << size << ", modulus = " << modulus);
+
+            thrust::host_vector<int> input = get_random_data<int>(size, -1000, 1000, size);
+            thrust::host_vector<int> stencil(size);
+            for(size_t i = 0; i < size; i++)
+            {
+                stencil[i] = static_cast<int>(i);
+            }
+
+            thrust::host_vector<int> expected(input);
+            const size_t expected_true = thrust::stable_partition(thrust::seq, expected.begin(), expected.end(), stencil.begin(), thrust::not1(is_multiple_of(modulus))) - expected.begin();
+
+            thrust::host_vector<int> output(input);
+            const size_t output_true = thrust::stable_partition(policy, output.begin(), output.end(), stencil.begin(), thrust::not1(is_multiple_of(modulus))) - output.begin();
+
+            ASSERT_EQ(output_true, expected_true);
+            ASSERT_EQ(output, expected);
+        }
+    }
+}
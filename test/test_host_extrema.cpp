@@ -0,0 +1,152 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/extrema.h>
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+#include <thrust/host_vector.h>
+#include <thrust/execution_policy.h>
+#include <thrust/iterator/transform_iterator.h>
+
+#include "test_header.hpp"
+#include "test_host_systems.hpp"
+
+HOST_SYSTEM_TESTS_DEFINE(HostExtremaTests);
+
+// integers drawn from [0, max], so that the floating point types tie too
+template <class T>
+thrust::host_vector<T> get_extrema_data(size_t size, int max, int seed)
+{
+    thrust::host_vector<int> data = get_random_data<int>(size, 0, max, seed);
+
+    thrust::host_vector<T> result(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        result[i] = static_cast<T>(data[i]);
+    }
+    return result;
+}
+
+template <class T>
+struct identity_function
+{
+    __host__ __device__
+    T operator()(const T& x) const
+    {
+        return x;
+    }
+};
+
+// checks the positions found through the policy against those of thrust::seq,
+// which are the first minimum and the first maximum
+template <class Policy, class Iterator, class Compare>
+void TestExtremaRange(Policy policy, Iterator first, Iterator last, Compare comp)
+{
+    ASSERT_EQ(thrust::min_element(policy, first, last, comp) - first,
+              thrust::min_element(thrust::seq, first, last, comp) - first);
+    ASSERT_EQ(thrust::max_element(policy, first, last, comp) - first,
+              thrust::max_element(thrust::seq, first, last, comp) - first);
+
+    thrust::pair<Iterator, Iterator> result   = thrust::minmax_element(policy, first, last, comp);
+    thrust::pair<Iterator, Iterator> expected = thrust::minmax_element(thrust::seq, first, last, comp);
+    ASSERT_EQ(result.first - first, expected.first - first);
+    ASSERT_EQ(result.second - first, expected.second - first);
+}
+
+template <class T, class Policy, class Compare>
+void TestExtremaKeys(Policy policy, const thrust::host_vector<T>& input, Compare comp)
+{
+    // the contiguous ranges, and a random access range the vectorized kernel does not take
+    TestExtremaRange(policy, input.begin(), input.end(), comp);
+    TestExtremaRange(policy, thrust::raw_pointer_cast(input.data()), thrust::raw_pointer_cast(input.data()) + input.size(), comp);
+    TestExtremaRange(policy,
+                     thrust::make_transform_iterator(input.begin(), identity_function<T>()),
+                     thrust::make_transform_iterator(input.end(), identity_function<T>()),
+                     comp);
+}
+
+template <class T, class Policy>
+void TestExtremaType(Policy policy)
+{
+    SCOPED_TRACE(testing::Message() << "with type size = " << sizeof(T));
+
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        // distinct values, values with many ties, and a single value
+        thrust::host_vector<T> input = get_extrema_data<T>(size, 100, size);
+        TestExtremaKeys(policy, input, thrust::less<T>());
+        TestExtremaKeys(policy, input, thrust::greater<T>());
+        TestExtremaKeys(policy, input, custom_compare_less<T>());
+
+        input = get_extrema_data<T>(size, 2, size);
+        TestExtremaKeys(policy, input, thrust::less<T>());
+        TestExtremaKeys(policy, input, thrust::greater<T>());
+        TestExtremaKeys(policy, input, custom_compare_less<T>());
+
+        thrust::fill(input.begin(), input.end(), T(1));
+        TestExtremaKeys(policy, input, thrust::less<T>());
+        TestExtremaKeys(policy, input, thrust::greater<T>());
+    }
+}
+
+TYPED_TEST(HostExtremaTests, TestExtrema)
+{
+    auto policy = TestFixture::policy();
+
+    TestExtremaType<char>(policy);
+    TestExtremaType<unsigned short>(policy);
+    TestExtremaType<int>(policy);
+    TestExtremaType<long long>(policy);
+    TestExtremaType<float>(policy);
+    TestExtremaType<double>(policy);
+}
+
+// the extrema repeated at the ends of the range, and around the boundaries
+// of the blocks and tiles, where the earlier one must win
+TYPED_TEST(HostExtremaTests, TestExtremaTies)
+{
+    auto policy = TestFixture::policy();
+
+    const size_t size = 131073;
+    const size_t positions[] = {0, 1, 63, 64, 1023, 1024, 4095, 4096, 65535, 65536, 131071, 131072};
+
+    for(auto position : positions)
+    {
+        SCOPED_TRACE(testing::Message() << "with position = " << position);
+
+        thrust::host_vector<float> input(size, 1.0f);
+
+        // the extrema at the position and at every later one
+        for(auto later : positions)
+        {
+            if(later >= position)
+            {
+                input[later] = (later % 2) ? -1.0f : 3.0f;
+            }
+        }
+        input[position] = -1.0f;
+        if(position + 1 < size)
+        {
+            input[position + 1] = 3.0f;
+        }
+
+        TestExtremaKeys(policy, input, thrust::less<float>());
+        TestExtremaKeys(policy, input, thrust::greater<float>());
+        TestExtremaKeys(policy, input, custom_compare_less<float>());
+    }
+}
@@ -0,0 +1,178 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/find.h>
+#include <thrust/mismatch.h>
+#include <thrust/equal.h>
+#include <thrust/functional.h>
+#include <thrust/host_vector.h>
+#include <thrust/execution_policy.h>
+
+#include "test_header.hpp"
+#include "test_host_systems.hpp"
+
+HOST_SYSTEM_TESTS_DEFINE(HostFindTests);
+
+struct equal_to_value
+{
+    int value;
+
+    equal_to_value(int value) : value(value) {}
+
+    __host__ __device__
+    bool operator()(int x) const
+    {
+        return x == value;
+    }
+};
+
+struct equal_mod_10
+{
+    __host__ __device__
+    bool operator()(int lhs, int rhs) const
+    {
+        return lhs % 10 == rhs % 10;
+    }
+};
+
+// the positions of the matches planted in a range of the given size: at the
+// front, around the tile sizes, in the middle and at the back
+std::vector<size_t> get_match_positions(size_t size)
+{
+    const size_t candidates[] = {0, 1, 1023, 1024, 1025, 4095, 65536, size / 2, size - 1};
+
+    std::vector<size_t> positions;
+    for(size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++)
+    {
+        if(candidates[i] < size)
+        {
+            positions.push_back(candidates[i]);
+        }
+    }
+    return positions;
+}
+
+TYPED_TEST(HostFindTests, TestFindIf)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> data(size, 0);
+
+        // no match
+        ASSERT_EQ(thrust::find_if(policy, data.begin(), data.end(), equal_to_value(1)) - data.begin(), size);
+
+        for(auto position : get_match_positions(size))
+        {
+            SCOPED_TRACE(testing::Message() << "with match at " << position);
+
+            data[position] = 1;
+
+            ASSERT_EQ(thrust::find_if(policy, data.begin(), data.end(), equal_to_value(1)) - data.begin(), position);
+            ASSERT_EQ(thrust::find(policy, data.begin(), data.end(), 1) - data.begin(), position);
+            ASSERT_EQ(thrust::find_if_not(policy, data.begin(), data.end(), equal_to_value(0)) - data.begin(), position);
+
+            // later matches don't hide the first one
+            thrust::host_vector<int> copy(data);
+            for(size_t i = position; i < size; i += 97)
+            {
+                copy[i] = 1;
+            }
+            copy[size - 1] = 1;
+
+            ASSERT_EQ(thrust::find_if(policy, copy.begin(), copy.end(), equal_to_value(1)) - copy.begin(), position);
+
+            data[position] = 0;
+        }
+    }
+}
+
+TYPED_TEST(HostFindTests, TestFindIfRandom)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> data = get_random_data<int>(size, 0, 100000, size);
+
+        for(int value = 0; value < 100000; value += 9973)
+        {
+            ASSERT_EQ(thrust::find_if(policy, data.begin(), data.end(), equal_to_value(value)) - data.begin(),
+                      thrust::find_if(thrust::seq, data.begin(), data.end(), equal_to_value(value)) - data.begin());
+        }
+    }
+}
+
+TYPED_TEST(HostFindTests, TestMismatch)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> a = get_random_data<int>(size, -1000, 1000, size);
+        thrust::host_vector<int> b(a);
+
+        ASSERT_EQ(thrust::mismatch(policy, a.begin(), a.end(), b.begin()).first - a.begin(), size);
+
+        for(auto position : get_match_positions(size))
+        {
+            SCOPED_TRACE(testing::Message() << "with mismatch at " << position);
+
+            b[position] += 10;
+
+            // a difference of 10 is a mismatch of equal_to, but not of equal_mod_10
+            ASSERT_EQ(thrust::mismatch(policy, a.begin(), a.end(), b.begin()).first - a.begin(), position);
+            ASSERT_EQ(thrust::mismatch(policy, a.begin(), a.end(), b.begin()).second - b.begin(), position);
+            ASSERT_EQ(thrust::mismatch(policy, a.begin(), a.end(), b.begin(), equal_mod_10()).first - a.begin(), size);
+
+            b[position] = a[position];
+        }
+    }
+}
+
+TYPED_TEST(HostFindTests, TestEqual)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> a = get_random_data<int>(size, -1000, 1000, size);
+        thrust::host_vector<int> b(a);
+
+        ASSERT_TRUE(thrust::equal(policy, a.begin(), a.end(), b.begin()));
+
+        for(auto position : get_match_positions(size))
+        {
+            SCOPED_TRACE(testing::Message() << "with difference at " << position);
+
+            b[position] += 10;
+
+            ASSERT_FALSE(thrust::equal(policy, a.begin(), a.end(), b.begin()));
+            ASSERT_TRUE(thrust::equal(policy, a.begin(), a.end(), b.begin(), equal_mod_10()));
+
+            b[position] = a[position];
+        }
+    }
+}
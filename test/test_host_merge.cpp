@@ -0,0 +1,148 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/merge.h>
+#include <thrust/fill.h>
+#include <thrust/sort.h>
+#include <thrust/sequence.h>
+#include <thrust/functional.h>
+#include <thrust/host_vector.h>
+#include <thrust/execution_policy.h>
+
+#include "test_header.hpp"
+#include "test_host_systems.hpp"
+
+HOST_SYSTEM_TESTS_DEFINE(HostMergeTests);
+
+struct greater_int
+{
+    __host__ __device__
+    bool operator()(int lhs, int rhs) const
+    {
+        return lhs > rhs;
+    }
+};
+
+// sorted keys drawn from [0, max_key], with many ties between the two ranges when max_key is small
+template <class Compare>
+thrust::host_vector<int> get_sorted_keys(size_t size, int max_key, int seed, Compare comp)
+{
+    thrust::host_vector<int> keys = get_random_data<int>(size, 0, max_key, seed);
+    thrust::sort(thrust::seq, keys.begin(), keys.end(), comp);
+    return keys;
+}
+
+template <class Policy, class Compare>
+void TestMergeKeys(Policy policy, size_t size1, size_t size2, int max_key, Compare comp)
+{
+    SCOPED_TRACE(testing::Message() << "with sizes = " << size1 << ", " << size2
+                 << ", max key = " << max_key);
+
+    const thrust::host_vector<int> keys1 = get_sorted_keys(size1, max_key, size1, comp);
+    const thrust::host_vector<int> keys2 = get_sorted_keys(size2, max_key, size2 + 1, comp);
+
+    // the values tell the ranges apart, so that the order of the ties is checked
+    thrust::host_vector<int> values1(size1);
+    thrust::host_vector<int> values2(size2);
+    thrust::sequence(values1.begin(), values1.end(), 0);
+    thrust::sequence(values2.begin(), values2.end(), static_cast<int>(size1));
+
+    thrust::host_vector<int> expected_keys(size1 + size2);
+    thrust::host_vector<int> expected_values(size1 + size2);
+    thrust::merge_by_key(thrust::seq,
+                         keys1.begin(), keys1.end(),
+                         keys2.begin(), keys2.end(),
+                         values1.begin(), values2.begin(),
+                         expected_keys.begin(), expected_values.begin(),
+                         comp);
+
+    thrust::host_vector<int> keys(size1 + size2);
+    thrust::host_vector<int> values(size1 + size2);
+
+    thrust::host_vector<int>::iterator end = thrust::merge(
+        policy, keys1.begin(), keys1.end(), keys2.begin(), keys2.end(), keys.begin(), comp);
+    ASSERT_EQ(end - keys.begin(), static_cast<std::ptrdiff_t>(size1 + size2));
+    ASSERT_EQ(keys, expected_keys);
+
+    // the pairs merged by key, and the ranges swapped
+    thrust::fill(keys.begin(), keys.end(), -1);
+    thrust::pair<thrust::host_vector<int>::iterator, thrust::host_vector<int>::iterator> ends
+        = thrust::merge_by_key(policy,
+                               keys1.begin(), keys1.end(),
+                               keys2.begin(), keys2.end(),
+                               values1.begin(), values2.begin(),
+                               keys.begin(), values.begin(),
+                               comp);
+    ASSERT_EQ(ends.first - keys.begin(), static_cast<std::ptrdiff_t>(size1 + size2));
+    ASSERT_EQ(ends.second - values.begin(), static_cast<std::ptrdiff_t>(size1 + size2));
+    ASSERT_EQ(keys, expected_keys);
+    ASSERT_EQ(values, expected_values);
+
+    thrust::merge_by_key(thrust::seq,
+                         keys2.begin(), keys2.end(),
+                         keys1.begin(), keys1.end(),
+                         values2.begin(), values1.begin(),
+                         expected_keys.begin(), expected_values.begin(),
+                         comp);
+    thrust::merge_by_key(policy,
+                         keys2.begin(), keys2.end(),
+                         keys1.begin(), keys1.end(),
+                         values2.begin(), values1.begin(),
+                         keys.begin(), values.begin(),
+                         comp);
+    ASSERT_EQ(keys, expected_keys);
+    ASSERT_EQ(values, expected_values);
+}
+
+template <class Policy, class Compare>
+void TestMergeSizes(Policy policy, Compare comp)
+{
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        // equal ranges, unbalanced ranges and an empty range
+        TestMergeKeys(policy, size, size, 1000000, comp);
+        TestMergeKeys(policy, size, size / 7, 1000000, comp);
+        TestMergeKeys(policy, 0, size, 1000000, comp);
+
+        // few distinct keys
+        TestMergeKeys(policy, size, size, 3, comp);
+        TestMergeKeys(policy, size / 3, size, 0, comp);
+    }
+}
+
+TYPED_TEST(HostMergeTests, TestMerge)
+{
+    auto policy = TestFixture::policy();
+
+    TestMergeSizes(policy, thrust::less<int>());
+}
+
+TYPED_TEST(HostMergeTests, TestMergeGreater)
+{
+    auto policy = TestFixture::policy();
+
+    TestMergeSizes(policy, thrust::greater<int>());
+    TestMergeSizes(policy, greater_int());
+}
+
+TYPED_TEST(HostMergeTests, TestMergeCustomCompare)
+{
+    auto policy = TestFixture::policy();
+
+    TestMergeSizes(policy, custom_compare_less<int>());
+}
@@ -0,0 +1,244 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
+#include <thrust/functional.h>
+#include <thrust/host_vector.h>
+#include <thrust/execution_policy.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "test_header.hpp"
+#include "test_host_systems.hpp"
+
+#if defined(THRUST_TEST_OMP)
+#include <omp.h>
+#endif
+
+#if defined(THRUST_TEST_TBB)
+#include <tbb/task_arena.h>
+#endif
+
+// runs the algorithms built on the policy's decompositions, and compares
+// their results with those of thrust::seq
+template <class Policy>
+void TestPolicyAlgorithms(Policy policy)
+{
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> input = get_random_data<int>(size, -1000, 1000, size);
+        thrust::host_vector<int> output(size);
+        thrust::host_vector<int> expected(size);
+
+        thrust::transform(thrust::seq, input.begin(), input.end(), expected.begin(), thrust::negate<int>());
+        thrust::transform(policy, input.begin(), input.end(), output.begin(), thrust::negate<int>());
+        ASSERT_EQ(output, expected);
+
+        thrust::fill(output.begin(), output.end(), 0);
+        thrust::copy(policy, input.begin(), input.end(), output.begin());
+        ASSERT_EQ(output, input);
+
+        ASSERT_EQ(thrust::reduce(policy, input.begin(), input.end(), 0ll),
+                  thrust::reduce(thrust::seq, input.begin(), input.end(), 0ll));
+
+        thrust::inclusive_scan(thrust::seq, input.begin(), input.end(), expected.begin());
+        thrust::inclusive_scan(policy, input.begin(), input.end(), output.begin());
+        ASSERT_EQ(output, expected);
+
+        // the merge sort, rather than the radix sort
+        expected = input;
+        thrust::stable_sort(thrust::seq, expected.begin(), expected.end(), custom_compare_less<int>());
+        output = input;
+        thrust::stable_sort(policy, output.begin(), output.end(), custom_compare_less<int>());
+        ASSERT_EQ(output, expected);
+    }
+}
+
+#if defined(THRUST_TEST_OMP)
+
+// records whether any element was visited inside a parallel region
+struct record_parallel
+{
+    bool* in_parallel;
+
+    __host__ __device__
+    void operator()(int) const
+    {
+        if(omp_in_parallel())
+        {
+            #pragma omp critical
+            *in_parallel = true;
+        }
+    }
+};
+
+// records the size of the largest team which visited an element
+struct record_num_threads
+{
+    int* num_threads;
+
+    __host__ __device__
+    void operator()(int) const
+    {
+        #pragma omp critical
+        *num_threads = std::max(*num_threads, omp_get_num_threads());
+    }
+};
+
+TEST(HostPoliciesTests, TestOmpGrainSize)
+{
+    const size_t grain_sizes[] = {1, 7, 1024, 1 << 20};
+
+    for(auto grain_size : grain_sizes)
+    {
+        SCOPED_TRACE(testing::Message() << "with grain size = " << grain_size);
+
+        TestPolicyAlgorithms(thrust::omp::par.with_grain_size(grain_size));
+    }
+}
+
+TEST(HostPoliciesTests, TestOmpGrainSizeAllocator)
+{
+    TestPolicyAlgorithms(thrust::omp::par(std::allocator<char>()).with_grain_size(1));
+}
+
+// ranges of less than two grains are not worth forking threads for
+TEST(HostPoliciesTests, TestOmpGrainSizeSequential)
+{
+    const size_t sizes[] = {1, 2, 1000, 1999};
+
+    for(auto size : sizes)
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> input(size);
+
+        bool in_parallel = false;
+        record_parallel f = {&in_parallel};
+
+        thrust::for_each(thrust::omp::par.with_grain_size(1000), input.begin(), input.end(), f);
+        ASSERT_FALSE(in_parallel);
+
+        thrust::for_each(thrust::omp::par.with_grain_size(size + 1), input.begin(), input.end(), f);
+        ASSERT_FALSE(in_parallel);
+    }
+}
+
+TEST(HostPoliciesTests, TestOmpThreads)
+{
+    const int thread_counts[] = {1, 2, 3, 7};
+
+    for(auto num_threads : thread_counts)
+    {
+        SCOPED_TRACE(testing::Message() << "with threads = " << num_threads);
+
+        TestPolicyAlgorithms(thrust::omp::par.with_threads(num_threads));
+        TestPolicyAlgorithms(thrust::omp::par.with_threads(num_threads).with_grain_size(1));
+        TestPolicyAlgorithms(thrust::omp::par(std::allocator<char>()).with_threads(num_threads).with_grain_size(1));
+    }
+}
+
+// the teams have the requested size, unless the grain size leaves fewer grains than threads
+TEST(HostPoliciesTests, TestOmpThreadsTeamSize)
+{
+    if(omp_get_dynamic() || omp_get_thread_limit() < 4)
+    {
+        return;
+    }
+
+    thrust::host_vector<int> input(1000);
+
+    int num_threads = 0;
+    record_num_threads f = {&num_threads};
+
+    thrust::for_each(thrust::omp::par.with_threads(4).with_grain_size(1), input.begin(), input.end(), f);
+    ASSERT_EQ(num_threads, 4);
+
+    num_threads = 0;
+    thrust::for_each(thrust::omp::par.with_grain_size(300).with_threads(4), input.begin(), input.end(), f);
+    ASSERT_EQ(num_threads, 3);
+
+    num_threads = 0;
+    thrust::for_each(thrust::omp::par.with_threads(1).with_grain_size(1), input.begin(), input.end(), f);
+    ASSERT_EQ(num_threads, 1);
+}
+
+#endif // THRUST_TEST_OMP
+
+#if defined(THRUST_TEST_TBB)
+
+// records the largest concurrency of the arenas which visited an element
+struct record_concurrency
+{
+    std::atomic<int>* concurrency;
+
+    __host__ __device__
+    void operator()(int) const
+    {
+        const int current = ::tbb::this_task_arena::max_concurrency();
+
+        int previous = concurrency->load();
+        while(previous < current && !concurrency->compare_exchange_weak(previous, current)) {}
+    }
+};
+
+TEST(HostPoliciesTests, TestTbbArena)
+{
+    const int arena_sizes[] = {1, 2, 3, 7};
+
+    for(auto arena_size : arena_sizes)
+    {
+        SCOPED_TRACE(testing::Message() << "with arena size = " << arena_size);
+
+        ::tbb::task_arena arena(arena_size);
+
+        TestPolicyAlgorithms(thrust::tbb::par.on(arena));
+        TestPolicyAlgorithms(thrust::tbb::par(std::allocator<char>()).on(arena));
+    }
+}
+
+// the algorithms run in the policy's arena rather than the caller's
+TEST(HostPoliciesTests, TestTbbArenaConcurrency)
+{
+    const int arena_sizes[] = {1, 2, 5};
+
+    for(auto arena_size : arena_sizes)
+    {
+        SCOPED_TRACE(testing::Message() << "with arena size = " << arena_size);
+
+        ::tbb::task_arena arena(arena_size);
+
+        thrust::host_vector<int> input(100000);
+
+        std::atomic<int> concurrency(0);
+        record_concurrency f = {&concurrency};
+
+        thrust::for_each(thrust::tbb::par.on(arena), input.begin(), input.end(), f);
+        ASSERT_EQ(concurrency.load(), arena_size);
+    }
+}
+
+#endif // THRUST_TEST_TBB
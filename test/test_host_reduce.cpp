@@ -0,0 +1,231 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/reduce.h>
+#include <thrust/transform_reduce.h>
+#include <thrust/inner_product.h>
+#include <thrust/functional.h>
+#include <thrust/host_vector.h>
+#include <thrust/device_vector.h>
+#include <thrust/execution_policy.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "test_header.hpp"
+#include "test_host_systems.hpp"
+
+HOST_SYSTEM_TESTS_DEFINE(HostReduceTests);
+
+// every size up to a few times the number of lanes of the vectorized reduce,
+// and the sizes around the cutoffs of the host systems
+inline std::vector<size_t> get_reduce_sizes()
+{
+    std::vector<size_t> sizes = get_host_system_sizes();
+    for(size_t size = 0; size < 200; size++)
+    {
+        sizes.push_back(size);
+    }
+    return sizes;
+}
+
+// small integers, which the floating point types add up exactly in any order
+template <class T>
+thrust::host_vector<T> get_reduce_data(size_t size, int min, int max, int seed)
+{
+    thrust::host_vector<int> data = get_random_data<int>(size, min, max, seed);
+
+    thrust::host_vector<T> result(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        result[i] = static_cast<T>(data[i]);
+    }
+    return result;
+}
+
+// the same results in the order of a single accumulator
+template <class T, class BinaryFunction>
+T expected_reduce(const thrust::host_vector<T>& input, size_t offset, T init, BinaryFunction op)
+{
+    T result = init;
+    for(size_t i = offset; i < input.size(); i++)
+    {
+        result = op(result, input[i]);
+    }
+    return result;
+}
+
+template <class T, class Policy>
+void TestReduceType(Policy policy, int min, int max)
+{
+    SCOPED_TRACE(testing::Message() << "with type size = " << sizeof(T));
+
+    for(auto size : get_reduce_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<T> input = get_reduce_data<T>(size, min, max, size);
+
+        // from the first element, and from a misaligned one
+        for(size_t offset = 0; offset < 2 && offset <= size; offset++)
+        {
+            SCOPED_TRACE(testing::Message() << "with offset = " << offset);
+
+            const T* first = thrust::raw_pointer_cast(input.data()) + offset;
+            const T* last  = thrust::raw_pointer_cast(input.data()) + size;
+
+            ASSERT_EQ(thrust::reduce(policy, first, last, T(3), thrust::plus<T>()),
+                      expected_reduce(input, offset, T(3), thrust::plus<T>()));
+            ASSERT_EQ(thrust::reduce(policy, input.begin() + offset, input.end(), T(3), thrust::plus<T>()),
+                      expected_reduce(input, offset, T(3), thrust::plus<T>()));
+
+            // inits inside and outside of the range of the elements
+            ASSERT_EQ(thrust::reduce(policy, first, last, T(0), thrust::minimum<T>()),
+                      expected_reduce(input, offset, T(0), thrust::minimum<T>()));
+            ASSERT_EQ(thrust::reduce(policy, first, last, T(max), thrust::minimum<T>()),
+                      expected_reduce(input, offset, T(max), thrust::minimum<T>()));
+            ASSERT_EQ(thrust::reduce(policy, first, last, T(0), thrust::maximum<T>()),
+                      expected_reduce(input, offset, T(0), thrust::maximum<T>()));
+            ASSERT_EQ(thrust::reduce(policy, first, last, T(min), thrust::maximum<T>()),
+                      expected_reduce(input, offset, T(min), thrust::maximum<T>()));
+        }
+    }
+}
+
+TYPED_TEST(HostReduceTests, TestReduceVectorized)
+{
+    auto policy = TestFixture::policy();
+
+    // the sums of the narrow types wrap around, which is exact in any order
+    TestReduceType<unsigned char>(policy, 0, 255);
+    TestReduceType<unsigned short>(policy, 0, 65535);
+    TestReduceType<int>(policy, -1000, 1000);
+    TestReduceType<unsigned int>(policy, 0, 1000);
+    TestReduceType<long long>(policy, -1000000, 1000000);
+    TestReduceType<float>(policy, -4, 4);
+    TestReduceType<double>(policy, -1000, 1000);
+}
+
+// the maximum of signed chars, whose sums would overflow
+TYPED_TEST(HostReduceTests, TestReduceVectorizedChar)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_reduce_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<signed char> input = get_reduce_data<signed char>(size, -128, 127, size);
+
+        ASSERT_EQ(thrust::reduce(policy, input.begin(), input.end(), (signed char)-128, thrust::maximum<signed char>()),
+                  expected_reduce(input, 0, (signed char)-128, thrust::maximum<signed char>()));
+        ASSERT_EQ(thrust::reduce(policy, input.begin(), input.end(), (signed char)127, thrust::minimum<signed char>()),
+                  expected_reduce(input, 0, (signed char)127, thrust::minimum<signed char>()));
+    }
+}
+
+struct square
+{
+    __host__ __device__
+    double operator()(double x) const
+    {
+        return x * x;
+    }
+};
+
+struct square_int
+{
+    __host__ __device__
+    int operator()(int x) const
+    {
+        return x * x;
+    }
+};
+
+TYPED_TEST(HostReduceTests, TestTransformReduceVectorized)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_reduce_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<double> input = get_reduce_data<double>(size, -1000, 1000, size);
+
+        double expected = 1;
+        for(size_t i = 0; i < size; i++)
+        {
+            expected += input[i] * input[i];
+        }
+
+        ASSERT_EQ(thrust::transform_reduce(policy, input.begin(), input.end(), square(), 1.0, thrust::plus<double>()),
+                  expected);
+    }
+}
+
+TYPED_TEST(HostReduceTests, TestInnerProductVectorized)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_reduce_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<float> input1 = get_reduce_data<float>(size, -4, 4, size);
+        thrust::host_vector<float> input2 = get_reduce_data<float>(size, -4, 4, size + 1);
+
+        float expected = 2;
+        for(size_t i = 0; i < size; i++)
+        {
+            expected += input1[i] * input2[i];
+        }
+
+        ASSERT_EQ(thrust::inner_product(policy, input1.begin(), input1.end(), input2.begin(), 2.0f), expected);
+    }
+}
+
+// the sequential reduce of device memory reads it through device references,
+// rather than through the raw pointers of the vectorized reduce of host memory
+TEST(HostReduceTests, TestReduceDeviceVectorSeq)
+{
+    for(auto size : get_reduce_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> h_input1 = get_reduce_data<int>(size, -1000, 1000, size);
+        thrust::host_vector<int> h_input2 = get_reduce_data<int>(size, -1000, 1000, size + 1);
+
+        thrust::device_vector<int> d_input1 = h_input1;
+        thrust::device_vector<int> d_input2 = h_input2;
+
+        int expected_square_sum = 1;
+        int expected_product = 2;
+        for(size_t i = 0; i < size; i++)
+        {
+            expected_square_sum += h_input1[i] * h_input1[i];
+            expected_product += h_input1[i] * h_input2[i];
+        }
+
+        ASSERT_EQ(thrust::reduce(thrust::seq, d_input1.begin(), d_input1.end(), 3, thrust::plus<int>()),
+                  expected_reduce(h_input1, 0, 3, thrust::plus<int>()));
+        ASSERT_EQ(thrust::reduce(thrust::seq, d_input1.data(), d_input1.data() + size, 3, thrust::maximum<int>()),
+                  expected_reduce(h_input1, 0, 3, thrust::maximum<int>()));
+        ASSERT_EQ(thrust::transform_reduce(thrust::seq, d_input1.begin(), d_input1.end(), square_int(), 1, thrust::plus<int>()),
+                  expected_square_sum);
+        ASSERT_EQ(thrust::inner_product(thrust::seq, d_input1.begin(), d_input1.end(), d_input2.begin(), 2),
+                  expected_product);
+    }
+}
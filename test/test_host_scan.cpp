@@ -0,0 +1,167 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/scan.h>
+#include <thrust/functional.h>
+#include <thrust/host_vector.h>
+#include <thrust/execution_policy.h>
+
+#include "test_header.hpp"
+#include "test_host_systems.hpp"
+
+HOST_SYSTEM_TESTS_DEFINE(HostScanTests);
+
+TYPED_TEST(HostScanTests, TestExclusiveScanInit)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<long long> input = get_random_data<long long>(size, -100, 100, size);
+        thrust::host_vector<long long> output(size);
+        thrust::host_vector<long long> expected(size);
+
+        thrust::exclusive_scan(thrust::seq, input.begin(), input.end(), expected.begin(), 7ll);
+
+        thrust::exclusive_scan(policy, input.begin(), input.end(), output.begin(), 7ll);
+        ASSERT_EQ(output, expected);
+
+        // in place
+        output = input;
+        thrust::exclusive_scan(policy, output.begin(), output.end(), output.begin(), 7ll);
+        ASSERT_EQ(output, expected);
+    }
+}
+
+TYPED_TEST(HostScanTests, TestExclusiveScanInitSimple)
+{
+    auto policy = TestFixture::policy();
+
+    thrust::host_vector<int> input(4);
+    input[0] = 1;
+    input[1] = 2;
+    input[2] = 3;
+    input[3] = 4;
+
+    thrust::host_vector<int> output(4);
+
+    thrust::exclusive_scan(policy, input.begin(), input.end(), output.begin(), 7);
+
+    ASSERT_EQ(output[0], 7);
+    ASSERT_EQ(output[1], 8);
+    ASSERT_EQ(output[2], 10);
+    ASSERT_EQ(output[3], 13);
+
+    thrust::exclusive_scan(policy, input.begin(), input.begin() + 1, output.begin(), 7);
+
+    ASSERT_EQ(output[0], 7);
+}
+
+struct max_functor
+{
+    __host__ __device__
+    int operator()(int lhs, int rhs) const
+    {
+        return lhs < rhs ? rhs : lhs;
+    }
+};
+
+TYPED_TEST(HostScanTests, TestInclusiveScan)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> input = get_random_data<int>(size, -1000, 1000, size);
+        thrust::host_vector<int> output(size);
+        thrust::host_vector<int> expected(size);
+
+        thrust::inclusive_scan(thrust::seq, input.begin(), input.end(), expected.begin());
+
+        thrust::inclusive_scan(policy, input.begin(), input.end(), output.begin());
+        ASSERT_EQ(output, expected);
+
+        // in place
+        output = input;
+        thrust::inclusive_scan(policy, output.begin(), output.end(), output.begin());
+        ASSERT_EQ(output, expected);
+
+        // a custom operator
+        thrust::inclusive_scan(thrust::seq, input.begin(), input.end(), expected.begin(), max_functor());
+
+        thrust::inclusive_scan(policy, input.begin(), input.end(), output.begin(), max_functor());
+        ASSERT_EQ(output, expected);
+
+        thrust::inclusive_scan(thrust::seq, input.begin(), input.end(), expected.begin(), thrust::bit_xor<int>());
+
+        thrust::inclusive_scan(policy, input.begin(), input.end(), output.begin(), thrust::bit_xor<int>());
+        ASSERT_EQ(output, expected);
+    }
+}
+
+TYPED_TEST(HostScanTests, TestInclusiveScanMixedTypes)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        // the sums overflow int, but not long long
+        thrust::host_vector<int> input = get_random_data<int>(size, 0, 1 << 20, size);
+        thrust::host_vector<long long> output(size);
+        thrust::host_vector<long long> expected(size);
+
+        thrust::inclusive_scan(thrust::seq, input.begin(), input.end(), expected.begin(), thrust::plus<long long>());
+
+        thrust::inclusive_scan(policy, input.begin(), input.end(), output.begin(), thrust::plus<long long>());
+        ASSERT_EQ(output, expected);
+    }
+}
+
+TYPED_TEST(HostScanTests, TestExclusiveScan)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> input = get_random_data<int>(size, -1000, 1000, size);
+        thrust::host_vector<int> output(size);
+        thrust::host_vector<int> expected(size);
+
+        thrust::exclusive_scan(thrust::seq, input.begin(), input.end(), expected.begin());
+
+        thrust::exclusive_scan(policy, input.begin(), input.end(), output.begin());
+        ASSERT_EQ(output, expected);
+
+        // a custom operator, with an init which is not its identity
+        thrust::exclusive_scan(thrust::seq, input.begin(), input.end(), expected.begin(), 500, max_functor());
+
+        thrust::exclusive_scan(policy, input.begin(), input.end(), output.begin(), 500, max_functor());
+        ASSERT_EQ(output, expected);
+
+        // in place
+        output = input;
+        thrust::exclusive_scan(policy, output.begin(), output.end(), output.begin(), 500, max_functor());
+        ASSERT_EQ(output, expected);
+    }
+}
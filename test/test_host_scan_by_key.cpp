@@ -0,0 +1,192 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/scan.h>
+#include <thrust/reduce.h>
+#include <thrust/tuning.h>
+#include <thrust/functional.h>
+#include <thrust/host_vector.h>
+#include <thrust/execution_policy.h>
+
+#include "test_header.hpp"
+#include "test_host_systems.hpp"
+
+HOST_SYSTEM_TESTS_DEFINE(HostScanByKeyTests);
+
+// the lengths of the runs of equal keys
+const size_t run_lengths[] = {1, 7, 1000, 100000};
+
+struct max_functor
+{
+    __host__ __device__
+    int operator()(int lhs, int rhs) const
+    {
+        return lhs < rhs ? rhs : lhs;
+    }
+};
+
+struct equal_div_2
+{
+    __host__ __device__
+    bool operator()(int lhs, int rhs) const
+    {
+        return lhs / 2 == rhs / 2;
+    }
+};
+
+thrust::host_vector<int> get_run_keys(size_t size, size_t run_length)
+{
+    thrust::host_vector<int> keys(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        keys[i] = static_cast<int>(i / run_length);
+    }
+    return keys;
+}
+
+template<typename Policy>
+void TestInclusiveScanByKeyWithPolicy(Policy policy)
+{
+    for(auto size : get_host_system_sizes())
+    {
+        for(auto run_length : run_lengths)
+        {
+            SCOPED_TRACE(testing::Message() << "with size = " << size << ", run length = " << run_length);
+
+            thrust::host_vector<int> keys = get_run_keys(size, run_length);
+            thrust::host_vector<int> values = get_random_data<int>(size, -1000, 1000, size);
+            thrust::host_vector<int> output(size);
+            thrust::host_vector<int> expected(size);
+
+            thrust::inclusive_scan_by_key(thrust::seq, keys.begin(), keys.end(), values.begin(), expected.begin());
+
+            thrust::inclusive_scan_by_key(policy, keys.begin(), keys.end(), values.begin(), output.begin());
+            ASSERT_EQ(output, expected);
+
+            // a custom predicate and operator
+            thrust::inclusive_scan_by_key(thrust::seq, keys.begin(), keys.end(), values.begin(), expected.begin(), equal_div_2(), max_functor());
+
+            thrust::inclusive_scan_by_key(policy, keys.begin(), keys.end(), values.begin(), output.begin(), equal_div_2(), max_functor());
+            ASSERT_EQ(output, expected);
+
+            // in place
+            output = values;
+            thrust::inclusive_scan_by_key(policy, keys.begin(), keys.end(), output.begin(), output.begin(), equal_div_2(), max_functor());
+            ASSERT_EQ(output, expected);
+        }
+    }
+}
+
+template<typename Policy>
+void TestExclusiveScanByKeyWithPolicy(Policy policy)
+{
+    for(auto size : get_host_system_sizes())
+    {
+        for(auto run_length : run_lengths)
+        {
+            SCOPED_TRACE(testing::Message() << "with size = " << size << ", run length = " << run_length);
+
+            thrust::host_vector<int> keys = get_run_keys(size, run_length);
+            thrust::host_vector<int> values = get_random_data<int>(size, -1000, 1000, size);
+            thrust::host_vector<int> output(size);
+            thrust::host_vector<int> expected(size);
+
+            thrust::exclusive_scan_by_key(thrust::seq, keys.begin(), keys.end(), values.begin(), expected.begin());
+
+            thrust::exclusive_scan_by_key(policy, keys.begin(), keys.end(), values.begin(), output.begin());
+            ASSERT_EQ(output, expected);
+
+            // an init, which starts every segment
+            thrust::exclusive_scan_by_key(thrust::seq, keys.begin(), keys.end(), values.begin(), expected.begin(), 7);
+
+            thrust::exclusive_scan_by_key(policy, keys.begin(), keys.end(), values.begin(), output.begin(), 7);
+            ASSERT_EQ(output, expected);
+
+            // a custom predicate and operator
+            thrust::exclusive_scan_by_key(thrust::seq, keys.begin(), keys.end(), values.begin(), expected.begin(), 500, equal_div_2(), max_functor());
+
+            thrust::exclusive_scan_by_key(policy, keys.begin(), keys.end(), values.begin(), output.begin(), 500, equal_div_2(), max_functor());
+            ASSERT_EQ(output, expected);
+
+            // in place
+            output = values;
+            thrust::exclusive_scan_by_key(policy, keys.begin(), keys.end(), output.begin(), output.begin(), 500, equal_div_2(), max_functor());
+            ASSERT_EQ(output, expected);
+        }
+    }
+}
+
+template<typename Policy>
+void TestReduceByKeyWithPolicy(Policy policy)
+{
+    for(auto size : get_host_system_sizes())
+    {
+        for(auto run_length : run_lengths)
+        {
+            SCOPED_TRACE(testing::Message() << "with size = " << size << ", run length = " << run_length);
+
+            thrust::host_vector<int> keys = get_run_keys(size, run_length);
+            thrust::host_vector<int> values = get_random_data<int>(size, -1000, 1000, size);
+
+            thrust::host_vector<int> expected_keys(size);
+            thrust::host_vector<int> expected_values(size);
+            thrust::host_vector<int> output_keys(size);
+            thrust::host_vector<int> output_values(size);
+
+            const size_t expected_size = thrust::reduce_by_key(thrust::seq, keys.begin(), keys.end(), values.begin(), expected_keys.begin(), expected_values.begin()).first - expected_keys.begin();
+            const size_t output_size = thrust::reduce_by_key(policy, keys.begin(), keys.end(), values.begin(), output_keys.begin(), output_values.begin()).first - output_keys.begin();
+
+            ASSERT_EQ(output_size, expected_size);
+            ASSERT_EQ(output_keys, expected_keys);
+            ASSERT_EQ(output_values, expected_values);
+
+            // a custom predicate and operator
+            const size_t expected_custom_size = thrust::reduce_by_key(thrust::seq, keys.begin(), keys.end(), values.begin(), expected_keys.begin(), expected_values.begin(), equal_div_2(), max_functor()).first - expected_keys.begin();
+            const size_t output_custom_size = thrust::reduce_by_key(policy, keys.begin(), keys.end(), values.begin(), output_keys.begin(), output_values.begin(), equal_div_2(), max_functor()).first - output_keys.begin();
+
+            ASSERT_EQ(output_custom_size, expected_custom_size);
+            ASSERT_EQ(output_keys, expected_keys);
+            ASSERT_EQ(output_values, expected_values);
+        }
+    }
+}
+
+TYPED_TEST(HostScanByKeyTests, TestInclusiveScanByKey)
+{
+    TestInclusiveScanByKeyWithPolicy(TestFixture::policy());
+}
+
+TYPED_TEST(HostScanByKeyTests, TestExclusiveScanByKey)
+{
+    TestExclusiveScanByKeyWithPolicy(TestFixture::policy());
+}
+
+TYPED_TEST(HostScanByKeyTests, TestReduceByKey)
+{
+    TestReduceByKeyWithPolicy(TestFixture::policy());
+}
+
+// the tiled algorithms also run in parallel on the smallest inputs
+TYPED_TEST(HostScanByKeyTests, TestByKeyLowThreshold)
+{
+    thrust::tuning::set(thrust::tuning::tbb_reduce_by_key_threshold, 1);
+
+    TestInclusiveScanByKeyWithPolicy(TestFixture::policy());
+    TestExclusiveScanByKeyWithPolicy(TestFixture::policy());
+    TestReduceByKeyWithPolicy(TestFixture::policy());
+
+    thrust::tuning::reset();
+}
@@ -0,0 +1,222 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/set_operations.h>
+#include <thrust/sort.h>
+#include <thrust/tuning.h>
+#include <thrust/sequence.h>
+#include <thrust/functional.h>
+#include <thrust/host_vector.h>
+#include <thrust/execution_policy.h>
+
+#include "test_header.hpp"
+#include "test_host_systems.hpp"
+
+HOST_SYSTEM_TESTS_DEFINE(HostSetOperationsTests);
+
+// the set operations, called with the keys alone and with keys and values
+#define DEFINE_SET_OPERATION(name)                                                             \
+    struct name##_operation                                                                    \
+    {                                                                                          \
+        template <class Policy, class Iterator, class Compare>                                 \
+        Iterator operator()(Policy policy,                                                     \
+                            Iterator first1, Iterator last1,                                   \
+                            Iterator first2, Iterator last2,                                   \
+                            Iterator result, Compare comp) const                               \
+        {                                                                                      \
+            return thrust::name(policy, first1, last1, first2, last2, result, comp);           \
+        }                                                                                      \
+                                                                                               \
+        template <class Policy, class Iterator, class Compare>                                 \
+        thrust::pair<Iterator, Iterator> operator()(Policy policy,                             \
+                                                    Iterator keys_first1, Iterator keys_last1, \
+                                                    Iterator keys_first2, Iterator keys_last2, \
+                                                    Iterator values_first1,                    \
+                                                    Iterator values_first2,                    \
+                                                    Iterator keys_result,                      \
+                                                    Iterator values_result,                    \
+                                                    Compare comp) const                        \
+        {                                                                                      \
+            return thrust::name##_by_key(policy,                                               \
+                                         keys_first1, keys_last1,                              \
+                                         keys_first2, keys_last2,                              \
+                                         values_first1, values_first2,                         \
+                                         keys_result, values_result,                           \
+                                         comp);                                                \
+        }                                                                                      \
+    };
+
+DEFINE_SET_OPERATION(set_difference)
+DEFINE_SET_OPERATION(set_symmetric_difference)
+DEFINE_SET_OPERATION(set_union)
+
+#undef DEFINE_SET_OPERATION
+
+// set_intersection_by_key only takes the values of the first range, which its outputs come from
+struct set_intersection_operation
+{
+    template <class Policy, class Iterator, class Compare>
+    Iterator operator()(Policy policy,
+                        Iterator first1, Iterator last1,
+                        Iterator first2, Iterator last2,
+                        Iterator result, Compare comp) const
+    {
+        return thrust::set_intersection(policy, first1, last1, first2, last2, result, comp);
+    }
+
+    template <class Policy, class Iterator, class Compare>
+    thrust::pair<Iterator, Iterator> operator()(Policy policy,
+                                                Iterator keys_first1, Iterator keys_last1,
+                                                Iterator keys_first2, Iterator keys_last2,
+                                                Iterator values_first1,
+                                                Iterator,
+                                                Iterator keys_result,
+                                                Iterator values_result,
+                                                Compare comp) const
+    {
+        return thrust::set_intersection_by_key(policy,
+                                               keys_first1, keys_last1,
+                                               keys_first2, keys_last2,
+                                               values_first1,
+                                               keys_result, values_result,
+                                               comp);
+    }
+};
+
+struct greater_int
+{
+    __host__ __device__
+    bool operator()(int lhs, int rhs) const
+    {
+        return lhs > rhs;
+    }
+};
+
+// sorted keys drawn from [0, max_key], with many repeated keys when max_key is small
+template <class Compare>
+thrust::host_vector<int> get_sorted_keys(size_t size, int max_key, int seed, Compare comp)
+{
+    thrust::host_vector<int> keys = get_random_data<int>(size, 0, max_key, seed);
+    thrust::sort(thrust::seq, keys.begin(), keys.end(), comp);
+    return keys;
+}
+
+template <class Policy, class Operation, class Compare>
+void TestSetOperationKeys(Policy policy, Operation op, size_t size1, size_t size2, int max_key, Compare comp)
+{
+    SCOPED_TRACE(testing::Message() << "with sizes = " << size1 << ", " << size2
+                 << ", max key = " << max_key);
+
+    thrust::host_vector<int> keys1 = get_sorted_keys(size1, max_key, size1, comp);
+    thrust::host_vector<int> keys2 = get_sorted_keys(size2, max_key, size2 + 1, comp);
+
+    // the values tell the ranges apart, so that the choice between equivalent keys is checked
+    thrust::host_vector<int> values1(size1);
+    thrust::host_vector<int> values2(size2);
+    thrust::sequence(values1.begin(), values1.end(), 0);
+    thrust::sequence(values2.begin(), values2.end(), static_cast<int>(size1));
+
+    thrust::host_vector<int> expected_keys(size1 + size2);
+    thrust::host_vector<int> expected_values(size1 + size2);
+    thrust::pair<thrust::host_vector<int>::iterator, thrust::host_vector<int>::iterator> expected_ends
+        = op(thrust::seq,
+             keys1.begin(), keys1.end(),
+             keys2.begin(), keys2.end(),
+             values1.begin(), values2.begin(),
+             expected_keys.begin(), expected_values.begin(),
+             comp);
+    expected_keys.resize(expected_ends.first - expected_keys.begin());
+    expected_values.resize(expected_ends.second - expected_values.begin());
+
+    thrust::host_vector<int> keys(size1 + size2);
+    thrust::host_vector<int>::iterator end
+        = op(policy, keys1.begin(), keys1.end(), keys2.begin(), keys2.end(), keys.begin(), comp);
+    keys.resize(end - keys.begin());
+    ASSERT_EQ(keys, expected_keys);
+
+    keys.resize(size1 + size2);
+    thrust::host_vector<int> values(size1 + size2);
+    thrust::pair<thrust::host_vector<int>::iterator, thrust::host_vector<int>::iterator> ends
+        = op(policy,
+             keys1.begin(), keys1.end(),
+             keys2.begin(), keys2.end(),
+             values1.begin(), values2.begin(),
+             keys.begin(), values.begin(),
+             comp);
+    keys.resize(ends.first - keys.begin());
+    values.resize(ends.second - values.begin());
+    ASSERT_EQ(keys, expected_keys);
+    ASSERT_EQ(values, expected_values);
+}
+
+template <class Policy, class Compare>
+void TestSetOperationsSize(Policy policy, size_t size, Compare comp)
+{
+    SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+    const int max_keys[] = {0, 3, 1000000};
+
+    for(auto max_key : max_keys)
+    {
+        TestSetOperationKeys(policy, set_difference_operation(), size, size / 3, max_key, comp);
+        TestSetOperationKeys(policy, set_difference_operation(), size / 3, size, max_key, comp);
+        TestSetOperationKeys(policy, set_intersection_operation(), size, size, max_key, comp);
+        TestSetOperationKeys(policy, set_intersection_operation(), size, size / 7, max_key, comp);
+        TestSetOperationKeys(policy, set_symmetric_difference_operation(), size, size / 3, max_key, comp);
+        TestSetOperationKeys(policy, set_union_operation(), size, size, max_key, comp);
+        TestSetOperationKeys(policy, set_union_operation(), 0, size, max_key, comp);
+    }
+}
+
+template <class Policy, class Compare>
+void TestSetOperations(Policy policy, Compare comp)
+{
+    for(auto size : get_host_system_sizes())
+    {
+        TestSetOperationsSize(policy, size, comp);
+    }
+}
+
+TYPED_TEST(HostSetOperationsTests, TestSetOperations)
+{
+    TestSetOperations(TestFixture::policy(), thrust::less<int>());
+}
+
+TYPED_TEST(HostSetOperationsTests, TestSetOperationsGreater)
+{
+    TestSetOperations(TestFixture::policy(), thrust::greater<int>());
+    TestSetOperations(TestFixture::policy(), greater_int());
+}
+
+TYPED_TEST(HostSetOperationsTests, TestSetOperationsCustomCompare)
+{
+    TestSetOperations(TestFixture::policy(), custom_compare_less<int>());
+}
+
+// the TBB set operations also split the smallest inputs
+TYPED_TEST(HostSetOperationsTests, TestSetOperationsLowThreshold)
+{
+    thrust::tuning::set(thrust::tuning::tbb_reduce_by_key_threshold, 1);
+
+    const size_t sizes[] = {1, 2, 3, 5, 17, 64, 255};
+
+    for(auto size : sizes)
+    {
+        TestSetOperationsSize(TestFixture::policy(), size, thrust::less<int>());
+    }
+
+    thrust::tuning::reset();
+}
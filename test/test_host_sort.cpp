@@ -0,0 +1,323 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/sort.h>
+#include <thrust/pair.h>
+#include <thrust/tuning.h>
+#include <thrust/functional.h>
+#include <thrust/host_vector.h>
+#include <thrust/execution_policy.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+
+#include "test_header.hpp"
+#include "test_host_systems.hpp"
+
+#if defined(THRUST_TEST_TBB)
+#include <thrust/system/tbb/calibrate.h>
+#endif
+
+HOST_SYSTEM_TESTS_DEFINE(HostSortTests);
+
+// the sizes around the sort cutoffs, which every key type is sorted at
+const size_t sort_sizes[] = {0, 1, 2, 3, 17, 255, 1024, 1025, 4097, 131072, 131073};
+
+// the sizes sorted with the sequential threshold lowered
+const size_t small_sort_sizes[] = {2, 3, 17, 255, 1024, 1025, 4097};
+
+// keys of every bit pattern of the integer types, and of both signs for the
+// floating point types
+template <class T>
+auto get_random_keys(size_t size, int seed) ->
+    typename std::enable_if<std::is_integral<T>::value, thrust::host_vector<T>>::type
+{
+    thrust::host_vector<unsigned long long> bits = get_random_data<unsigned long long>(
+        size, 0, std::numeric_limits<unsigned long long>::max(), seed);
+
+    thrust::host_vector<T> keys(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        keys[i] = static_cast<T>(bits[i]);
+    }
+    return keys;
+}
+
+template <class T>
+auto get_random_keys(size_t size, int seed) ->
+    typename std::enable_if<std::is_floating_point<T>::value, thrust::host_vector<T>>::type
+{
+    return get_random_data<T>(size, T(-1000000), T(1000000), seed);
+}
+
+// keys of only four distinct values, so that stability matters
+template <class T>
+thrust::host_vector<T> get_duplicate_keys(size_t size, int seed)
+{
+    thrust::host_vector<unsigned int> bits = get_random_data<unsigned int>(size, 0, 3, seed);
+
+    thrust::host_vector<T> keys(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        keys[i] = static_cast<T>(bits[i]);
+    }
+    return keys;
+}
+
+// sorts the keys and their positions with std::stable_sort
+template <class T, class Compare>
+void stable_sort_expected(thrust::host_vector<T>& keys, thrust::host_vector<int>& values, Compare comp)
+{
+    const thrust::host_vector<T> input(keys);
+
+    values.resize(keys.size());
+    std::iota(values.begin(), values.end(), 0);
+    std::stable_sort(values.begin(), values.end(), [&](int lhs, int rhs) {
+        return comp(input[lhs], input[rhs]);
+    });
+
+    for(size_t i = 0; i < keys.size(); i++)
+    {
+        keys[i] = input[values[i]];
+    }
+}
+
+template <class T, class Policy, class Compare>
+void TestStableSortKeys(Policy policy, const thrust::host_vector<T>& input, Compare comp)
+{
+    thrust::host_vector<T> expected_keys(input);
+    thrust::host_vector<int> expected_values;
+    stable_sort_expected(expected_keys, expected_values, comp);
+
+    thrust::host_vector<T> keys(input);
+    thrust::stable_sort(policy, keys.begin(), keys.end(), comp);
+    ASSERT_EQ(keys, expected_keys);
+
+    keys = input;
+    thrust::sort(policy, keys.begin(), keys.end(), comp);
+    ASSERT_EQ(keys, expected_keys);
+
+    // the values are the original positions of the keys
+    keys = input;
+    thrust::host_vector<int> values(input.size());
+    std::iota(values.begin(), values.end(), 0);
+    thrust::stable_sort_by_key(policy, keys.begin(), keys.end(), values.begin(), comp);
+    ASSERT_EQ(keys, expected_keys);
+    ASSERT_EQ(values, expected_values);
+}
+
+template <class T, class Policy, size_t N>
+void TestRadixSortKeys(Policy policy, const size_t (&sizes)[N])
+{
+    SCOPED_TRACE(testing::Message() << "with key size = " << sizeof(T)
+                 << (std::is_floating_point<T>::value ? ", floating point" : "")
+                 << (std::is_signed<T>::value ? ", signed" : ""));
+
+    for(auto size : sizes)
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<T> input = get_random_keys<T>(size, size);
+
+        TestStableSortKeys(policy, input, thrust::less<T>());
+        TestStableSortKeys(policy, input, thrust::greater<T>());
+
+        input = get_duplicate_keys<T>(size, size);
+
+        TestStableSortKeys(policy, input, thrust::less<T>());
+        TestStableSortKeys(policy, input, thrust::greater<T>());
+    }
+}
+
+template <class Policy, size_t N>
+void TestRadixSortAllKeys(Policy policy, const size_t (&sizes)[N])
+{
+    TestRadixSortKeys<char>(policy, sizes);
+    TestRadixSortKeys<signed char>(policy, sizes);
+    TestRadixSortKeys<unsigned char>(policy, sizes);
+    TestRadixSortKeys<short>(policy, sizes);
+    TestRadixSortKeys<unsigned short>(policy, sizes);
+    TestRadixSortKeys<int>(policy, sizes);
+    TestRadixSortKeys<unsigned int>(policy, sizes);
+    TestRadixSortKeys<long>(policy, sizes);
+    TestRadixSortKeys<unsigned long>(policy, sizes);
+    TestRadixSortKeys<long long>(policy, sizes);
+    TestRadixSortKeys<unsigned long long>(policy, sizes);
+    TestRadixSortKeys<float>(policy, sizes);
+    TestRadixSortKeys<double>(policy, sizes);
+}
+
+TYPED_TEST(HostSortTests, TestRadixSort)
+{
+    TestRadixSortAllKeys(TestFixture::policy(), sort_sizes);
+}
+
+// the TBB radix sort also runs on the smallest inputs
+TYPED_TEST(HostSortTests, TestRadixSortLowThreshold)
+{
+    thrust::tuning::set(thrust::tuning::tbb_radix_sort_threshold, 2);
+
+    TestRadixSortAllKeys(TestFixture::policy(), small_sort_sizes);
+
+    thrust::tuning::reset();
+}
+
+TYPED_TEST(HostSortTests, TestRadixSortBool)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<bool> input = get_duplicate_keys<bool>(size, size);
+
+        TestStableSortKeys(policy, input, thrust::less<bool>());
+        TestStableSortKeys(policy, input, thrust::greater<bool>());
+    }
+}
+
+struct greater_int
+{
+    __host__ __device__
+    bool operator()(int lhs, int rhs) const
+    {
+        return lhs > rhs;
+    }
+};
+
+// orders the pairs by their first element only, so that the ties are kept in order
+struct compare_first
+{
+    __host__ __device__
+    bool operator()(const thrust::pair<int, int>& lhs, const thrust::pair<int, int>& rhs) const
+    {
+        return lhs.first < rhs.first;
+    }
+};
+
+TYPED_TEST(HostSortTests, TestMergeSort)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> input = get_random_data<int>(size, -1000000, 1000000, size);
+
+        TestStableSortKeys(policy, input, custom_compare_less<int>());
+        TestStableSortKeys(policy, input, greater_int());
+
+        input = get_duplicate_keys<int>(size, size);
+
+        TestStableSortKeys(policy, input, custom_compare_less<int>());
+        TestStableSortKeys(policy, input, greater_int());
+    }
+}
+
+TYPED_TEST(HostSortTests, TestMergeSortPairs)
+{
+    auto policy = TestFixture::policy();
+
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> firsts = get_duplicate_keys<int>(size, size);
+
+        // the second elements are the original positions
+        thrust::host_vector<thrust::pair<int, int>> input(size);
+        for(size_t i = 0; i < size; i++)
+        {
+            input[i] = thrust::make_pair(firsts[i], static_cast<int>(i));
+        }
+
+        TestStableSortKeys(policy, input, compare_first());
+    }
+}
+
+// the TBB merge sort also splits the smallest inputs
+TYPED_TEST(HostSortTests, TestMergeSortLowThreshold)
+{
+    auto policy = TestFixture::policy();
+
+    thrust::tuning::set(thrust::tuning::tbb_merge_sort_leaf_size, 2);
+
+    for(auto size : small_sort_sizes)
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> input = get_duplicate_keys<int>(size, size);
+
+        TestStableSortKeys(policy, input, custom_compare_less<int>());
+        TestStableSortKeys(policy, input, greater_int());
+    }
+
+    thrust::tuning::reset();
+}
+
+#if defined(THRUST_TEST_TBB)
+// calibrate stores a merge sort leaf size and a radix sort threshold for the
+// element size it is given, among the sizes it measures, and the sorts of that
+// element size sort correctly around them
+TEST(HostSortCalibrationTests, TestTbbCalibratedSortThresholds)
+{
+    thrust::tuning::reset();
+    const size_t default_leaf_size = thrust::tuning::get<char>(thrust::tuning::tbb_merge_sort_leaf_size);
+    const size_t default_radix_threshold = thrust::tuning::get<char>(thrust::tuning::tbb_radix_sort_threshold);
+    thrust::tbb::calibrate<int>();
+
+    const size_t leaf_size = thrust::tuning::get<int>(thrust::tuning::tbb_merge_sort_leaf_size);
+    ASSERT_GE(leaf_size, 1024u);
+    ASSERT_LE(leaf_size, 1048576u);
+
+    // the radix sort may never be faster, in which case it is only used above the sizes measured
+    const size_t radix_threshold = thrust::tuning::get<int>(thrust::tuning::tbb_radix_sort_threshold);
+    ASSERT_GE(radix_threshold, 1024u);
+    ASSERT_LE(radix_threshold, 2097152u);
+
+    // other element sizes keep the defaults
+    ASSERT_EQ(thrust::tuning::get<char>(thrust::tuning::tbb_merge_sort_leaf_size), default_leaf_size);
+    ASSERT_EQ(thrust::tuning::get<char>(thrust::tuning::tbb_radix_sort_threshold), default_radix_threshold);
+
+    const size_t leaf_sizes[] = {leaf_size - 1, leaf_size, leaf_size + 1, 4 * leaf_size + 3};
+    for(auto size : leaf_sizes)
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> input = get_random_data<int>(size, -1000000, 1000000, size);
+
+        TestStableSortKeys(thrust::tbb::par, input, custom_compare_less<int>());
+        TestStableSortKeys(thrust::tbb::par, input, greater_int());
+    }
+
+    const size_t radix_sizes[] = {radix_threshold - 1, radix_threshold, radix_threshold + 1};
+    for(auto size : radix_sizes)
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        thrust::host_vector<int> input = get_random_data<int>(size, -1000000, 1000000, size);
+
+        TestStableSortKeys(thrust::tbb::par, input, thrust::less<int>());
+        TestStableSortKeys(thrust::tbb::par, input, thrust::greater<int>());
+    }
+
+    thrust::tuning::reset();
+}
+#endif
@@ -0,0 +1,123 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <thrust/system/cpp/execution_policy.h>
+
+#if defined(THRUST_TEST_OMP)
+#include <thrust/system/omp/execution_policy.h>
+#endif
+
+#if defined(THRUST_TEST_TBB)
+#include <thrust/system/tbb/execution_policy.h>
+#include <tbb/task_arena.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+// The execution policies of the host systems the tests are built with. The
+// results of their algorithms are compared to those of thrust::seq. Besides
+// the default policies, the OpenMP and TBB algorithms also run on several
+// threads and with small grains, so that their parallel paths are taken on a
+// machine with a single processor and on small inputs.
+
+struct CppPolicy
+{
+    typedef thrust::system::cpp::detail::par_t type;
+    static type get() { return thrust::cpp::par; }
+};
+
+#if defined(THRUST_TEST_OMP)
+struct OmpPolicy
+{
+    typedef thrust::system::omp::detail::par_t type;
+    static type get() { return thrust::omp::par; }
+};
+
+struct OmpThreadsPolicy
+{
+    typedef thrust::system::omp::detail::execute_with_parameters type;
+    static type get() { return thrust::omp::par.with_threads(4); }
+};
+
+struct OmpSmallGrainPolicy
+{
+    typedef thrust::system::omp::detail::execute_with_parameters type;
+    static type get() { return thrust::omp::par.with_threads(3).with_grain_size(1); }
+};
+#endif // THRUST_TEST_OMP
+
+#if defined(THRUST_TEST_TBB)
+struct TbbPolicy
+{
+    typedef thrust::system::tbb::detail::par_t type;
+    static type get() { return thrust::tbb::par; }
+};
+
+struct TbbArenaPolicy
+{
+    typedef thrust::system::tbb::detail::execute_on_arena type;
+    static type get()
+    {
+        static ::tbb::task_arena arena(4);
+        return thrust::tbb::par.on(arena);
+    }
+};
+#endif // THRUST_TEST_TBB
+
+#if defined(THRUST_TEST_OMP) && defined(THRUST_TEST_TBB)
+typedef ::testing::Types<CppPolicy,
+                         OmpPolicy,
+                         OmpThreadsPolicy,
+                         OmpSmallGrainPolicy,
+                         TbbPolicy,
+                         TbbArenaPolicy>
+    HostSystemTestsParams;
+#elif defined(THRUST_TEST_OMP)
+typedef ::testing::Types<CppPolicy, OmpPolicy, OmpThreadsPolicy, OmpSmallGrainPolicy>
+    HostSystemTestsParams;
+#elif defined(THRUST_TEST_TBB)
+typedef ::testing::Types<CppPolicy, TbbPolicy, TbbArenaPolicy> HostSystemTestsParams;
+#else
+typedef ::testing::Types<CppPolicy> HostSystemTestsParams;
+#endif
+
+// Definition of typed test cases over the host systems' policies
+#define HOST_SYSTEM_TESTS_DEFINE(x)                          \
+    template <class Policy>                                  \
+    class x : public ::testing::Test                         \
+    {                                                        \
+    public:                                                  \
+        using policy_type = typename Policy::type;           \
+                                                             \
+        static policy_type policy() { return Policy::get(); } \
+    };                                                       \
+                                                             \
+    TYPED_TEST_CASE(x, HostSystemTestsParams);
+
+// Sizes around the cutoffs of the host systems: the OpenMP grain size, the
+// TBB sequential thresholds and the tile sizes of the vectorized loops
+inline std::vector<size_t> get_host_system_sizes()
+{
+    std::vector<size_t> sizes = {
+        0, 1, 2, 3, 5, 17, 64, 255, 1023, 1024, 1025, 2047, 2048, 2049,
+        4097, 9999, 10000, 10001, 65537, 131071, 131072, 131073, 250000
+    };
+    return sizes;
+}
@@ -0,0 +1,114 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/host_vector.h>
+
+#include <string>
+#include <vector>
+
+#include "test_header.hpp"
+#include "test_host_systems.hpp"
+
+#if defined(THRUST_TEST_OMP)
+#include <thrust/system/omp/vector.h>
+#endif
+
+#if defined(THRUST_TEST_TBB)
+#include <thrust/system/tbb/vector.h>
+#endif
+
+// strings too long to be stored in place, so that constructing one by
+// assignment over uninitialized storage would be caught
+thrust::host_vector<std::string> get_strings(size_t size)
+{
+    thrust::host_vector<std::string> strings(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        strings[i] = std::string(40, 'a' + i % 26) + std::to_string(i);
+    }
+    return strings;
+}
+
+template <class Vector, class Input>
+void TestConstructFrom(const Input& input)
+{
+    typedef typename Input::value_type T;
+
+    // from a host_vector, a std::vector and a pointer range
+    Vector from_host_vector(input);
+    ASSERT_EQ(from_host_vector.size(), input.size());
+
+    std::vector<T> std_input(input.begin(), input.end());
+    Vector from_std_vector(std_input);
+    ASSERT_EQ(from_std_vector.size(), input.size());
+
+    Vector from_range(std_input.data(), std_input.data() + std_input.size());
+    ASSERT_EQ(from_range.size(), input.size());
+
+    // and by copy
+    Vector from_vector(from_range);
+    ASSERT_EQ(from_vector.size(), input.size());
+
+    for(size_t i = 0; i < input.size(); i++)
+    {
+        ASSERT_EQ(T(from_host_vector[i]), input[i]);
+        ASSERT_EQ(T(from_std_vector[i]), input[i]);
+        ASSERT_EQ(T(from_range[i]), input[i]);
+        ASSERT_EQ(T(from_vector[i]), input[i]);
+    }
+}
+
+template <template <class> class Vector>
+void TestConstructFromHost()
+{
+    for(auto size : get_host_system_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        TestConstructFrom<Vector<int>>(get_random_data<int>(size, -1000, 1000, size));
+        TestConstructFrom<Vector<double>>(get_random_data<double>(size, -1000, 1000, size));
+        TestConstructFrom<Vector<char>>(get_random_data<char>(size, 0, 127, size));
+    }
+
+    const size_t string_sizes[] = {0, 1, 2, 17, 1025, 10001};
+
+    for(auto size : string_sizes)
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+
+        TestConstructFrom<Vector<std::string>>(get_strings(size));
+    }
+}
+
+#if defined(THRUST_TEST_OMP)
+template <class T>
+using omp_vector = thrust::omp::vector<T>;
+
+TEST(HostVectorTests, TestOmpVectorConstructFromHost)
+{
+    TestConstructFromHost<omp_vector>();
+}
+#endif // THRUST_TEST_OMP
+
+#if defined(THRUST_TEST_TBB)
+template <class T>
+using tbb_vector = thrust::tbb::vector<T>;
+
+TEST(HostVectorTests, TestTbbVectorConstructFromHost)
+{
+    TestConstructFromHost<tbb_vector>();
+}
+#endif // THRUST_TEST_TBB
@@ -0,0 +1,256 @@
+#include <thrust/mr/arena.h>
+#include <thrust/mr/new.h>
+#include <thrust/sort.h>
+#include <thrust/sequence.h>
+#include <thrust/host_vector.h>
+#include <thrust/system/cpp/execution_policy.h>
+
+#include "test_header.hpp"
+
+#if __cplusplus >= 201103L
+
+#include <limits>
+#include <new>
+#include <thread>
+
+// counts the bytes obtained from upstream, and fails requests bigger than a limit
+class counting_resource THRUST_FINAL : public thrust::mr::memory_resource<>
+{
+public:
+    counting_resource()
+        : allocations(0), deallocations(0), bytes_in_use(0), largest_allocation(0),
+          limit(std::numeric_limits<std::size_t>::max())
+    {
+    }
+
+    virtual void * do_allocate(std::size_t bytes, std::size_t alignment) THRUST_OVERRIDE
+    {
+        if (bytes > limit)
+        {
+            throw std::bad_alloc();
+        }
+
+        ++allocations;
+        bytes_in_use += bytes;
+        largest_allocation = std::max(largest_allocation, bytes);
+        return thrust::mr::get_global_resource<thrust::mr::new_delete_resource>()->do_allocate(bytes, alignment);
+    }
+
+    virtual void do_deallocate(void * p, std::size_t bytes, std::size_t alignment) THRUST_OVERRIDE
+    {
+        ++deallocations;
+        bytes_in_use -= bytes;
+        thrust::mr::get_global_resource<thrust::mr::new_delete_resource>()->do_deallocate(p, bytes, alignment);
+    }
+
+    std::size_t allocations;
+    std::size_t deallocations;
+    std::size_t bytes_in_use;
+    std::size_t largest_allocation;
+    std::size_t limit;
+};
+
+TEST(MrArenaTests, TestArenaAlignment)
+{
+    thrust::mr::arena_resource<thrust::mr::new_delete_resource> arena(1024);
+
+    for (std::size_t size = 1; size <= 64 * 1024; size = size * 3 + 1)
+    {
+        for (std::size_t alignment = 1; alignment <= 4096; alignment <<= 1)
+        {
+            void * ptr = arena.do_allocate(size, alignment);
+            ASSERT_EQ(reinterpret_cast<std::size_t>(ptr) % alignment, 0u);
+
+            char * char_ptr = static_cast<char *>(ptr);
+            std::fill(char_ptr, char_ptr + size, 1);
+        }
+    }
+}
+
+TEST(MrArenaTests, TestArenaLastAllocationReuse)
+{
+    counting_resource upstream;
+    thrust::mr::arena_resource<counting_resource> arena(&upstream, 4096);
+
+    void * a = arena.do_allocate(100);
+    void * b = arena.do_allocate(200);
+
+    // rolling back the last allocation makes its memory available again
+    arena.do_deallocate(b, 200);
+    void * c = arena.do_allocate(200);
+    ASSERT_EQ(b, c);
+
+    // other deallocations are no-ops
+    arena.do_deallocate(a, 100);
+    void * d = arena.do_allocate(100);
+    ASSERT_NE(a, d);
+
+    ASSERT_EQ(upstream.allocations, 1u);
+}
+
+TEST(MrArenaTests, TestArenaReset)
+{
+    counting_resource upstream;
+    thrust::mr::arena_resource<counting_resource> arena(&upstream, 1024);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        (void)arena.do_allocate(100);
+    }
+    ASSERT_GT(upstream.allocations, 1u);
+
+    // the blocks are replaced by a single one, big enough for the whole next iteration
+    arena.reset();
+    ASSERT_EQ(upstream.bytes_in_use, 0u);
+
+    std::size_t allocations = upstream.allocations;
+    for (int i = 0; i < 100; ++i)
+    {
+        (void)arena.do_allocate(100);
+    }
+    ASSERT_EQ(upstream.allocations, allocations + 1);
+
+    // which is kept from now on
+    for (int iteration = 0; iteration < 3; ++iteration)
+    {
+        arena.reset();
+        ASSERT_EQ(upstream.allocations - upstream.deallocations, 1u);
+        ASSERT_EQ(arena.upstream_bytes(), upstream.bytes_in_use);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            (void)arena.do_allocate(100);
+        }
+        ASSERT_EQ(upstream.allocations, allocations + 1);
+    }
+
+    arena.release();
+    ASSERT_EQ(upstream.bytes_in_use, 0u);
+    ASSERT_EQ(upstream.allocations, upstream.deallocations);
+    ASSERT_EQ(arena.upstream_bytes(), 0u);
+}
+
+TEST(MrArenaTests, TestArenaConcurrentAllocation)
+{
+    thrust::mr::arena_resource<thrust::mr::new_delete_resource> arena(256);
+
+    const int num_threads = 8;
+    const int iterations = 1000;
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<int *> > results(num_threads);
+
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.push_back(std::thread([&, t]() {
+            for (int i = 0; i < iterations; ++i)
+            {
+                int * ptr = static_cast<int *>(arena.do_allocate(sizeof(int) * (i % 7 + 1), alignof(int)));
+                *ptr = t * iterations + i;
+                results[t].push_back(ptr);
+
+                if (i % 3 == 0)
+                {
+                    int * scratch = static_cast<int *>(arena.do_allocate(sizeof(int) * 16, alignof(int)));
+                    std::fill(scratch, scratch + 16, -1);
+                    arena.do_deallocate(scratch, sizeof(int) * 16, alignof(int));
+                }
+            }
+        }));
+    }
+
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads[t].join();
+    }
+
+    // no two allocations overlap
+    for (int t = 0; t < num_threads; ++t)
+    {
+        for (int i = 0; i < iterations; ++i)
+        {
+            ASSERT_EQ(*results[t][i], t * iterations + i);
+        }
+    }
+}
+
+TEST(MrArenaTests, TestArenaManySubarenasGrowOnce)
+{
+    counting_resource upstream;
+    thrust::mr::arena_resource<counting_resource> arena(&upstream, 256);
+
+    // one allocation from each of many threads, which are spread over the subarenas; every subarena doubles its own
+    // blocks, which stay small
+    const int num_threads = 64;
+
+    for (int t = 0; t < num_threads; ++t)
+    {
+        std::thread thread([&]() {
+            char * ptr = static_cast<char *>(arena.do_allocate(256));
+            std::fill(ptr, ptr + 256, 1);
+        });
+        thread.join();
+    }
+
+    // at most num_threads / min_subarenas blocks per subarena
+    ASSERT_LE(upstream.largest_allocation, std::size_t(256) << (num_threads / 8));
+    ASSERT_LE(upstream.allocations, std::size_t(num_threads));
+    ASSERT_EQ(arena.upstream_bytes(), upstream.bytes_in_use);
+}
+
+TEST(MrArenaTests, TestArenaUpstreamFailure)
+{
+    counting_resource upstream;
+    upstream.limit = 64 * 1024;
+
+    thrust::mr::arena_resource<counting_resource> arena(&upstream, 1024);
+
+    // failed requests leave the arena as it was
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_THROW((void)arena.do_allocate(1024 * 1024), std::bad_alloc);
+    }
+    ASSERT_THROW((void)arena.do_allocate(std::numeric_limits<std::size_t>::max() / 2), std::bad_alloc);
+    ASSERT_EQ(upstream.allocations, 0u);
+    ASSERT_EQ(arena.upstream_bytes(), 0u);
+
+    void * ptr = arena.do_allocate(100);
+    ASSERT_NE(ptr, static_cast<void *>(NULL));
+    ASSERT_EQ(upstream.allocations, 1u);
+    ASSERT_EQ(upstream.largest_allocation, 1024u);
+
+    // and so do failures when growing
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_THROW((void)arena.do_allocate(128 * 1024), std::bad_alloc);
+    }
+    (void)arena.do_allocate(2000);
+    ASSERT_EQ(upstream.allocations, 2u);
+    ASSERT_EQ(upstream.largest_allocation, 2048u);
+
+    arena.release();
+    ASSERT_EQ(upstream.bytes_in_use, 0u);
+}
+
+TEST(MrArenaTests, TestArenaExecutionPolicy)
+{
+    counting_resource upstream;
+    thrust::mr::arena_resource<counting_resource> arena(&upstream);
+
+    thrust::host_vector<int> data(10000);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        thrust::sequence(data.begin(), data.end(), int(data.size()), -1);
+        thrust::stable_sort(thrust::cpp::par(&arena), data.begin(), data.end());
+        ASSERT_EQ(data[0], 1);
+        ASSERT_EQ(data[data.size() - 1], int(data.size()));
+
+        arena.reset();
+    }
+
+    ASSERT_GT(upstream.allocations, 0u);
+    ASSERT_LT(upstream.allocations, 10u);
+}
+
+#endif
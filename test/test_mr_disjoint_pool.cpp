@@ -3,6 +3,10 @@
 
 #include "test_header.hpp"
 
+#include <algorithm>
+#include <map>
+#include <random>
+
 #if __cplusplus >= 201103L
 #include <thrust/mr/disjoint_sync_pool.h>
 #endif
@@ -285,3 +289,258 @@ TEST(MrDisjointPoolTests, TestSynchronizedDisjointGlobalPool)
     TestDisjointGlobalPool<thrust::mr::disjoint_synchronized_pool_resource>();
 }
 #endif
+
+class checked_resource THRUST_FINAL : public thrust::mr::memory_resource<>
+{
+public:
+    ~checked_resource()
+    {
+        EXPECT_EQ(sizes.empty(), true);
+    }
+
+    virtual void * do_allocate(std::size_t bytes, std::size_t alignment) THRUST_OVERRIDE
+    {
+        void * p = upstream.do_allocate(bytes, alignment);
+        sizes[p] = bytes;
+        return p;
+    }
+
+    virtual void do_deallocate(void * p, std::size_t bytes, std::size_t alignment) THRUST_OVERRIDE
+    {
+        // the pool returns memory with the size it was allocated with
+        EXPECT_EQ(sizes[p], bytes);
+        sizes.erase(p);
+        upstream.do_deallocate(p, bytes, alignment);
+    }
+
+    std::map<void *, std::size_t> sizes;
+
+private:
+    thrust::mr::new_delete_resource upstream;
+};
+
+template<template<typename, typename> class PoolTemplate>
+void TestDisjointPoolManyOversized(bool cache_oversized)
+{
+    checked_resource upstream;
+    thrust::mr::new_delete_resource bookkeeper;
+
+    typedef PoolTemplate<
+        checked_resource,
+        thrust::mr::new_delete_resource
+    > Pool;
+
+    thrust::mr::pool_options opts = Pool::get_default_options();
+    opts.cache_oversized = cache_oversized;
+    opts.largest_block_size = 1024;
+
+    Pool pool(&upstream, &bookkeeper, opts);
+
+    std::vector<void *> blocks;
+    std::vector<std::size_t> sizes;
+    for (std::size_t i = 0; i < 3000; ++i)
+    {
+        sizes.push_back(2048 + (i % 7) * 64);
+        blocks.push_back(pool.do_allocate(sizes.back()));
+    }
+
+    // free the blocks in an order unrelated to the order of allocation
+    std::vector<std::size_t> order(blocks.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    for (std::size_t i = 0; i < order.size() / 2; ++i)
+    {
+        pool.do_deallocate(blocks[order[i]], sizes[order[i]]);
+        blocks[order[i]] = pool.do_allocate(sizes[order[i]]);
+    }
+
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        pool.do_deallocate(blocks[order[i]], sizes[order[i]]);
+    }
+
+    if (!cache_oversized)
+    {
+        ASSERT_EQ(upstream.sizes.empty(), true);
+    }
+
+    pool.release();
+    ASSERT_EQ(upstream.sizes.empty(), true);
+}
+
+TEST(MrDisjointPoolTests, TestDisjointUnsynchronizedPoolManyOversized)
+{
+    TestDisjointPoolManyOversized<thrust::mr::disjoint_unsynchronized_pool_resource>(false);
+    TestDisjointPoolManyOversized<thrust::mr::disjoint_unsynchronized_pool_resource>(true);
+}
+
+#if __cplusplus >= 201103L
+TEST(MrDisjointPoolTests, TestDisjointSynchronizedPoolManyOversized)
+{
+    TestDisjointPoolManyOversized<thrust::mr::disjoint_synchronized_pool_resource>(false);
+    TestDisjointPoolManyOversized<thrust::mr::disjoint_synchronized_pool_resource>(true);
+}
+#endif
+
+template<template<typename, typename> class PoolTemplate>
+void TestDisjointPoolManyCachedSizes()
+{
+    checked_resource upstream;
+    thrust::mr::new_delete_resource bookkeeper;
+
+    typedef PoolTemplate<
+        checked_resource,
+        thrust::mr::new_delete_resource
+    > Pool;
+
+    thrust::mr::pool_options opts = Pool::get_default_options();
+    opts.cache_oversized = true;
+    opts.largest_block_size = 1024;
+
+    Pool pool(&upstream, &bookkeeper, opts);
+
+    // two blocks of each of many sizes, cached in an order unrelated to their sizes
+    std::vector<std::size_t> sizes;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        sizes.push_back(2048 + i * 16);
+        sizes.push_back(2048 + i * 16);
+    }
+    std::shuffle(sizes.begin(), sizes.end(), std::mt19937(42));
+
+    std::vector<void *> blocks;
+    for (std::size_t i = 0; i < sizes.size(); ++i)
+    {
+        blocks.push_back(pool.do_allocate(sizes[i]));
+    }
+    for (std::size_t i = 0; i < blocks.size(); ++i)
+    {
+        pool.do_deallocate(blocks[i], sizes[i]);
+    }
+
+    ASSERT_EQ(upstream.sizes.size(), sizes.size());
+
+    // every request is served from the cache by a block of exactly its size
+    std::shuffle(sizes.begin(), sizes.end(), std::mt19937(43));
+    for (std::size_t i = 0; i < sizes.size(); ++i)
+    {
+        blocks[i] = pool.do_allocate(sizes[i]);
+        ASSERT_EQ(upstream.sizes[blocks[i]], sizes[i]);
+    }
+
+    ASSERT_EQ(upstream.sizes.size(), sizes.size());
+
+    for (std::size_t i = 0; i < blocks.size(); ++i)
+    {
+        pool.do_deallocate(blocks[i], sizes[i]);
+    }
+
+    // a size between the cached ones gets the smallest block that fits
+    void * p = pool.do_allocate(2048 + 8);
+    ASSERT_EQ(upstream.sizes[p], 2048u + 16u);
+    void * q = pool.do_allocate(2048 + 8);
+    ASSERT_EQ(upstream.sizes[q], 2048u + 16u);
+    void * r = pool.do_allocate(2048 + 8);
+    ASSERT_EQ(upstream.sizes[r], 2048u + 32u);
+
+    pool.do_deallocate(p, 2048 + 8);
+    pool.do_deallocate(q, 2048 + 8);
+    pool.do_deallocate(r, 2048 + 8);
+
+    ASSERT_EQ(upstream.sizes.size(), sizes.size());
+
+    pool.release();
+    ASSERT_EQ(upstream.sizes.empty(), true);
+}
+
+TEST(MrDisjointPoolTests, TestDisjointUnsynchronizedPoolManyCachedSizes)
+{
+    TestDisjointPoolManyCachedSizes<thrust::mr::disjoint_unsynchronized_pool_resource>();
+}
+
+#if __cplusplus >= 201103L
+TEST(MrDisjointPoolTests, TestDisjointSynchronizedPoolManyCachedSizes)
+{
+    TestDisjointPoolManyCachedSizes<thrust::mr::disjoint_synchronized_pool_resource>();
+}
+#endif
+
+template<template<typename, typename> class PoolTemplate>
+void TestDisjointPoolMissingWithAllCachedSizesInUse()
+{
+    checked_resource upstream;
+    thrust::mr::new_delete_resource bookkeeper;
+
+    typedef PoolTemplate<
+        checked_resource,
+        thrust::mr::new_delete_resource
+    > Pool;
+
+    thrust::mr::pool_options opts = Pool::get_default_options();
+    opts.cache_oversized = true;
+    opts.largest_block_size = 1024;
+
+    Pool pool(&upstream, &bookkeeper, opts);
+
+    // cache one block of each of many sizes, then take all of them back, leaving every bucket empty
+    std::vector<std::size_t> sizes;
+    for (std::size_t i = 0; i < 4000; ++i)
+    {
+        sizes.push_back(2048 + i * 16);
+    }
+
+    std::vector<void *> blocks;
+    for (std::size_t i = 0; i < sizes.size(); ++i)
+    {
+        blocks.push_back(pool.do_allocate(sizes[i]));
+    }
+    for (std::size_t i = 0; i < blocks.size(); ++i)
+    {
+        pool.do_deallocate(blocks[i], sizes[i]);
+    }
+    for (std::size_t i = 0; i < sizes.size(); ++i)
+    {
+        blocks[i] = pool.do_allocate(sizes[i]);
+    }
+
+    ASSERT_EQ(upstream.sizes.size(), sizes.size());
+    ASSERT_EQ(pool.statistics().total_cache_hits(), sizes.size());
+
+    // every further request misses and gets a new block of exactly its size
+    std::vector<void *> missed;
+    for (std::size_t i = 0; i < sizes.size(); ++i)
+    {
+        std::size_t size = 2048 + (i * 7919 % sizes.size()) * 16 + 8;
+        missed.push_back(pool.do_allocate(size));
+        ASSERT_EQ(upstream.sizes[missed.back()], size);
+    }
+
+    ASSERT_EQ(upstream.sizes.size(), 2 * sizes.size());
+    ASSERT_EQ(pool.statistics().total_cache_hits(), sizes.size());
+    ASSERT_EQ(pool.statistics().total_cache_misses(), 2 * sizes.size());
+
+    // a block returned afterwards is found again by a request it fits
+    pool.do_deallocate(blocks[100], sizes[100]);
+    void * p = pool.do_allocate(sizes[100] - 8);
+    ASSERT_EQ(p, blocks[100]);
+    pool.do_deallocate(p, sizes[100] - 8);
+
+    pool.release();
+    ASSERT_EQ(upstream.sizes.empty(), true);
+}
+
+TEST(MrDisjointPoolTests, TestDisjointUnsynchronizedPoolMissingWithAllCachedSizesInUse)
+{
+    TestDisjointPoolMissingWithAllCachedSizesInUse<thrust::mr::disjoint_unsynchronized_pool_resource>();
+}
+
+#if __cplusplus >= 201103L
+TEST(MrDisjointPoolTests, TestDisjointSynchronizedPoolMissingWithAllCachedSizesInUse)
+{
+    TestDisjointPoolMissingWithAllCachedSizesInUse<thrust::mr::disjoint_synchronized_pool_resource>();
+}
+#endif
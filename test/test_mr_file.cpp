@@ -0,0 +1,142 @@
+#include <thrust/mr/file.h>
+#include <thrust/mapped_vector.h>
+#include <thrust/binary_search.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+#include <thrust/count.h>
+#include <thrust/execution_policy.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "test_header.hpp"
+
+// a temporary file, removed when the test ends
+struct temporary_file
+{
+    temporary_file()
+    {
+        char name[] = "/tmp/thrust_mr_file_XXXXXX";
+        int fd = ::mkstemp(name);
+        ::close(fd);
+        path = name;
+    }
+
+    ~temporary_file()
+    {
+        std::remove(path.c_str());
+    }
+
+    std::string path;
+};
+
+TEST(MrFileTests, TestFileResourceAllocations)
+{
+    temporary_file file;
+
+    {
+        thrust::mr::file_memory_resource resource(file.path.c_str());
+        ASSERT_EQ(resource.file_size(), 0u);
+
+        int * a = static_cast<int *>(resource.do_allocate(100 * sizeof(int)));
+        int * b = static_cast<int *>(resource.do_allocate(100 * sizeof(int)));
+        for (int i = 0; i < 100; ++i)
+        {
+            a[i] = i;
+            b[i] = -i;
+        }
+
+        // allocations start at page boundaries of the file
+        ASSERT_EQ(resource.file_size(), ::sysconf(_SC_PAGESIZE) + 100 * sizeof(int));
+
+        resource.sync(a, 100 * sizeof(int));
+        resource.do_deallocate(a, 100 * sizeof(int));
+        resource.do_deallocate(b, 100 * sizeof(int));
+    }
+
+    // the first allocation from a new resource maps the file's contents
+    thrust::mr::file_mapping_options options;
+    options.read_only = true;
+
+    thrust::mr::file_memory_resource resource(file.path.c_str(), options);
+    const int * a = static_cast<const int *>(resource.do_allocate(100 * sizeof(int)));
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(a[i], i);
+    }
+    resource.do_deallocate(const_cast<int *>(a), 100 * sizeof(int));
+
+    ASSERT_THROW(thrust::mr::file_memory_resource("/nonexistent/file", options), thrust::system_error);
+}
+
+TEST(MrFileTests, TestMappedVectorSortInPlace)
+{
+    temporary_file file;
+    const std::size_t n = 100000;
+
+    {
+        thrust::mapped_vector<int> v(file.path.c_str(), n);
+        ASSERT_EQ(v.size(), n);
+        ASSERT_EQ(thrust::count(v.begin(), v.end(), 0), std::ptrdiff_t(n));
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            v[i] = static_cast<int>((i * 7919) % n);
+        }
+
+        thrust::sort(thrust::host, v.begin(), v.end());
+    }
+
+    // the sorted data went to the file
+    thrust::mr::file_mapping_options options;
+    options.read_only = true;
+    options.access = thrust::mr::random_access;
+
+    const thrust::mapped_vector<int> v(file.path.c_str(), options);
+    ASSERT_EQ(v.size(), n);
+
+    std::vector<int> queries;
+    for (int i = -5; i < static_cast<int>(n) + 5; i += 999)
+    {
+        queries.push_back(i);
+    }
+    std::vector<bool> found(queries.size());
+    thrust::binary_search(thrust::host, v.begin(), v.end(), queries.begin(), queries.end(), found.begin());
+
+    for (std::size_t i = 0; i < queries.size(); ++i)
+    {
+        ASSERT_EQ(found[i], queries[i] >= 0 && queries[i] < static_cast<int>(n));
+    }
+}
+
+TEST(MrFileTests, TestMappedVectorPrivate)
+{
+    temporary_file file;
+
+    {
+        thrust::mapped_vector<int> v(file.path.c_str(), 1000);
+        thrust::sequence(thrust::host, v.begin(), v.end());
+        v.sync();
+    }
+
+    {
+        // writes to a private mapping are not carried through to the file
+        thrust::mr::file_mapping_options options;
+        options.shared = false;
+        options.access = thrust::mr::sequential_access;
+
+        thrust::mapped_vector<int> v(file.path.c_str(), options);
+        thrust::fill(thrust::host, v.begin(), v.end(), -1);
+        ASSERT_EQ(v[999], -1);
+    }
+
+    thrust::mapped_vector<int> v(file.path.c_str());
+    ASSERT_EQ(v.size(), 1000u);
+    ASSERT_EQ(v[999], 999);
+
+    thrust::mapped_vector<int> empty(file.path.c_str(), 0);
+    ASSERT_EQ(empty.empty(), true);
+}
@@ -0,0 +1,88 @@
+#include <thrust/mr/mmap.h>
+#include <thrust/mr/pool.h>
+#include <thrust/mr/allocator.h>
+#include <thrust/fill.h>
+#include <thrust/count.h>
+#include <thrust/host_vector.h>
+
+#include "test_header.hpp"
+
+void TestAlignment(thrust::mr::mmap_memory_resource & memres, std::size_t size, std::size_t alignment)
+{
+    void * ptr = memres.do_allocate(size, alignment);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(ptr) % alignment, 0u);
+
+    char * char_ptr = reinterpret_cast<char *>(ptr);
+    thrust::fill(char_ptr, char_ptr + size, 1);
+
+    memres.do_deallocate(ptr, size, alignment);
+}
+
+TEST(MrMmapTests, TestMmapResourceAlignedAllocation)
+{
+    // map every allocation, to cover sizes that are not multiples of the page size
+    thrust::mr::mmap_memory_resource memres(true, false, 1);
+
+    for (std::size_t size = 1; size <= 64 * 1024; size = size * 3 + 1)
+    {
+        for (std::size_t alignment = 16; alignment <= 64 * 1024; alignment <<= 2)
+        {
+            TestAlignment(memres, size, alignment);
+        }
+    }
+}
+
+TEST(MrMmapTests, TestMmapResourceHugePages)
+{
+    const std::size_t huge_page_size = thrust::mr::mmap_memory_resource::huge_page_size;
+
+    thrust::mr::mmap_memory_resource memres;
+    thrust::mr::mmap_memory_resource populated(true, true);
+    thrust::mr::mmap_memory_resource small_pages(false, true);
+
+    // large mappings are aligned to huge pages
+    TestAlignment(memres, 3 * huge_page_size + 5, 16);
+    TestAlignment(populated, 3 * huge_page_size + 5, 16);
+    TestAlignment(small_pages, 3 * huge_page_size + 5, 16);
+
+    void * ptr = memres.do_allocate(2 * huge_page_size);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(ptr) % huge_page_size, 0u);
+    memres.do_deallocate(ptr, 2 * huge_page_size);
+
+    // allocations below the threshold come from operator new
+    TestAlignment(memres, 1000, 64);
+}
+
+TEST(MrMmapTests, TestMmapResourceDiscard)
+{
+    thrust::mr::mmap_memory_resource memres;
+
+    const std::size_t size = 4 << 20;
+    char * ptr = static_cast<char *>(memres.do_allocate(size));
+    thrust::fill(ptr, ptr + size, 1);
+
+    memres.discard(ptr, size);
+    ASSERT_EQ(thrust::count(ptr, ptr + size, 0), std::ptrdiff_t(size));
+
+    // the block remains usable
+    thrust::fill(ptr, ptr + size, 2);
+    ASSERT_EQ(thrust::count(ptr, ptr + size, 2), std::ptrdiff_t(size));
+
+    memres.do_deallocate(ptr, size);
+}
+
+TEST(MrMmapTests, TestMmapResourceAsUpstream)
+{
+    thrust::mr::mmap_memory_resource upstream;
+    thrust::mr::unsynchronized_pool_resource<thrust::mr::mmap_memory_resource> pool(&upstream);
+
+    typedef thrust::mr::allocator<int, thrust::mr::mmap_memory_resource> allocator;
+
+    thrust::host_vector<int, allocator> vec(1 << 20, 7, allocator(&upstream));
+    ASSERT_EQ(thrust::count(vec.begin(), vec.end(), 7), 1 << 20);
+
+    void * small = pool.do_allocate(100);
+    void * large = pool.do_allocate(8 << 20);
+    pool.do_deallocate(small, 100);
+    pool.do_deallocate(large, 8 << 20);
+}
@@ -1,6 +1,9 @@
 #include <thrust/mr/pool.h>
 #include <thrust/mr/new.h>
 
+#include <map>
+#include <random>
+
 #if __cplusplus >= 201103L
 #include <thrust/mr/sync_pool.h>
 #endif
@@ -21,6 +24,9 @@ struct reference<void>
 
 struct unit {};
 
+// the number of times a tracked_pointer has been dereferenced, which counts the pool's accesses to its descriptors
+std::size_t tracked_dereferences = 0;
+
 template<typename T>
 struct tracked_pointer : thrust::iterator_facade<
                             tracked_pointer<T>,
@@ -78,6 +84,7 @@ struct tracked_pointer : thrust::iterator_facade<
     __host__ __device__
     typename ::reference<T>::type dereference() const
     {
+        ++tracked_dereferences;
         return *get();
     }
 
@@ -350,3 +357,265 @@ TEST(MrPoolTests, TestSynchronizedGlobalPool)
     TestGlobalPool<thrust::mr::synchronized_pool_resource>();
 }
 #endif
+
+class counting_resource THRUST_FINAL : public thrust::mr::memory_resource<>
+{
+public:
+    counting_resource() : bytes_outstanding(0)
+    {
+    }
+
+    ~counting_resource()
+    {
+        EXPECT_EQ(bytes_outstanding, 0u);
+    }
+
+    virtual void * do_allocate(std::size_t n, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        void * p = upstream.do_allocate(n, alignment);
+        sizes[p] = n;
+        bytes_outstanding += n;
+        return p;
+    }
+
+    virtual void do_deallocate(void * p, std::size_t n, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        // the pool returns memory with the size it was allocated with
+        EXPECT_EQ(sizes[p], n);
+        sizes.erase(p);
+        bytes_outstanding -= n;
+        upstream.do_deallocate(p, n, alignment);
+    }
+
+    std::map<void *, std::size_t> sizes;
+    std::size_t bytes_outstanding;
+
+private:
+    thrust::mr::new_delete_resource upstream;
+};
+
+template<template<typename> class PoolTemplate>
+void TestPoolTrim()
+{
+    counting_resource upstream;
+
+    typedef PoolTemplate<
+        counting_resource
+    > Pool;
+
+    thrust::mr::pool_options opts = Pool::get_default_options();
+    opts.cache_oversized = true;
+    opts.largest_block_size = 1024;
+
+    {
+        Pool pool(&upstream, opts);
+
+        // the pool keeps its bookkeeping until it is destroyed
+        std::size_t bookkeeping = upstream.bytes_outstanding;
+
+        // make sure the best fitting cached block is used, regardless of the order of deallocation
+        void * a1 = pool.do_allocate(2048);
+        void * a2 = pool.do_allocate(8192);
+        pool.do_deallocate(a1, 2048);
+        pool.do_deallocate(a2, 8192);
+
+        void * a3 = pool.do_allocate(2000);
+        ASSERT_EQ(a3, a1);
+
+        // a block handed out for a smaller request is deallocated with the smaller size
+        void * a4 = pool.do_allocate(5000);
+        ASSERT_EQ(a4, a2);
+        pool.do_deallocate(a4, 5000);
+        pool.do_deallocate(a3, 2000);
+
+        // fill a chunk and then free all of its blocks, but one
+        std::vector<void *> blocks;
+        for (int i = 0; i < 64; ++i)
+        {
+            blocks.push_back(pool.do_allocate(64));
+        }
+        for (std::size_t i = 1; i < blocks.size(); ++i)
+        {
+            pool.do_deallocate(blocks[i], 64);
+        }
+
+        // trimming to a limit retains the smaller cached oversized block
+        std::size_t released = pool.trim(4096);
+        ASSERT_EQ(released > 8192u, true);
+        ASSERT_EQ(upstream.bytes_outstanding > bookkeeping + 2048, true);
+
+        // the chunk whose block is still in use is retained by trimming everything
+        pool.trim();
+        std::size_t in_use = upstream.bytes_outstanding;
+        ASSERT_EQ(in_use > bookkeeping, true);
+
+        // and returned once its last block is free
+        pool.do_deallocate(blocks[0], 64);
+        ASSERT_EQ(pool.trim() > 0u, true);
+        ASSERT_EQ(upstream.bytes_outstanding, bookkeeping);
+
+        // the pool remains usable afterwards
+        void * a5 = pool.do_allocate(64);
+        void * a6 = pool.do_allocate(4096);
+        pool.do_deallocate(a5, 64);
+        pool.do_deallocate(a6, 4096);
+    }
+
+    ASSERT_EQ(upstream.bytes_outstanding, 0u);
+}
+
+TEST(MrPoolTests, TestUnsynchronizedPoolTrim)
+{
+    TestPoolTrim<thrust::mr::unsynchronized_pool_resource>();
+}
+
+#if __cplusplus >= 201103L
+TEST(MrPoolTests, TestSynchronizedPoolTrim)
+{
+    TestPoolTrim<thrust::mr::synchronized_pool_resource>();
+}
+#endif
+
+template<template<typename> class PoolTemplate>
+void TestPoolManyCachedSizes()
+{
+    typedef PoolTemplate<
+        tracked_resource
+    > Pool;
+
+    thrust::mr::pool_options opts = Pool::get_default_options();
+    opts.cache_oversized = true;
+    opts.largest_block_size = 256;
+
+    // the descriptors visited to find a cached block must not grow with the number of cached blocks
+    // whose sizes fall in the same power of two
+    const std::size_t counts[] = {1000, 8000};
+    for (std::size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+    {
+        const std::size_t n = counts[c];
+        SCOPED_TRACE(testing::Message() << "with " << n << " cached blocks");
+
+        tracked_resource upstream;
+        upstream.id_to_allocate = -1u;
+        Pool pool(&upstream, opts);
+
+        std::vector<tracked_pointer<void> > blocks;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            upstream.id_to_allocate = i + 1;
+            blocks.push_back(pool.do_allocate(1025 + i % 1000));
+        }
+        const std::size_t smallest = blocks[0].size;
+        const std::size_t largest = blocks[999].size;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            pool.do_deallocate(blocks[i], 1025 + i % 1000);
+        }
+
+        // every request is served from the cache, the smallest blocks first
+        tracked_dereferences = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            blocks[i] = pool.do_allocate(1024);
+            ASSERT_EQ(blocks[i].size, i == 0 ? smallest : (std::max)(blocks[i].size, blocks[i - 1].size));
+        }
+        ASSERT_LE(tracked_dereferences, 8 * n);
+        ASSERT_EQ(blocks[n - 1].size, largest);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            pool.do_deallocate(blocks[i], 1024);
+        }
+        pool.release();
+    }
+}
+
+TEST(MrPoolTests, TestUnsynchronizedPoolManyCachedSizes)
+{
+    TestPoolManyCachedSizes<thrust::mr::unsynchronized_pool_resource>();
+}
+
+#if __cplusplus >= 201103L
+TEST(MrPoolTests, TestSynchronizedPoolManyCachedSizes)
+{
+    TestPoolManyCachedSizes<thrust::mr::synchronized_pool_resource>();
+}
+#endif
+
+// the bucket a pool should take for a request, found by visiting every bucket
+std::size_t brute_force_best_fit(const std::map<std::pair<std::size_t, std::size_t>, std::size_t> & buckets,
+    std::size_t size, std::size_t alignment, std::size_t size_cutoff, std::size_t alignment_cutoff)
+{
+    std::size_t best_size = 0, best_alignment = 0, best = -1u;
+    for (auto it = buckets.begin(); it != buckets.end(); ++it)
+    {
+        std::size_t bucket_alignment = it->first.first, bucket_size = it->first.second;
+        if (bucket_size < size || bucket_alignment < alignment
+            || bucket_size / size >= size_cutoff || bucket_alignment / alignment >= alignment_cutoff)
+        {
+            continue;
+        }
+        if (best == -1u || bucket_size < best_size || (bucket_size == best_size && bucket_alignment < best_alignment))
+        {
+            best = it->second;
+            best_size = bucket_size;
+            best_alignment = bucket_alignment;
+        }
+    }
+    return best;
+}
+
+TEST(MrPoolTests, TestCachedBlockIndex)
+{
+    typedef thrust::mr::cached_block_index<std::size_t, std::allocator<char> > index_type;
+
+    index_type index;
+    // the heads of the buckets by alignment and size
+    std::map<std::pair<std::size_t, std::size_t>, std::size_t> buckets;
+
+    std::mt19937 rng(42);
+    for (std::size_t i = 0; i < 20000; ++i)
+    {
+        std::size_t size = 1024 + rng() % 4096;
+        std::size_t alignment = std::size_t(1) << (rng() % 8);
+
+        std::size_t expected = brute_force_best_fit(buckets, size, alignment, 4, 8);
+        std::size_t position = index.find_best_fit(size, alignment, 4, 8);
+        ASSERT_EQ(position == index_type::npos ? -1u : index.head(position), expected);
+
+        // take the best fitting bucket half of the time, and add the requested one otherwise
+        if (position != index_type::npos && rng() % 2)
+        {
+            buckets.erase(std::make_pair(index.bucket_alignment(position), index.bucket_size(position)));
+            index.erase(position);
+        }
+        else if (index.find(size, alignment) == index_type::npos)
+        {
+            index.insert(size, alignment, i);
+            buckets[std::make_pair(alignment, size)] = i;
+        }
+
+        ASSERT_EQ(index.size(), buckets.size());
+    }
+
+    // the buckets are visited in order
+    auto it = buckets.begin();
+    for (std::size_t position = index.first(); position != index_type::npos; position = index.next(position), ++it)
+    {
+        ASSERT_EQ(index.bucket_alignment(position), it->first.first);
+        ASSERT_EQ(index.bucket_size(position), it->first.second);
+        ASSERT_EQ(index.head(position), it->second);
+    }
+    ASSERT_TRUE(it == buckets.end());
+
+    // the positions of erased buckets are reused, so that buckets of ever new sizes do not accumulate
+    index.clear();
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        std::size_t position = index.insert(1024 + i, 16, i);
+        ASSERT_EQ(position, 0u);
+        ASSERT_EQ(index.find_best_fit(1024, 16, 16, 16), position);
+        index.erase(position);
+        ASSERT_TRUE(index.empty());
+    }
+}
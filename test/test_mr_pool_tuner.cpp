@@ -0,0 +1,162 @@
+#include <thrust/mr/pool_tuner.h>
+#include <thrust/mr/pool.h>
+#include <thrust/mr/disjoint_pool.h>
+#include <thrust/mr/new.h>
+
+#include <cstdio>
+#include <string>
+
+#include "test_header.hpp"
+
+typedef thrust::mr::unsynchronized_pool_resource<thrust::mr::new_delete_resource> Pool;
+typedef thrust::mr::disjoint_unsynchronized_pool_resource<
+    thrust::mr::new_delete_resource,
+    thrust::mr::new_delete_resource
+> DisjointPool;
+
+// repeatedly allocates a batch of blocks of mixed sizes and frees them in reverse order
+thrust::mr::allocation_trace make_trace()
+{
+    thrust::mr::allocation_trace trace;
+    std::size_t num_blocks = 0;
+
+    for (std::size_t round = 0; round < 20; ++round)
+    {
+        std::size_t first = num_blocks;
+        for (std::size_t i = 0; i < 50; ++i)
+        {
+            thrust::mr::allocation_event event = { true, 16 + (i * 97) % 3000, 16, num_blocks++ };
+            if (i % 10 == 0)
+            {
+                event.bytes = (std::size_t(1) << 18) + i;
+            }
+            trace.push_back(event);
+        }
+
+        for (std::size_t i = num_blocks; i-- > first; )
+        {
+            thrust::mr::allocation_event event = trace[2 * 50 * round + (i - first)];
+            event.is_allocation = false;
+            trace.push_back(event);
+        }
+    }
+
+    return trace;
+}
+
+TEST(MrPoolTunerTests, TestTraceRoundTrip)
+{
+    thrust::mr::allocation_trace trace = make_trace();
+
+    std::FILE * file = std::tmpfile();
+    ASSERT_NE(file, (std::FILE *)NULL);
+
+    thrust::mr::write_allocation_trace(file, trace);
+    std::rewind(file);
+
+    thrust::mr::allocation_trace read;
+    ASSERT_EQ(thrust::mr::read_allocation_trace(file, read), true);
+    std::fclose(file);
+
+    ASSERT_EQ(read.size(), trace.size());
+    for (std::size_t i = 0; i < trace.size(); ++i)
+    {
+        ASSERT_EQ(read[i].is_allocation, trace[i].is_allocation);
+        ASSERT_EQ(read[i].bytes, trace[i].bytes);
+        ASSERT_EQ(read[i].alignment, trace[i].alignment);
+        ASSERT_EQ(read[i].block, trace[i].block);
+    }
+}
+
+TEST(MrPoolTunerTests, TestReadRecordedTrace)
+{
+    std::FILE * file = std::tmpfile();
+    ASSERT_NE(file, (std::FILE *)NULL);
+
+    thrust::mr::statistics_resource<thrust::mr::new_delete_resource> recorder;
+
+    // allocated before the recording started; its deallocation is skipped
+    void * early = recorder.do_allocate(32);
+
+    recorder.start_trace(file);
+    void * a = recorder.do_allocate(100);
+    recorder.do_deallocate(early, 32);
+    recorder.do_deallocate(a, 100);
+    // likely to reuse the address of a, but a different block
+    void * b = recorder.do_allocate(100);
+    recorder.do_deallocate(b, 100);
+    recorder.stop_trace();
+
+    std::rewind(file);
+
+    thrust::mr::allocation_trace trace;
+    ASSERT_EQ(thrust::mr::read_allocation_trace(file, trace), true);
+    std::fclose(file);
+
+    ASSERT_EQ(trace.size(), 4u);
+    ASSERT_EQ(trace[0].is_allocation, true);
+    ASSERT_EQ(trace[0].block, 0u);
+    ASSERT_EQ(trace[1].is_allocation, false);
+    ASSERT_EQ(trace[1].block, 0u);
+    ASSERT_EQ(trace[2].block, 1u);
+    ASSERT_EQ(trace[3].block, 1u);
+
+    std::FILE * malformed = std::tmpfile();
+    std::fprintf(malformed, "a 100 16 0x1\n");
+    std::rewind(malformed);
+    ASSERT_EQ(thrust::mr::read_allocation_trace(malformed, trace), false);
+    std::fclose(malformed);
+}
+
+template<typename PoolType>
+void TestReplay()
+{
+    thrust::mr::allocation_trace trace = make_trace();
+    thrust::mr::pool_options options = PoolType::get_default_options();
+
+    thrust::mr::allocation_statistics replayed = thrust::mr::replay_allocation_trace<PoolType>(trace, options);
+
+    ASSERT_EQ(replayed.allocations, 1000u);
+    ASSERT_EQ(replayed.deallocations, 1000u);
+    ASSERT_EQ(replayed.bytes_in_use, 0u);
+    ASSERT_GT(replayed.upstream_allocations, 0u);
+
+    thrust::mr::pool_tuning_result result = thrust::mr::tune_pool_options<PoolType>(trace, 65536.0);
+
+    ASSERT_EQ(result.options.validate(), true);
+    ASSERT_EQ(result.options.alignment, options.alignment);
+    ASSERT_LE(result.cost, thrust::mr::pool_tuning_cost(replayed, 65536.0));
+    ASSERT_EQ(result.cost, thrust::mr::pool_tuning_cost(
+        thrust::mr::replay_allocation_trace<PoolType>(trace, result.options), 65536.0));
+
+    // with upstream calls being free, the footprint is all that matters
+    thrust::mr::pool_tuning_result smallest = thrust::mr::tune_pool_options<PoolType>(trace, 0.0);
+    ASSERT_LE(smallest.statistics.peak_upstream_bytes_in_use, result.statistics.peak_upstream_bytes_in_use);
+}
+
+TEST(MrPoolTunerTests, TestPoolReplay)
+{
+    TestReplay<Pool>();
+}
+
+TEST(MrPoolTunerTests, TestDisjointPoolReplay)
+{
+    TestReplay<DisjointPool>();
+}
+
+TEST(MrPoolTunerTests, TestPrintPoolOptions)
+{
+    std::FILE * file = std::tmpfile();
+    ASSERT_NE(file, (std::FILE *)NULL);
+
+    thrust::mr::print_pool_options(file, Pool::get_default_options(), "opts");
+    std::rewind(file);
+
+    char line[128];
+    ASSERT_NE(std::fgets(line, sizeof(line), file), (char *)NULL);
+    ASSERT_EQ(std::string(line), "thrust::mr::pool_options opts;\n");
+    ASSERT_NE(std::fgets(line, sizeof(line), file), (char *)NULL);
+    ASSERT_EQ(std::string(line), "opts.min_blocks_per_chunk = 16;\n");
+
+    std::fclose(file);
+}
@@ -0,0 +1,268 @@
+#include <thrust/mr/statistics.h>
+#include <thrust/mr/pool.h>
+#include <thrust/mr/disjoint_pool.h>
+#include <thrust/mr/new.h>
+
+#if __cplusplus >= 201103L
+#include <thrust/mr/thread_caching_pool.h>
+#endif
+
+#include <cstdio>
+#include <map>
+#include <string>
+
+#include "test_header.hpp"
+
+TEST(MrStatisticsTests, TestStatisticsResource)
+{
+    thrust::mr::new_delete_resource upstream;
+    thrust::mr::statistics_resource<thrust::mr::new_delete_resource> resource(&upstream);
+
+    void * a = resource.do_allocate(100);
+    void * b = resource.do_allocate(1000);
+    void * c = resource.do_allocate(1024, 256);
+
+    const thrust::mr::allocation_statistics & stats = resource.statistics();
+    ASSERT_EQ(stats.allocations, 3u);
+    ASSERT_EQ(stats.bytes_in_use, 2124u);
+    ASSERT_EQ(stats.upstream_bytes_in_use, 2124u);
+    ASSERT_EQ(stats.size_histogram[7], 1u);
+    ASSERT_EQ(stats.size_histogram[10], 2u);
+    ASSERT_EQ(stats.total_cache_misses(), 3u);
+    ASSERT_EQ(stats.fragmentation(), 0.0);
+
+    resource.do_deallocate(b, 1000);
+    ASSERT_EQ(stats.deallocations, 1u);
+    ASSERT_EQ(stats.bytes_in_use, 1124u);
+    ASSERT_EQ(stats.peak_bytes_in_use, 2124u);
+
+    // the blocks allocated before the reset can still be deallocated
+    resource.reset_statistics();
+    ASSERT_EQ(stats.allocations, 0u);
+    ASSERT_EQ(stats.peak_bytes_in_use, 1124u);
+
+    resource.do_deallocate(a, 100);
+    resource.do_deallocate(c, 1024, 256);
+    ASSERT_EQ(stats.bytes_in_use, 0u);
+    ASSERT_EQ(stats.upstream_bytes_in_use, 0u);
+    ASSERT_EQ(stats.peak_bytes_in_use, 1124u);
+}
+
+TEST(MrStatisticsTests, TestStatisticsResourceTrace)
+{
+    std::FILE * file = std::tmpfile();
+    ASSERT_NE(file, (std::FILE *)NULL);
+
+    {
+        thrust::mr::statistics_resource<thrust::mr::new_delete_resource> resource;
+        resource.start_trace(file);
+
+        void * a = resource.do_allocate(64);
+        void * b = resource.do_allocate(4096, 512);
+        resource.do_deallocate(a, 64);
+        resource.stop_trace();
+
+        // not recorded
+        resource.do_deallocate(b, 4096, 512);
+    }
+
+    std::rewind(file);
+
+    char header[64];
+    ASSERT_NE(std::fgets(header, sizeof(header), file), (char *)NULL);
+    ASSERT_EQ(std::string(header), "# thrust::mr allocation trace 1\n");
+
+    char types[3];
+    std::size_t sizes[3];
+    std::size_t alignments[3];
+    void * pointers[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(std::fscanf(file, " %c %zu %zu %p", &types[i], &sizes[i], &alignments[i], &pointers[i]), 4);
+    }
+    ASSERT_EQ(std::fscanf(file, " %c", &types[0]), EOF);
+
+    ASSERT_EQ(types[0], 'a');
+    ASSERT_EQ(sizes[0], 64u);
+    ASSERT_EQ(alignments[0], std::size_t(THRUST_MR_DEFAULT_ALIGNMENT));
+    ASSERT_EQ(types[1], 'a');
+    ASSERT_EQ(sizes[1], 4096u);
+    ASSERT_EQ(alignments[1], 512u);
+    ASSERT_EQ(types[2], 'd');
+    ASSERT_EQ(pointers[2], pointers[0]);
+
+    std::fclose(file);
+}
+
+template<typename Pool>
+void TestPoolStatistics(Pool & pool)
+{
+    const thrust::mr::allocation_statistics & stats = pool.statistics();
+
+    // the first allocation from a bucket allocates a chunk; the following ones are served from it
+    void * a = pool.do_allocate(40);
+    void * b = pool.do_allocate(60);
+    ASSERT_EQ(stats.cache_misses[6], 1u);
+    ASSERT_EQ(stats.cache_hits[6], 1u);
+    ASSERT_EQ(stats.size_histogram[6], 2u);
+    ASSERT_EQ(stats.upstream_allocations, 1u);
+    ASSERT_EQ(stats.bytes_in_use, 100u);
+    ASSERT_GT(stats.fragmentation(), 0.0);
+
+    // oversized blocks are cached after being deallocated
+    void * c = pool.do_allocate(2048);
+    pool.do_deallocate(c, 2048);
+    c = pool.do_allocate(2048);
+    ASSERT_EQ(stats.cache_misses[11], 1u);
+    ASSERT_EQ(stats.cache_hits[11], 1u);
+    ASSERT_EQ(stats.upstream_allocations, 2u);
+    ASSERT_EQ(stats.hit_rate(), 0.5);
+    ASSERT_EQ(stats.hit_rate(11), 0.5);
+
+    pool.do_deallocate(a, 40);
+    pool.do_deallocate(b, 60);
+    pool.do_deallocate(c, 2048);
+    ASSERT_EQ(stats.allocations, 4u);
+    ASSERT_EQ(stats.deallocations, 4u);
+    ASSERT_EQ(stats.bytes_in_use, 0u);
+    ASSERT_EQ(stats.peak_bytes_in_use, 2148u);
+
+    // all the memory held from upstream is cached
+    ASSERT_EQ(stats.fragmentation(), 1.0);
+
+    pool.release();
+    ASSERT_EQ(stats.upstream_deallocations, 2u);
+    ASSERT_EQ(stats.upstream_bytes_in_use, 0u);
+}
+
+TEST(MrStatisticsTests, TestPoolStatistics)
+{
+    thrust::mr::new_delete_resource upstream;
+
+    thrust::mr::pool_options opts = thrust::mr::unsynchronized_pool_resource<thrust::mr::new_delete_resource>::get_default_options();
+    opts.largest_block_size = 1024;
+
+    thrust::mr::unsynchronized_pool_resource<thrust::mr::new_delete_resource> pool(&upstream, opts);
+    TestPoolStatistics(pool);
+}
+
+TEST(MrStatisticsTests, TestDisjointPoolStatistics)
+{
+    thrust::mr::new_delete_resource upstream;
+    thrust::mr::new_delete_resource bookkeeper;
+
+    typedef thrust::mr::disjoint_unsynchronized_pool_resource<
+        thrust::mr::new_delete_resource,
+        thrust::mr::new_delete_resource
+    > Pool;
+
+    thrust::mr::pool_options opts = Pool::get_default_options();
+    opts.largest_block_size = 1024;
+
+    Pool pool(&upstream, &bookkeeper, opts);
+    TestPoolStatistics(pool);
+}
+
+template<typename Pool>
+void TestPoolStatisticsBelowSmallestBlock(Pool & pool)
+{
+    // requests smaller than the smallest block are binned with the blocks serving them, as are their hits and misses
+    void * a = pool.do_allocate(8);
+    void * b = pool.do_allocate(24);
+
+    thrust::mr::allocation_statistics stats = pool.statistics();
+    ASSERT_EQ(stats.size_histogram[6], 2u);
+    ASSERT_EQ(stats.cache_hits[6] + stats.cache_misses[6], 2u);
+    for (std::size_t i = 0; i < thrust::mr::allocation_statistics::num_size_bins; ++i)
+    {
+        ASSERT_EQ(stats.size_histogram[i], stats.cache_hits[i] + stats.cache_misses[i]);
+    }
+    ASSERT_EQ(stats.bytes_in_use, 32u);
+
+    pool.do_deallocate(a, 8);
+    pool.do_deallocate(b, 24);
+
+    stats = pool.statistics();
+    ASSERT_EQ(stats.bytes_in_use, 0u);
+}
+
+TEST(MrStatisticsTests, TestPoolStatisticsBelowSmallestBlock)
+{
+    thrust::mr::new_delete_resource upstream;
+
+    thrust::mr::pool_options opts = thrust::mr::unsynchronized_pool_resource<thrust::mr::new_delete_resource>::get_default_options();
+    opts.smallest_block_size = 64;
+    opts.largest_block_size = 1024;
+
+    thrust::mr::unsynchronized_pool_resource<thrust::mr::new_delete_resource> pool(&upstream, opts);
+    TestPoolStatisticsBelowSmallestBlock(pool);
+}
+
+TEST(MrStatisticsTests, TestDisjointPoolStatisticsBelowSmallestBlock)
+{
+    thrust::mr::new_delete_resource upstream;
+    thrust::mr::new_delete_resource bookkeeper;
+
+    typedef thrust::mr::disjoint_unsynchronized_pool_resource<
+        thrust::mr::new_delete_resource,
+        thrust::mr::new_delete_resource
+    > Pool;
+
+    thrust::mr::pool_options opts = Pool::get_default_options();
+    opts.smallest_block_size = 64;
+    opts.largest_block_size = 1024;
+
+    Pool pool(&upstream, &bookkeeper, opts);
+    TestPoolStatisticsBelowSmallestBlock(pool);
+}
+
+#if __cplusplus >= 201103L
+TEST(MrStatisticsTests, TestThreadCachingPoolStatistics)
+{
+    thrust::mr::new_delete_resource upstream;
+
+    thrust::mr::pool_options opts = thrust::mr::thread_caching_pool_resource<thrust::mr::new_delete_resource>::get_default_options();
+    opts.largest_block_size = 1024;
+
+    thrust::mr::thread_caching_pool_resource<thrust::mr::new_delete_resource> pool(&upstream, opts, 4);
+
+    // the first allocation refills the magazine with two blocks
+    void * a = pool.do_allocate(64);
+    void * b = pool.do_allocate(64);
+    void * c = pool.do_allocate(64);
+    void * d = pool.do_allocate(4096);
+
+    thrust::mr::allocation_statistics stats = pool.statistics();
+    ASSERT_EQ(stats.allocations, 4u);
+    ASSERT_EQ(stats.cache_misses[6], 2u);
+    ASSERT_EQ(stats.cache_hits[6], 1u);
+    ASSERT_EQ(stats.cache_misses[12], 1u);
+    ASSERT_EQ(stats.bytes_in_use, 3 * 64u + 4096u);
+    ASSERT_EQ(stats.upstream_allocations, 2u);
+
+    pool.do_deallocate(a, 64);
+    pool.do_deallocate(b, 64);
+    pool.do_deallocate(c, 64);
+    pool.do_deallocate(d, 4096);
+
+    stats = pool.statistics();
+    ASSERT_EQ(stats.deallocations, 4u);
+    ASSERT_EQ(stats.bytes_in_use, 0u);
+
+    pool.release();
+    stats = pool.statistics();
+    ASSERT_EQ(stats.upstream_bytes_in_use, 0u);
+}
+
+TEST(MrStatisticsTests, TestThreadCachingPoolStatisticsBelowSmallestBlock)
+{
+    thrust::mr::new_delete_resource upstream;
+
+    thrust::mr::pool_options opts = thrust::mr::thread_caching_pool_resource<thrust::mr::new_delete_resource>::get_default_options();
+    opts.smallest_block_size = 64;
+    opts.largest_block_size = 1024;
+
+    thrust::mr::thread_caching_pool_resource<thrust::mr::new_delete_resource> pool(&upstream, opts, 4);
+    TestPoolStatisticsBelowSmallestBlock(pool);
+}
+#endif
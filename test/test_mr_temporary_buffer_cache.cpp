@@ -0,0 +1,224 @@
+#include <thrust/mr/temporary_buffer_cache.h>
+#include <thrust/mr/new.h>
+#include <thrust/host_vector.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+#include <thrust/system/cpp/execution_policy.h>
+
+#include "test_header.hpp"
+
+#if __cplusplus >= 201103L
+
+#include <thread>
+#include <vector>
+
+// counts the bytes obtained from upstream
+class counting_resource THRUST_FINAL : public thrust::mr::memory_resource<>
+{
+public:
+    counting_resource() : allocations(0), bytes_in_use(0)
+    {
+    }
+
+    virtual void * do_allocate(std::size_t bytes, std::size_t alignment) THRUST_OVERRIDE
+    {
+        ++allocations;
+        bytes_in_use += bytes;
+        return thrust::mr::get_global_resource<thrust::mr::new_delete_resource>()->do_allocate(bytes, alignment);
+    }
+
+    virtual void do_deallocate(void * p, std::size_t bytes, std::size_t alignment) THRUST_OVERRIDE
+    {
+        bytes_in_use -= bytes;
+        thrust::mr::get_global_resource<thrust::mr::new_delete_resource>()->do_deallocate(p, bytes, alignment);
+    }
+
+    std::size_t allocations;
+    std::size_t bytes_in_use;
+};
+
+void sort_reversed(thrust::host_vector<int> & data)
+{
+    thrust::sequence(data.begin(), data.end(), int(data.size()), -1);
+    thrust::stable_sort(data.begin(), data.end());
+}
+
+TEST(MrTemporaryBufferCacheTests, TestCacheReuse)
+{
+    counting_resource upstream;
+    thrust::mr::temporary_buffer_cache<counting_resource> cache(&upstream);
+
+    // the pool's own bookkeeping also comes from upstream
+    const std::size_t bookkeeping_bytes = upstream.bytes_in_use;
+
+    void * p = cache.do_allocate(4 << 20);
+    cache.do_deallocate(p, 4 << 20);
+    const std::size_t allocations = upstream.allocations;
+
+    // the same buffer is handed out again
+    void * q = cache.do_allocate(4 << 20);
+    ASSERT_EQ(p, q);
+    ASSERT_EQ(upstream.allocations, allocations);
+    cache.do_deallocate(q, 4 << 20);
+
+    cache.trim();
+    ASSERT_EQ(upstream.bytes_in_use, bookkeeping_bytes);
+}
+
+TEST(MrTemporaryBufferCacheTests, TestCacheBound)
+{
+    thrust::mr::temporary_buffer_cache<thrust::mr::new_delete_resource> cache(5 << 20);
+
+    void * p = cache.do_allocate(4 << 20);
+    void * q = cache.do_allocate(4 << 20);
+    cache.do_deallocate(p, 4 << 20);
+    cache.do_deallocate(q, 4 << 20);
+
+    // only one of the buffers fits under the bound
+    ASSERT_LE(cache.statistics().upstream_bytes_in_use, std::size_t(5 << 20));
+    ASSERT_GT(cache.statistics().upstream_bytes_in_use, 0u);
+
+    cache.set_max_cached_bytes(0);
+    ASSERT_EQ(cache.statistics().upstream_bytes_in_use, 0u);
+
+    // with no room in the cache, buffers go straight back upstream
+    p = cache.do_allocate(4 << 20);
+    cache.do_deallocate(p, 4 << 20);
+    ASSERT_EQ(cache.statistics().upstream_bytes_in_use, 0u);
+}
+
+TEST(MrTemporaryBufferCacheTests, TestCacheBoundWithPartiallyUsedChunks)
+{
+    const std::size_t max_cached_bytes = 64 << 10;
+    thrust::mr::temporary_buffer_cache<thrust::mr::new_delete_resource> cache(max_cached_bytes);
+
+    // every other buffer stays in use, so the chunks can't be returned and the unused memory stays above the bound;
+    // this must not trim on every deallocation
+    const std::size_t count = 320000;
+    std::vector<void *> buffers(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        buffers[i] = cache.do_allocate(64);
+    }
+    for (std::size_t i = 0; i < count; i += 2)
+    {
+        cache.do_deallocate(buffers[i], 64);
+    }
+    for (std::size_t i = 1; i < count; i += 2)
+    {
+        cache.do_deallocate(buffers[i], 64);
+    }
+
+    // a large buffer still brings the cache back under the bound
+    void * p = cache.do_allocate(64 << 20);
+    cache.do_deallocate(p, 64 << 20);
+    ASSERT_LE(cache.statistics().upstream_bytes_in_use, max_cached_bytes);
+}
+
+TEST(MrTemporaryBufferCacheTests, TestCacheExecutionPolicy)
+{
+    thrust::mr::temporary_buffer_cache<thrust::mr::new_delete_resource> cache;
+
+    thrust::host_vector<int> data(20000);
+    for (int i = 0; i < 10; ++i)
+    {
+        thrust::sequence(data.begin(), data.end(), int(data.size()), -1);
+        thrust::stable_sort(thrust::cpp::par(&cache), data.begin(), data.end());
+        ASSERT_EQ(data[0], 1);
+    }
+
+    // all iterations but the first are served from the cache
+    const thrust::mr::allocation_statistics stats = cache.statistics();
+    ASSERT_GT(stats.allocations, 0u);
+    ASSERT_EQ(stats.allocations, stats.deallocations);
+    ASSERT_LE(stats.upstream_allocations, 2u);
+}
+
+TEST(MrTemporaryBufferCacheTests, TestHostTemporaryBufferCache)
+{
+    thrust::mr::temporary_buffer_cache<thrust::mr::new_delete_resource> * cache
+        = thrust::mr::get_host_temporary_buffer_cache();
+
+    thrust::host_vector<int> data(20000);
+
+    // opt-in: nothing goes through the cache by default
+    cache->reset_statistics();
+    sort_reversed(data);
+    ASSERT_EQ(cache->statistics().allocations, 0u);
+
+    thrust::mr::enable_host_temporary_buffer_cache();
+    for (int i = 0; i < 10; ++i)
+    {
+        sort_reversed(data);
+        ASSERT_EQ(data[0], 1);
+    }
+
+    thrust::mr::allocation_statistics stats = cache->statistics();
+    ASSERT_GT(stats.allocations, 0u);
+    ASSERT_EQ(stats.allocations, stats.deallocations);
+    ASSERT_LE(stats.upstream_allocations, 2u);
+
+    thrust::mr::disable_host_temporary_buffer_cache();
+    ASSERT_EQ(cache->statistics().upstream_bytes_in_use, 0u);
+
+    const std::size_t allocations = cache->statistics().allocations;
+    sort_reversed(data);
+    ASSERT_EQ(cache->statistics().allocations, allocations);
+}
+
+TEST(MrTemporaryBufferCacheTests, TestHostTemporaryResourceSwitching)
+{
+    counting_resource first;
+    counting_resource second;
+
+    // buffers go back to the resource they came from, even if it was replaced in the meantime
+    thrust::mr::host_temporary_resource::set(&first);
+    void * p = thrust::mr::host_temporary_resource::allocate(1000);
+    thrust::mr::host_temporary_resource::set(&second);
+    void * q = thrust::mr::host_temporary_resource::allocate(1000);
+    thrust::mr::host_temporary_resource::set(NULL);
+
+    ASSERT_EQ(thrust::mr::host_temporary_resource::allocate(1000), (void *)NULL);
+
+    ASSERT_TRUE(thrust::mr::host_temporary_resource::deallocate(p));
+    ASSERT_TRUE(thrust::mr::host_temporary_resource::deallocate(q));
+    ASSERT_EQ(first.bytes_in_use, 0u);
+    ASSERT_EQ(second.bytes_in_use, 0u);
+    ASSERT_EQ(first.allocations, 1u);
+    ASSERT_EQ(second.allocations, 1u);
+
+    // memory which didn't come from a resource is left to the caller
+    int unrelated;
+    ASSERT_FALSE(thrust::mr::host_temporary_resource::deallocate(&unrelated));
+}
+
+TEST(MrTemporaryBufferCacheTests, TestHostTemporaryBufferCacheConcurrent)
+{
+    thrust::mr::enable_host_temporary_buffer_cache();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.push_back(std::thread([]() {
+            thrust::host_vector<int> data(20000);
+            for (int i = 0; i < 20; ++i)
+            {
+                sort_reversed(data);
+                ASSERT_EQ(data[0], 1);
+            }
+        }));
+    }
+
+    for (std::size_t t = 0; t < threads.size(); ++t)
+    {
+        threads[t].join();
+    }
+
+    thrust::mr::disable_host_temporary_buffer_cache();
+
+    thrust::mr::allocation_statistics stats = thrust::mr::get_host_temporary_buffer_cache()->statistics();
+    ASSERT_EQ(stats.allocations, stats.deallocations);
+    ASSERT_EQ(stats.upstream_bytes_in_use, 0u);
+}
+
+#endif
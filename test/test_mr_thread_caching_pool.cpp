@@ -0,0 +1,177 @@
+#include <thrust/mr/new.h>
+
+#if __cplusplus >= 201103L
+#include <thrust/mr/thread_caching_pool.h>
+
+#include <atomic>
+#include <thread>
+#endif
+
+#include "test_header.hpp"
+
+#if __cplusplus >= 201103L
+
+class counting_resource THRUST_FINAL : public thrust::mr::memory_resource<>
+{
+public:
+    counting_resource() : allocations(0), bytes_outstanding(0)
+    {
+    }
+
+    ~counting_resource()
+    {
+        EXPECT_EQ(bytes_outstanding.load(), 0u);
+    }
+
+    virtual void * do_allocate(std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        ++allocations;
+        bytes_outstanding += bytes;
+        return upstream.do_allocate(bytes, alignment);
+    }
+
+    virtual void do_deallocate(void * p, std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        bytes_outstanding -= bytes;
+        upstream.do_deallocate(p, bytes, alignment);
+    }
+
+    std::atomic<std::size_t> allocations;
+    std::atomic<std::size_t> bytes_outstanding;
+
+private:
+    thrust::mr::new_delete_resource upstream;
+};
+
+typedef thrust::mr::thread_caching_pool_resource<counting_resource> Pool;
+
+TEST(MrThreadCachingPoolTests, TestReuse)
+{
+    counting_resource upstream;
+
+    {
+        Pool pool(&upstream);
+
+        // the central pools keep their bookkeeping until they are destroyed
+        std::size_t bookkeeping = upstream.bytes_outstanding;
+
+        // deallocating and allocating back should give the same block back
+        void * a1 = pool.do_allocate(12);
+        pool.do_deallocate(a1, 12);
+        std::size_t allocations = upstream.allocations;
+
+        void * a2 = pool.do_allocate(16);
+        ASSERT_EQ(a1, a2);
+        ASSERT_EQ(upstream.allocations.load(), allocations);
+
+        // blocks of the same size class are distinct
+        void * a3 = pool.do_allocate(16);
+        ASSERT_NE(a2, a3);
+
+        // oversized and overaligned allocations are served
+        void * a4 = pool.do_allocate(Pool::get_default_options().largest_block_size * 2);
+        void * a5 = pool.do_allocate(32, THRUST_MR_DEFAULT_ALIGNMENT * 4);
+        ASSERT_EQ(reinterpret_cast<std::size_t>(a5) % (THRUST_MR_DEFAULT_ALIGNMENT * 4), 0u);
+
+        pool.do_deallocate(a2, 16);
+        pool.do_deallocate(a3, 16);
+        pool.do_deallocate(a4, Pool::get_default_options().largest_block_size * 2);
+        pool.do_deallocate(a5, 32, THRUST_MR_DEFAULT_ALIGNMENT * 4);
+
+        // trimming returns all cached blocks to upstream
+        ASSERT_EQ(pool.trim() > 0u, true);
+        ASSERT_EQ(upstream.bytes_outstanding.load(), bookkeeping);
+
+        void * a6 = pool.do_allocate(64);
+        pool.do_deallocate(a6, 64);
+
+        // and so does release
+        pool.release();
+        ASSERT_EQ(upstream.bytes_outstanding.load(), bookkeeping);
+
+        // and the pool remains usable afterwards
+        void * a7 = pool.do_allocate(64);
+        pool.do_deallocate(a7, 64);
+    }
+
+    // destruction also returns memory
+    ASSERT_EQ(upstream.bytes_outstanding.load(), 0u);
+}
+
+TEST(MrThreadCachingPoolTests, TestCrossThreadDeallocation)
+{
+    counting_resource upstream;
+
+    {
+        Pool pool(&upstream, Pool::get_default_options(), 8);
+
+        const int num_threads = 4;
+        const int num_blocks = 2000;
+
+        std::vector<std::vector<unsigned char *> > blocks(num_threads, std::vector<unsigned char *>(num_blocks));
+        std::vector<std::thread> threads;
+
+        // every thread allocates blocks of varying sizes and fills them with its id
+        for (int t = 0; t < num_threads; ++t)
+        {
+            threads.push_back(std::thread([&, t]{
+                for (int i = 0; i < num_blocks; ++i)
+                {
+                    std::size_t size = 8 + (i % 200);
+                    blocks[t][i] = static_cast<unsigned char *>(pool.do_allocate(size));
+                    std::fill(blocks[t][i], blocks[t][i] + size, static_cast<unsigned char>(t));
+                }
+            }));
+        }
+
+        for (int t = 0; t < num_threads; ++t)
+        {
+            threads[t].join();
+        }
+        threads.clear();
+
+        // no block was handed out twice
+        for (int t = 0; t < num_threads; ++t)
+        {
+            for (int i = 0; i < num_blocks; ++i)
+            {
+                std::size_t size = 8 + (i % 200);
+                ASSERT_EQ(std::count(blocks[t][i], blocks[t][i] + size, static_cast<unsigned char>(t)), (std::ptrdiff_t)size);
+            }
+        }
+
+        // every thread frees the blocks of the next thread, and allocates again in between
+        for (int t = 0; t < num_threads; ++t)
+        {
+            threads.push_back(std::thread([&, t]{
+                int other = (t + 1) % num_threads;
+                for (int i = 0; i < num_blocks; ++i)
+                {
+                    std::size_t size = 8 + (i % 200);
+                    pool.do_deallocate(blocks[other][i], size);
+
+                    void * p = pool.do_allocate(size);
+                    pool.do_deallocate(p, size);
+                }
+            }));
+        }
+
+        for (int t = 0; t < num_threads; ++t)
+        {
+            threads[t].join();
+        }
+    }
+
+    ASSERT_EQ(upstream.bytes_outstanding.load(), 0u);
+}
+
+TEST(MrThreadCachingPoolTests, TestGlobalPool)
+{
+    typedef thrust::mr::thread_caching_pool_resource<
+        thrust::mr::new_delete_resource
+    > GlobalPool;
+
+    ASSERT_EQ(thrust::mr::get_global_resource<GlobalPool>() != NULL, true);
+}
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/sorted_index.h>
+#include <thrust/binary_search.h>
+#include <thrust/functional.h>
+#include <thrust/host_vector.h>
+#include <thrust/sort.h>
+#include <thrust/system/cpp/execution_policy.h>
+
+#include "test_header.hpp"
+
+TESTS_DEFINE(SortedIndexTests, VectorIntegerTestsParams);
+
+TEST(SortedIndexTests, TestSortedIndexSimple)
+{
+    thrust::host_vector<int> vec(5);
+    vec[0] = 0;
+    vec[1] = 2;
+    vec[2] = 5;
+    vec[3] = 7;
+    vec[4] = 8;
+
+    thrust::sorted_index<int> index(vec.begin(), vec.end());
+
+    ASSERT_EQ(index.size(), 5u);
+    ASSERT_FALSE(index.empty());
+
+    ASSERT_EQ(index.lower_bound(0), 0u);
+    ASSERT_EQ(index.lower_bound(1), 1u);
+    ASSERT_EQ(index.lower_bound(2), 1u);
+    ASSERT_EQ(index.lower_bound(7), 3u);
+    ASSERT_EQ(index.lower_bound(9), 5u);
+
+    ASSERT_EQ(index.upper_bound(0), 1u);
+    ASSERT_EQ(index.upper_bound(1), 1u);
+    ASSERT_EQ(index.upper_bound(7), 4u);
+    ASSERT_EQ(index.upper_bound(8), 5u);
+    ASSERT_EQ(index.upper_bound(-1), 0u);
+
+    ASSERT_TRUE(index.binary_search(5));
+    ASSERT_TRUE(index.binary_search(8));
+    ASSERT_FALSE(index.binary_search(-1));
+    ASSERT_FALSE(index.binary_search(6));
+    ASSERT_FALSE(index.binary_search(9));
+}
+
+TEST(SortedIndexTests, TestSortedIndexEmpty)
+{
+    thrust::host_vector<int> vec;
+
+    thrust::sorted_index<int> index(vec.begin(), vec.end());
+
+    ASSERT_TRUE(index.empty());
+    ASSERT_EQ(index.lower_bound(1), 0u);
+    ASSERT_EQ(index.upper_bound(1), 0u);
+    ASSERT_FALSE(index.binary_search(1));
+
+    thrust::sorted_index<int> default_index;
+    ASSERT_TRUE(default_index.empty());
+    ASSERT_EQ(default_index.lower_bound(1), 0u);
+}
+
+TEST(SortedIndexTests, TestSortedIndexDescending)
+{
+    thrust::host_vector<int> vec(4);
+    vec[0] = 9;
+    vec[1] = 6;
+    vec[2] = 6;
+    vec[3] = 1;
+
+    thrust::sorted_index<int, thrust::greater<int> > index(vec.begin(), vec.end());
+
+    ASSERT_EQ(index.lower_bound(10), 0u);
+    ASSERT_EQ(index.lower_bound(6), 1u);
+    ASSERT_EQ(index.upper_bound(6), 3u);
+    ASSERT_EQ(index.lower_bound(0), 4u);
+    ASSERT_TRUE(index.binary_search(1));
+    ASSERT_FALSE(index.binary_search(5));
+}
+
+TYPED_TEST(SortedIndexTests, TestSortedIndexVectorSearches)
+{
+    using Vector = typename TestFixture::input_type;
+    using T      = typename Vector::value_type;
+
+    for(auto size : get_sizes())
+    {
+        SCOPED_TRACE(testing::Message() << "with size = " << size);
+        for(size_t seed_index = 0; seed_index < random_seeds_count + seed_size; seed_index++)
+        {
+            unsigned int seed_value
+                = seed_index < random_seeds_count ? rand() : seeds[seed_index - random_seeds_count];
+            SCOPED_TRACE(testing::Message() << "with seed= " << seed_value);
+
+            thrust::host_vector<T> h_vec = get_random_data<T>(
+                size, std::numeric_limits<T>::min(), std::numeric_limits<T>::max(), seed_value);
+            thrust::sort(h_vec.begin(), h_vec.end());
+            Vector vec = h_vec;
+
+            thrust::host_vector<T> h_input = get_random_data<T>(
+                2 * size, std::numeric_limits<T>::min(),
+                std::numeric_limits<T>::max(),
+                seed_value + seed_value_addition
+            );
+            // also look for the elements themselves
+            thrust::copy(h_vec.begin(), h_vec.end(), h_input.begin());
+
+            // the index lives in host memory whichever memory space the range comes from
+            thrust::sorted_index<T> index(vec.begin(), vec.end());
+            ASSERT_EQ(index.size(), size);
+
+            thrust::host_vector<size_t> expected(2 * size);
+            thrust::host_vector<size_t> output(2 * size);
+
+            thrust::lower_bound(
+                h_vec.begin(), h_vec.end(), h_input.begin(), h_input.end(), expected.begin());
+            index.lower_bound(h_input.begin(), h_input.end(), output.begin());
+            ASSERT_EQ(expected, output);
+
+            thrust::upper_bound(
+                h_vec.begin(), h_vec.end(), h_input.begin(), h_input.end(), expected.begin());
+            index.upper_bound(thrust::cpp::par, h_input.begin(), h_input.end(), output.begin());
+            ASSERT_EQ(expected, output);
+        }
+    }
+}
+
+TEST(SortedIndexTests, TestSortedIndexWithPolicy)
+{
+    thrust::host_vector<int> vec(1000);
+    for(size_t i = 0; i < vec.size(); ++i)
+    {
+        vec[i] = static_cast<int>(i / 3);
+    }
+
+    thrust::sorted_index<int> index(thrust::cpp::par, vec.begin(), vec.end());
+
+    for(int value = -1; value <= 334; ++value)
+    {
+        ASSERT_EQ(index.lower_bound(value),
+                  size_t(thrust::lower_bound(vec.begin(), vec.end(), value) - vec.begin()));
+        ASSERT_EQ(index.upper_bound(value),
+                  size_t(thrust::upper_bound(vec.begin(), vec.end(), value) - vec.begin()));
+        ASSERT_EQ(index.binary_search(value), value >= 0 && value < 334);
+    }
+}
@@ -0,0 +1,199 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/tuning.h>
+#include <thrust/host_vector.h>
+#include <thrust/sort.h>
+#include <thrust/execution_policy.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <string>
+
+#include <unistd.h>
+
+#include "test_header.hpp"
+
+// a temporary file, removed when the test ends
+struct temporary_file
+{
+    temporary_file()
+    {
+        char name[] = "/tmp/thrust_tuning_XXXXXX";
+        int fd = ::mkstemp(name);
+        ::close(fd);
+        path = name;
+    }
+
+    ~temporary_file()
+    {
+        std::remove(path.c_str());
+    }
+
+    std::string path;
+};
+
+struct greater_int
+{
+    __host__ __device__
+    bool operator()(int lhs, int rhs) const
+    {
+        return lhs > rhs;
+    }
+};
+
+TEST(TuningTests, TestTuningDefaults)
+{
+    thrust::tuning::reset();
+
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::tbb_merge_sort_leaf_size), 131072u);
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::tbb_radix_sort_threshold), 131072u);
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::tbb_reduce_by_key_threshold), 10000u);
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::generic_find_interval_size), 1048576u);
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::merge_sort_partition_size), 32u);
+
+    ASSERT_EQ(std::strcmp(thrust::tuning::name(thrust::tuning::merge_sort_partition_size), "merge_sort_partition_size"), 0);
+}
+
+TEST(TuningTests, TestTuningSetGet)
+{
+    thrust::tuning::reset();
+
+    thrust::tuning::set(thrust::tuning::tbb_radix_sort_threshold, 4096);
+
+    ASSERT_EQ(thrust::tuning::get<char>(thrust::tuning::tbb_radix_sort_threshold), 4096u);
+    ASSERT_EQ(thrust::tuning::get<double>(thrust::tuning::tbb_radix_sort_threshold), 4096u);
+
+    // sizes are rounded up to a power of two, and larger elements share the 16 byte value
+    thrust::tuning::set(thrust::tuning::tbb_radix_sort_threshold, 4, 1024);
+
+    ASSERT_EQ(thrust::tuning::get(thrust::tuning::tbb_radix_sort_threshold, 3), 1024u);
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::tbb_radix_sort_threshold), 1024u);
+    ASSERT_EQ(thrust::tuning::get<short>(thrust::tuning::tbb_radix_sort_threshold), 4096u);
+    ASSERT_EQ(thrust::tuning::get(thrust::tuning::tbb_radix_sort_threshold, 5), 4096u);
+
+    thrust::tuning::set(thrust::tuning::tbb_radix_sort_threshold, 16, 7);
+
+    ASSERT_EQ(thrust::tuning::get(thrust::tuning::tbb_radix_sort_threshold, 64), 7u);
+
+    // 0 restores the default
+    thrust::tuning::set(thrust::tuning::tbb_radix_sort_threshold, 4, 0);
+
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::tbb_radix_sort_threshold), 131072u);
+    ASSERT_EQ(thrust::tuning::get<char>(thrust::tuning::tbb_radix_sort_threshold), 4096u);
+
+    // the other parameters are unchanged
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::tbb_merge_sort_leaf_size), 131072u);
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::merge_sort_partition_size), 32u);
+
+    thrust::tuning::reset();
+
+    ASSERT_EQ(thrust::tuning::get<char>(thrust::tuning::tbb_radix_sort_threshold), 131072u);
+}
+
+TEST(TuningTests, TestTuningParse)
+{
+    thrust::tuning::reset();
+
+    ASSERT_TRUE(thrust::tuning::parse("tbb_radix_sort_threshold=65536, merge_sort_partition_size.8=48;\tgeneric_find_interval_size=4096\n"));
+
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::tbb_radix_sort_threshold), 65536u);
+    ASSERT_EQ(thrust::tuning::get<double>(thrust::tuning::merge_sort_partition_size), 48u);
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::merge_sort_partition_size), 32u);
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::generic_find_interval_size), 4096u);
+
+    // invalid entries are reported, and the valid ones still applied
+    ASSERT_FALSE(thrust::tuning::parse("unknown=1 tbb_reduce_by_key_threshold=500"));
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::tbb_reduce_by_key_threshold), 500u);
+
+    ASSERT_FALSE(thrust::tuning::parse("tbb_radix_sort_threshold"));
+    ASSERT_FALSE(thrust::tuning::parse("tbb_radix_sort_threshold=-1"));
+    ASSERT_FALSE(thrust::tuning::parse("tbb_radix_sort_threshold=12x"));
+    ASSERT_FALSE(thrust::tuning::parse("tbb_radix_sort_threshold.0=12"));
+    ASSERT_FALSE(thrust::tuning::parse("tbb_radix_sort_threshold.=12"));
+
+    ASSERT_EQ(thrust::tuning::get<int>(thrust::tuning::tbb_radix_sort_threshold), 65536u);
+
+    ASSERT_TRUE(thrust::tuning::parse(""));
+
+    thrust::tuning::reset();
+}
+
+TEST(TuningTests, TestTuningSaveLoad)
+{
+    temporary_file file;
+
+    thrust::tuning::reset();
+
+    thrust::tuning::set(thrust::tuning::tbb_radix_sort_threshold, 1, 2048);
+    thrust::tuning::set(thrust::tuning::tbb_radix_sort_threshold, 8, 8192);
+    thrust::tuning::set(thrust::tuning::merge_sort_partition_size, 24);
+
+    ASSERT_TRUE(thrust::tuning::save(file.path.c_str()));
+
+    thrust::tuning::reset();
+
+    ASSERT_TRUE(thrust::tuning::load(file.path.c_str()));
+
+    ASSERT_EQ(thrust::tuning::get<char>(thrust::tuning::tbb_radix_sort_threshold), 2048u);
+    ASSERT_EQ(thrust::tuning::get<short>(thrust::tuning::tbb_radix_sort_threshold), 131072u);
+    ASSERT_EQ(thrust::tuning::get<double>(thrust::tuning::tbb_radix_sort_threshold), 8192u);
+    ASSERT_EQ(thrust::tuning::get<char>(thrust::tuning::merge_sort_partition_size), 24u);
+    ASSERT_EQ(thrust::tuning::get(thrust::tuning::merge_sort_partition_size, 32), 24u);
+
+    thrust::tuning::reset();
+
+    ASSERT_FALSE(thrust::tuning::load("/nonexistent/thrust_tuning"));
+}
+
+TEST(TuningTests, TestTuningMergeSortPartitionSize)
+{
+    const size_t partition_sizes[] = {1, 2, 7, 32, 100, 600};
+
+    for(size_t p = 0; p < sizeof(partition_sizes) / sizeof(partition_sizes[0]); p++)
+    {
+        thrust::tuning::set(thrust::tuning::merge_sort_partition_size, partition_sizes[p]);
+
+        for(auto size : get_sizes())
+        {
+            SCOPED_TRACE(testing::Message() << "with size = " << size << ", partition size = " << partition_sizes[p]);
+
+            thrust::host_vector<int> keys = get_random_data<int>(size, 0, 100, size + p);
+            thrust::host_vector<int> values(size);
+            std::iota(values.begin(), values.end(), 0);
+
+            // the values are the original positions of the keys
+            thrust::host_vector<int> expected_keys(keys);
+            thrust::host_vector<int> expected_values(values);
+            std::stable_sort(expected_values.begin(), expected_values.end(), [&](int lhs, int rhs) {
+                return keys[lhs] > keys[rhs];
+            });
+            for(size_t i = 0; i < size; i++)
+            {
+                expected_keys[i] = keys[expected_values[i]];
+            }
+
+            thrust::stable_sort_by_key(thrust::seq, keys.begin(), keys.end(), values.begin(), greater_int());
+
+            ASSERT_EQ(keys, expected_keys);
+            ASSERT_EQ(values, expected_values);
+        }
+    }
+
+    thrust::tuning::reset();
+}
@@ -80,15 +80,98 @@ template<typename U, typename T>
 {};
 
 
+// the destination system can access the source range directly when it is the
+// source system or refines it, e.g. omp and tbb refine cpp; the copy then runs
+// in the destination system, so that a parallel system first-touches the new
+// storage from the threads which go on to process it
+template<typename FromSystem, typename ToSystem>
+  struct copies_in_destination_system
+    : is_convertible<ToSystem,FromSystem>
+{};
+
+
+// the systems can access each other's memory when either one refines the other
+template<typename FromSystem, typename ToSystem>
+  struct systems_are_interoperable
+    : or_<
+        is_convertible<FromSystem,ToSystem>,
+        is_convertible<ToSystem,FromSystem>
+      >
+{};
+
+
+template<typename FromSystem, typename ToSystem, typename InputIterator, typename Pointer>
+__host__ __device__
+  typename enable_if<
+    copies_in_destination_system<FromSystem,ToSystem>::value,
+    Pointer
+  >::type
+    copy_into_system(const thrust::execution_policy<FromSystem> &,
+                     const thrust::execution_policy<ToSystem> &to_system,
+                     InputIterator first,
+                     InputIterator last,
+                     Pointer result)
+{
+  return thrust::copy(thrust::detail::derived_cast(thrust::detail::strip_const(to_system)), first, last, result);
+}
+
+
+template<typename FromSystem, typename ToSystem, typename InputIterator, typename Size, typename Pointer>
+__host__ __device__
+  typename enable_if<
+    copies_in_destination_system<FromSystem,ToSystem>::value,
+    Pointer
+  >::type
+    copy_into_system_n(const thrust::execution_policy<FromSystem> &,
+                       const thrust::execution_policy<ToSystem> &to_system,
+                       InputIterator first,
+                       Size n,
+                       Pointer result)
+{
+  return thrust::copy_n(thrust::detail::derived_cast(thrust::detail::strip_const(to_system)), first, n, result);
+}
+
+
+template<typename FromSystem, typename ToSystem, typename InputIterator, typename Pointer>
+__host__ __device__
+  typename disable_if<
+    copies_in_destination_system<FromSystem,ToSystem>::value,
+    Pointer
+  >::type
+    copy_into_system(const thrust::execution_policy<FromSystem> &from_system,
+                     const thrust::execution_policy<ToSystem> &to_system,
+                     InputIterator first,
+                     InputIterator last,
+                     Pointer result)
+{
+  return thrust::detail::two_system_copy(from_system, to_system, first, last, result);
+}
+
+
+template<typename FromSystem, typename ToSystem, typename InputIterator, typename Size, typename Pointer>
+__host__ __device__
+  typename disable_if<
+    copies_in_destination_system<FromSystem,ToSystem>::value,
+    Pointer
+  >::type
+    copy_into_system_n(const thrust::execution_policy<FromSystem> &from_system,
+                       const thrust::execution_policy<ToSystem> &to_system,
+                       InputIterator first,
+                       Size n,
+                       Pointer result)
+{
+  return thrust::detail::two_system_copy_n(from_system, to_system, first, n, result);
+}
+
+
 // XXX it's regrettable that this implementation is copied almost
 //     exactly from system::detail::generic::uninitialized_copy
 //     perhaps generic::uninitialized_copy could call this routine
 //     with a default allocator
 template<typename Allocator, typename FromSystem, typename ToSystem, typename InputIterator, typename Pointer>
 __host__ __device__
-  typename enable_if_convertible<
-    FromSystem,
-    ToSystem,
+  typename enable_if<
+    systems_are_interoperable<FromSystem,ToSystem>::value,
     Pointer
   >::type
     uninitialized_copy_with_allocator(Allocator &a,
@@ -128,9 +211,8 @@ __host__ __device__
 //     with a default allocator
 template<typename Allocator, typename FromSystem, typename ToSystem, typename InputIterator, typename Size, typename Pointer>
 __host__ __device__
-  typename enable_if_convertible<
-    FromSystem,
-    ToSystem,
+  typename enable_if<
+    systems_are_interoperable<FromSystem,ToSystem>::value,
     Pointer
   >::type
     uninitialized_copy_with_allocator_n(Allocator &a,
@@ -161,9 +243,8 @@ __host__ __device__
 
 template<typename Allocator, typename FromSystem, typename ToSystem, typename InputIterator, typename Pointer>
 __host__ __device__
-  typename disable_if_convertible<
-    FromSystem,
-    ToSystem,
+  typename disable_if<
+    systems_are_interoperable<FromSystem,ToSystem>::value,
     Pointer
   >::type
     uninitialized_copy_with_allocator(Allocator &,
@@ -181,9 +262,8 @@ __host__ __device__
 
 template<typename Allocator, typename FromSystem, typename ToSystem, typename InputIterator, typename Size, typename Pointer>
 __host__ __device__
-  typename disable_if_convertible<
-    FromSystem,
-    ToSystem,
+  typename disable_if<
+    systems_are_interoperable<FromSystem,ToSystem>::value,
     Pointer
   >::type
     uninitialized_copy_with_allocator_n(Allocator &,
@@ -214,8 +294,7 @@ __host__ __device__
                          InputIterator last,
                          Pointer result)
 {
-  // just call two_system_copy
-  return thrust::detail::two_system_copy(from_system, allocator_system<Allocator>::get(a), first, last, result);
+  return copy_into_system(from_system, allocator_system<Allocator>::get(a), first, last, result);
 }
 
 
@@ -234,8 +313,7 @@ __host__ __device__
                            Size n,
                            Pointer result)
 {
-  // just call two_system_copy_n
-  return thrust::detail::two_system_copy_n(from_system, allocator_system<Allocator>::get(a), first, n, result);
+  return copy_into_system_n(from_system, allocator_system<Allocator>::get(a), first, n, result);
 }
 
 
@@ -56,7 +56,7 @@ public:
     : alloc(alloc_)
   {}
 
-  Allocator get_allocator() { return alloc; }
+  typename thrust::detail::remove_reference<Allocator>::type & get_allocator() { return alloc; }
 };
 
 template <
@@ -108,6 +108,35 @@ return_temporary_buffer(
   alloc_traits::deallocate(system.get_allocator(), to_ptr, 0);
 }
 
+template <
+    typename Pointer
+  , typename Allocator
+  , template <typename> class BaseSystem
+>
+__host__
+void
+return_temporary_buffer(
+    thrust::detail::execute_with_allocator<Allocator, BaseSystem>& system
+  , Pointer p
+  , std::ptrdiff_t n
+    )
+{
+  typedef typename thrust::detail::remove_reference<Allocator>::type naked_allocator;
+  typedef typename thrust::detail::allocator_traits<naked_allocator> alloc_traits;
+  typedef typename alloc_traits::pointer                             pointer;
+  typedef typename alloc_traits::size_type                           size_type;
+  typedef typename alloc_traits::value_type                          value_type;
+  typedef typename thrust::detail::pointer_element<Pointer>::type    T;
+
+  // pass the allocator the same number of elements get_temporary_buffer
+  // allocated, so that allocators which need the size get it
+  size_type num_elements =
+      thrust::detail::util::divide_ri(sizeof(T) * n, sizeof(value_type));
+
+  pointer to_ptr = thrust::detail::reinterpret_pointer_cast<pointer>(p);
+  alloc_traits::deallocate(system.get_allocator(), to_ptr, num_elements);
+}
+
 } // end detail
 } // end thrust
 
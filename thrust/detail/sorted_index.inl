@@ -0,0 +1,361 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/sorted_index.h>
+#include <thrust/detail/integer_math.h>
+#include <thrust/detail/raw_pointer_cast.h>
+#include <thrust/detail/type_traits.h>
+#include <thrust/distance.h>
+#include <thrust/gather.h>
+#include <thrust/transform.h>
+#include <thrust/system/detail/generic/select_system.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/iterator/transform_iterator.h>
+
+namespace thrust
+{
+namespace detail
+{
+namespace sorted_index_detail
+{
+
+
+#if (THRUST_HOST_COMPILER == THRUST_HOST_COMPILER_GCC) || (THRUST_HOST_COMPILER == THRUST_HOST_COMPILER_CLANG)
+#  define THRUST_SORTED_INDEX_HAS_BUILTINS 1
+#else
+#  define THRUST_SORTED_INDEX_HAS_BUILTINS 0
+#endif
+
+
+__host__ __device__ __thrust_forceinline__
+std::size_t floor_log2(std::size_t x)
+{
+#if THRUST_SORTED_INDEX_HAS_BUILTINS
+  return 8 * sizeof(unsigned long long) - 1 - __builtin_clzll(x);
+#else
+  return thrust::detail::log2(x);
+#endif
+}
+
+
+__host__ __device__ __thrust_forceinline__
+std::size_t trailing_ones(std::size_t x)
+{
+#if THRUST_SORTED_INDEX_HAS_BUILTINS
+  return __builtin_ctzll(~static_cast<unsigned long long>(x));
+#else
+  std::size_t result = 0;
+  for(; x & 1; x >>= 1)
+  {
+    ++result;
+  }
+  return result;
+#endif
+}
+
+
+// maps a node of the tree to the position of its element in the sorted range
+//
+// in a perfect tree with levels levels, the node k at depth d is the (2 * (k - 2^d) + 1)-th node of a depth-d subtree
+// in order, and every subtree below it has 2^(levels - 1 - d) - 1 nodes; the nodes missing from the last level are
+// the ones at the largest even positions, so only the ones before the node need to be subtracted
+struct eytzinger_rank
+{
+  typedef std::size_t result_type;
+
+  std::size_t levels;
+  std::size_t last_level_size;
+
+  __host__ __device__
+  explicit eytzinger_rank(std::size_t n)
+    : levels(n == 0 ? 0 : floor_log2(n) + 1),
+      last_level_size(n == 0 ? 0 : n - ((std::size_t(1) << (levels - 1)) - 1))
+  {}
+
+  __host__ __device__ __thrust_forceinline__
+  std::size_t operator()(std::size_t k) const
+  {
+    std::size_t depth = floor_log2(k);
+    std::size_t position = ((2 * (k - (std::size_t(1) << depth)) + 1) << (levels - 1 - depth)) - 1;
+    std::size_t last_level_before = (position + 1) / 2;
+
+    return last_level_before > last_level_size ? position - (last_level_before - last_level_size) : position;
+  }
+};
+
+
+// the number of nodes on the level whose first node is prefetched; the nodes of a subtree's level are contiguous, so
+// this many of them fit in a 64 byte cache line
+template<typename T>
+struct prefetch_stride
+{
+  static const std::size_t value = sizeof(T) <= 4  ? 16 :
+                                   sizeof(T) <= 8  ?  8 :
+                                   sizeof(T) <= 16 ?  4 :
+                                   sizeof(T) <= 32 ?  2 : 1;
+};
+
+
+template<typename T, typename StrictWeakOrdering, bool UpperBound>
+struct eytzinger_search
+{
+  typedef std::size_t result_type;
+
+  const T *keys;
+  std::size_t n;
+  eytzinger_rank rank;
+  StrictWeakOrdering comp;
+
+  __host__ __device__
+  eytzinger_search(const T *keys, std::size_t n, StrictWeakOrdering comp)
+    : keys(keys), n(n), rank(n), comp(comp)
+  {}
+
+  // returns the node of the first element not before value, or 0 if there is none
+  __thrust_exec_check_disable__
+  template<typename U>
+  __host__ __device__ __thrust_forceinline__
+  std::size_t node(const U &value) const
+  {
+    std::size_t k = 1;
+
+    while(k <= n)
+    {
+#if THRUST_SORTED_INDEX_HAS_BUILTINS && !defined(__CUDA_ARCH__) && !defined(__HIP_DEVICE_COMPILE__)
+      __builtin_prefetch(keys + k * prefetch_stride<T>::value);
+#endif
+      // descend without branching on the comparison: go right past the elements before value
+      k = 2 * k + (UpperBound ? !comp(value, keys[k]) : comp(keys[k], value));
+    }
+
+    // the answer is where the path last went left
+    return k >> (trailing_ones(k) + 1);
+  }
+
+  template<typename U>
+  __host__ __device__ __thrust_forceinline__
+  std::size_t operator()(const U &value) const
+  {
+    std::size_t k = node(value);
+    return k == 0 ? n : rank(k);
+  }
+};
+
+
+#undef THRUST_SORTED_INDEX_HAS_BUILTINS
+
+
+} // end sorted_index_detail
+} // end detail
+
+
+template<typename T, typename StrictWeakOrdering, typename Alloc>
+  sorted_index<T,StrictWeakOrdering,Alloc>
+    ::sorted_index(StrictWeakOrdering comp)
+      : m_storage(), m_size(0), m_comp(comp)
+{
+} // end sorted_index::sorted_index()
+
+
+template<typename T, typename StrictWeakOrdering, typename Alloc>
+  template<typename InputIterator>
+    sorted_index<T,StrictWeakOrdering,Alloc>
+      ::sorted_index(InputIterator first, InputIterator last, StrictWeakOrdering comp)
+        : m_storage(), m_size(0), m_comp(comp)
+{
+  typedef typename thrust::iterator_system<InputIterator>::type input_system;
+  typedef typename thrust::iterator_system<typename storage_type::iterator>::type storage_system;
+
+  // the range can be permuted in place when it is random access and can be read together with the storage
+  typedef thrust::detail::and_<
+    thrust::detail::is_convertible<
+      typename thrust::iterator_traversal<InputIterator>::type,
+      thrust::random_access_traversal_tag
+    >,
+    thrust::detail::or_<
+      thrust::detail::is_convertible<input_system, storage_system>,
+      thrust::detail::is_convertible<storage_system, input_system>
+    >
+  > can_gather;
+
+  build(first, last, can_gather());
+} // end sorted_index::sorted_index()
+
+
+template<typename T, typename StrictWeakOrdering, typename Alloc>
+  template<typename DerivedPolicy, typename RandomAccessIterator>
+    sorted_index<T,StrictWeakOrdering,Alloc>
+      ::sorted_index(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                     RandomAccessIterator first, RandomAccessIterator last,
+                     StrictWeakOrdering comp)
+        : m_storage(), m_size(thrust::distance(first, last)), m_comp(comp)
+{
+  build(exec, first);
+} // end sorted_index::sorted_index()
+
+
+template<typename T, typename StrictWeakOrdering, typename Alloc>
+  template<typename DerivedPolicy, typename RandomAccessIterator>
+    void sorted_index<T,StrictWeakOrdering,Alloc>
+      ::build(const thrust::detail::execution_policy_base<DerivedPolicy> &exec, RandomAccessIterator first)
+{
+  if(m_size == 0)
+  {
+    return;
+  }
+
+  m_storage.resize(m_size + 1);
+
+  // node k of the tree takes the element of the sorted range at its in-order position
+  thrust::counting_iterator<size_type> nodes(1);
+  thrust::detail::sorted_index_detail::eytzinger_rank rank(m_size);
+
+  thrust::gather(exec,
+                 thrust::make_transform_iterator(nodes, rank),
+                 thrust::make_transform_iterator(nodes + m_size, rank),
+                 first,
+                 m_storage.begin() + 1);
+} // end sorted_index::build()
+
+
+template<typename T, typename StrictWeakOrdering, typename Alloc>
+  template<typename InputIterator>
+    void sorted_index<T,StrictWeakOrdering,Alloc>
+      ::build(InputIterator first, InputIterator last, thrust::detail::true_type)
+{
+  typedef typename thrust::iterator_system<InputIterator>::type input_system;
+  typedef typename thrust::iterator_system<typename storage_type::iterator>::type storage_system;
+
+  using thrust::system::detail::generic::select_system;
+
+  input_system system1;
+  storage_system system2;
+
+  m_size = thrust::distance(first, last);
+  build(select_system(system1, system2), first);
+} // end sorted_index::build()
+
+
+template<typename T, typename StrictWeakOrdering, typename Alloc>
+  template<typename InputIterator>
+    void sorted_index<T,StrictWeakOrdering,Alloc>
+      ::build(InputIterator first, InputIterator last, thrust::detail::false_type)
+{
+  // bring the range next to the storage first
+  storage_type sorted(first, last);
+
+  build(sorted.begin(), sorted.end(), thrust::detail::true_type());
+} // end sorted_index::build()
+
+
+template<typename T, typename StrictWeakOrdering, typename Alloc>
+  template<typename U>
+    typename sorted_index<T,StrictWeakOrdering,Alloc>::size_type
+      sorted_index<T,StrictWeakOrdering,Alloc>
+        ::lower_bound(const U &value) const
+{
+  thrust::detail::sorted_index_detail::eytzinger_search<T,StrictWeakOrdering,false>
+    search(thrust::raw_pointer_cast(m_storage.data()), m_size, m_comp);
+
+  return search(value);
+} // end sorted_index::lower_bound()
+
+
+template<typename T, typename StrictWeakOrdering, typename Alloc>
+  template<typename U>
+    typename sorted_index<T,StrictWeakOrdering,Alloc>::size_type
+      sorted_index<T,StrictWeakOrdering,Alloc>
+        ::upper_bound(const U &value) const
+{
+  thrust::detail::sorted_index_detail::eytzinger_search<T,StrictWeakOrdering,true>
+    search(thrust::raw_pointer_cast(m_storage.data()), m_size, m_comp);
+
+  return search(value);
+} // end sorted_index::upper_bound()
+
+
+template<typename T, typename StrictWeakOrdering, typename Alloc>
+  template<typename U>
+    bool sorted_index<T,StrictWeakOrdering,Alloc>
+      ::binary_search(const U &value) const
+{
+  const T *keys = thrust::raw_pointer_cast(m_storage.data());
+
+  thrust::detail::sorted_index_detail::eytzinger_search<T,StrictWeakOrdering,false>
+    search(keys, m_size, m_comp);
+
+  size_type k = search.node(value);
+
+  return k != 0 && !m_comp(value, keys[k]);
+} // end sorted_index::binary_search()
+
+
+template<typename T, typename StrictWeakOrdering, typename Alloc>
+  template<typename InputIterator, typename OutputIterator>
+    OutputIterator sorted_index<T,StrictWeakOrdering,Alloc>
+      ::lower_bound(InputIterator values_first, InputIterator values_last, OutputIterator result) const
+{
+  thrust::detail::sorted_index_detail::eytzinger_search<T,StrictWeakOrdering,false>
+    search(thrust::raw_pointer_cast(m_storage.data()), m_size, m_comp);
+
+  return thrust::transform(values_first, values_last, result, search);
+} // end sorted_index::lower_bound()
+
+
+template<typename T, typename StrictWeakOrdering, typename Alloc>
+  template<typename DerivedPolicy, typename InputIterator, typename OutputIterator>
+    OutputIterator sorted_index<T,StrictWeakOrdering,Alloc>
+      ::lower_bound(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    InputIterator values_first, InputIterator values_last, OutputIterator result) const
+{
+  thrust::detail::sorted_index_detail::eytzinger_search<T,StrictWeakOrdering,false>
+    search(thrust::raw_pointer_cast(m_storage.data()), m_size, m_comp);
+
+  return thrust::transform(exec, values_first, values_last, result, search);
+} // end sorted_index::lower_bound()
+
+
+template<typename T, typename StrictWeakOrdering, typename Alloc>
+  template<typename InputIterator, typename OutputIterator>
+    OutputIterator sorted_index<T,StrictWeakOrdering,Alloc>
+      ::upper_bound(InputIterator values_first, InputIterator values_last, OutputIterator result) const
+{
+  thrust::detail::sorted_index_detail::eytzinger_search<T,StrictWeakOrdering,true>
+    search(thrust::raw_pointer_cast(m_storage.data()), m_size, m_comp);
+
+  return thrust::transform(values_first, values_last, result, search);
+} // end sorted_index::upper_bound()
+
+
+template<typename T, typename StrictWeakOrdering, typename Alloc>
+  template<typename DerivedPolicy, typename InputIterator, typename OutputIterator>
+    OutputIterator sorted_index<T,StrictWeakOrdering,Alloc>
+      ::upper_bound(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    InputIterator values_first, InputIterator values_last, OutputIterator result) const
+{
+  thrust::detail::sorted_index_detail::eytzinger_search<T,StrictWeakOrdering,true>
+    search(thrust::raw_pointer_cast(m_storage.data()), m_size, m_comp);
+
+  return thrust::transform(exec, values_first, values_last, result, search);
+} // end sorted_index::upper_bound()
+
+
+} // end thrust
+
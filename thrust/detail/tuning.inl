@@ -0,0 +1,308 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/tuning.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace thrust
+{
+namespace detail
+{
+namespace tuning_detail
+{
+
+
+// elements of 1, 2, 4, 8 and 16 or more bytes
+const std::size_t num_size_classes = 5;
+
+
+inline std::size_t size_class(std::size_t element_size)
+{
+  std::size_t result = 0;
+
+  while(result + 1 < num_size_classes && (std::size_t(1) << result) < element_size)
+  {
+    ++result;
+  }
+
+  return result;
+}
+
+
+inline std::size_t default_value(thrust::tuning::parameter p)
+{
+  switch(p)
+  {
+    case thrust::tuning::tbb_merge_sort_leaf_size:    return 128 * 1024;
+    case thrust::tuning::tbb_radix_sort_threshold:    return 128 * 1024;
+    case thrust::tuning::tbb_reduce_by_key_threshold: return 10000;
+    case thrust::tuning::generic_find_interval_size:  return 1 << 20;
+    case thrust::tuning::merge_sort_partition_size:   return 32;
+    default:                                          return 0;
+  }
+}
+
+
+inline bool is_separator(char c)
+{
+  return c == ',' || c == ';' || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+
+inline bool is_number(const std::string &s)
+{
+  return !s.empty() && s[0] >= '0' && s[0] <= '9';
+}
+
+
+struct table
+{
+  // 0 stands for the default
+  std::size_t values[thrust::tuning::num_parameters][num_size_classes];
+
+  table()
+  {
+    clear();
+
+    if(const char * path = std::getenv("THRUST_TUNING_FILE"))
+    {
+      load(path);
+    }
+
+    if(const char * entries = std::getenv("THRUST_TUNING"))
+    {
+      parse(entries);
+    }
+  }
+
+  void clear()
+  {
+    std::memset(values, 0, sizeof(values));
+  }
+
+  void set(thrust::tuning::parameter p, std::size_t size_class, std::size_t value)
+  {
+    if(p < thrust::tuning::num_parameters && size_class < num_size_classes)
+    {
+      values[p][size_class] = value;
+    }
+  }
+
+  // applies an entry, name=value or name.size=value
+  bool parse_entry(const std::string &entry)
+  {
+    std::string::size_type equals = entry.find('=');
+    if(equals == std::string::npos) return false;
+
+    std::string key = entry.substr(0, equals);
+    std::string::size_type dot = key.find('.');
+
+    char * end;
+
+    const std::string value_string = entry.substr(equals + 1);
+    const unsigned long value = std::strtoul(value_string.c_str(), &end, 10);
+    if(!is_number(value_string) || *end != '\0') return false;
+
+    std::size_t element_size = 0;
+
+    if(dot != std::string::npos)
+    {
+      const std::string size_string = key.substr(dot + 1);
+      element_size = static_cast<std::size_t>(std::strtoul(size_string.c_str(), &end, 10));
+      if(!is_number(size_string) || *end != '\0' || element_size == 0) return false;
+
+      key.erase(dot);
+    }
+
+    for(int p = 0; p < thrust::tuning::num_parameters; ++p)
+    {
+      if(key == thrust::tuning::name(thrust::tuning::parameter(p)))
+      {
+        for(std::size_t c = 0; c < num_size_classes; ++c)
+        {
+          if(element_size == 0 || c == size_class(element_size))
+          {
+            set(thrust::tuning::parameter(p), c, static_cast<std::size_t>(value));
+          }
+        }
+
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  bool parse(const char * entries)
+  {
+    bool result = true;
+
+    while(*entries)
+    {
+      while(*entries && is_separator(*entries)) ++entries;
+
+      const char * last = entries;
+      while(*last && !is_separator(*last)) ++last;
+
+      if(last != entries)
+      {
+        result = parse_entry(std::string(entries, last)) && result;
+      }
+
+      entries = last;
+    }
+
+    return result;
+  }
+
+  bool load(const char * path)
+  {
+    std::FILE * file = std::fopen(path, "r");
+    if(!file) return false;
+
+    bool result = true;
+    char line[256];
+
+    while(std::fgets(line, sizeof(line), file))
+    {
+      const char * first = line;
+      while(*first == ' ' || *first == '\t') ++first;
+
+      if(*first != '#')
+      {
+        result = parse(first) && result;
+      }
+    }
+
+    result = !std::ferror(file) && result;
+    std::fclose(file);
+
+    return result;
+  }
+
+  bool save(const char * path) const
+  {
+    std::FILE * file = std::fopen(path, "w");
+    if(!file) return false;
+
+    std::fprintf(file, "# thrust tuning table\n");
+
+    for(int p = 0; p < thrust::tuning::num_parameters; ++p)
+    {
+      for(std::size_t c = 0; c < num_size_classes; ++c)
+      {
+        if(values[p][c] != 0)
+        {
+          std::fprintf(file, "%s.%lu=%lu\n", thrust::tuning::name(thrust::tuning::parameter(p)),
+                       static_cast<unsigned long>(std::size_t(1) << c), static_cast<unsigned long>(values[p][c]));
+        }
+      }
+    }
+
+    const bool result = !std::ferror(file);
+    return (std::fclose(file) == 0) && result;
+  }
+};
+
+
+inline table &get_table()
+{
+  static table t;
+  return t;
+}
+
+
+} // end tuning_detail
+} // end detail
+
+
+namespace tuning
+{
+
+
+inline const char * name(parameter p)
+{
+  switch(p)
+  {
+    case tbb_merge_sort_leaf_size:    return "tbb_merge_sort_leaf_size";
+    case tbb_radix_sort_threshold:    return "tbb_radix_sort_threshold";
+    case tbb_reduce_by_key_threshold: return "tbb_reduce_by_key_threshold";
+    case generic_find_interval_size:  return "generic_find_interval_size";
+    case merge_sort_partition_size:   return "merge_sort_partition_size";
+    default:                          return "";
+  }
+}
+
+
+inline std::size_t get(parameter p, std::size_t element_size)
+{
+  if(p >= num_parameters) return 0;
+
+  const std::size_t value =
+    thrust::detail::tuning_detail::get_table().values[p][thrust::detail::tuning_detail::size_class(element_size)];
+
+  return value != 0 ? value : thrust::detail::tuning_detail::default_value(p);
+}
+
+
+inline void set(parameter p, std::size_t value)
+{
+  for(std::size_t c = 0; c < thrust::detail::tuning_detail::num_size_classes; ++c)
+  {
+    thrust::detail::tuning_detail::get_table().set(p, c, value);
+  }
+}
+
+
+inline void set(parameter p, std::size_t element_size, std::size_t value)
+{
+  thrust::detail::tuning_detail::get_table().set(p, thrust::detail::tuning_detail::size_class(element_size), value);
+}
+
+
+inline void reset()
+{
+  thrust::detail::tuning_detail::get_table().clear();
+}
+
+
+inline bool parse(const char * entries)
+{
+  return thrust::detail::tuning_detail::get_table().parse(entries);
+}
+
+
+inline bool load(const char * path)
+{
+  return thrust::detail::tuning_detail::get_table().load(path);
+}
+
+
+inline bool save(const char * path)
+{
+  return thrust::detail::tuning_detail::get_table().save(path);
+}
+
+
+} // end tuning
+} // end thrust
+
@@ -0,0 +1,173 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file mapped_vector.h
+ *  \brief A fixed-size array of elements which reside in a memory mapped file
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/mr/file.h>
+
+#if !defined(_WIN32)
+
+#include <thrust/detail/type_traits/pointer_traits.h>
+#include <thrust/iterator/iterator_traits.h>
+
+namespace thrust
+{
+
+/*! \addtogroup container_classes Container Classes
+ *  \addtogroup host_containers Host Containers
+ *  \ingroup container_classes
+ *  \{
+ */
+
+/*! A \p mapped_vector is a fixed-size array whose elements are the contents of a file, mapped into memory by a
+ *      \p thrust::mr::file_memory_resource. Nothing is read upfront: the elements are paged in as they are accessed, so
+ *      algorithms can run directly on data sets kept on disk, e.g.
+ *      <tt>thrust::sort(thrust::omp::par, v.begin(), v.end())</tt> sorts a file in place when it is mapped shared.
+ *
+ *  The elements are the file's bytes reinterpreted, so \p T must be trivially copyable, and the file must have been
+ *      written in the machine's representation of \p T. The iterators are of type \p Pointer, which selects the system
+ *      algorithms dispatch to; e.g. \p thrust::omp::pointer<T> makes them run with OpenMP without an explicit policy.
+ *
+ *  \tparam T the type of the elements
+ *  \tparam Pointer the type of pointer to the elements
+ */
+template<typename T, typename Pointer = T *>
+  class mapped_vector
+{
+  public:
+    typedef T value_type;
+    typedef Pointer pointer;
+    typedef typename thrust::detail::pointer_traits<Pointer>::template rebind<const T>::other const_pointer;
+    typedef typename thrust::iterator_reference<pointer>::type reference;
+    typedef typename thrust::iterator_reference<const_pointer>::type const_reference;
+    typedef pointer iterator;
+    typedef const_pointer const_iterator;
+    typedef std::size_t size_type;
+
+    /*! Maps the whole contents of a file. Any trailing bytes that do not make up a whole element are not mapped.
+     *
+     *  \param path the path of the file
+     *  \param options the options of the mapping
+     *  \throws thrust::system_error if the file cannot be opened
+     */
+    explicit mapped_vector(const char * path,
+                           thrust::mr::file_mapping_options options = thrust::mr::file_mapping_options())
+      : m_resource(path, options), m_data(NULL), m_size(m_resource.file_size() / sizeof(T))
+    {
+      map();
+    }
+
+    /*! Maps the first \p n elements of a file, creating or extending it if needed. Elements beyond the previous end of
+     *      the file are zero.
+     *
+     *  \param path the path of the file
+     *  \param n the number of elements
+     *  \param options the options of the mapping
+     *  \throws thrust::system_error if the file cannot be opened
+     */
+    mapped_vector(const char * path, size_type n,
+                  thrust::mr::file_mapping_options options = thrust::mr::file_mapping_options())
+      : m_resource(path, options), m_data(NULL), m_size(n)
+    {
+      map();
+    }
+
+    /*! The destructor unmaps the file, flushing the writes first if the options ask for it.
+     */
+    ~mapped_vector()
+    {
+      if(m_data)
+      {
+        m_resource.do_deallocate(m_data, m_size * sizeof(T), THRUST_ALIGNOF(T));
+      }
+    }
+
+    size_type size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+    pointer data() { return pointer(m_data); }
+
+    const_pointer data() const { return const_pointer(m_data); }
+
+    iterator begin() { return data(); }
+
+    const_iterator begin() const { return data(); }
+
+    const_iterator cbegin() const { return data(); }
+
+    iterator end() { return data() + m_size; }
+
+    const_iterator end() const { return data() + m_size; }
+
+    const_iterator cend() const { return data() + m_size; }
+
+    reference operator[](size_type n) { return begin()[n]; }
+
+    const_reference operator[](size_type n) const { return begin()[n]; }
+
+    /*! Flushes the writes to the elements to the file, and waits for them to complete.
+     */
+    void sync()
+    {
+      if(m_data)
+      {
+        m_resource.sync(m_data, m_size * sizeof(T));
+      }
+    }
+
+    /*! Advises the system about the order in which the elements are going to be accessed, e.g. \p random_access before
+     *      a pass of binary searches.
+     *
+     *  \param access the expected order of accesses
+     */
+    void advise(thrust::mr::file_access_pattern access)
+    {
+      if(m_data)
+      {
+        m_resource.advise(m_data, m_size * sizeof(T), access);
+      }
+    }
+
+  private:
+    // not copyable, since the elements are the file's contents
+    mapped_vector(const mapped_vector &);
+    mapped_vector & operator=(const mapped_vector &);
+
+    void map()
+    {
+      if(m_size != 0)
+      {
+        m_data = static_cast<T *>(m_resource.do_allocate(m_size * sizeof(T), THRUST_ALIGNOF(T)));
+      }
+    }
+
+    thrust::mr::file_memory_resource m_resource;
+    T * m_data;
+    size_type m_size;
+};
+
+/*! \}
+ */
+
+} // end thrust
+
+#endif
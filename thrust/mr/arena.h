@@ -0,0 +1,373 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file arena.h
+ *  \brief A thread-safe monotonic memory resource adaptor for short-lived scratch memory, such as the temporary storage
+ *      of algorithms, which is bump-allocated from large blocks and released in bulk.
+ */
+
+#pragma once
+
+#include <thrust/detail/cpp11_required.h>
+
+#if __cplusplus >= 201103L
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <thrust/detail/type_traits/pointer_traits.h>
+
+#include <thrust/mr/memory_resource.h>
+#include <thrust/mr/validator.h>
+
+namespace thrust
+{
+namespace mr
+{
+
+/*! \addtogroup memory_management Memory Management
+ *  \addtogroup memory_management_classes Memory Management Classes
+ *  \addtogroup memory_resources Memory Resources
+ *  \ingroup memory_resources
+ *  \{
+ */
+
+/*! A memory resource adaptor which bump-allocates memory from large blocks obtained from \p Upstream, and only returns
+ *      them when \p reset or \p release is called. Deallocations are free: the most recent allocation of a thread is
+ *      rolled back, so that scratch memory used in a stack-like fashion is reused right away, and any other deallocation
+ *      does nothing. Uses \p std::atomic and \p thread_local, and therefore requires C++11.
+ *
+ *  Attaching an arena to an execution policy makes the temporary storage of algorithms come from it:
+ *
+ *  \code
+ *  thrust::mr::arena_resource<thrust::mr::new_delete_resource> arena;
+ *  for (int i = 0; i < iterations; ++i)
+ *  {
+ *      thrust::sort(thrust::omp::par(&arena), keys.begin(), keys.end());
+ *      thrust::reduce(thrust::omp::par(&arena), values.begin(), values.end());
+ *      arena.reset();
+ *  }
+ *  \endcode
+ *
+ *  Each thread allocates from its own subarena, so temporaries created inside parallel regions don't contend; threads
+ *      are mapped onto as many subarenas as \p std::thread::hardware_concurrency reports, and at least
+ *      \p min_subarenas. Threads which share a subarena remain correct, since the bump pointers are atomic.
+ *
+ *  \tparam Upstream the type of memory resources that will be used for allocating memory blocks
+ */
+template<typename Upstream>
+class arena_resource THRUST_FINAL
+    : public memory_resource<typename Upstream::pointer>,
+        private validator<Upstream>
+{
+    typedef typename Upstream::pointer void_ptr;
+    typedef std::lock_guard<std::mutex> lock_t;
+
+    struct block
+    {
+        void_ptr memory;
+        char * begin;
+        std::size_t size;
+        std::size_t alignment;
+        std::atomic<std::size_t> used;
+    };
+
+    struct subarena
+    {
+        std::atomic<block *> current;
+        // the size of the next block of this subarena, and of its blocks since the last reset; guarded by m_mtx
+        std::size_t next_block_size;
+        std::size_t held_bytes;
+        // keep the bump pointers of different threads on different cache lines
+        char padding[64];
+    };
+
+public:
+    /*! The size of the first block allocated from upstream, unless a bigger allocation is requested.
+     */
+    static const std::size_t default_initial_block_size = std::size_t(1) << 16;
+    /*! The minimal number of subarenas.
+     */
+    static const std::size_t min_subarenas = 8;
+    /*! The size beyond which blocks stop doubling; bigger blocks are only allocated for bigger requests.
+     */
+    static const std::size_t max_block_size = (std::numeric_limits<std::size_t>::max() >> 2) + 1;
+
+    /*! Constructor.
+     *
+     *  \param upstream the upstream memory resource for allocations
+     *  \param initial_block_size the size of the first block of each subarena; each following block of a subarena is
+     *      twice as big as its previous one
+     */
+    arena_resource(Upstream * upstream, std::size_t initial_block_size = default_initial_block_size)
+        : m_upstream(upstream)
+    {
+        if (initial_block_size == 0)
+        {
+            initial_block_size = 1;
+        }
+        if (initial_block_size > max_block_size)
+        {
+            initial_block_size = max_block_size;
+        }
+
+        std::size_t num_subarenas = static_cast<std::size_t>(std::thread::hardware_concurrency());
+        if (num_subarenas < min_subarenas)
+        {
+            num_subarenas = min_subarenas;
+        }
+
+        m_subarenas.reset(new subarena[num_subarenas]);
+        m_num_subarenas = num_subarenas;
+
+        for (std::size_t i = 0; i < m_num_subarenas; ++i)
+        {
+            m_subarenas[i].current.store(NULL);
+            m_subarenas[i].next_block_size = initial_block_size;
+            m_subarenas[i].held_bytes = 0;
+        }
+    }
+
+    /*! Constructor. The upstream resource is obtained by calling \p get_global_resource<Upstream>.
+     *
+     *  \param initial_block_size the size of the first block of each subarena; each following block of a subarena is
+     *      twice as big as its previous one
+     */
+    arena_resource(std::size_t initial_block_size = default_initial_block_size)
+        : arena_resource(get_global_resource<Upstream>(), initial_block_size)
+    {
+    }
+
+    /*! Destructor. Releases all held memory to upstream.
+     */
+    ~arena_resource()
+    {
+        release();
+    }
+
+    /*! Releases all held memory to upstream. Must not be called concurrently with allocations and deallocations, and
+     *      invalidates all memory allocated from the arena.
+     */
+    void release()
+    {
+        for (std::size_t i = 0; i < m_num_subarenas; ++i)
+        {
+            m_subarenas[i].current.store(NULL);
+            m_subarenas[i].held_bytes = 0;
+        }
+
+        for (std::size_t i = 0; i < m_blocks.size(); ++i)
+        {
+            deallocate_block(m_blocks[i]);
+        }
+        m_blocks.clear();
+    }
+
+    /*! Makes all memory of the arena available for allocation again, invalidating all memory allocated from it. If no
+     *      subarena outgrew its block since the last reset, the blocks are kept; otherwise they are all returned to
+     *      upstream, and the next block of each subarena is made as big as all of its blocks together, so that an arena
+     *      reset after every iteration of a loop settles on blocks big enough for a whole iteration. Must not be called
+     *      concurrently with allocations and deallocations.
+     */
+    void reset()
+    {
+        std::size_t current_blocks = 0;
+        for (std::size_t i = 0; i < m_num_subarenas; ++i)
+        {
+            block * current = m_subarenas[i].current.load();
+            if (current)
+            {
+                current->used.store(0);
+                ++current_blocks;
+            }
+        }
+
+        if (current_blocks == m_blocks.size())
+        {
+            return;
+        }
+
+        for (std::size_t i = 0; i < m_num_subarenas; ++i)
+        {
+            subarena & s = m_subarenas[i];
+            if (s.next_block_size < s.held_bytes)
+            {
+                s.next_block_size = s.held_bytes;
+            }
+            if (s.next_block_size > max_block_size)
+            {
+                s.next_block_size = max_block_size;
+            }
+        }
+
+        release();
+    }
+
+    /*! Returns the number of bytes currently held from upstream.
+     */
+    std::size_t upstream_bytes()
+    {
+        lock_t lock(m_mtx);
+
+        std::size_t ret = 0;
+        for (std::size_t i = 0; i < m_blocks.size(); ++i)
+        {
+            ret += m_blocks[i]->size;
+        }
+        return ret;
+    }
+
+    THRUST_NODISCARD virtual void_ptr do_allocate(std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        subarena & local = local_subarena();
+
+        while (true)
+        {
+            block * current = local.current.load(std::memory_order_acquire);
+
+            if (current)
+            {
+                std::size_t address = reinterpret_cast<std::size_t>(current->begin);
+                std::size_t used = current->used.load(std::memory_order_relaxed);
+
+                while (true)
+                {
+                    std::size_t start = (address + used + alignment - 1) / alignment * alignment - address;
+                    if (start + bytes > current->size)
+                    {
+                        break;
+                    }
+
+                    if (current->used.compare_exchange_weak(used, start + bytes, std::memory_order_relaxed))
+                    {
+                        return void_ptr(static_cast<void *>(current->begin + start));
+                    }
+                }
+            }
+
+            grow(local, current, bytes, alignment);
+        }
+    }
+
+    virtual void do_deallocate(void_ptr p, std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        (void)alignment;
+
+        block * current = local_subarena().current.load(std::memory_order_acquire);
+        if (!current)
+        {
+            return;
+        }
+
+        char * ptr = static_cast<char *>(thrust::detail::pointer_traits<void_ptr>::get(p));
+        if (ptr < current->begin || ptr + bytes > current->begin + current->size)
+        {
+            return;
+        }
+
+        // roll back the most recent allocation from this block; anything else is released in bulk
+        std::size_t end = ptr + bytes - current->begin;
+        current->used.compare_exchange_strong(end, ptr - current->begin, std::memory_order_relaxed);
+    }
+
+private:
+    // a small integer identifying the calling thread, assigned on its first use of any arena
+    static std::size_t thread_index()
+    {
+        static std::atomic<std::size_t> next_index(0);
+        static thread_local std::size_t index = next_index++;
+        return index;
+    }
+
+    subarena & local_subarena()
+    {
+        return m_subarenas[thread_index() % m_num_subarenas];
+    }
+
+    // replaces the full block of a subarena with one big enough for the request, unless another thread sharing the
+    // subarena already did
+    void grow(subarena & local, block * full, std::size_t bytes, std::size_t alignment)
+    {
+        lock_t lock(m_mtx);
+
+        if (local.current.load(std::memory_order_relaxed) != full)
+        {
+            return;
+        }
+
+        // double up to max_block_size; a bigger request gets a block of exactly its size
+        std::size_t size = local.next_block_size;
+        while (size < bytes && size <= max_block_size / 2)
+        {
+            size *= 2;
+        }
+        if (size < bytes)
+        {
+            size = bytes;
+        }
+
+        if (alignment < THRUST_MR_DEFAULT_ALIGNMENT)
+        {
+            alignment = THRUST_MR_DEFAULT_ALIGNMENT;
+        }
+
+        // nothing changes if upstream throws
+        std::unique_ptr<block> fresh(new block);
+        m_blocks.reserve(m_blocks.size() + 1);
+
+        fresh->memory = m_upstream->do_allocate(size, alignment);
+        fresh->begin = static_cast<char *>(thrust::detail::pointer_traits<void_ptr>::get(fresh->memory));
+        fresh->size = size;
+        fresh->alignment = alignment;
+        fresh->used.store(0, std::memory_order_relaxed);
+
+        local.next_block_size = max_block_size;
+        if (size <= max_block_size / 2)
+        {
+            local.next_block_size = size * 2;
+        }
+        local.held_bytes += size;
+
+        m_blocks.push_back(fresh.get());
+        local.current.store(fresh.release(), std::memory_order_release);
+    }
+
+    void deallocate_block(block * b)
+    {
+        m_upstream->do_deallocate(b->memory, b->size, b->alignment);
+        delete b;
+    }
+
+    Upstream * m_upstream;
+
+    std::mutex m_mtx;
+    std::vector<block *> m_blocks;
+
+    std::unique_ptr<subarena[]> m_subarenas;
+    std::size_t m_num_subarenas;
+};
+
+/*! \}
+ */
+
+} // end mr
+} // end thrust
+
+#endif
@@ -0,0 +1,391 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file cached_block_index.h
+ *  \brief An ordered index of the cached oversized blocks of the pool resources, by size and alignment.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/detail/integer_math.h>
+#include <thrust/host_vector.h>
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace thrust
+{
+namespace mr
+{
+
+namespace cached_block_index_detail
+{
+
+// the vector of the nodes: a host_vector, which supports the fancy pointers of the bookkeeping resources, except with
+// std::allocator, which lacks the members host_vector requires since C++20
+template<typename T, typename Allocator>
+struct node_vector
+{
+    typedef thrust::host_vector<T, Allocator> type;
+};
+
+template<typename T>
+struct node_vector<T, std::allocator<T> >
+{
+    typedef std::vector<T> type;
+};
+
+} // end cached_block_index_detail
+
+/*! The cached oversized blocks of a pool resource, in buckets of one size and alignment each. A bucket only records the
+ *      most recently cached of its blocks, its head; the pool links the others through its own descriptors.
+ *
+ *  The buckets which hold a block form a treap ordered by alignment, then by size, whose nodes are kept in a vector
+ *      allocated with \p Allocator; a bucket is erased as soon as it is emptied. Finding the best fitting bucket for a
+ *      request takes one search per alignment within the cutoff, each logarithmic in the number of buckets, however
+ *      many distinct sizes are cached.
+ *
+ *  \tparam Handle the type of the head of a bucket
+ *  \tparam Allocator an allocator, rebound to allocate the nodes
+ */
+template<typename Handle, typename Allocator>
+class cached_block_index
+{
+public:
+    /*! The position of no bucket.
+     */
+    static const std::size_t npos = ~std::size_t(0);
+
+    cached_block_index(const Allocator & alloc = Allocator())
+        : m_nodes(node_allocator(alloc)), m_root(npos), m_free(npos), m_size(0)
+    {
+    }
+
+    /*! Returns the number of buckets.
+     */
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /*! Erases every bucket.
+     */
+    void clear()
+    {
+        m_nodes.clear();
+        m_root = npos;
+        m_free = npos;
+        m_size = 0;
+    }
+
+    std::size_t bucket_size(std::size_t position) const
+    {
+        return m_nodes[position].size;
+    }
+
+    std::size_t bucket_alignment(std::size_t position) const
+    {
+        return m_nodes[position].alignment;
+    }
+
+    Handle head(std::size_t position) const
+    {
+        return m_nodes[position].head;
+    }
+
+    void set_head(std::size_t position, Handle head)
+    {
+        m_nodes[position].head = head;
+    }
+
+    /*! Returns the position of the bucket of a size and alignment, or \p npos if there is none. Positions remain valid
+     *      until their bucket is erased.
+     */
+    std::size_t find(std::size_t size, std::size_t alignment) const
+    {
+        std::size_t position = lower_bound(size, alignment);
+
+        if (position != npos && m_nodes[position].size == size && m_nodes[position].alignment == alignment)
+        {
+            return position;
+        }
+
+        return npos;
+    }
+
+    /*! Returns the position of the bucket of the smallest size, and then alignment, which serves a request: its size is
+     *      at least \p size and smaller than \p size times \p size_cutoff_factor, and likewise for its alignment. Returns
+     *      \p npos if there is no such bucket.
+     */
+    std::size_t find_best_fit(std::size_t size, std::size_t alignment,
+        std::size_t size_cutoff_factor, std::size_t alignment_cutoff_factor) const
+    {
+        if (m_root == npos)
+        {
+            return npos;
+        }
+
+        std::size_t largest_alignment = m_nodes[last()].alignment;
+        std::size_t best = npos;
+
+        // the alignments are powers of two; one search finds the smallest fitting size of each
+        for (std::size_t a = alignment; a != 0 && a <= largest_alignment && a / alignment < alignment_cutoff_factor; a *= 2)
+        {
+            std::size_t position = lower_bound(size, a);
+            if (position == npos)
+            {
+                break;
+            }
+
+            const node & candidate = m_nodes[position];
+            if (candidate.alignment != a || candidate.size / size >= size_cutoff_factor)
+            {
+                continue;
+            }
+
+            if (best == npos || candidate.size < m_nodes[best].size)
+            {
+                best = position;
+            }
+        }
+
+        return best;
+    }
+
+    /*! Adds a bucket of a size and alignment, which must not exist, and returns its position.
+     */
+    std::size_t insert(std::size_t size, std::size_t alignment, Handle head)
+    {
+        node n;
+        n.size = size;
+        n.alignment = alignment;
+        n.head = head;
+        n.priority = priority(size, alignment);
+        n.left = npos;
+        n.right = npos;
+
+        std::size_t position = m_free;
+        if (position != npos)
+        {
+            m_free = m_nodes[position].left;
+            m_nodes[position] = n;
+        }
+        else
+        {
+            m_nodes.push_back(n);
+            position = m_nodes.size() - 1;
+        }
+
+        std::size_t less, greater;
+        split(m_root, size, alignment, false, less, greater);
+        m_root = merge(merge(less, position), greater);
+        ++m_size;
+
+        return position;
+    }
+
+    /*! Erases the bucket at a position.
+     */
+    void erase(std::size_t position)
+    {
+        std::size_t size = m_nodes[position].size;
+        std::size_t alignment = m_nodes[position].alignment;
+
+        std::size_t less, rest, equal, greater;
+        split(m_root, size, alignment, false, less, rest);
+        split(rest, size, alignment, true, equal, greater);
+        assert(equal == position);
+
+        m_root = merge(less, greater);
+        --m_size;
+
+        m_nodes[position].left = m_free;
+        m_free = position;
+    }
+
+    /*! Returns the position of the first bucket, or \p npos; the buckets are visited in order of alignment, then size.
+     */
+    std::size_t first() const
+    {
+        std::size_t position = m_root;
+        while (position != npos && m_nodes[position].left != npos)
+        {
+            position = m_nodes[position].left;
+        }
+        return position;
+    }
+
+    /*! Returns the position of the bucket following the one at \p position, or \p npos.
+     */
+    std::size_t next(std::size_t position) const
+    {
+        std::size_t size = m_nodes[position].size;
+        std::size_t alignment = m_nodes[position].alignment;
+
+        std::size_t result = npos;
+        for (std::size_t i = m_root; i != npos; )
+        {
+            if (precedes(size, alignment, m_nodes[i]))
+            {
+                result = i;
+                i = m_nodes[i].left;
+            }
+            else
+            {
+                i = m_nodes[i].right;
+            }
+        }
+        return result;
+    }
+
+private:
+    struct node
+    {
+        std::size_t size;
+        std::size_t alignment;
+        Handle head;
+        std::size_t priority;
+        // the children, or npos; for a free node, left links the free list
+        std::size_t left;
+        std::size_t right;
+    };
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<node> node_allocator;
+    typedef typename cached_block_index_detail::node_vector<node, node_allocator>::type node_vector;
+
+    node_vector m_nodes;
+    std::size_t m_root;
+    std::size_t m_free;
+    std::size_t m_size;
+
+    // whether the key (size, alignment) comes before the key of n
+    static bool precedes(std::size_t size, std::size_t alignment, const node & n)
+    {
+        return alignment < n.alignment || (alignment == n.alignment && size < n.size);
+    }
+
+    // the priority of a key; a hash, so that the treap is balanced whatever order the buckets are inserted in
+    static std::size_t priority(std::size_t size, std::size_t alignment)
+    {
+        std::size_t hash = size ^ (thrust::detail::log2(alignment) << (sizeof(std::size_t) * 8 - 6));
+
+        hash ^= hash >> 16;
+        hash *= 0x45d9f3b;
+        hash ^= hash >> 16;
+        hash *= 0x45d9f3b;
+        hash ^= hash >> 16;
+
+        return hash;
+    }
+
+    // returns the position of the first bucket whose key is not before (size, alignment), or npos
+    std::size_t lower_bound(std::size_t size, std::size_t alignment) const
+    {
+        std::size_t result = npos;
+        for (std::size_t i = m_root; i != npos; )
+        {
+            const node & n = m_nodes[i];
+            if (n.alignment < alignment || (n.alignment == alignment && n.size < size))
+            {
+                i = n.right;
+            }
+            else
+            {
+                result = i;
+                i = n.left;
+            }
+        }
+        return result;
+    }
+
+    std::size_t last() const
+    {
+        std::size_t position = m_root;
+        while (position != npos && m_nodes[position].right != npos)
+        {
+            position = m_nodes[position].right;
+        }
+        return position;
+    }
+
+    // splits the treap rooted at t into the nodes before the key (size, alignment), or also those equal to it when
+    // inclusive is true, and the others
+    void split(std::size_t t, std::size_t size, std::size_t alignment, bool inclusive,
+        std::size_t & before, std::size_t & after)
+    {
+        if (t == npos)
+        {
+            before = npos;
+            after = npos;
+            return;
+        }
+
+        node & n = m_nodes[t];
+        bool goes_before = inclusive ? !precedes(size, alignment, n)
+            : (n.alignment < alignment || (n.alignment == alignment && n.size < size));
+
+        if (goes_before)
+        {
+            std::size_t right = n.right;
+            split(right, size, alignment, inclusive, m_nodes[t].right, after);
+            before = t;
+        }
+        else
+        {
+            std::size_t left = n.left;
+            split(left, size, alignment, inclusive, before, m_nodes[t].left);
+            after = t;
+        }
+    }
+
+    // merges two treaps, every key of the first of which comes before every key of the second
+    std::size_t merge(std::size_t first, std::size_t second)
+    {
+        if (first == npos)
+        {
+            return second;
+        }
+        if (second == npos)
+        {
+            return first;
+        }
+
+        if (m_nodes[first].priority > m_nodes[second].priority)
+        {
+            std::size_t right = merge(m_nodes[first].right, second);
+            m_nodes[first].right = right;
+            return first;
+        }
+
+        std::size_t left = merge(first, m_nodes[second].left);
+        m_nodes[second].left = left;
+        return second;
+    }
+};
+
+template<typename Handle, typename Allocator>
+const std::size_t cached_block_index<Handle, Allocator>::npos;
+
+} // end mr
+} // end thrust
+
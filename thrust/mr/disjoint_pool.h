@@ -29,6 +29,8 @@
 #include <thrust/mr/memory_resource.h>
 #include <thrust/mr/allocator.h>
 #include <thrust/mr/pool_options.h>
+#include <thrust/mr/statistics.h>
+#include <thrust/mr/detail/cached_block_index.h>
 
 #include <cassert>
 
@@ -114,8 +116,9 @@ public:
         m_smallest_block_log2(detail::log2_ri(m_options.smallest_block_size)),
         m_pools(m_bookkeeper),
         m_allocated(m_bookkeeper),
+        m_cached(m_bookkeeper),
         m_oversized(m_bookkeeper),
-        m_cached_oversized(m_bookkeeper)
+        m_oversized_index(m_bookkeeper)
     {
         assert(m_options.validate());
 
@@ -137,8 +140,9 @@ public:
         m_smallest_block_log2(detail::log2_ri(m_options.smallest_block_size)),
         m_pools(m_bookkeeper),
         m_allocated(m_bookkeeper),
+        m_cached(m_bookkeeper),
         m_oversized(m_bookkeeper),
-        m_cached_oversized(m_bookkeeper)
+        m_oversized_index(m_bookkeeper)
     {
         assert(m_options.validate());
 
@@ -174,54 +178,14 @@ private:
         std::size_t size;
         std::size_t alignment;
         void_ptr pointer;
+        // the position in m_oversized of the next block in the same cached bucket, or empty_slot
+        std::size_t next_cached;
 
         __host__ __device__
         bool operator==(const oversized_block_descriptor & other) const
         {
             return size == other.size && alignment == other.alignment && pointer == other.pointer;
         }
-
-        __host__ __device__
-        bool operator<(const oversized_block_descriptor & other) const
-        {
-            return size < other.size || (size == other.size && alignment < other.alignment);
-        }
-    };
-
-    struct equal_pointers
-    {
-    public:
-        __host__ __device__
-        equal_pointers(void_ptr p) : p(p)
-        {
-        }
-
-        __host__ __device__
-        bool operator()(const oversized_block_descriptor & desc) const
-        {
-            return desc.pointer == p;
-        }
-
-    private:
-        void_ptr p;
-    };
-
-    struct matching_alignment
-    {
-    public:
-        __host__ __device__
-        matching_alignment(std::size_t requested) : requested(requested)
-        {
-        }
-
-        __host__ __device__
-        bool operator()(const oversized_block_descriptor & desc) const
-        {
-            return desc.alignment >= requested;
-        }
-
-    private:
-        std::size_t requested;
     };
 
     typedef thrust::host_vector<
@@ -234,6 +198,20 @@ private:
         allocator<void_ptr, Bookkeeper>
     > pointer_vector;
 
+    struct index_slot
+    {
+        void_ptr pointer;
+        // the position of the block's descriptor in m_oversized, or empty_slot
+        std::size_t position;
+    };
+
+    typedef thrust::host_vector<
+        index_slot,
+        allocator<index_slot, Bookkeeper>
+    > index_vector;
+
+    static const std::size_t empty_slot = ~std::size_t(0);
+
     struct pool
     {
         __host__
@@ -272,10 +250,18 @@ private:
     pool_vector m_pools;
     // list of all allocations from upstream for the above
     chunk_vector m_allocated;
-    // list of all cached oversized/overaligned blocks that have been returned to the pool to cache
-    oversized_block_vector m_cached_oversized;
+    // buckets of the cached oversized/overaligned blocks that have been returned to the pool, one for each size and
+    // alignment which has a cached block; each holds a free list of positions in m_oversized, linked through their
+    // next_cached
+    typedef cached_block_index<std::size_t, allocator<char, Bookkeeper> > cached_index;
+    cached_index m_cached;
     // list of all oversized/overaligned allocations from upstream
     oversized_block_vector m_oversized;
+    // hash table mapping the pointers of the blocks in m_oversized to their positions; uses open addressing with linear
+    // probing, its size is a power of two, and it is kept at most half full
+    index_vector m_oversized_index;
+
+    allocation_statistics m_statistics;
 
 public:
     /*! Releases all held memory to upstream.
@@ -292,7 +278,7 @@ public:
         // deallocate memory allocated for the buckets
         for (std::size_t i = 0; i < m_allocated.size(); ++i)
         {
-            m_upstream->do_deallocate(
+            upstream_deallocate(
                 m_allocated[i].pointer,
                 m_allocated[i].size,
                 m_options.alignment);
@@ -301,7 +287,7 @@ public:
         // deallocate cached oversized/overaligned memory
         for (std::size_t i = 0; i < m_oversized.size(); ++i)
         {
-            m_upstream->do_deallocate(
+            upstream_deallocate(
                 m_oversized[i].pointer,
                 m_oversized[i].size,
                 m_oversized[i].alignment);
@@ -309,12 +295,15 @@ public:
 
         m_allocated.clear();
         m_oversized.clear();
-        m_cached_oversized.clear();
+        m_cached.clear();
+        m_oversized_index.clear();
     }
 
     THRUST_NODISCARD virtual void_ptr do_allocate(std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
     {
+        std::size_t requested = bytes;
         bytes = (std::max)(bytes, m_options.smallest_block_size);
+        m_statistics.record_allocation(requested, bytes);
         assert(detail::is_power_of_2(alignment));
 
         // an oversized and/or overaligned allocation requested; needs to be allocated separately
@@ -324,54 +313,39 @@ public:
             oversized.size = bytes;
             oversized.alignment = alignment;
 
-            if (m_options.cache_oversized && !m_cached_oversized.empty())
+            if (m_options.cache_oversized && !m_cached.empty())
             {
-                typename oversized_block_vector::iterator it = thrust::lower_bound(
-                    thrust::seq,
-                    m_cached_oversized.begin(),
-                    m_cached_oversized.end(),
-                    oversized);
-
-                // if the size is bigger than the requested size by a factor
-                // bigger than or equal to the specified cutoff for size,
-                // allocate a new block
-                if (it != m_cached_oversized.end())
-                {
-                    std::size_t size_factor = (*it).size / bytes;
-                    if (size_factor >= m_options.cached_size_cutoff_factor)
-                    {
-                        it = m_cached_oversized.end();
-                    }
-                }
+                std::size_t position = m_cached.find_best_fit(bytes, alignment,
+                    m_options.cached_size_cutoff_factor, m_options.cached_alignment_cutoff_factor);
 
-                if (it != m_cached_oversized.end() && (*it).alignment < alignment)
+                if (position != cached_index::npos)
                 {
-                    it = find_if(it + 1, m_cached_oversized.end(), matching_alignment(alignment));
-                }
+                    ++m_statistics.cache_hits[allocation_statistics::size_bin(bytes)];
 
-                // if the alignment is bigger than the requested one by a factor
-                // bigger than or equal to the specified cutoff for alignment,
-                // allocate a new block
-                if (it != m_cached_oversized.end())
-                {
-                    std::size_t alignment_factor = (*it).alignment / alignment;
-                    if (alignment_factor >= m_options.cached_alignment_cutoff_factor)
+                    // pop the bucket's most recently cached block, erasing the bucket if it was the last one
+                    oversized_block_descriptor & block = m_oversized[m_cached.head(position)];
+
+                    if (block.next_cached != empty_slot)
                     {
-                        it = m_cached_oversized.end();
+                        m_cached.set_head(position, block.next_cached);
+                    }
+                    else
+                    {
+                        m_cached.erase(position);
                     }
-                }
 
-                if (it != m_cached_oversized.end())
-                {
-                    oversized.pointer = (*it).pointer;
-                    m_cached_oversized.erase(it);
-                    return oversized.pointer;
+                    block.next_cached = empty_slot;
+
+                    return block.pointer;
                 }
             }
 
             // no fitting cached block found; allocate a new one that's just up to the specs
-            oversized.pointer = m_upstream->do_allocate(bytes, alignment);
+            ++m_statistics.cache_misses[allocation_statistics::size_bin(bytes)];
+            oversized.pointer = upstream_allocate(bytes, alignment);
+            oversized.next_cached = empty_slot;
             m_oversized.push_back(oversized);
+            index_oversized(m_oversized.size() - 1);
 
             return oversized.pointer;
         }
@@ -386,6 +360,8 @@ public:
         // and split it into blocks pushed to the free list
         if (bucket.free_blocks.empty())
         {
+            ++m_statistics.cache_misses[bytes_log2];
+
             std::size_t bucket_size = 1 << bytes_log2;
 
             std::size_t n = bucket.previous_allocated_count;
@@ -419,7 +395,7 @@ public:
 
             chunk_descriptor allocated;
             allocated.size = bytes;
-            allocated.pointer = m_upstream->do_allocate(bytes, m_options.alignment);
+            allocated.pointer = upstream_allocate(bytes, m_options.alignment);
             m_allocated.push_back(allocated);
             bucket.previous_allocated_count = n;
 
@@ -433,6 +409,11 @@ public:
             }
         }
 
+        else
+        {
+            ++m_statistics.cache_hits[bytes_log2];
+        }
+
         // allocate a block from the front of the bucket's free list
         void_ptr ret = bucket.free_blocks.back();
         bucket.free_blocks.pop_back();
@@ -441,6 +422,8 @@ public:
 
     virtual void do_deallocate(void_ptr p, std::size_t n, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
     {
+        m_statistics.record_deallocation(n);
+
         n = (std::max)(n, m_options.smallest_block_size);
         assert(detail::is_power_of_2(alignment));
 
@@ -450,21 +433,41 @@ public:
         // the deallocated block is oversized and/or overaligned
         if (n > m_options.largest_block_size || alignment > m_options.alignment)
         {
-            typename oversized_block_vector::iterator it = find_if(m_oversized.begin(), m_oversized.end(), equal_pointers(p));
-            assert(it != m_oversized.end());
+            std::size_t slot = find_oversized(p);
+            std::size_t position = m_oversized_index[slot].position;
 
-            oversized_block_descriptor oversized = *it;
+            oversized_block_descriptor oversized = m_oversized[position];
 
             if (m_options.cache_oversized)
             {
-                typename oversized_block_vector::iterator position = lower_bound(m_cached_oversized.begin(), m_cached_oversized.end(), oversized);
-                m_cached_oversized.insert(position, oversized);
+                // push the block to the front of the free list of the bucket of its size and alignment, adding the
+                // bucket if needed
+                std::size_t bucket_position = m_cached.find(oversized.size, oversized.alignment);
+                if (bucket_position == cached_index::npos)
+                {
+                    m_oversized[position].next_cached = empty_slot;
+                    m_cached.insert(oversized.size, oversized.alignment, position);
+                }
+                else
+                {
+                    m_oversized[position].next_cached = m_cached.head(bucket_position);
+                    m_cached.set_head(bucket_position, position);
+                }
+
                 return;
             }
 
-            m_oversized.erase(it);
+            unindex_oversized(slot);
+
+            // fill the gap with the last block, so that the positions of the other blocks remain valid
+            if (position != m_oversized.size() - 1)
+            {
+                m_oversized[position] = m_oversized.back();
+                m_oversized_index[find_oversized(m_oversized[position].pointer)].position = position;
+            }
+            m_oversized.pop_back();
 
-            m_upstream->do_deallocate(p, oversized.size, oversized.alignment);
+            upstream_deallocate(p, oversized.size, oversized.alignment);
 
             return;
         }
@@ -476,6 +479,131 @@ public:
 
         bucket.free_blocks.push_back(p);
     }
+
+    /*! Returns the statistics of the requests made so far. The buckets' size bins are the ones of their block sizes;
+     *      a miss is a request which had to allocate a new chunk, or a new oversized block, from upstream. The memory
+     *      allocated from the bookkeeper is not counted.
+     */
+    const allocation_statistics & statistics() const
+    {
+        return m_statistics;
+    }
+
+    /*! Resets the statistics, as described in \p allocation_statistics::reset_counters.
+     */
+    void reset_statistics()
+    {
+        m_statistics.reset_counters();
+    }
+
+private:
+    void_ptr upstream_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        void_ptr p = m_upstream->do_allocate(bytes, alignment);
+        m_statistics.record_upstream_allocation(bytes);
+        return p;
+    }
+
+    void upstream_deallocate(void_ptr p, std::size_t bytes, std::size_t alignment)
+    {
+        m_statistics.record_upstream_deallocation(bytes);
+        m_upstream->do_deallocate(p, bytes, alignment);
+    }
+
+    // the first slot of m_oversized_index to probe for a pointer
+    std::size_t index_home(void_ptr p) const
+    {
+        std::size_t hash = reinterpret_cast<std::size_t>(detail::pointer_traits<void_ptr>::get(p));
+
+        // the blocks are aligned, so mix the high bits into the low ones, which select the slot
+        hash ^= hash >> 16;
+        hash *= 0x45d9f3b;
+        hash ^= hash >> 16;
+
+        return hash & (m_oversized_index.size() - 1);
+    }
+
+    // returns the slot of m_oversized_index holding an oversized block
+    std::size_t find_oversized(void_ptr p) const
+    {
+        std::size_t mask = m_oversized_index.size() - 1;
+
+        for (std::size_t i = index_home(p); ; i = (i + 1) & mask)
+        {
+            assert(m_oversized_index[i].position != empty_slot);
+
+            if (m_oversized_index[i].pointer == p)
+            {
+                return i;
+            }
+        }
+    }
+
+    // adds the oversized block at the given position of m_oversized to the index
+    void index_oversized(std::size_t position)
+    {
+        // grow the index, if needed, by rebuilding it from m_oversized
+        if (2 * m_oversized.size() > m_oversized_index.size())
+        {
+            index_slot empty;
+            empty.pointer = void_ptr();
+            empty.position = empty_slot;
+
+            std::size_t size = (std::max)(m_oversized_index.size() * 2, std::size_t(16));
+
+            m_oversized_index.clear();
+            m_oversized_index.resize(size, empty);
+
+            for (std::size_t i = 0; i < m_oversized.size(); ++i)
+            {
+                insert_index_slot(m_oversized[i].pointer, i);
+            }
+
+            return;
+        }
+
+        insert_index_slot(m_oversized[position].pointer, position);
+    }
+
+    void insert_index_slot(void_ptr p, std::size_t position)
+    {
+        std::size_t mask = m_oversized_index.size() - 1;
+
+        std::size_t i = index_home(p);
+        while (m_oversized_index[i].position != empty_slot)
+        {
+            i = (i + 1) & mask;
+        }
+
+        index_slot slot;
+        slot.pointer = p;
+        slot.position = position;
+        m_oversized_index[i] = slot;
+    }
+
+    // removes a slot from the index, shifting back the slots that follow it in their probe sequences
+    void unindex_oversized(std::size_t slot)
+    {
+        std::size_t mask = m_oversized_index.size() - 1;
+
+        std::size_t i = slot;
+        for (std::size_t j = (i + 1) & mask; m_oversized_index[j].position != empty_slot; j = (j + 1) & mask)
+        {
+            std::size_t home = index_home(m_oversized_index[j].pointer);
+
+            // the entry in j may move to i, unless its home lies cyclically in (i, j]
+            bool home_in_range = i < j ? (home > i && home <= j) : (home > i || home <= j);
+            if (!home_in_range)
+            {
+                m_oversized_index[i] = m_oversized_index[j];
+                i = j;
+            }
+        }
+
+        index_slot empty = m_oversized_index[i];
+        empty.position = empty_slot;
+        m_oversized_index[i] = empty;
+    }
 };
 
 /*! \}
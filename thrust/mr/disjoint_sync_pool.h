@@ -92,6 +92,22 @@ public:
         upstream_pool.release();
     }
 
+    /*! Returns a copy of the statistics of the requests made so far. See \p disjoint_unsynchronized_pool_resource::statistics.
+     */
+    allocation_statistics statistics()
+    {
+        lock_t lock(mtx);
+        return upstream_pool.statistics();
+    }
+
+    /*! Resets the statistics, as described in \p allocation_statistics::reset_counters.
+     */
+    void reset_statistics()
+    {
+        lock_t lock(mtx);
+        upstream_pool.reset_statistics();
+    }
+
     THRUST_NODISCARD virtual void_ptr do_allocate(std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
     {
         lock_t lock(mtx);
@@ -0,0 +1,251 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file file.h
+ *  \brief A memory resource which maps its allocations from a file, for data sets that live on disk.
+ */
+
+#pragma once
+
+#include <thrust/mr/memory_resource.h>
+
+// memory mapped files are only supported on POSIX systems
+#if !defined(_WIN32)
+
+#include <cerrno>
+#include <new>
+
+#include <thrust/system/system_error.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace thrust
+{
+namespace mr
+{
+
+/*! \addtogroup memory_management Memory Management
+ *  \addtogroup memory_management_classes Memory Management Classes
+ *  \addtogroup memory_resources Memory Resources
+ *  \ingroup memory_resources
+ *  \{
+ */
+
+/*! The expected order of accesses to mapped memory, passed on to the system with \p madvise.
+ */
+enum file_access_pattern
+{
+    /*! No particular order; the system's default read-ahead is used.
+     */
+    normal_access,
+    /*! Mostly sequential accesses, e.g. a copy or a scan; the system reads ahead aggressively.
+     */
+    sequential_access,
+    /*! Mostly random accesses, e.g. binary searches; the system does not read ahead.
+     */
+    random_access
+};
+
+/*! A type used for configuring \p file_memory_resource.
+ */
+struct file_mapping_options
+{
+    /*! Whether the file is mapped for reading only. A read-only resource cannot extend the file.
+     */
+    bool read_only;
+    /*! Whether writes to the mapped memory are carried through to the file (\p MAP_SHARED), or kept private to the
+     *      process (\p MAP_PRIVATE).
+     */
+    bool shared;
+    /*! Whether writes to the mapped memory are flushed to the file synchronously when it is unmapped. Otherwise, the
+     *      system writes them back at its own pace.
+     */
+    bool sync_on_unmap;
+    /*! The expected order of accesses to the mapped memory.
+     */
+    file_access_pattern access;
+
+    /*! Constructor. Sets the options for a writable, shared mapping, with no synchronous flushing and no access hints.
+     */
+    file_mapping_options() : read_only(false), shared(true), sync_on_unmap(false), access(normal_access)
+    {
+    }
+};
+
+/*! A memory resource which maps its allocations from a file. Allocations are laid out one after another in the file,
+ *      each starting at a page boundary, beginning at offset zero; the file is extended as needed. The first allocation
+ *      from a resource over an existing file therefore maps the file's contents, without reading or copying them
+ *      upfront - see \p mapped_vector for a container built on that. Memory that is deallocated is unmapped, but its
+ *      space in the file is not reused.
+ *
+ *  This memory resource is not thread safe.
+ */
+class file_memory_resource THRUST_FINAL : public memory_resource<>
+{
+public:
+    /*! Constructor. Opens the file, creating it unless the mapping is read only.
+     *
+     *  \param path the path of the file
+     *  \param options the options of the mappings
+     *  \throws thrust::system_error if the file cannot be opened
+     */
+    file_memory_resource(const char * path, file_mapping_options options = file_mapping_options())
+        : m_options(options), m_offset(0)
+    {
+        m_fd = ::open(path, options.read_only ? O_RDONLY : (O_RDWR | O_CREAT), 0644);
+        if (m_fd == -1)
+        {
+            throw thrust::system_error(errno, thrust::system_category(), "file_memory_resource: open");
+        }
+    }
+
+    /*! Destructor. Closes the file; blocks which are still allocated remain mapped until they are deallocated.
+     */
+    ~file_memory_resource()
+    {
+        ::close(m_fd);
+    }
+
+    /*! Returns the current size of the file.
+     */
+    std::size_t file_size() const
+    {
+        struct stat status;
+        if (::fstat(m_fd, &status) != 0)
+        {
+            throw thrust::system_error(errno, thrust::system_category(), "file_memory_resource: fstat");
+        }
+        return static_cast<std::size_t>(status.st_size);
+    }
+
+private:
+    typedef memory_resource<>::pointer void_ptr;
+
+public:
+    THRUST_NODISCARD virtual void_ptr do_allocate(std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        std::size_t page = page_size();
+        // mmap returns memory aligned to a page boundary; stricter alignments are not supported
+        if (alignment > page || bytes == 0)
+        {
+            throw std::bad_alloc();
+        }
+
+        std::size_t length = round_up(bytes, page);
+        std::size_t offset = m_offset;
+
+        if (offset + bytes > file_size())
+        {
+            if (m_options.read_only || ::ftruncate(m_fd, static_cast<off_t>(offset + bytes)) != 0)
+            {
+                throw std::bad_alloc();
+            }
+        }
+
+        int protection = m_options.read_only ? PROT_READ : (PROT_READ | PROT_WRITE);
+        int flags = m_options.shared ? MAP_SHARED : MAP_PRIVATE;
+
+        void * p = ::mmap(NULL, length, protection, flags, m_fd, static_cast<off_t>(offset));
+        if (p == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+
+        advise(p, bytes, m_options.access);
+
+        m_offset = offset + length;
+        return p;
+    }
+
+    virtual void do_deallocate(void_ptr p, std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        (void)alignment;
+
+        if (m_options.sync_on_unmap && m_options.shared && !m_options.read_only)
+        {
+            sync(p, bytes);
+        }
+
+        ::munmap(p, round_up(bytes, page_size()));
+    }
+
+    /*! Flushes the writes to an allocated block to the file, and waits for them to complete.
+     *
+     *  \param p the block
+     *  \param bytes the size of the block
+     */
+    void sync(void * p, std::size_t bytes)
+    {
+        if (::msync(p, round_up(bytes, page_size()), MS_SYNC) != 0)
+        {
+            throw thrust::system_error(errno, thrust::system_category(), "file_memory_resource: msync");
+        }
+    }
+
+    /*! Advises the system about the order in which an allocated block is going to be accessed.
+     *
+     *  \param p the block
+     *  \param bytes the size of the block
+     *  \param access the expected order of accesses
+     */
+    void advise(void * p, std::size_t bytes, file_access_pattern access)
+    {
+        int advice = MADV_NORMAL;
+        if (access == sequential_access)
+        {
+            advice = MADV_SEQUENTIAL;
+        }
+        else if (access == random_access)
+        {
+            advice = MADV_RANDOM;
+        }
+
+        // the advice is only a hint, so failures are not reported
+        ::madvise(p, round_up(bytes, page_size()), advice);
+    }
+
+private:
+    // not copyable, since the resource owns the file descriptor
+    file_memory_resource(const file_memory_resource &);
+    file_memory_resource & operator=(const file_memory_resource &);
+
+    static std::size_t page_size()
+    {
+        static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    static std::size_t round_up(std::size_t bytes, std::size_t alignment)
+    {
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+
+    file_mapping_options m_options;
+    int m_fd;
+    // the offset in the file of the next allocation
+    std::size_t m_offset;
+};
+
+/*! \}
+ */
+
+} // end mr
+} // end thrust
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file host_temporary_resource.h
+ *  \brief A process-wide hook for the memory resource that the temporary storage of algorithms executed by the host
+ *      systems is allocated from.
+ */
+
+#pragma once
+
+#include <thrust/detail/cpp11_required.h>
+
+#if __cplusplus >= 201103L
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+#include <thrust/mr/memory_resource.h>
+
+namespace thrust
+{
+namespace mr
+{
+
+/*! \addtogroup memory_management Memory Management
+ *  \addtogroup memory_management_classes Memory Management Classes
+ *  \ingroup memory_management
+ *  \{
+ */
+
+/*! Routes the temporary storage of algorithms executed by the host systems (\p cpp, \p omp and \p tbb) to a memory
+ *      resource set by the user, instead of \p malloc and \p free. Policies with an attached allocator or memory
+ *      resource keep using it. No resource is set by default.
+ *
+ *  The resource can be changed at any time, including while algorithms are running; buffers are always returned to
+ *      the resource they were allocated from. Uses \p std::mutex, and therefore requires C++11.
+ */
+class host_temporary_resource
+{
+    typedef std::lock_guard<std::mutex> lock_t;
+
+    struct allocation
+    {
+        memory_resource<> * resource;
+        std::size_t bytes;
+    };
+
+    struct state
+    {
+        state() : resource(NULL), outstanding(0)
+        {
+        }
+
+        std::atomic<memory_resource<> *> resource;
+        std::atomic<std::size_t> outstanding;
+
+        std::mutex mtx;
+        std::unordered_map<void *, allocation> allocations;
+    };
+
+    static state & get_state()
+    {
+        static state s;
+        return s;
+    }
+
+public:
+    /*! Sets the resource that temporary storage of the host systems is allocated from.
+     *
+     *  \param resource the resource to use, or a null pointer to go back to \p malloc and \p free
+     */
+    static void set(memory_resource<> * resource)
+    {
+        get_state().resource.store(resource);
+    }
+
+    /*! Returns the resource that temporary storage of the host systems is allocated from, or a null pointer if none is
+     *      set.
+     */
+    static memory_resource<> * get()
+    {
+        return get_state().resource.load();
+    }
+
+    /*! Allocates temporary storage from the current resource.
+     *
+     *  \param bytes the size of the allocation
+     *  \returns the allocated memory, or a null pointer if no resource is set or the allocation failed
+     */
+    static void * allocate(std::size_t bytes)
+    {
+        state & s = get_state();
+
+        memory_resource<> * resource = s.resource.load();
+        if (!resource)
+        {
+            return NULL;
+        }
+
+        void * p = NULL;
+        try
+        {
+            p = resource->do_allocate(bytes, THRUST_MR_DEFAULT_ALIGNMENT);
+        }
+        catch (const std::bad_alloc &)
+        {
+            return NULL;
+        }
+
+        allocation a;
+        a.resource = resource;
+        a.bytes = bytes;
+
+        {
+            lock_t lock(s.mtx);
+            s.allocations[p] = a;
+        }
+        ++s.outstanding;
+
+        return p;
+    }
+
+    /*! Returns temporary storage to the resource it was allocated from.
+     *
+     *  \param p the pointer to the storage
+     *  \returns true if \p p was allocated by \p allocate, false otherwise, i.e. if it came from \p malloc
+     */
+    static bool deallocate(void * p)
+    {
+        state & s = get_state();
+
+        // the common case when no resource was ever set: no lock
+        if (s.outstanding.load() == 0)
+        {
+            return false;
+        }
+
+        allocation a;
+
+        {
+            lock_t lock(s.mtx);
+
+            std::unordered_map<void *, allocation>::iterator it = s.allocations.find(p);
+            if (it == s.allocations.end())
+            {
+                return false;
+            }
+
+            a = it->second;
+            s.allocations.erase(it);
+        }
+        --s.outstanding;
+
+        a.resource->do_deallocate(p, a.bytes, THRUST_MR_DEFAULT_ALIGNMENT);
+        return true;
+    }
+};
+
+/*! \}
+ */
+
+} // end mr
+} // end thrust
+
+#endif
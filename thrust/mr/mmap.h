@@ -0,0 +1,226 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file mmap.h
+ *  \brief Anonymous <tt>mmap</tt>-based memory resource, using transparent huge pages where available.
+ */
+
+#pragma once
+
+#include <new>
+
+#include <thrust/mr/memory_resource.h>
+#include <thrust/mr/new.h>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace thrust
+{
+namespace mr
+{
+
+/*! \addtogroup memory_management Memory Management
+ *  \addtogroup memory_management_classes Memory Management Classes
+ *  \addtogroup memory_resources Memory Resources
+ *  \ingroup memory_resources
+ *  \{
+ */
+
+/*! A memory resource that maps anonymous memory directly from the operating system for large allocations, and uses
+ *      global operators new and delete for the rest.
+ *
+ *  Large mappings are aligned to the size of a huge page and advised with \p MADV_HUGEPAGE, so that the kernel can back
+ *      them with transparent huge pages, which cuts the number of page faults and TLB misses of multi-gigabyte
+ *      containers by a factor of 512. Optionally, mappings are populated upfront with \p MAP_POPULATE, taking all the
+ *      page faults in a single system call. Deallocating unmaps the memory, which returns it to the system immediately.
+ *
+ *  Where \p mmap is not available, all allocations use operators new and delete.
+ */
+class mmap_memory_resource THRUST_FINAL : public memory_resource<>
+{
+public:
+    /*! The size of a huge page, to which large mappings are aligned.
+     */
+    static const std::size_t huge_page_size = std::size_t(1) << 21;
+
+    /*! Constructor.
+     *
+     *  \param use_huge_pages whether mappings of at least \p huge_page_size bytes are advised to use huge pages
+     *  \param populate whether mappings are populated when they are allocated, rather than on first touch
+     *  \param mmap_threshold the smallest allocation which is mapped directly; smaller ones use operator new
+     */
+    mmap_memory_resource(bool use_huge_pages = true, bool populate = false,
+        std::size_t mmap_threshold = std::size_t(1) << 20)
+        : m_use_huge_pages(use_huge_pages), m_populate(populate), m_mmap_threshold(mmap_threshold)
+    {
+    }
+
+private:
+    typedef memory_resource<>::pointer void_ptr;
+
+public:
+    THRUST_NODISCARD virtual void_ptr do_allocate(std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+#if !defined(_WIN32)
+        if (bytes >= m_mmap_threshold && bytes != 0)
+        {
+            return map(bytes, alignment);
+        }
+#endif
+        return m_fallback.do_allocate(bytes, alignment);
+    }
+
+    virtual void do_deallocate(void_ptr p, std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+#if !defined(_WIN32)
+        if (bytes >= m_mmap_threshold && bytes != 0)
+        {
+            ::munmap(p, round_up(bytes, page_size()));
+            return;
+        }
+#endif
+        m_fallback.do_deallocate(p, bytes, alignment);
+    }
+
+    /*! Returns the physical memory of the whole pages within an allocated block to the system, without deallocating the
+     *      block; the contents of those pages read as zeros afterwards. Does nothing for blocks that were not mapped
+     *      directly.
+     *
+     *  \param p the block
+     *  \param bytes the size of the block
+     */
+    void discard(void * p, std::size_t bytes)
+    {
+#if !defined(_WIN32)
+        if (bytes < m_mmap_threshold || bytes == 0)
+        {
+            return;
+        }
+
+        // the block starts at a page boundary, so only its end may be a partial page
+        std::size_t discarded = bytes / page_size() * page_size();
+        if (discarded != 0)
+        {
+            ::madvise(p, discarded, MADV_DONTNEED);
+        }
+#else
+        (void)p;
+        (void)bytes;
+#endif
+    }
+
+private:
+#if !defined(_WIN32)
+    static std::size_t page_size()
+    {
+        static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    static std::size_t round_up(std::size_t bytes, std::size_t alignment)
+    {
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+
+    void * map(std::size_t bytes, std::size_t alignment)
+    {
+        std::size_t page = page_size();
+        std::size_t length = round_up(bytes, page);
+
+        if (m_use_huge_pages && length >= huge_page_size && alignment < huge_page_size)
+        {
+            alignment = huge_page_size;
+        }
+
+        // map enough to find an aligned range, then unmap the rest; mmap itself only guarantees page alignment
+        std::size_t slack = alignment > page ? alignment - page : 0;
+
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+        bool populated = false;
+#ifdef MAP_POPULATE
+        // the slack is unmapped right away, and huge pages must be advised before the first touch, so only populate
+        // mappings which need no slack at once
+        if (m_populate && slack == 0)
+        {
+            flags |= MAP_POPULATE;
+            populated = true;
+        }
+#endif
+
+        void * mapping = ::mmap(NULL, length + slack, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (mapping == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+
+        char * begin = static_cast<char *>(mapping);
+        char * aligned = reinterpret_cast<char *>(round_up(reinterpret_cast<std::size_t>(begin), alignment));
+
+        if (aligned != begin)
+        {
+            ::munmap(begin, aligned - begin);
+        }
+        if (aligned + length != begin + length + slack)
+        {
+            ::munmap(aligned + length, begin + length + slack - (aligned + length));
+        }
+
+#ifdef MADV_HUGEPAGE
+        if (m_use_huge_pages && length >= huge_page_size)
+        {
+            ::madvise(aligned, length, MADV_HUGEPAGE);
+        }
+#endif
+
+        if (m_populate && !populated)
+        {
+            populate(aligned, length);
+        }
+
+        return aligned;
+    }
+
+    // faults in a mapping by writing to each of its pages, after it has been advised to use huge pages
+    static void populate(char * p, std::size_t length)
+    {
+#ifdef MADV_POPULATE_WRITE
+        if (::madvise(p, length, MADV_POPULATE_WRITE) == 0)
+        {
+            return;
+        }
+#endif
+        for (std::size_t i = 0; i < length; i += page_size())
+        {
+            static_cast<volatile char *>(p)[i] = 0;
+        }
+    }
+#endif
+
+    bool m_use_huge_pages;
+    bool m_populate;
+    std::size_t m_mmap_threshold;
+
+    new_delete_resource m_fallback;
+};
+
+/*! \}
+ */
+
+} // end mr
+} // end thrust
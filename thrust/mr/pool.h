@@ -22,12 +22,15 @@
 #pragma once
 
 #include <algorithm>
+#include <vector>
 
 #include <thrust/host_vector.h>
 
 #include <thrust/mr/memory_resource.h>
 #include <thrust/mr/allocator.h>
 #include <thrust/mr/pool_options.h>
+#include <thrust/mr/statistics.h>
+#include <thrust/mr/detail/cached_block_index.h>
 
 #include <cassert>
 
@@ -107,8 +110,7 @@ public:
         m_smallest_block_log2(detail::log2_ri(m_options.smallest_block_size)),
         m_pools(upstream),
         m_allocated(NULL),
-        m_oversized(NULL),
-        m_cached_oversized(NULL)
+        m_oversized(NULL)
     {
         assert(m_options.validate());
 
@@ -128,8 +130,7 @@ public:
         m_smallest_block_log2(detail::log2_ri(m_options.smallest_block_size)),
         m_pools(get_global_resource<Upstream>()),
         m_allocated(NULL),
-        m_oversized(NULL),
-        m_cached_oversized(NULL)
+        m_oversized(NULL)
     {
         assert(m_options.validate());
 
@@ -169,8 +170,8 @@ private:
 
     // this was originally a forward list, but I made it a doubly linked list
     // because that way deallocation when not caching is faster and doesn't require
-    // traversal of a linked list (it's still a forward list for the cached list,
-    // because allocation from that list already traverses)
+    // traversal of a linked list (it's still a forward list for the cached blocks
+    // of each capacity and alignment, which are only ever taken from the front)
     //
     // TODO: investigate whether it's better to have this be a doubly-linked list
     // with fast do_deallocate when !m_options.cache_oversized, or to have this be
@@ -179,9 +180,12 @@ private:
     // I assume that it is better this way, but the additional pointer could
     // potentially hurt? these are supposed to be oversized and/or overaligned,
     // so they are kinda memory intensive already
+    // a cached oversized block may be handed out again for a smaller request, in which case its descriptor moves to
+    // just past the requested size, so that it can be found from the size passed to do_deallocate
     struct oversized_block_descriptor
     {
         std::size_t size;
+        std::size_t capacity;
         std::size_t alignment;
         oversized_block_descriptor_ptr prev;
         oversized_block_descriptor_ptr next;
@@ -207,7 +211,14 @@ private:
     pool_vector m_pools;
     chunk_descriptor_ptr m_allocated;
     oversized_block_descriptor_ptr m_oversized;
-    oversized_block_descriptor_ptr m_cached_oversized;
+
+    // the buckets of the cached oversized blocks, one for each capacity and alignment which has a cached block; each
+    // holds a list linked through the blocks' descriptors' next_cached. Like the address ranges of find_free_chunks,
+    // the index is kept on the host, so that caching a block never allocates from upstream
+    typedef cached_block_index<oversized_block_descriptor_ptr, std::allocator<char> > cached_index;
+    cached_index m_cached;
+
+    allocation_statistics m_statistics;
 
 public:
     /*! Releases all held memory to upstream.
@@ -232,7 +243,7 @@ public:
                     static_cast<void_ptr>(alloc)
                 ) - (*alloc).size
             );
-            m_upstream->do_deallocate(p, (*alloc).size + sizeof(chunk_descriptor), m_options.alignment);
+            upstream_deallocate(p, (*alloc).size + sizeof(chunk_descriptor), m_options.alignment);
         }
 
         // deallocate cached oversized/overaligned memory
@@ -241,20 +252,24 @@ public:
             oversized_block_descriptor_ptr alloc = m_oversized;
             m_oversized = (*m_oversized).next;
 
+            oversized_block_descriptor desc = *alloc;
+
             void_ptr p = static_cast<void_ptr>(
                 static_cast<char_ptr>(
                     static_cast<void_ptr>(alloc)
-                ) - (*alloc).size
+                ) - desc.size
             );
-            m_upstream->do_deallocate(p, (*alloc).size + sizeof(oversized_block_descriptor), (*alloc).alignment);
+            upstream_deallocate(p, desc.capacity + sizeof(oversized_block_descriptor), desc.alignment);
         }
 
-        m_cached_oversized = oversized_block_descriptor_ptr();
+        m_cached.clear();
     }
 
     THRUST_NODISCARD virtual void_ptr do_allocate(std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
     {
+        std::size_t requested = bytes;
         bytes = (std::max)(bytes, m_options.smallest_block_size);
+        m_statistics.record_allocation(requested, bytes);
         assert(detail::is_power_of_2(alignment));
 
         // an oversized and/or overaligned allocation requested; needs to be allocated separately
@@ -262,67 +277,21 @@ public:
         {
             if (m_options.cache_oversized)
             {
-                oversized_block_descriptor_ptr ptr = m_cached_oversized;
-                oversized_block_descriptor_ptr * previous = &m_cached_oversized;
-                while (detail::pointer_traits<oversized_block_descriptor_ptr>::get(ptr))
+                oversized_block_descriptor_ptr ptr = take_cached_oversized(bytes, alignment);
+                if (detail::pointer_traits<oversized_block_descriptor_ptr>::get(ptr))
                 {
-                    oversized_block_descriptor desc = *ptr;
-                    bool is_good = desc.size >= bytes && desc.alignment >= alignment;
-
-                    // if the size is bigger than the requested size by a factor
-                    // bigger than or equal to the specified cutoff for size,
-                    // allocate a new block
-                    if (is_good)
-                    {
-                        std::size_t size_factor = desc.size / bytes;
-                        if (size_factor >= m_options.cached_size_cutoff_factor)
-                        {
-                            is_good = false;
-                        }
-                    }
-
-                    // if the alignment is bigger than the requested one by a factor
-                    // bigger than or equal to the specified cutoff for alignment,
-                    // allocate a new block
-                    if (is_good)
-                    {
-                        std::size_t alignment_factor = desc.alignment / alignment;
-                        if (alignment_factor >= m_options.cached_alignment_cutoff_factor)
-                        {
-                            is_good = false;
-                        }
-                    }
-
-                    if (is_good)
-                    {
-                        if (previous != &m_cached_oversized)
-                        {
-                            oversized_block_descriptor previous_desc = **previous;
-                            previous_desc.next_cached = desc.next_cached;
-                            **previous = previous_desc;
-                        }
-                        else
-                        {
-                            m_cached_oversized = desc.next_cached;
-                        }
-
-                        desc.next_cached = oversized_block_descriptor_ptr();
-                        *ptr = desc;
-
-                        return static_cast<void_ptr>(
-                            static_cast<char_ptr>(
-                                static_cast<void_ptr>(ptr)
-                            ) - desc.size
-                        );
-                    }
-
-                    previous = &(*ptr).next_cached;
-                    ptr = *previous;
+                    ++m_statistics.cache_hits[allocation_statistics::size_bin(bytes)];
+                    return static_cast<void_ptr>(
+                        static_cast<char_ptr>(
+                            static_cast<void_ptr>(ptr)
+                        ) - bytes
+                    );
                 }
             }
 
             // no fitting cached block found; allocate a new one that's just up to the specs
-            void_ptr allocated = m_upstream->do_allocate(bytes + sizeof(oversized_block_descriptor), alignment);
+            ++m_statistics.cache_misses[allocation_statistics::size_bin(bytes)];
+            void_ptr allocated = upstream_allocate(bytes + sizeof(oversized_block_descriptor), alignment);
             oversized_block_descriptor_ptr block = static_cast<oversized_block_descriptor_ptr>(
                 static_cast<void_ptr>(
                     static_cast<char_ptr>(allocated) + bytes
@@ -331,6 +300,7 @@ public:
 
             oversized_block_descriptor desc;
             desc.size = bytes;
+            desc.capacity = bytes;
             desc.alignment = alignment;
             desc.prev = oversized_block_descriptor_ptr();
             desc.next = m_oversized;
@@ -360,6 +330,8 @@ public:
         // and split it into blocks pushed to the free list
         if (!detail::pointer_traits<block_descriptor_ptr>::get(bucket.free_list))
         {
+            ++m_statistics.cache_misses[bytes_log2];
+
             std::size_t n = bucket.previous_allocated_count;
             if (n == 0)
             {
@@ -387,7 +359,7 @@ public:
             block_size += m_options.alignment - block_size % m_options.alignment;
             std::size_t chunk_size = block_size * n;
 
-            void_ptr allocated = m_upstream->do_allocate(chunk_size + sizeof(chunk_descriptor), m_options.alignment);
+            void_ptr allocated = upstream_allocate(chunk_size + sizeof(chunk_descriptor), m_options.alignment);
             chunk_descriptor_ptr chunk = static_cast<chunk_descriptor_ptr>(
                 static_cast<void_ptr>(
                     static_cast<char_ptr>(allocated) + chunk_size
@@ -415,6 +387,11 @@ public:
             }
         }
 
+        else
+        {
+            ++m_statistics.cache_hits[bytes_log2];
+        }
+
         // allocate a block from the front of the bucket's free list
         block_descriptor_ptr block = bucket.free_list;
         bucket.free_list = (*block).next;
@@ -427,6 +404,8 @@ public:
 
     virtual void do_deallocate(void_ptr p, std::size_t n, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
     {
+        m_statistics.record_deallocation(n);
+
         n = (std::max)(n, m_options.smallest_block_size);
         assert(detail::is_power_of_2(alignment));
 
@@ -446,35 +425,25 @@ public:
 
             if (m_options.cache_oversized)
             {
-                desc.next_cached = m_cached_oversized;
-                *block = desc;
-                m_cached_oversized = block;
+                // push the block to the front of the bucket of its capacity and alignment, adding the bucket if needed
+                std::size_t position = m_cached.find(desc.capacity, desc.alignment);
+                if (position == cached_index::npos)
+                {
+                    desc.next_cached = oversized_block_descriptor_ptr();
+                    *block = desc;
+                    m_cached.insert(desc.capacity, desc.alignment, block);
+                }
+                else
+                {
+                    desc.next_cached = m_cached.head(position);
+                    *block = desc;
+                    m_cached.set_head(position, block);
+                }
 
                 return;
             }
 
-            if (!detail::pointer_traits<oversized_block_descriptor_ptr>::get(desc.prev))
-            {
-                assert(m_oversized == block);
-                m_oversized = desc.next;
-            }
-            else
-            {
-                oversized_block_descriptor prev = *desc.prev;
-                assert(prev.next == block);
-                prev.next = desc.next;
-                *desc.prev = prev;
-            }
-
-            if (detail::pointer_traits<oversized_block_descriptor_ptr>::get(desc.next))
-            {
-                oversized_block_descriptor next = *desc.next;
-                assert(next.prev == block);
-                next.prev = desc.prev;
-                *desc.next = next;
-            }
-
-            m_upstream->do_deallocate(p, desc.size + sizeof(oversized_block_descriptor), desc.alignment);
+            deallocate_oversized(block);
 
             return;
         }
@@ -497,6 +466,417 @@ public:
         *block = desc;
         bucket.free_list = block;
     }
+
+    /*! Returns memory which is cached, but not in use, to upstream, until at most \p max_cached_bytes of such memory
+     *      remain. Cached oversized blocks are returned first, largest first, followed by chunks none of whose blocks are
+     *      in use. Free blocks of chunks which are partially in use cannot be returned, and are not counted.
+     *
+     *  Calling this periodically implements a decay policy for memory cached after a burst of allocations.
+     *
+     *  \param max_cached_bytes the amount of cached memory to retain
+     *  \returns the number of bytes returned to upstream
+     */
+    std::size_t trim(std::size_t max_cached_bytes = 0)
+    {
+        std::size_t cached_bytes = 0;
+
+        std::vector<std::size_t> buckets;
+        for (std::size_t i = m_cached.first(); i != cached_index::npos; i = m_cached.next(i))
+        {
+            buckets.push_back(i);
+
+            oversized_block_descriptor_ptr ptr = m_cached.head(i);
+            while (detail::pointer_traits<oversized_block_descriptor_ptr>::get(ptr))
+            {
+                oversized_block_descriptor desc = *ptr;
+                cached_bytes += desc.capacity + sizeof(oversized_block_descriptor);
+                ptr = desc.next_cached;
+            }
+        }
+
+        std::vector<free_chunk> free_chunks = find_free_chunks();
+        for (std::size_t i = 0; i < free_chunks.size(); ++i)
+        {
+            cached_bytes += free_chunks[i].size + sizeof(chunk_descriptor);
+        }
+
+        std::size_t released_bytes = 0;
+
+        // return the cached oversized blocks, largest first
+        std::sort(buckets.begin(), buckets.end(), larger_bucket(m_cached));
+
+        for (std::size_t i = 0; i < buckets.size() && cached_bytes > max_cached_bytes; ++i)
+        {
+            std::size_t position = buckets[i];
+
+            while (cached_bytes > max_cached_bytes && position != cached_index::npos)
+            {
+                oversized_block_descriptor_ptr block = m_cached.head(position);
+                oversized_block_descriptor desc = *block;
+
+                if (detail::pointer_traits<oversized_block_descriptor_ptr>::get(desc.next_cached))
+                {
+                    m_cached.set_head(position, desc.next_cached);
+                }
+                else
+                {
+                    m_cached.erase(position);
+                    position = cached_index::npos;
+                }
+
+                std::size_t bytes = desc.capacity + sizeof(oversized_block_descriptor);
+                deallocate_oversized(block);
+
+                cached_bytes -= bytes;
+                released_bytes += bytes;
+            }
+        }
+
+        // return the chunks none of whose blocks are in use
+        std::size_t num_released_chunks = 0;
+        while (num_released_chunks < free_chunks.size() && cached_bytes > max_cached_bytes)
+        {
+            std::size_t bytes = free_chunks[num_released_chunks].size + sizeof(chunk_descriptor);
+            cached_bytes -= bytes;
+            released_bytes += bytes;
+            ++num_released_chunks;
+        }
+        free_chunks.resize(num_released_chunks);
+
+        if (!free_chunks.empty())
+        {
+            deallocate_chunks(free_chunks);
+        }
+
+        return released_bytes;
+    }
+
+    /*! Returns the statistics of the requests made so far. The buckets' size bins are the ones of their block sizes;
+     *      a miss is a request which had to allocate a new chunk, or a new oversized block, from upstream.
+     */
+    const allocation_statistics & statistics() const
+    {
+        return m_statistics;
+    }
+
+    /*! Resets the statistics, as described in \p allocation_statistics::reset_counters.
+     */
+    void reset_statistics()
+    {
+        m_statistics.reset_counters();
+    }
+
+private:
+    void_ptr upstream_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        void_ptr p = m_upstream->do_allocate(bytes, alignment);
+        m_statistics.record_upstream_allocation(bytes);
+        return p;
+    }
+
+    void upstream_deallocate(void_ptr p, std::size_t bytes, std::size_t alignment)
+    {
+        m_statistics.record_upstream_deallocation(bytes);
+        m_upstream->do_deallocate(p, bytes, alignment);
+    }
+
+    // orders the positions of cached buckets from the largest capacity down
+    struct larger_bucket
+    {
+        const cached_index & index;
+
+        larger_bucket(const cached_index & index) : index(index)
+        {
+        }
+
+        bool operator()(std::size_t lhs, std::size_t rhs) const
+        {
+            return index.bucket_size(lhs) > index.bucket_size(rhs);
+        }
+    };
+
+    // finds the best fitting cached oversized block within the cutoff factors, removes it from the cache, and prepares
+    // its descriptor for a block of the requested size; returns a null pointer if there is no such block
+    oversized_block_descriptor_ptr take_cached_oversized(std::size_t bytes, std::size_t alignment)
+    {
+        std::size_t position = m_cached.find_best_fit(bytes, alignment,
+            m_options.cached_size_cutoff_factor, m_options.cached_alignment_cutoff_factor);
+        if (position == cached_index::npos)
+        {
+            return oversized_block_descriptor_ptr();
+        }
+
+        // pop the bucket's most recently cached block, erasing the bucket if it was the last one
+        oversized_block_descriptor_ptr best = m_cached.head(position);
+
+        oversized_block_descriptor desc = *best;
+
+        if (detail::pointer_traits<oversized_block_descriptor_ptr>::get(desc.next_cached))
+        {
+            m_cached.set_head(position, desc.next_cached);
+        }
+        else
+        {
+            m_cached.erase(position);
+        }
+
+        desc.next_cached = oversized_block_descriptor_ptr();
+
+        if (desc.size == bytes)
+        {
+            *best = desc;
+            return best;
+        }
+
+        // move the descriptor to just past the requested size
+        oversized_block_descriptor_ptr moved = static_cast<oversized_block_descriptor_ptr>(
+            static_cast<void_ptr>(
+                static_cast<char_ptr>(
+                    static_cast<void_ptr>(best)
+                ) - desc.size + bytes
+            )
+        );
+
+        desc.size = bytes;
+        *moved = desc;
+
+        if (detail::pointer_traits<oversized_block_descriptor_ptr>::get(desc.prev))
+        {
+            oversized_block_descriptor prev = *desc.prev;
+            prev.next = moved;
+            *desc.prev = prev;
+        }
+        else
+        {
+            m_oversized = moved;
+        }
+
+        if (detail::pointer_traits<oversized_block_descriptor_ptr>::get(desc.next))
+        {
+            oversized_block_descriptor next = *desc.next;
+            next.prev = moved;
+            *desc.next = next;
+        }
+
+        return moved;
+    }
+
+    // unlinks an oversized block from the list of all oversized blocks, and returns it to upstream
+    void deallocate_oversized(oversized_block_descriptor_ptr block)
+    {
+        oversized_block_descriptor desc = *block;
+
+        if (!detail::pointer_traits<oversized_block_descriptor_ptr>::get(desc.prev))
+        {
+            assert(m_oversized == block);
+            m_oversized = desc.next;
+        }
+        else
+        {
+            oversized_block_descriptor prev = *desc.prev;
+            assert(prev.next == block);
+            prev.next = desc.next;
+            *desc.prev = prev;
+        }
+
+        if (detail::pointer_traits<oversized_block_descriptor_ptr>::get(desc.next))
+        {
+            oversized_block_descriptor next = *desc.next;
+            assert(next.prev == block);
+            next.prev = desc.prev;
+            *desc.next = next;
+        }
+
+        void_ptr p = static_cast<void_ptr>(
+            static_cast<char_ptr>(
+                static_cast<void_ptr>(block)
+            ) - desc.size
+        );
+        upstream_deallocate(p, desc.capacity + sizeof(oversized_block_descriptor), desc.alignment);
+    }
+
+    // a chunk none of whose blocks are in use, as found by find_free_chunks
+    struct free_chunk
+    {
+        chunk_descriptor_ptr chunk;
+        std::size_t size;
+        // the address range of the chunk's blocks
+        const char * begin;
+        const char * end;
+    };
+
+    struct chunk_range
+    {
+        const char * begin;
+        const char * end;
+        chunk_descriptor_ptr chunk;
+        std::size_t size;
+        std::size_t num_blocks;
+        std::size_t num_free_blocks;
+
+        bool operator<(const chunk_range & other) const
+        {
+            return begin < other.begin;
+        }
+    };
+
+    // returns the address range of the block whose descriptor is pointed to by block
+    static const char * block_address(block_descriptor_ptr block)
+    {
+        return reinterpret_cast<const char *>(detail::pointer_traits<block_descriptor_ptr>::get(block));
+    }
+
+    // finds the chunks whose blocks are all in the free lists, by attributing every free block to its chunk by address;
+    // the chunks' address ranges are kept on the host, so this works for upstream resources with fancy pointers as well
+    std::vector<free_chunk> find_free_chunks()
+    {
+        std::vector<chunk_range> ranges;
+
+        for (chunk_descriptor_ptr alloc = m_allocated; detail::pointer_traits<chunk_descriptor_ptr>::get(alloc); )
+        {
+            chunk_descriptor desc = *alloc;
+
+            chunk_range range;
+            range.end = reinterpret_cast<const char *>(detail::pointer_traits<chunk_descriptor_ptr>::get(alloc));
+            range.begin = range.end - desc.size;
+            range.chunk = alloc;
+            range.size = desc.size;
+            range.num_blocks = 0;
+            range.num_free_blocks = 0;
+            ranges.push_back(range);
+
+            alloc = desc.next;
+        }
+
+        std::sort(ranges.begin(), ranges.end());
+
+        std::size_t descriptor_size = (std::max)(sizeof(block_descriptor), m_options.alignment);
+
+        for (std::size_t i = 0; i < m_pools.size(); ++i)
+        {
+            std::size_t bytes = static_cast<std::size_t>(1) << (i + m_smallest_block_log2);
+            std::size_t block_size = bytes + descriptor_size;
+            block_size += m_options.alignment - block_size % m_options.alignment;
+
+            for (block_descriptor_ptr block = m_pools[i].free_list; detail::pointer_traits<block_descriptor_ptr>::get(block); )
+            {
+                const char * address = block_address(block);
+
+                chunk_range key;
+                key.begin = address;
+                typename std::vector<chunk_range>::iterator it = std::upper_bound(ranges.begin(), ranges.end(), key);
+                assert(it != ranges.begin());
+                --it;
+                assert(address < it->end);
+
+                // all blocks of a chunk come from the same pool
+                it->num_blocks = it->size / block_size;
+                ++it->num_free_blocks;
+
+                block = (*block).next;
+            }
+        }
+
+        std::vector<free_chunk> result;
+        for (std::size_t i = 0; i < ranges.size(); ++i)
+        {
+            if (ranges[i].num_free_blocks != 0 && ranges[i].num_free_blocks == ranges[i].num_blocks)
+            {
+                free_chunk chunk = { ranges[i].chunk, ranges[i].size, ranges[i].begin, ranges[i].end };
+                result.push_back(chunk);
+            }
+        }
+
+        return result;
+    }
+
+    // removes the blocks of the given free chunks from the free lists and returns the chunks to upstream
+    void deallocate_chunks(std::vector<free_chunk> & chunks)
+    {
+        std::vector<chunk_range> ranges;
+        for (std::size_t i = 0; i < chunks.size(); ++i)
+        {
+            chunk_range range;
+            range.begin = chunks[i].begin;
+            range.end = chunks[i].end;
+            ranges.push_back(range);
+        }
+        std::sort(ranges.begin(), ranges.end());
+
+        for (std::size_t i = 0; i < m_pools.size(); ++i)
+        {
+            block_descriptor_ptr previous = block_descriptor_ptr();
+            block_descriptor_ptr block = m_pools[i].free_list;
+
+            while (detail::pointer_traits<block_descriptor_ptr>::get(block))
+            {
+                block_descriptor desc = *block;
+                const char * address = block_address(block);
+
+                chunk_range key;
+                key.begin = address;
+                typename std::vector<chunk_range>::iterator it = std::upper_bound(ranges.begin(), ranges.end(), key);
+                bool is_released = it != ranges.begin() && address < (--it)->end;
+
+                if (!is_released)
+                {
+                    previous = block;
+                }
+                else if (detail::pointer_traits<block_descriptor_ptr>::get(previous))
+                {
+                    block_descriptor previous_desc = *previous;
+                    previous_desc.next = desc.next;
+                    *previous = previous_desc;
+                }
+                else
+                {
+                    m_pools[i].free_list = desc.next;
+                }
+
+                block = desc.next;
+            }
+        }
+
+        chunk_descriptor_ptr previous = chunk_descriptor_ptr();
+        chunk_descriptor_ptr alloc = m_allocated;
+        while (detail::pointer_traits<chunk_descriptor_ptr>::get(alloc))
+        {
+            chunk_descriptor desc = *alloc;
+
+            bool is_released = false;
+            for (std::size_t i = 0; i < chunks.size() && !is_released; ++i)
+            {
+                is_released = chunks[i].chunk == alloc;
+            }
+
+            if (!is_released)
+            {
+                previous = alloc;
+                alloc = desc.next;
+                continue;
+            }
+
+            if (detail::pointer_traits<chunk_descriptor_ptr>::get(previous))
+            {
+                chunk_descriptor previous_desc = *previous;
+                previous_desc.next = desc.next;
+                *previous = previous_desc;
+            }
+            else
+            {
+                m_allocated = desc.next;
+            }
+
+            void_ptr p = static_cast<void_ptr>(
+                static_cast<char_ptr>(
+                    static_cast<void_ptr>(alloc)
+                ) - desc.size
+            );
+            upstream_deallocate(p, desc.size + sizeof(chunk_descriptor), m_options.alignment);
+
+            alloc = desc.next;
+        }
+    }
 };
 
 /*! \}
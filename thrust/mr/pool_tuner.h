@@ -0,0 +1,351 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file pool_tuner.h
+ *  \brief Host-side utilities for replaying recorded allocation traces against the pooling resources, and for searching
+ *      for the \p pool_options that suit a trace best.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <thrust/mr/pool_options.h>
+#include <thrust/mr/statistics.h>
+
+namespace thrust
+{
+namespace mr
+{
+
+/*! \addtogroup memory_management Memory Management
+ *  \addtogroup memory_management_classes Memory Management Classes
+ *  \addtogroup memory_resources Memory Resources
+ *  \ingroup memory_resources
+ *  \{
+ */
+
+/*! A single request of an allocation trace. The blocks are identified by consecutive integers, in the order of their
+ *      allocation.
+ */
+struct allocation_event
+{
+    /*! \p true for an allocation, \p false for a deallocation.
+     */
+    bool is_allocation;
+    /*! The size of the request.
+     */
+    std::size_t bytes;
+    /*! The alignment of the request.
+     */
+    std::size_t alignment;
+    /*! The block allocated or deallocated.
+     */
+    std::size_t block;
+};
+
+/*! A sequence of allocation requests, as recorded by \p statistics_resource.
+ */
+typedef std::vector<allocation_event> allocation_trace;
+
+/*! Reads an allocation trace in the format written by \p statistics_resource. Deallocations of blocks which were allocated
+ *      before the recording started are skipped.
+ *
+ *  \param file the stream to read the trace from
+ *  \param trace the vector the requests are appended to
+ *  \returns \p false if the stream is not a well formed trace
+ */
+inline bool read_allocation_trace(std::FILE * file, allocation_trace & trace)
+{
+    char line[256];
+    if (!std::fgets(line, sizeof(line), file) || std::string(line) != "# thrust::mr allocation trace 1\n")
+    {
+        return false;
+    }
+
+    std::map<std::string, std::size_t> live_blocks;
+    std::size_t num_blocks = 0;
+
+    while (std::fgets(line, sizeof(line), file))
+    {
+        if (line[0] == '#' || line[0] == '\n')
+        {
+            continue;
+        }
+
+        char type;
+        allocation_event event;
+        char address[128];
+        if (std::sscanf(line, "%c %zu %zu %127s", &type, &event.bytes, &event.alignment, address) != 4
+            || (type != 'a' && type != 'd'))
+        {
+            return false;
+        }
+
+        event.is_allocation = type == 'a';
+
+        if (event.is_allocation)
+        {
+            event.block = num_blocks++;
+            live_blocks[address] = event.block;
+        }
+        else
+        {
+            std::map<std::string, std::size_t>::iterator it = live_blocks.find(address);
+            if (it == live_blocks.end())
+            {
+                continue;
+            }
+
+            event.block = it->second;
+            live_blocks.erase(it);
+        }
+
+        trace.push_back(event);
+    }
+
+    return !std::ferror(file);
+}
+
+/*! Reads an allocation trace from a file. See \p read_allocation_trace.
+ *
+ *  \param filename the name of the file to read the trace from
+ *  \param trace the vector the requests are appended to
+ *  \returns \p false if the file cannot be read or is not a well formed trace
+ */
+inline bool read_allocation_trace(const char * filename, allocation_trace & trace)
+{
+    std::FILE * file = std::fopen(filename, "r");
+    if (!file)
+    {
+        return false;
+    }
+
+    bool ret = read_allocation_trace(file, trace);
+    std::fclose(file);
+    return ret;
+}
+
+/*! Writes an allocation trace in the format written by \p statistics_resource, using the block numbers as addresses.
+ *
+ *  \param file the stream to write the trace to
+ *  \param trace the requests to write
+ */
+inline void write_allocation_trace(std::FILE * file, const allocation_trace & trace)
+{
+    std::fprintf(file, "# thrust::mr allocation trace 1\n");
+
+    for (std::size_t i = 0; i < trace.size(); ++i)
+    {
+        std::fprintf(file, "%c %zu %zu 0x%zx\n", trace[i].is_allocation ? 'a' : 'd',
+            trace[i].bytes, trace[i].alignment, trace[i].block + 1);
+    }
+}
+
+/*! Replays an allocation trace against a pool constructed with the given options, and returns the pool's statistics
+ *      from just before it is destroyed. The memory is not touched by the replay, but it is actually allocated from the
+ *      pool's global upstream resource, so \p Pool should be a pool over a host resource.
+ *
+ *  \tparam Pool the type of the pool, constructible from \p pool_options alone
+ *  \param trace the requests to replay
+ *  \param options the options of the pool
+ */
+template<typename Pool>
+allocation_statistics replay_allocation_trace(const allocation_trace & trace, const pool_options & options)
+{
+    typedef typename Pool::pointer void_ptr;
+
+    Pool pool(options);
+    std::vector<void_ptr> blocks;
+
+    for (std::size_t i = 0; i < trace.size(); ++i)
+    {
+        const allocation_event & event = trace[i];
+
+        if (event.is_allocation)
+        {
+            if (blocks.size() <= event.block)
+            {
+                blocks.resize(event.block + 1, void_ptr());
+            }
+            blocks[event.block] = pool.do_allocate(event.bytes, event.alignment);
+        }
+        else
+        {
+            pool.do_deallocate(blocks[event.block], event.bytes, event.alignment);
+        }
+    }
+
+    // the blocks still in use are released along with the pool
+    return pool.statistics();
+}
+
+/*! The cost of a replay which \p tune_pool_options minimizes: the peak number of bytes held from upstream, plus a fixed
+ *      number of bytes charged for every upstream allocation and deallocation.
+ *
+ *  \param statistics the statistics of a replay
+ *  \param bytes_per_upstream_call the number of bytes of footprint one upstream call is considered to be worth
+ */
+inline double pool_tuning_cost(const allocation_statistics & statistics, double bytes_per_upstream_call)
+{
+    return static_cast<double>(statistics.peak_upstream_bytes_in_use)
+        + bytes_per_upstream_call * static_cast<double>(statistics.upstream_allocations + statistics.upstream_deallocations);
+}
+
+/*! The outcome of \p tune_pool_options.
+ */
+struct pool_tuning_result
+{
+    /*! The best options found.
+     */
+    pool_options options;
+    /*! The statistics of the replay of the trace with \p options.
+     */
+    allocation_statistics statistics;
+    /*! The cost of that replay, as computed by \p pool_tuning_cost.
+     */
+    double cost;
+};
+
+/*! Searches for the pool options which minimize \p pool_tuning_cost for a trace. Starting from \p initial, it tries the
+ *      candidate values of one option at a time, keeping any that lowers the cost, and repeats the sweep until none does.
+ *      The alignment is never changed, since it is a requirement of the user rather than a trade-off.
+ *
+ *  \tparam Pool the type of the pool, constructible from \p pool_options alone
+ *  \param trace the requests to replay
+ *  \param bytes_per_upstream_call the number of bytes of footprint one upstream call is considered to be worth
+ *  \param initial the options to start the search from; these are also the result if nothing better is found
+ */
+template<typename Pool>
+pool_tuning_result tune_pool_options(const allocation_trace & trace, double bytes_per_upstream_call,
+    const pool_options & initial)
+{
+    struct knob
+    {
+        std::size_t pool_options::* option;
+        std::size_t first;
+        std::size_t last;
+        std::size_t factor;
+    };
+
+    const knob knobs[] = {
+        { &pool_options::min_blocks_per_chunk, 1, std::size_t(1) << 10, 4 },
+        { &pool_options::min_bytes_per_chunk, std::size_t(1) << 8, std::size_t(1) << 24, 4 },
+        { &pool_options::max_blocks_per_chunk, std::size_t(1) << 6, std::size_t(1) << 20, 4 },
+        { &pool_options::max_bytes_per_chunk, std::size_t(1) << 16, std::size_t(1) << 30, 4 },
+        { &pool_options::smallest_block_size, initial.alignment, std::size_t(1) << 10, 2 },
+        { &pool_options::largest_block_size, std::size_t(1) << 10, std::size_t(1) << 26, 4 },
+        { &pool_options::cached_size_cutoff_factor, 2, 64, 2 },
+        { &pool_options::cached_alignment_cutoff_factor, 2, 64, 2 }
+    };
+    const std::size_t num_knobs = sizeof(knobs) / sizeof(knobs[0]);
+
+    pool_tuning_result best;
+    best.options = initial;
+    best.statistics = replay_allocation_trace<Pool>(trace, initial);
+    best.cost = pool_tuning_cost(best.statistics, bytes_per_upstream_call);
+
+    for (bool improved = true; improved; )
+    {
+        improved = false;
+
+        for (std::size_t i = 0; i <= num_knobs; ++i)
+        {
+            std::vector<pool_options> candidates;
+
+            if (i == num_knobs)
+            {
+                pool_options candidate = best.options;
+                candidate.cache_oversized = !candidate.cache_oversized;
+                candidates.push_back(candidate);
+            }
+            else
+            {
+                for (std::size_t value = knobs[i].first; value <= knobs[i].last; value *= knobs[i].factor)
+                {
+                    pool_options candidate = best.options;
+                    candidate.*knobs[i].option = value;
+                    candidates.push_back(candidate);
+                }
+            }
+
+            for (std::size_t j = 0; j < candidates.size(); ++j)
+            {
+                if (!candidates[j].validate())
+                {
+                    continue;
+                }
+
+                allocation_statistics statistics = replay_allocation_trace<Pool>(trace, candidates[j]);
+                double cost = pool_tuning_cost(statistics, bytes_per_upstream_call);
+
+                if (cost < best.cost)
+                {
+                    best.options = candidates[j];
+                    best.statistics = statistics;
+                    best.cost = cost;
+                    improved = true;
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+/*! Searches for the pool options which minimize \p pool_tuning_cost for a trace, starting from the pool's default
+ *      options. See the other overload.
+ *
+ *  \tparam Pool the type of the pool, constructible from \p pool_options alone
+ *  \param trace the requests to replay
+ *  \param bytes_per_upstream_call the number of bytes of footprint one upstream call is considered to be worth
+ */
+template<typename Pool>
+pool_tuning_result tune_pool_options(const allocation_trace & trace, double bytes_per_upstream_call = 65536.0)
+{
+    return tune_pool_options<Pool>(trace, bytes_per_upstream_call, Pool::get_default_options());
+}
+
+/*! Writes the code initializing a \p pool_options variable to the given options.
+ *
+ *  \param file the stream to write the code to
+ *  \param options the options to write
+ *  \param name the name of the variable
+ */
+inline void print_pool_options(std::FILE * file, const pool_options & options, const char * name = "options")
+{
+    std::fprintf(file, "thrust::mr::pool_options %s;\n", name);
+    std::fprintf(file, "%s.min_blocks_per_chunk = %zu;\n", name, options.min_blocks_per_chunk);
+    std::fprintf(file, "%s.min_bytes_per_chunk = %zu;\n", name, options.min_bytes_per_chunk);
+    std::fprintf(file, "%s.max_blocks_per_chunk = %zu;\n", name, options.max_blocks_per_chunk);
+    std::fprintf(file, "%s.max_bytes_per_chunk = %zu;\n", name, options.max_bytes_per_chunk);
+    std::fprintf(file, "%s.smallest_block_size = %zu;\n", name, options.smallest_block_size);
+    std::fprintf(file, "%s.largest_block_size = %zu;\n", name, options.largest_block_size);
+    std::fprintf(file, "%s.alignment = %zu;\n", name, options.alignment);
+    std::fprintf(file, "%s.cache_oversized = %s;\n", name, options.cache_oversized ? "true" : "false");
+    std::fprintf(file, "%s.cached_size_cutoff_factor = %zu;\n", name, options.cached_size_cutoff_factor);
+    std::fprintf(file, "%s.cached_alignment_cutoff_factor = %zu;\n", name, options.cached_alignment_cutoff_factor);
+}
+
+/*! \}
+ */
+
+} // end mr
+} // end thrust
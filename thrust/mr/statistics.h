@@ -0,0 +1,452 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file statistics.h
+ *  \brief Allocation counters kept by the pooling resources, and a memory resource adaptor which collects them for any
+ *      resource and can record a trace of the allocation requests.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+
+#include <thrust/detail/integer_math.h>
+#include <thrust/detail/type_traits/pointer_traits.h>
+
+#include <thrust/mr/memory_resource.h>
+#include <thrust/mr/validator.h>
+
+namespace thrust
+{
+namespace mr
+{
+
+/*! \addtogroup memory_management Memory Management
+ *  \addtogroup memory_management_classes Memory Management Classes
+ *  \addtogroup memory_resources Memory Resources
+ *  \ingroup memory_resources
+ *  \{
+ */
+
+/*! Counters describing the behavior of a memory resource. Requests are binned by the base 2 logarithm of their size,
+ *      rounded up; the pooling resources bin a request by the size of the block serving it, at least
+ *      \p pool_options::smallest_block_size, so that the bins of sizes up to \p pool_options::largest_block_size are
+ *      exactly their buckets.
+ */
+struct allocation_statistics
+{
+    /*! The number of size bins, enough for any value of \p std::size_t.
+     */
+    static const std::size_t num_size_bins = sizeof(std::size_t) * 8;
+
+    /*! The number of calls to \p do_allocate.
+     */
+    std::size_t allocations;
+    /*! The number of calls to \p do_deallocate.
+     */
+    std::size_t deallocations;
+    /*! The number of bytes requested by the user and not yet deallocated.
+     */
+    std::size_t bytes_in_use;
+    /*! The maximum value \p bytes_in_use has reached.
+     */
+    std::size_t peak_bytes_in_use;
+
+    /*! The number of allocations made from the upstream resource.
+     */
+    std::size_t upstream_allocations;
+    /*! The number of deallocations made to the upstream resource.
+     */
+    std::size_t upstream_deallocations;
+    /*! The number of bytes currently held from the upstream resource, whether in use or cached.
+     */
+    std::size_t upstream_bytes_in_use;
+    /*! The maximum value \p upstream_bytes_in_use has reached.
+     */
+    std::size_t peak_upstream_bytes_in_use;
+
+    /*! The number of allocation requests in each size bin.
+     */
+    std::size_t size_histogram[num_size_bins];
+    /*! The number of allocation requests in each size bin that were served from memory already cached by the resource.
+     */
+    std::size_t cache_hits[num_size_bins];
+    /*! The number of allocation requests in each size bin that required an allocation from the upstream resource.
+     */
+    std::size_t cache_misses[num_size_bins];
+
+    allocation_statistics()
+    {
+        reset();
+    }
+
+    /*! Sets all counters to zero.
+     */
+    void reset()
+    {
+        allocations = 0;
+        deallocations = 0;
+        bytes_in_use = 0;
+        peak_bytes_in_use = 0;
+
+        upstream_allocations = 0;
+        upstream_deallocations = 0;
+        upstream_bytes_in_use = 0;
+        peak_upstream_bytes_in_use = 0;
+
+        for (std::size_t i = 0; i < num_size_bins; ++i)
+        {
+            size_histogram[i] = 0;
+            cache_hits[i] = 0;
+            cache_misses[i] = 0;
+        }
+    }
+
+    /*! Sets the counters of events to zero, and the peaks to the current values, keeping the numbers of bytes in use,
+     *      so that the statistics of a phase of a program can be collected while memory from earlier phases is in use.
+     */
+    void reset_counters()
+    {
+        std::size_t in_use = bytes_in_use;
+        std::size_t upstream_in_use = upstream_bytes_in_use;
+
+        reset();
+
+        bytes_in_use = peak_bytes_in_use = in_use;
+        upstream_bytes_in_use = peak_upstream_bytes_in_use = upstream_in_use;
+    }
+
+    /*! Returns the size bin of a request for \p bytes bytes.
+     */
+    static std::size_t size_bin(std::size_t bytes)
+    {
+        return bytes <= 1 ? 0 : thrust::detail::log2_ri(bytes);
+    }
+
+    /*! Returns the total number of allocation requests served from cached memory.
+     */
+    std::size_t total_cache_hits() const
+    {
+        std::size_t ret = 0;
+        for (std::size_t i = 0; i < num_size_bins; ++i)
+        {
+            ret += cache_hits[i];
+        }
+        return ret;
+    }
+
+    /*! Returns the total number of allocation requests that required an allocation from the upstream resource.
+     */
+    std::size_t total_cache_misses() const
+    {
+        std::size_t ret = 0;
+        for (std::size_t i = 0; i < num_size_bins; ++i)
+        {
+            ret += cache_misses[i];
+        }
+        return ret;
+    }
+
+    /*! Returns the fraction of allocation requests served from cached memory, or zero if there were none.
+     */
+    double hit_rate() const
+    {
+        std::size_t hits = total_cache_hits();
+        std::size_t requests = hits + total_cache_misses();
+        return requests ? static_cast<double>(hits) / requests : 0.0;
+    }
+
+    /*! Returns the fraction of allocation requests in a size bin served from cached memory, or zero if there were none.
+     */
+    double hit_rate(std::size_t bin) const
+    {
+        std::size_t requests = cache_hits[bin] + cache_misses[bin];
+        return requests ? static_cast<double>(cache_hits[bin]) / requests : 0.0;
+    }
+
+    /*! Returns the fraction of the memory held from the upstream resource which is not in use by the user, either because
+     *      it is cached, or because of rounding, alignment and bookkeeping overhead; zero if no memory is held.
+     */
+    double fragmentation() const
+    {
+        if (upstream_bytes_in_use == 0 || bytes_in_use >= upstream_bytes_in_use)
+        {
+            return 0.0;
+        }
+        return 1.0 - static_cast<double>(bytes_in_use) / upstream_bytes_in_use;
+    }
+
+    /*! Records an allocation request for \p bytes bytes.
+     */
+    void record_allocation(std::size_t bytes)
+    {
+        record_allocation(bytes, bytes);
+    }
+
+    /*! Records an allocation request for \p bytes bytes, in the size bin of \p block_bytes, the size of the block
+     *      serving it.
+     */
+    void record_allocation(std::size_t bytes, std::size_t block_bytes)
+    {
+        ++allocations;
+        ++size_histogram[size_bin(block_bytes)];
+        bytes_in_use += bytes;
+        if (bytes_in_use > peak_bytes_in_use)
+        {
+            peak_bytes_in_use = bytes_in_use;
+        }
+    }
+
+    /*! Records a deallocation request for \p bytes bytes.
+     */
+    void record_deallocation(std::size_t bytes)
+    {
+        ++deallocations;
+        bytes_in_use -= bytes;
+    }
+
+    /*! Records an allocation of \p bytes bytes from the upstream resource.
+     */
+    void record_upstream_allocation(std::size_t bytes)
+    {
+        ++upstream_allocations;
+        upstream_bytes_in_use += bytes;
+        if (upstream_bytes_in_use > peak_upstream_bytes_in_use)
+        {
+            peak_upstream_bytes_in_use = upstream_bytes_in_use;
+        }
+    }
+
+    /*! Records a deallocation of \p bytes bytes to the upstream resource.
+     */
+    void record_upstream_deallocation(std::size_t bytes)
+    {
+        ++upstream_deallocations;
+        upstream_bytes_in_use -= bytes;
+    }
+
+    /*! Adds the counters of another resource to these ones, e.g. to aggregate the statistics of several pools. The peaks
+     *      are added as well, which gives an upper bound of the peak of the aggregate.
+     */
+    allocation_statistics & operator+=(const allocation_statistics & other)
+    {
+        allocations += other.allocations;
+        deallocations += other.deallocations;
+        bytes_in_use += other.bytes_in_use;
+        peak_bytes_in_use += other.peak_bytes_in_use;
+
+        upstream_allocations += other.upstream_allocations;
+        upstream_deallocations += other.upstream_deallocations;
+        upstream_bytes_in_use += other.upstream_bytes_in_use;
+        peak_upstream_bytes_in_use += other.peak_upstream_bytes_in_use;
+
+        for (std::size_t i = 0; i < num_size_bins; ++i)
+        {
+            size_histogram[i] += other.size_histogram[i];
+            cache_hits[i] += other.cache_hits[i];
+            cache_misses[i] += other.cache_misses[i];
+        }
+
+        return *this;
+    }
+
+    /*! Writes a human readable summary of the counters to \p file.
+     */
+    void print(std::FILE * file) const
+    {
+        std::fprintf(file, "allocations: %zu, deallocations: %zu\n", allocations, deallocations);
+        std::fprintf(file, "bytes in use: %zu, peak: %zu\n", bytes_in_use, peak_bytes_in_use);
+        std::fprintf(file, "upstream allocations: %zu, deallocations: %zu\n", upstream_allocations, upstream_deallocations);
+        std::fprintf(file, "upstream bytes in use: %zu, peak: %zu\n", upstream_bytes_in_use, peak_upstream_bytes_in_use);
+        std::fprintf(file, "hit rate: %.4f, fragmentation: %.4f\n", hit_rate(), fragmentation());
+
+        for (std::size_t i = 0; i < num_size_bins; ++i)
+        {
+            if (size_histogram[i] != 0)
+            {
+                std::fprintf(file, "size <= %zu: %zu requests, %zu hits, %zu misses\n",
+                    static_cast<std::size_t>(1) << i, size_histogram[i], cache_hits[i], cache_misses[i]);
+            }
+        }
+    }
+};
+
+/*! A memory resource adaptor which forwards all requests to \p Upstream, keeping \p allocation_statistics about them, and
+ *      optionally recording them to an allocation trace. It makes the statistics available for resources that don't keep
+ *      them, such as \p new_delete_resource or \p fancy_pointer_resource, and lets the requests made to any resource,
+ *      including a pool, be recorded for offline replay.
+ *
+ *  A trace is a text file starting with the line <tt># thrust::mr allocation trace 1</tt>, followed by one line per
+ *      request: <tt>a bytes alignment address</tt> for allocations, and <tt>d bytes alignment address</tt> for
+ *      deallocations, with the address in hexadecimal. Addresses only serve to match deallocations with allocations,
+ *      and are reused once deallocated.
+ *
+ *  Like the unsynchronized pools, this adaptor is not thread safe.
+ *
+ *  \tparam Upstream the type of memory resource the requests are forwarded to
+ */
+template<typename Upstream>
+class statistics_resource THRUST_FINAL
+    : public memory_resource<typename Upstream::pointer>,
+        private validator<Upstream>
+{
+    typedef typename Upstream::pointer void_ptr;
+
+public:
+    /*! Constructor. The upstream resource is obtained by calling \p get_global_resource<Upstream>.
+     */
+    statistics_resource() : m_upstream(get_global_resource<Upstream>()), m_trace(NULL), m_owns_trace(false)
+    {
+    }
+
+    /*! Constructor.
+     *
+     *  \param upstream the upstream memory resource for allocations
+     */
+    statistics_resource(Upstream * upstream) : m_upstream(upstream), m_trace(NULL), m_owns_trace(false)
+    {
+    }
+
+    /*! Destructor. Closes the trace file, if it was opened by \p start_trace.
+     */
+    ~statistics_resource()
+    {
+        stop_trace();
+    }
+
+    THRUST_NODISCARD
+    virtual void_ptr do_allocate(std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        void_ptr p = m_upstream->do_allocate(bytes, alignment);
+
+        m_statistics.record_allocation(bytes);
+        m_statistics.record_upstream_allocation(bytes);
+        ++m_statistics.cache_misses[allocation_statistics::size_bin(bytes)];
+
+        record_event('a', p, bytes, alignment);
+
+        return p;
+    }
+
+    virtual void do_deallocate(void_ptr p, std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        record_event('d', p, bytes, alignment);
+
+        m_statistics.record_deallocation(bytes);
+        m_statistics.record_upstream_deallocation(bytes);
+
+        m_upstream->do_deallocate(p, bytes, alignment);
+    }
+
+    /*! Returns the statistics of the requests made so far. Every request is forwarded upstream, so the upstream counters
+     *      match the ones of the user's requests, and every allocation counts as a cache miss.
+     */
+    const allocation_statistics & statistics() const
+    {
+        return m_statistics;
+    }
+
+    /*! Resets the statistics, as described in \p allocation_statistics::reset_counters.
+     */
+    void reset_statistics()
+    {
+        m_statistics.reset_counters();
+    }
+
+    /*! Starts recording the requests to a trace file, replacing any trace being recorded.
+     *
+     *  \param filename the name of the file to write; it is truncated if it exists
+     *  \returns \p true if the file could be opened
+     */
+    bool start_trace(const char * filename)
+    {
+        stop_trace();
+
+        std::FILE * file = std::fopen(filename, "w");
+        if (!file)
+        {
+            return false;
+        }
+
+        start_trace(file);
+        m_owns_trace = true;
+
+        return true;
+    }
+
+    /*! Starts recording the requests to an open stream, replacing any trace being recorded. The stream is not closed by
+     *      the adaptor.
+     *
+     *  \param file the stream to write the trace to
+     */
+    void start_trace(std::FILE * file)
+    {
+        stop_trace();
+
+        m_trace = file;
+        m_owns_trace = false;
+        std::fprintf(m_trace, "# thrust::mr allocation trace 1\n");
+    }
+
+    /*! Stops recording the requests, closing the trace file if it was opened by the adaptor.
+     */
+    void stop_trace()
+    {
+        if (!m_trace)
+        {
+            return;
+        }
+
+        if (m_owns_trace)
+        {
+            std::fclose(m_trace);
+        }
+        else
+        {
+            std::fflush(m_trace);
+        }
+
+        m_trace = NULL;
+        m_owns_trace = false;
+    }
+
+private:
+    // not copyable, since the adaptor may own the trace file
+    statistics_resource(const statistics_resource &);
+    statistics_resource & operator=(const statistics_resource &);
+
+    void record_event(char type, void_ptr p, std::size_t bytes, std::size_t alignment)
+    {
+        if (m_trace)
+        {
+            std::fprintf(m_trace, "%c %zu %zu %p\n", type, bytes, alignment,
+                static_cast<void *>(thrust::detail::pointer_traits<void_ptr>::get(p)));
+        }
+    }
+
+    Upstream * m_upstream;
+    allocation_statistics m_statistics;
+
+    std::FILE * m_trace;
+    bool m_owns_trace;
+};
+
+/*! \}
+ */
+
+} // end mr
+} // end thrust
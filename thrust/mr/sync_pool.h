@@ -89,6 +89,33 @@ public:
         upstream_pool.release();
     }
 
+    /*! Returns memory which is cached, but not in use, to upstream. See \p unsynchronized_pool_resource::trim.
+     *
+     *  \param max_cached_bytes the amount of cached memory to retain
+     *  \returns the number of bytes returned to upstream
+     */
+    std::size_t trim(std::size_t max_cached_bytes = 0)
+    {
+        lock_t lock(mtx);
+        return upstream_pool.trim(max_cached_bytes);
+    }
+
+    /*! Returns a copy of the statistics of the requests made so far. See \p unsynchronized_pool_resource::statistics.
+     */
+    allocation_statistics statistics()
+    {
+        lock_t lock(mtx);
+        return upstream_pool.statistics();
+    }
+
+    /*! Resets the statistics, as described in \p allocation_statistics::reset_counters.
+     */
+    void reset_statistics()
+    {
+        lock_t lock(mtx);
+        upstream_pool.reset_statistics();
+    }
+
     THRUST_NODISCARD virtual void_ptr do_allocate(std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
     {
         lock_t lock(mtx);
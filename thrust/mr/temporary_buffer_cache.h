@@ -0,0 +1,261 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file temporary_buffer_cache.h
+ *  \brief A thread-safe pool with a bound on the memory it keeps cached, meant for the temporary storage of algorithms,
+ *      and a process-wide instance of it for the host systems.
+ */
+
+#pragma once
+
+#include <thrust/detail/cpp11_required.h>
+
+#if __cplusplus >= 201103L
+
+#include <algorithm>
+#include <mutex>
+
+#include <thrust/mr/pool.h>
+#include <thrust/mr/new.h>
+#include <thrust/mr/host_temporary_resource.h>
+
+namespace thrust
+{
+namespace mr
+{
+
+/*! \addtogroup memory_management Memory Management
+ *  \addtogroup memory_management_classes Memory Management Classes
+ *  \addtogroup memory_resources Memory Resources
+ *  \ingroup memory_resources
+ *  \{
+ */
+
+/*! A mutex-synchronized \p unsynchronized_pool_resource which keeps at most a given number of bytes of memory that is
+ *      not in use, returning the rest to upstream as it is deallocated. Algorithms called in a loop then reuse the same
+ *      scratch buffers instead of allocating them anew on every call, while a burst of large temporaries is not kept
+ *      around indefinitely. Uses \p std::mutex, and therefore requires C++11.
+ *
+ *  To use it for a single call, attach it to the execution policy: \p thrust::omp::par(&cache). To use it for all
+ *      algorithms executed by the host systems, see \p enable_host_temporary_buffer_cache.
+ *
+ *  \tparam Upstream the type of memory resources that will be used for allocating memory
+ */
+template<typename Upstream>
+class temporary_buffer_cache THRUST_FINAL
+    : public memory_resource<typename Upstream::pointer>,
+        private validator<Upstream>
+{
+    typedef unsynchronized_pool_resource<Upstream> unsync_pool;
+    typedef std::lock_guard<std::mutex> lock_t;
+
+    typedef typename Upstream::pointer void_ptr;
+
+public:
+    /*! The default bound on the number of bytes of cached memory that is not in use.
+     */
+    static const std::size_t default_max_cached_bytes = std::size_t(1) << 30;
+
+    /*! Get the default options for the underlying pool: those of \p unsynchronized_pool_resource, with oversized
+     *      blocks cached, since temporary buffers of algorithms are usually big.
+     */
+    static pool_options get_default_options()
+    {
+        pool_options ret = unsync_pool::get_default_options();
+        ret.cache_oversized = true;
+        return ret;
+    }
+
+    /*! Constructor.
+     *
+     *  \param upstream the upstream memory resource for allocations
+     *  \param max_cached_bytes the bound on the number of bytes of cached memory that is not in use
+     *  \param options pool options to use
+     */
+    temporary_buffer_cache(Upstream * upstream,
+            std::size_t max_cached_bytes = default_max_cached_bytes,
+            pool_options options = get_default_options())
+        : m_max_cached_bytes(max_cached_bytes), m_trim_threshold(max_cached_bytes), m_pool(upstream, options)
+    {
+    }
+
+    /*! Constructor. The upstream resource is obtained by calling \p get_global_resource<Upstream>.
+     *
+     *  \param max_cached_bytes the bound on the number of bytes of cached memory that is not in use
+     *  \param options pool options to use
+     */
+    temporary_buffer_cache(std::size_t max_cached_bytes = default_max_cached_bytes,
+            pool_options options = get_default_options())
+        : m_max_cached_bytes(max_cached_bytes), m_trim_threshold(max_cached_bytes), m_pool(get_global_resource<Upstream>(), options)
+    {
+    }
+
+    /*! Returns the bound on the number of bytes of cached memory that is not in use.
+     */
+    std::size_t max_cached_bytes()
+    {
+        lock_t lock(m_mtx);
+        return m_max_cached_bytes;
+    }
+
+    /*! Sets the bound on the number of bytes of cached memory that is not in use, returning memory above it to
+     *      upstream.
+     *
+     *  \param max_cached_bytes the new bound
+     */
+    void set_max_cached_bytes(std::size_t max_cached_bytes)
+    {
+        lock_t lock(m_mtx);
+        m_max_cached_bytes = max_cached_bytes;
+        trim_to_bound();
+    }
+
+    /*! Returns all cached memory that is not in use to upstream.
+     *
+     *  \returns the number of bytes returned to upstream
+     */
+    std::size_t trim()
+    {
+        lock_t lock(m_mtx);
+        std::size_t released = m_pool.trim(0);
+        m_trim_threshold = trim_threshold(unused_bytes());
+        return released;
+    }
+
+    /*! Releases all held memory to upstream, including memory in use.
+     */
+    void release()
+    {
+        lock_t lock(m_mtx);
+        m_pool.release();
+        m_trim_threshold = m_max_cached_bytes;
+    }
+
+    /*! Returns a copy of the statistics of the requests made so far. See \p unsynchronized_pool_resource::statistics.
+     */
+    allocation_statistics statistics()
+    {
+        lock_t lock(m_mtx);
+        return m_pool.statistics();
+    }
+
+    /*! Resets the statistics, as described in \p allocation_statistics::reset_counters.
+     */
+    void reset_statistics()
+    {
+        lock_t lock(m_mtx);
+        m_pool.reset_statistics();
+    }
+
+    THRUST_NODISCARD virtual void_ptr do_allocate(std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        lock_t lock(m_mtx);
+        void_ptr p = m_pool.do_allocate(bytes, alignment);
+
+        // follow the unused memory down, so that memory freed after it was reused is trimmed again
+        m_trim_threshold = (std::min)(m_trim_threshold, trim_threshold(unused_bytes()));
+
+        return p;
+    }
+
+    virtual void do_deallocate(void_ptr p, std::size_t n, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        lock_t lock(m_mtx);
+        m_pool.do_deallocate(p, n, alignment);
+
+        // the unused memory overestimates the cached memory, so only trim when it exceeds the threshold; trim does the
+        // exact accounting
+        if (unused_bytes() > m_trim_threshold)
+        {
+            trim_to_bound();
+        }
+    }
+
+private:
+    // the memory obtained from upstream which is not in use; besides the cached memory, this counts the unused parts of
+    // blocks and chunks, and the free blocks of chunks which are partially in use, none of which trim can return
+    std::size_t unused_bytes() const
+    {
+        const allocation_statistics & stats = m_pool.statistics();
+        return stats.upstream_bytes_in_use - stats.bytes_in_use;
+    }
+
+    // the unused memory above which deallocations trim again, given the unused memory after a trim; when trim could
+    // not get down to the bound, the next pass waits for the unused memory to grow by the bound or by half of what
+    // remained, whichever is more, so that the passes over the pool are amortized over the memory freed in between
+    std::size_t trim_threshold(std::size_t unused) const
+    {
+        if (unused <= m_max_cached_bytes)
+        {
+            return m_max_cached_bytes;
+        }
+
+        return unused + (std::max)(m_max_cached_bytes, unused / 2);
+    }
+
+    void trim_to_bound()
+    {
+        m_pool.trim(m_max_cached_bytes);
+        m_trim_threshold = trim_threshold(unused_bytes());
+    }
+
+    std::mutex m_mtx;
+    std::size_t m_max_cached_bytes;
+    // the unused memory above which deallocations trim the pool
+    std::size_t m_trim_threshold;
+    unsync_pool m_pool;
+};
+
+/*! Returns the process-wide \p temporary_buffer_cache used by \p enable_host_temporary_buffer_cache.
+ */
+inline temporary_buffer_cache<new_delete_resource> * get_host_temporary_buffer_cache()
+{
+    static temporary_buffer_cache<new_delete_resource> cache;
+    return &cache;
+}
+
+/*! Makes the temporary storage of all algorithms executed by the host systems (\p cpp, \p omp and \p tbb) come from
+ *      the process-wide \p temporary_buffer_cache, instead of \p malloc and \p free. Policies with an attached
+ *      allocator or memory resource keep using it.
+ *
+ *  \param max_cached_bytes the bound on the number of bytes of cached memory that is not in use
+ */
+inline void enable_host_temporary_buffer_cache(
+    std::size_t max_cached_bytes = temporary_buffer_cache<new_delete_resource>::default_max_cached_bytes)
+{
+    temporary_buffer_cache<new_delete_resource> * cache = get_host_temporary_buffer_cache();
+    cache->set_max_cached_bytes(max_cached_bytes);
+    host_temporary_resource::set(cache);
+}
+
+/*! Makes the temporary storage of algorithms executed by the host systems come from \p malloc and \p free again, and
+ *      returns the memory cached by the process-wide \p temporary_buffer_cache to upstream. Buffers which are still in
+ *      use are returned to upstream as they are deallocated.
+ */
+inline void disable_host_temporary_buffer_cache()
+{
+    temporary_buffer_cache<new_delete_resource> * cache = get_host_temporary_buffer_cache();
+    host_temporary_resource::set(NULL);
+    cache->set_max_cached_bytes(0);
+}
+
+/*! \}
+ */
+
+} // end mr
+} // end thrust
+
+#endif
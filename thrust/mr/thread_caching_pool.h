@@ -0,0 +1,470 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file thread_caching_pool.h
+ *  \brief A thread-safe pooling resource adaptor which caches small blocks per thread in front of sharded central pools.
+ */
+
+#pragma once
+
+#include <thrust/detail/cpp11_required.h>
+
+#if __cplusplus >= 201103L
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <thrust/mr/pool.h>
+
+namespace thrust
+{
+namespace mr
+{
+
+/*! \addtogroup memory_management Memory Management
+ *  \addtogroup memory_management_classes Memory Management Classes
+ *  \addtogroup memory_resources Memory Resources
+ *  \ingroup memory_resources
+ *  \{
+ */
+
+/*! A thread-safe memory resource adaptor allowing for pooling and caching allocations from \p Upstream, designed for
+ *      many threads allocating and deallocating concurrently. Uses \p std::mutex and \p thread_local, and therefore
+ *      requires C++11.
+ *
+ *  \p synchronized_pool_resource serializes every allocation and deallocation on a single mutex. This resource instead
+ *      keeps a magazine of free blocks of every size class for each thread, in front of one central
+ *      \p unsynchronized_pool_resource per size class. Allocations and deallocations of blocks up to
+ *      \p pool_options::largest_block_size are served from the calling thread's magazine, under the magazine's own,
+ *      normally uncontended, mutex. The magazine talks to the central pool of that size class only when it runs empty
+ *      or full, once per batch of half a magazine.
+ *
+ *  Blocks of a given size class are interchangeable, so a block freed by a thread other than the one that allocated it
+ *      simply enters the freeing thread's magazine, and returns to the central pool with the next batch.
+ *
+ *  Threads are mapped onto a fixed set of magazines, twice as many as \p std::thread::hardware_concurrency reports and
+ *      at least \p min_thread_caches; if more threads use the resource, some share a magazine, which remains correct but
+ *      may contend.
+ *
+ *  Oversized and overaligned allocations are forwarded to a separate, mutex-synchronized
+ *      \p unsynchronized_pool_resource, and cached according to \p pool_options::cache_oversized.
+ *
+ *  The central pools may call \p Upstream concurrently with one another; these calls are serialized by the adaptor,
+ *      so \p Upstream does not need to be thread-safe.
+ *
+ *  \tparam Upstream the type of memory resources that will be used for allocating memory blocks
+ */
+template<typename Upstream>
+class thread_caching_pool_resource THRUST_FINAL
+    : public memory_resource<typename Upstream::pointer>,
+        private validator<Upstream>
+{
+    typedef typename Upstream::pointer void_ptr;
+    typedef std::lock_guard<std::mutex> lock_t;
+
+    // serializes the calls the central pools make to the upstream resource
+    class locked_upstream THRUST_FINAL : public memory_resource<void_ptr>
+    {
+    public:
+        locked_upstream(Upstream * upstream) : m_upstream(upstream)
+        {
+        }
+
+        THRUST_NODISCARD virtual void_ptr do_allocate(std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+        {
+            lock_t lock(m_mtx);
+            return m_upstream->do_allocate(bytes, alignment);
+        }
+
+        virtual void do_deallocate(void_ptr p, std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+        {
+            lock_t lock(m_mtx);
+            m_upstream->do_deallocate(p, bytes, alignment);
+        }
+
+    private:
+        Upstream * m_upstream;
+        std::mutex m_mtx;
+    };
+
+    typedef unsynchronized_pool_resource<locked_upstream> central_pool;
+
+    struct central_shard
+    {
+        central_shard(locked_upstream * upstream, pool_options options) : pool(upstream, options)
+        {
+        }
+
+        std::mutex mtx;
+        central_pool pool;
+    };
+
+    struct thread_cache
+    {
+        std::mutex mtx;
+        // m_magazine_size free blocks for every size class, followed by the number of blocks in each magazine
+        std::vector<void_ptr> blocks;
+        std::vector<std::size_t> counts;
+        // the requests for blocks up to the largest size class made through this cache
+        allocation_statistics statistics;
+        // keep the magazines of different threads on different cache lines
+        char padding[64];
+    };
+
+public:
+    /*! The number of blocks of each size class a thread caches by default.
+     */
+    static const std::size_t default_magazine_size = 32;
+
+    /*! The minimum number of magazine sets threads are mapped onto, regardless of the reported hardware concurrency.
+     */
+    static const std::size_t min_thread_caches = 16;
+
+    /*! Get the default options for a pool. These are meant to be a sensible set of values for many use cases,
+     *      and as such, may be tuned in the future. This function is exposed so that creating a set of options that are
+     *      just a slight departure from the defaults is easy.
+     */
+    static pool_options get_default_options()
+    {
+        return central_pool::get_default_options();
+    }
+
+    /*! Constructor.
+     *
+     *  \param upstream the upstream memory resource for allocations
+     *  \param options pool options to use
+     *  \param magazine_size the number of blocks of each size class cached by each thread
+     */
+    thread_caching_pool_resource(Upstream * upstream, pool_options options = get_default_options(),
+        std::size_t magazine_size = default_magazine_size)
+        : m_upstream(upstream),
+        m_options(options),
+        m_smallest_block_log2(detail::log2_ri(m_options.smallest_block_size)),
+        m_magazine_size((std::max)(magazine_size, std::size_t(2))),
+        m_oversized(new central_shard(&m_upstream, options))
+    {
+        assert(m_options.validate());
+
+        std::size_t num_classes = detail::log2_ri(m_options.largest_block_size) - m_smallest_block_log2 + 1;
+
+        // each central pool serves exactly one size class
+        for (std::size_t i = 0; i < num_classes; ++i)
+        {
+            pool_options class_options = m_options;
+            class_options.smallest_block_size = m_options.smallest_block_size << i;
+            class_options.largest_block_size = class_options.smallest_block_size;
+
+            m_shards.push_back(std::unique_ptr<central_shard>(new central_shard(&m_upstream, class_options)));
+        }
+
+        // the magazines themselves are only allocated once a thread uses them
+        std::size_t num_caches = 2 * static_cast<std::size_t>(std::thread::hardware_concurrency());
+        if (num_caches < min_thread_caches)
+        {
+            num_caches = min_thread_caches;
+        }
+
+        for (std::size_t i = 0; i < num_caches; ++i)
+        {
+            m_caches.push_back(std::unique_ptr<thread_cache>(new thread_cache()));
+        }
+    }
+
+    /*! Constructor. The upstream resource is obtained by calling \p get_global_resource<Upstream>.
+     *
+     *  \param options pool options to use
+     *  \param magazine_size the number of blocks of each size class cached by each thread
+     */
+    thread_caching_pool_resource(pool_options options = get_default_options(),
+        std::size_t magazine_size = default_magazine_size)
+        : thread_caching_pool_resource(get_global_resource<Upstream>(), options, magazine_size)
+    {
+    }
+
+    /*! Destructor. Releases all held memory to upstream.
+     */
+    ~thread_caching_pool_resource()
+    {
+        release();
+    }
+
+    /*! Releases all held memory to upstream. Must not be called concurrently with allocations and deallocations.
+     */
+    void release()
+    {
+        // the blocks in the magazines belong to the central pools' chunks, so forgetting them is enough
+        for (std::size_t i = 0; i < m_caches.size(); ++i)
+        {
+            lock_t lock(m_caches[i]->mtx);
+            std::fill(m_caches[i]->counts.begin(), m_caches[i]->counts.end(), std::size_t(0));
+        }
+
+        for (std::size_t i = 0; i < m_shards.size(); ++i)
+        {
+            lock_t lock(m_shards[i]->mtx);
+            m_shards[i]->pool.release();
+        }
+
+        lock_t lock(m_oversized->mtx);
+        m_oversized->pool.release();
+    }
+
+    /*! Returns the blocks cached by all threads to the central pools, then returns memory which is cached, but not in
+     *      use, to upstream. \p max_cached_bytes applies to each central pool separately. See
+     *      \p unsynchronized_pool_resource::trim.
+     *
+     *  \param max_cached_bytes the amount of cached memory to retain in each central pool
+     *  \returns the number of bytes returned to upstream
+     */
+    std::size_t trim(std::size_t max_cached_bytes = 0)
+    {
+        for (std::size_t i = 0; i < m_caches.size(); ++i)
+        {
+            thread_cache & cache = *m_caches[i];
+            lock_t lock(cache.mtx);
+
+            for (std::size_t class_idx = 0; class_idx < cache.counts.size(); ++class_idx)
+            {
+                void_ptr * magazine = &cache.blocks[class_idx * m_magazine_size];
+                std::size_t & count = cache.counts[class_idx];
+
+                central_shard & shard = *m_shards[class_idx];
+                lock_t shard_lock(shard.mtx);
+
+                for (; count > 0; --count)
+                {
+                    shard.pool.do_deallocate(magazine[count - 1], m_options.smallest_block_size << class_idx, m_options.alignment);
+                }
+            }
+        }
+
+        std::size_t released_bytes = 0;
+
+        for (std::size_t i = 0; i < m_shards.size(); ++i)
+        {
+            lock_t lock(m_shards[i]->mtx);
+            released_bytes += m_shards[i]->pool.trim(max_cached_bytes);
+        }
+
+        lock_t lock(m_oversized->mtx);
+        released_bytes += m_oversized->pool.trim(max_cached_bytes);
+
+        return released_bytes;
+    }
+
+    /*! Returns the statistics of the requests made so far. Requests for blocks up to the largest size class are counted
+     *      by the thread caches, where a miss is a request that found the magazine empty; oversized requests are counted by
+     *      the central pool serving them. The upstream counters are exact, but their peak is the sum of the peaks of all
+     *      central pools. The peak of the bytes in use is not tracked, since that would take a counter shared by all
+     *      threads, and is reported as the number of bytes currently in use.
+     *
+     *  Must not be called concurrently with \p reset_statistics.
+     */
+    allocation_statistics statistics()
+    {
+        allocation_statistics ret;
+
+        for (std::size_t i = 0; i < m_caches.size(); ++i)
+        {
+            lock_t lock(m_caches[i]->mtx);
+            ret += m_caches[i]->statistics;
+        }
+
+        for (std::size_t i = 0; i < m_shards.size(); ++i)
+        {
+            lock_t lock(m_shards[i]->mtx);
+            const allocation_statistics & central = m_shards[i]->pool.statistics();
+
+            ret.upstream_allocations += central.upstream_allocations;
+            ret.upstream_deallocations += central.upstream_deallocations;
+            ret.upstream_bytes_in_use += central.upstream_bytes_in_use;
+            ret.peak_upstream_bytes_in_use += central.peak_upstream_bytes_in_use;
+        }
+
+        {
+            lock_t lock(m_oversized->mtx);
+            ret += m_oversized->pool.statistics();
+        }
+
+        ret.peak_bytes_in_use = ret.bytes_in_use;
+
+        return ret;
+    }
+
+    /*! Resets the statistics, as described in \p allocation_statistics::reset_counters.
+     */
+    void reset_statistics()
+    {
+        for (std::size_t i = 0; i < m_caches.size(); ++i)
+        {
+            lock_t lock(m_caches[i]->mtx);
+            m_caches[i]->statistics.reset_counters();
+        }
+
+        for (std::size_t i = 0; i < m_shards.size(); ++i)
+        {
+            lock_t lock(m_shards[i]->mtx);
+            m_shards[i]->pool.reset_statistics();
+        }
+
+        lock_t lock(m_oversized->mtx);
+        m_oversized->pool.reset_statistics();
+    }
+
+    THRUST_NODISCARD virtual void_ptr do_allocate(std::size_t bytes, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        std::size_t requested = bytes;
+        bytes = (std::max)(bytes, m_options.smallest_block_size);
+        assert(detail::is_power_of_2(alignment));
+
+        // an oversized and/or overaligned allocation requested; bypass the magazines
+        if (bytes > m_options.largest_block_size || alignment > m_options.alignment)
+        {
+            lock_t lock(m_oversized->mtx);
+            return m_oversized->pool.do_allocate(bytes, alignment);
+        }
+
+        std::size_t bytes_log2 = detail::log2_ri(bytes);
+        std::size_t class_idx = bytes_log2 - m_smallest_block_log2;
+
+        thread_cache & cache = local_cache();
+        lock_t lock(cache.mtx);
+        prepare_cache(cache);
+
+        void_ptr * magazine = &cache.blocks[class_idx * m_magazine_size];
+        std::size_t & count = cache.counts[class_idx];
+
+        // the bytes in use are only meaningful summed over all caches, since blocks may be freed by other threads; keep
+        // the per-cache peak, which would be wrong, at zero
+        ++cache.statistics.allocations;
+        ++cache.statistics.size_histogram[bytes_log2];
+        cache.statistics.bytes_in_use += requested;
+
+        // the magazine is empty; take half a magazine of blocks from the central pool at once
+        if (count == 0)
+        {
+            ++cache.statistics.cache_misses[bytes_log2];
+
+            central_shard & shard = *m_shards[class_idx];
+            lock_t shard_lock(shard.mtx);
+
+            for (; count < m_magazine_size / 2; ++count)
+            {
+                magazine[count] = shard.pool.do_allocate(m_options.smallest_block_size << class_idx, m_options.alignment);
+            }
+        }
+        else
+        {
+            ++cache.statistics.cache_hits[bytes_log2];
+        }
+
+        return magazine[--count];
+    }
+
+    virtual void do_deallocate(void_ptr p, std::size_t n, std::size_t alignment = THRUST_MR_DEFAULT_ALIGNMENT) THRUST_OVERRIDE
+    {
+        std::size_t requested = n;
+        n = (std::max)(n, m_options.smallest_block_size);
+        assert(detail::is_power_of_2(alignment));
+
+        // the deallocated block is oversized and/or overaligned
+        if (n > m_options.largest_block_size || alignment > m_options.alignment)
+        {
+            lock_t lock(m_oversized->mtx);
+            m_oversized->pool.do_deallocate(p, n, alignment);
+            return;
+        }
+
+        std::size_t class_idx = detail::log2_ri(n) - m_smallest_block_log2;
+
+        thread_cache & cache = local_cache();
+        lock_t lock(cache.mtx);
+        prepare_cache(cache);
+
+        void_ptr * magazine = &cache.blocks[class_idx * m_magazine_size];
+        std::size_t & count = cache.counts[class_idx];
+
+        ++cache.statistics.deallocations;
+        cache.statistics.bytes_in_use -= requested;
+
+        // the magazine is full; return its least recently freed half to the central pool at once
+        if (count == m_magazine_size)
+        {
+            std::size_t batch = m_magazine_size / 2;
+
+            {
+                central_shard & shard = *m_shards[class_idx];
+                lock_t shard_lock(shard.mtx);
+
+                for (std::size_t i = 0; i < batch; ++i)
+                {
+                    shard.pool.do_deallocate(magazine[i], m_options.smallest_block_size << class_idx, m_options.alignment);
+                }
+            }
+
+            std::copy(magazine + batch, magazine + count, magazine);
+            count -= batch;
+        }
+
+        magazine[count++] = p;
+    }
+
+private:
+    // a small integer identifying the calling thread, assigned on its first use of any such resource
+    static std::size_t thread_index()
+    {
+        static std::atomic<std::size_t> next_index(0);
+        static thread_local std::size_t index = next_index++;
+        return index;
+    }
+
+    thread_cache & local_cache()
+    {
+        return *m_caches[thread_index() % m_caches.size()];
+    }
+
+    // allocates the magazines of a cache on first use; must be called with the cache's mutex held
+    void prepare_cache(thread_cache & cache)
+    {
+        if (cache.counts.empty())
+        {
+            cache.blocks.resize(m_shards.size() * m_magazine_size);
+            cache.counts.resize(m_shards.size(), 0);
+        }
+    }
+
+    locked_upstream m_upstream;
+
+    pool_options m_options;
+    std::size_t m_smallest_block_log2;
+    std::size_t m_magazine_size;
+
+    std::unique_ptr<central_shard> m_oversized;
+    std::vector<std::unique_ptr<central_shard> > m_shards;
+    std::vector<std::unique_ptr<thread_cache> > m_caches;
+};
+
+/*! \}
+ */
+
+} // end mr
+} // end thrust
+
+#endif
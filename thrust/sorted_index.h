@@ -0,0 +1,183 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file sorted_index.h
+ *  \brief A read-only search index over a sorted range, laid out for cache-friendly binary searches
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/detail/vector_base.h>
+#include <thrust/detail/execution_policy.h>
+#include <thrust/functional.h>
+#include <memory>
+
+namespace thrust
+{
+
+/*! \addtogroup container_classes Container Classes
+ *  \{
+ */
+
+/*! A \p sorted_index holds a copy of a sorted range in Eytzinger order: the elements are stored in the breadth-first
+ *      order of the implicit binary search tree over the range, so the first levels of every search share the same few
+ *      cache lines, and the children of a node sit next to each other. Searches walk down the tree without branching
+ *      on the comparison and prefetch the nodes a few levels ahead, which makes them considerably faster than
+ *      \p thrust::lower_bound on the sorted range once it does not fit in cache.
+ *
+ *  The index is built once, in parallel with the system of its storage or of a given execution policy, and is then
+ *      queried any number of times. Results are positions in the original sorted range, exactly as returned by the
+ *      vectorized versions of \p thrust::lower_bound and \p thrust::upper_bound.
+ *
+ *  The storage is allocated with \p Alloc, and batched queries run on the system of the query iterators or of the
+ *      given execution policy, which must be able to access that storage; with the default allocator, this means
+ *      \p thrust::cpp, \p thrust::omp or \p thrust::tbb.
+ *
+ *  \tparam T the type of the elements
+ *  \tparam StrictWeakOrdering the ordering the range is sorted by
+ *  \tparam Alloc the allocator of the storage
+ */
+template<typename T,
+         typename StrictWeakOrdering = thrust::less<T>,
+         typename Alloc = std::allocator<T> >
+  class sorted_index
+{
+  private:
+    typedef thrust::detail::vector_base<T, Alloc> storage_type;
+
+  public:
+    typedef T value_type;
+    typedef StrictWeakOrdering value_compare;
+    typedef Alloc allocator_type;
+    typedef std::size_t size_type;
+
+    /*! Creates an empty index.
+     */
+    explicit sorted_index(StrictWeakOrdering comp = StrictWeakOrdering());
+
+    /*! Creates an index over the sorted range <tt>[first, last)</tt>. The range may live in any memory space;
+     *      when its system cannot access the storage of the index, it is copied first.
+     *
+     *  \param first the beginning of the sorted range
+     *  \param last the end of the sorted range
+     *  \param comp the ordering the range is sorted by
+     */
+    template<typename InputIterator>
+    sorted_index(InputIterator first, InputIterator last, StrictWeakOrdering comp = StrictWeakOrdering());
+
+    /*! Creates an index over the sorted range <tt>[first, last)</tt>, permuting it into the index with \p exec.
+     *
+     *  \param exec the execution policy to build the index with
+     *  \param first the beginning of the sorted range, which must be random access and accessible by \p exec
+     *  \param last the end of the sorted range
+     *  \param comp the ordering the range is sorted by
+     */
+    template<typename DerivedPolicy, typename RandomAccessIterator>
+    sorted_index(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                 RandomAccessIterator first, RandomAccessIterator last,
+                 StrictWeakOrdering comp = StrictWeakOrdering());
+
+    /*! \returns the number of elements in the index
+     */
+    size_type size() const { return m_size; }
+
+    /*! \returns whether the index is empty
+     */
+    bool empty() const { return m_size == 0; }
+
+    /*! \returns the ordering of the index
+     */
+    value_compare value_comp() const { return m_comp; }
+
+    /*! Searches for the first position in the sorted range at which \p value could be inserted without violating the
+     *      ordering.
+     *
+     *  \param value the value to search for
+     *  \returns the position, in <tt>[0, size()]</tt>
+     */
+    template<typename U>
+    size_type lower_bound(const U &value) const;
+
+    /*! Searches for the last position in the sorted range at which \p value could be inserted without violating the
+     *      ordering.
+     *
+     *  \param value the value to search for
+     *  \returns the position, in <tt>[0, size()]</tt>
+     */
+    template<typename U>
+    size_type upper_bound(const U &value) const;
+
+    /*! \returns whether an element equivalent to \p value is in the index
+     */
+    template<typename U>
+    bool binary_search(const U &value) const;
+
+    /*! Writes the lower bound of every value in <tt>[values_first, values_last)</tt> to \p result, on the system of
+     *      the iterators.
+     *
+     *  \returns the end of the output range
+     */
+    template<typename InputIterator, typename OutputIterator>
+    OutputIterator lower_bound(InputIterator values_first, InputIterator values_last, OutputIterator result) const;
+
+    /*! Writes the lower bound of every value in <tt>[values_first, values_last)</tt> to \p result, using \p exec.
+     *
+     *  \returns the end of the output range
+     */
+    template<typename DerivedPolicy, typename InputIterator, typename OutputIterator>
+    OutputIterator lower_bound(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                               InputIterator values_first, InputIterator values_last, OutputIterator result) const;
+
+    /*! Writes the upper bound of every value in <tt>[values_first, values_last)</tt> to \p result, on the system of
+     *      the iterators.
+     *
+     *  \returns the end of the output range
+     */
+    template<typename InputIterator, typename OutputIterator>
+    OutputIterator upper_bound(InputIterator values_first, InputIterator values_last, OutputIterator result) const;
+
+    /*! Writes the upper bound of every value in <tt>[values_first, values_last)</tt> to \p result, using \p exec.
+     *
+     *  \returns the end of the output range
+     */
+    template<typename DerivedPolicy, typename InputIterator, typename OutputIterator>
+    OutputIterator upper_bound(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                               InputIterator values_first, InputIterator values_last, OutputIterator result) const;
+
+  private:
+    template<typename DerivedPolicy, typename RandomAccessIterator>
+    void build(const thrust::detail::execution_policy_base<DerivedPolicy> &exec, RandomAccessIterator first);
+
+    template<typename InputIterator>
+    void build(InputIterator first, InputIterator last, thrust::detail::true_type);
+
+    template<typename InputIterator>
+    void build(InputIterator first, InputIterator last, thrust::detail::false_type);
+
+    // the tree is 1-based, element 0 of the storage is unused
+    storage_type m_storage;
+    size_type m_size;
+    StrictWeakOrdering m_comp;
+};
+
+/*! \}
+ */
+
+} // end thrust
+
+#include <thrust/detail/sorted_index.inl>
+
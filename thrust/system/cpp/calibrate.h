@@ -0,0 +1,124 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file thrust/system/cpp/calibrate.h
+ *  \brief Measures the thresholds of \p thrust::tuning used by the standard C++ system
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+
+#if __cplusplus >= 201103L
+
+#include <thrust/sort.h>
+#include <thrust/tuning.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/static_assert.h>
+#include <thrust/detail/type_traits.h>
+#include <thrust/system/detail/internal/calibrate.h>
+#include <cstddef>
+#include <vector>
+
+namespace thrust
+{
+namespace system
+{
+namespace cpp
+{
+namespace detail
+{
+namespace calibrate_detail
+{
+
+
+// orders like less, without being recognized as less, so that sorts use a comparison sort
+template<typename T>
+  struct comparison_less
+{
+  bool operator()(const T &lhs, const T &rhs) const
+  {
+    return lhs < rhs;
+  }
+};
+
+
+} // end calibrate_detail
+} // end detail
+
+
+/*! \addtogroup utility
+ *  \{
+ */
+
+/*! \p calibrate measures, on this machine, the values of the parameters of \p thrust::tuning used by the standard
+ *      C++ system for elements of type \p T, and sets them in the table for elements of the size of \p T.
+ *
+ *  This sets \p thrust::tuning::merge_sort_partition_size to the partition size for which sorting 65536 elements with
+ *      a comparison sort is fastest. It takes about a second; the results can be kept with \p thrust::tuning::save.
+ *
+ *  \tparam T An arithmetic type.
+ *
+ *  \see thrust::tuning
+ */
+template<typename T>
+void calibrate()
+{
+  THRUST_STATIC_ASSERT( thrust::detail::is_arithmetic<T>::value );
+
+  const std::size_t candidates[] = {8, 16, 24, 32, 48, 64, 96, 128};
+  const std::size_t num_candidates = sizeof(candidates) / sizeof(candidates[0]);
+
+  const std::vector<T> input = thrust::system::detail::internal::calibration_input<T>(1 << 16);
+
+  std::size_t best_partition_size = candidates[0];
+  double best_time = 0;
+
+  for(std::size_t i = 0; i < num_candidates; ++i)
+  {
+    thrust::tuning::set(thrust::tuning::merge_sort_partition_size, sizeof(T), candidates[i]);
+
+    const double time = thrust::system::detail::internal::calibration_time(input, [](std::vector<T> &v)
+    {
+      thrust::stable_sort(thrust::seq, v.begin(), v.end(), detail::calibrate_detail::comparison_less<T>());
+    });
+
+    if(i == 0 || time < best_time)
+    {
+      best_partition_size = candidates[i];
+      best_time = time;
+    }
+  }
+
+  thrust::tuning::set(thrust::tuning::merge_sort_partition_size, sizeof(T), best_partition_size);
+} // end calibrate()
+
+/*! \}
+ */
+
+} // end cpp
+} // end system
+
+namespace cpp
+{
+
+using thrust::system::cpp::calibrate;
+
+} // end cpp
+} // end thrust
+
+#endif // __cplusplus >= 201103L
+
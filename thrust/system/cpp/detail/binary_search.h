@@ -18,6 +18,93 @@
 
 #include <thrust/system/cpp/detail/execution_policy.h>
 
-// this system inherits the binary search algorithms
+// this system inherits the scalar binary search algorithms
 #include <thrust/system/detail/sequential/binary_search.h>
+#include <thrust/system/detail/internal/sorted_search.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace cpp
+{
+namespace detail
+{
+namespace binary_search_detail
+{
+
+
+template<typename RandomAccessIterator1, typename RandomAccessIterator2, typename RandomAccessIterator3, typename Search>
+RandomAccessIterator3 sorted_search(RandomAccessIterator1 begin,
+                                    RandomAccessIterator1 end,
+                                    RandomAccessIterator2 values_begin,
+                                    RandomAccessIterator2 values_end,
+                                    RandomAccessIterator3 output,
+                                    Search search)
+{
+  typedef typename thrust::iterator_difference<RandomAccessIterator1>::type Size;
+
+  const Size m = values_end - values_begin;
+
+  thrust::system::detail::internal::sorted_search_tile(begin, Size(end - begin), values_begin, Size(0), m, output, search);
+
+  return output + m;
+}
+
+
+} // end binary_search_detail
+
+
+// the vectorized searches gallop from one answer to the next when the queries
+// are sorted; omp and tbb override these with parallel versions
+
+template <typename DerivedPolicy, typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+typename thrust::system::detail::internal::enable_if_sorted_search<ForwardIterator,InputIterator,OutputIterator,OutputIterator>::type
+  lower_bound(execution_policy<DerivedPolicy> &,
+              ForwardIterator begin,
+              ForwardIterator end,
+              InputIterator values_begin,
+              InputIterator values_end,
+              OutputIterator output,
+              StrictWeakOrdering comp)
+{
+  return binary_search_detail::sorted_search(begin, end, values_begin, values_end, output,
+    thrust::system::detail::internal::sorted_lower_bound<StrictWeakOrdering>(comp));
+}
+
+
+template <typename DerivedPolicy, typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+typename thrust::system::detail::internal::enable_if_sorted_search<ForwardIterator,InputIterator,OutputIterator,OutputIterator>::type
+  upper_bound(execution_policy<DerivedPolicy> &,
+              ForwardIterator begin,
+              ForwardIterator end,
+              InputIterator values_begin,
+              InputIterator values_end,
+              OutputIterator output,
+              StrictWeakOrdering comp)
+{
+  return binary_search_detail::sorted_search(begin, end, values_begin, values_end, output,
+    thrust::system::detail::internal::sorted_upper_bound<StrictWeakOrdering>(comp));
+}
+
+
+template <typename DerivedPolicy, typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+typename thrust::system::detail::internal::enable_if_sorted_search<ForwardIterator,InputIterator,OutputIterator,OutputIterator>::type
+  binary_search(execution_policy<DerivedPolicy> &,
+                ForwardIterator begin,
+                ForwardIterator end,
+                InputIterator values_begin,
+                InputIterator values_end,
+                OutputIterator output,
+                StrictWeakOrdering comp)
+{
+  return binary_search_detail::sorted_search(begin, end, values_begin, values_end, output,
+    thrust::system::detail::internal::sorted_binary_search<StrictWeakOrdering>(comp));
+}
+
+
+} // end detail
+} // end cpp
+} // end system
+} // end thrust
 
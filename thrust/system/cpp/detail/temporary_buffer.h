@@ -14,9 +14,69 @@
  *  limitations under the License.
  */
 
+
 #pragma once
 
 #include <thrust/detail/config.h>
 
-// this system has no special temporary buffer functions
+#if __cplusplus >= 201103L
+
+#include <thrust/system/cpp/detail/execution_policy.h>
+#include <thrust/system/detail/generic/temporary_buffer.h>
+#include <thrust/mr/host_temporary_resource.h>
+#include <thrust/detail/pointer.h>
+#include <thrust/detail/raw_pointer_cast.h>
+#include <thrust/pair.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace cpp
+{
+namespace detail
+{
+
+
+// the temporary storage of the host systems (omp and tbb inherit these) comes from
+// thrust::mr::host_temporary_resource when the user has set one, and from malloc otherwise
+
+template<typename T, typename DerivedPolicy>
+__host__ __device__
+  thrust::pair<thrust::pointer<T,DerivedPolicy>, typename thrust::pointer<T,DerivedPolicy>::difference_type>
+    get_temporary_buffer(execution_policy<DerivedPolicy> &exec, typename thrust::pointer<T,DerivedPolicy>::difference_type n)
+{
+#if !defined(__HIP_DEVICE_COMPILE__) && !defined(__CUDA_ARCH__)
+  void *ptr = thrust::mr::host_temporary_resource::allocate(n * sizeof(T));
+
+  if(ptr)
+  {
+    return thrust::make_pair(thrust::pointer<T,DerivedPolicy>(static_cast<T*>(ptr)), n);
+  } // end if
+#endif
+
+  return thrust::system::detail::generic::get_temporary_buffer<T>(exec, n);
+} // end get_temporary_buffer()
+
+
+template<typename DerivedPolicy, typename Pointer>
+__host__ __device__
+  void return_temporary_buffer(execution_policy<DerivedPolicy> &exec, Pointer p)
+{
+#if !defined(__HIP_DEVICE_COMPILE__) && !defined(__CUDA_ARCH__)
+  if(thrust::mr::host_temporary_resource::deallocate(thrust::raw_pointer_cast(p)))
+  {
+    return;
+  } // end if
+#endif
+
+  thrust::system::detail::generic::return_temporary_buffer(exec, p);
+} // end return_temporary_buffer()
+
+
+} // end detail
+} // end cpp
+} // end system
+} // end thrust
 
+#endif
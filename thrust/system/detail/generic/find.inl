@@ -17,6 +17,7 @@
 #include <thrust/detail/config.h>
 #include <thrust/find.h>
 #include <thrust/reduce.h>
+#include <thrust/tuning.h>
 
 #include <thrust/tuple.h>
 #include <thrust/detail/minmax.h>
@@ -91,8 +92,13 @@ InputIterator find_if(thrust::execution_policy<DerivedPolicy> &exec,
   // this implementation breaks up the sequence into separate intervals
   // in an attempt to early-out as soon as a value is found
   
-  // TODO incorporate sizeof(InputType) into interval_threshold and round to multiple of 32
+  // the interval size can be tuned per element size, except in device code, see thrust::tuning::generic_find_interval_size
+#if !defined(__CUDA_ARCH__) && !defined(__HIP_DEVICE_COMPILE__)
+  typedef typename thrust::iterator_value<InputIterator>::type input_type;
+  const difference_type interval_threshold = static_cast<difference_type>(thrust::tuning::get<input_type>(thrust::tuning::generic_find_interval_size));
+#else
   const difference_type interval_threshold = 1 << 20;
+#endif
   const difference_type interval_size = (thrust::min)(interval_threshold, n);
   
   // force transform_iterator output to bool
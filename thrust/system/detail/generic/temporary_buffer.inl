@@ -55,6 +55,15 @@ __host__ __device__
 } // end return_temporary_buffer()
 
 
+template<typename DerivedPolicy, typename Pointer>
+__host__ __device__
+  void return_temporary_buffer(thrust::execution_policy<DerivedPolicy> &exec, Pointer p, std::ptrdiff_t)
+{
+  // systems which don't need the size customize the overload without it
+  return_temporary_buffer(thrust::detail::derived_cast(exec), p);
+} // end return_temporary_buffer()
+
+
 } // end generic
 } // end detail
 } // end system
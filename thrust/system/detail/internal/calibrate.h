@@ -0,0 +1,94 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file calibrate.h
+ *  \brief Timing helpers used to calibrate the thresholds of thrust::tuning
+ *         on the host.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+
+#if __cplusplus >= 201103L
+
+#include <thrust/random.h>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace thrust
+{
+namespace system
+{
+namespace detail
+{
+namespace internal
+{
+
+
+// the number of times an operation is timed; the shortest time is kept
+const int calibration_repetitions = 3;
+
+
+// returns n pseudo-random values, the same on every call
+template<typename T>
+  std::vector<T> calibration_input(std::size_t n)
+{
+  thrust::default_random_engine rng;
+
+  std::vector<T> result(n);
+
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    result[i] = static_cast<T>(rng());
+  }
+
+  return result;
+}
+
+
+// returns the shortest time, in seconds, taken by op to process a fresh copy of input
+template<typename T, typename Operation>
+  double calibration_time(const std::vector<T> &input, Operation op)
+{
+  std::vector<T> copy;
+  double result = std::numeric_limits<double>::max();
+
+  for(int i = 0; i < calibration_repetitions; ++i)
+  {
+    copy = input;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    op(copy);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if(elapsed.count() < result) result = elapsed.count();
+  }
+
+  return result;
+}
+
+
+} // end namespace internal
+} // end namespace detail
+} // end namespace system
+} // end namespace thrust
+
+#endif // __cplusplus >= 201103L
+
@@ -0,0 +1,163 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file compaction_tiles.h
+ *  \brief Tile-level building blocks for parallel in-place stream compaction
+ *         on the host.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/copy.h>
+#include <thrust/detail/seq.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace detail
+{
+namespace internal
+{
+
+// A parallel in-place compaction (remove_if, unique, ...) is performed in
+// three steps over a set of tiles which partition the input:
+//
+//   1. every tile is compacted in parallel by the corresponding sequential
+//      algorithm, leaving the tile's survivors at the front of the tile
+//   2. compaction_tile_offsets runs sequentially over the O(tiles) survivor
+//      counts and computes where each tile's survivors belong
+//   3. the survivors are moved to their final position in parallel
+//
+// A tile's survivors only ever move towards the front, so moving them in
+// place could overwrite the survivors of an earlier tile which have yet to
+// move. Step 3 therefore moves the output left to right in sweeps through a
+// temporary buffer of a bounded number of chunks: every sweep gathers the
+// survivors bound for the next window of the output into the buffer, one
+// chunk per thread, and then copies the buffer back over the window. A
+// survivor's source never precedes its output position, so the survivors
+// bound for later windows all lie after the current one and are never
+// overwritten. The tiles in front of the first removed element are already
+// in place and are skipped. Only O(tiles + threads * chunk) temporary
+// storage is required.
+
+template<typename Size>
+  struct compaction_tile
+{
+  typedef Size size_type;
+
+  // the position of the tile's first survivor after step 1
+  Size survivors_begin;
+
+  // the number of survivors in the tile
+  Size num_survivors;
+
+  // the position of the tile's first survivor in the output
+  Size output_offset;
+};
+
+
+// computes the output offset of each tile and returns the total number of survivors
+template<typename Tile>
+  typename Tile::size_type
+    compaction_tile_offsets(Tile *tiles, typename Tile::size_type num_tiles)
+{
+  typedef typename Tile::size_type Size;
+
+  Size offset = 0;
+
+  for(Size i = 0; i < num_tiles; ++i)
+  {
+    tiles[i].output_offset = offset;
+
+    offset += tiles[i].num_survivors;
+  }
+
+  return offset;
+}
+
+
+// returns the first tile whose survivors are not at their output offset, or num_tiles if there is none
+template<typename Tile>
+  typename Tile::size_type
+    compaction_tile_first_moved(const Tile *tiles, typename Tile::size_type num_tiles)
+{
+  typedef typename Tile::size_type Size;
+
+  // the distance a tile's survivors move never decreases from one tile to the next,
+  // so every non-empty tile after the first one which moves moves as well
+  for(Size i = 0; i < num_tiles; ++i)
+  {
+    if(tiles[i].num_survivors != 0 && tiles[i].survivors_begin != tiles[i].output_offset)
+    {
+      return i;
+    }
+  }
+
+  return num_tiles;
+}
+
+
+// copies the survivors bound for the output positions [output_begin, output_end) to a buffer
+template<typename Tile, typename RandomAccessIterator, typename OutputIterator>
+  void compaction_tiles_gather(const Tile *tiles,
+                               typename Tile::size_type num_tiles,
+                               RandomAccessIterator first,
+                               typename Tile::size_type output_begin,
+                               typename Tile::size_type output_end,
+                               OutputIterator buffer)
+{
+  typedef typename Tile::size_type Size;
+
+  // find the last tile whose survivors start at or before output_begin
+  Size lo = 0, hi = num_tiles;
+  while(hi - lo > 1)
+  {
+    const Size mid = lo + (hi - lo) / 2;
+
+    if(tiles[mid].output_offset <= output_begin)
+    {
+      lo = mid;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  for(Size i = lo; output_begin < output_end; ++i)
+  {
+    const Size tile_end = tiles[i].output_offset + tiles[i].num_survivors;
+
+    if(tile_end <= output_begin) continue;
+
+    const Size count  = ((tile_end < output_end) ? tile_end : output_end) - output_begin;
+    const Size source = tiles[i].survivors_begin + (output_begin - tiles[i].output_offset);
+
+    buffer = thrust::copy(thrust::seq, first + source, first + source + count, buffer);
+
+    output_begin += count;
+  }
+}
+
+
+} // end namespace internal
+} // end namespace detail
+} // end namespace system
+} // end namespace thrust
+
@@ -0,0 +1,277 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file extrema_tiles.h
+ *  \brief Tile-level building blocks for parallel min_element, max_element
+ *         and minmax_element on the host.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/extrema.h>
+#include <thrust/pair.h>
+#include <thrust/functional.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/minmax.h>
+#include <thrust/detail/type_traits.h>
+#include <thrust/detail/raw_pointer_cast.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/system/detail/sequential/vectorized_reduce.h>
+#include <cstddef>
+
+namespace thrust
+{
+namespace system
+{
+namespace detail
+{
+namespace internal
+{
+
+// A parallel extremum search splits the input into one tile per worker,
+// finds the position of the first extremum of every tile, and keeps the
+// first of the tiles' extrema in order. Positions are tracked as offsets from
+// the beginning of the input; no (value, position) tuples are built or moved.
+//
+// On a contiguous range of arithmetic values in host memory, ordered by less
+// or greater, a tile is processed in blocks small enough to stay in the L1
+// cache. The extremum value of a block is reduced over independent lanes, a
+// loop which vectorizes; only a block that improves on the extremum so far is
+// scanned again to find the position of its first occurrence.
+
+
+// the comparisons whose extrema have a vector equivalent
+template<typename BinaryPredicate, typename T>
+  struct is_vectorizable_comparison
+    : thrust::detail::false_type
+{};
+
+template<typename T>
+  struct is_vectorizable_comparison<thrust::less<T>, T>
+    : thrust::detail::is_arithmetic<T>
+{};
+
+template<typename T>
+  struct is_vectorizable_comparison<thrust::greater<T>, T>
+    : thrust::detail::is_arithmetic<T>
+{};
+
+
+template<typename RandomAccessIterator, typename BinaryPredicate>
+  struct is_vectorizable_extrema
+    : thrust::detail::integral_constant<
+        bool,
+        thrust::system::detail::sequential::reduce_detail::is_host_trivial_iterator<RandomAccessIterator>::value &&
+        is_vectorizable_comparison<
+          BinaryPredicate,
+          typename thrust::iterator_value<RandomAccessIterator>::type
+        >::value
+      >
+{};
+
+
+namespace extrema_detail
+{
+
+
+template<typename T>
+  struct block_size
+{
+  static const std::ptrdiff_t value = 64 * thrust::system::detail::sequential::reduce_detail::num_lanes<T>::value;
+};
+
+
+// returns the position of the first element of ptr[0, n) equivalent to value,
+// which is an extremum of the range
+template<typename T, typename BinaryPredicate>
+  std::ptrdiff_t find_min(const T *ptr, std::ptrdiff_t n, const T &value, BinaryPredicate comp)
+{
+  std::ptrdiff_t i = 0;
+  while(i < n && comp(value, ptr[i])) ++i;
+  return i;
+}
+
+template<typename T, typename BinaryPredicate>
+  std::ptrdiff_t find_max(const T *ptr, std::ptrdiff_t n, const T &value, BinaryPredicate comp)
+{
+  std::ptrdiff_t i = 0;
+  while(i < n && comp(ptr[i], value)) ++i;
+  return i;
+}
+
+
+// updates the lanes of a group with the elements ptr[0, GroupSize)
+template<bool FindMin, bool FindMax, int GroupSize, typename T, typename BinaryPredicate>
+  void extrema_of_lane_group(T (&min)[GroupSize], T (&max)[GroupSize], const T *ptr, BinaryPredicate comp)
+{
+  for(std::ptrdiff_t j = 0; j < GroupSize; ++j)
+  {
+    const T x = ptr[j];
+
+    if(FindMin) min[j] = comp(x, min[j]) ? x : min[j];
+    if(FindMax) max[j] = comp(max[j], x) ? x : max[j];
+  }
+}
+
+
+// returns the positions of the first minimum and of the first maximum of ptr[0, n), n > 0
+template<bool FindMin, bool FindMax, typename T, typename BinaryPredicate>
+  thrust::pair<std::ptrdiff_t,std::ptrdiff_t>
+    vectorized_extrema(const T *ptr, std::ptrdiff_t n, BinaryPredicate comp)
+{
+  namespace reduce_detail = thrust::system::detail::sequential::reduce_detail;
+
+  const int            groups = reduce_detail::num_lane_groups;
+  const int            group  = reduce_detail::lane_group_size<T>::value;
+  const std::ptrdiff_t lanes  = reduce_detail::num_lanes<T>::value;
+  const std::ptrdiff_t block  = block_size<T>::value;
+
+  std::ptrdiff_t imin = 0, imax = 0;
+  T vmin = ptr[0], vmax = ptr[0];
+
+  T min[groups][group], max[groups][group];
+
+  for(std::ptrdiff_t b = 0; b < n; b += block)
+  {
+    const std::ptrdiff_t size = thrust::min<std::ptrdiff_t>(block, n - b);
+
+    for(int g = 0; g < groups; ++g)
+    {
+      for(std::ptrdiff_t j = 0; j < group; ++j)
+      {
+        min[g][j] = vmin;
+        max[g][j] = vmax;
+      }
+    }
+
+    // update every group with a loop of its own, at a constant address, so that the lanes stay in registers; see
+    // vectorized_reduce
+    const T *block_ptr = ptr + b;
+    std::ptrdiff_t i = 0;
+
+    for(; i + lanes <= size; i += lanes)
+    {
+      extrema_of_lane_group<FindMin,FindMax>(min[0], max[0], block_ptr + i,             comp);
+      extrema_of_lane_group<FindMin,FindMax>(min[1], max[1], block_ptr + i + group,     comp);
+      extrema_of_lane_group<FindMin,FindMax>(min[2], max[2], block_ptr + i + 2 * group, comp);
+      extrema_of_lane_group<FindMin,FindMax>(min[3], max[3], block_ptr + i + 3 * group, comp);
+    }
+
+    // the elements past the last whole set of lanes are compared with the extrema of the lanes
+    if(FindMin)
+    {
+      T m = min[0][0];
+      for(int g = 0; g < groups; ++g)
+      {
+        for(std::ptrdiff_t j = 0; j < group; ++j) m = comp(min[g][j], m) ? min[g][j] : m;
+      }
+      for(std::ptrdiff_t j = i; j < size; ++j) m = comp(block_ptr[j], m) ? block_ptr[j] : m;
+
+      if(comp(m, vmin))
+      {
+        vmin = m;
+        imin = b + find_min(ptr + b, size, m, comp);
+      }
+    }
+
+    if(FindMax)
+    {
+      T m = max[0][0];
+      for(int g = 0; g < groups; ++g)
+      {
+        for(std::ptrdiff_t j = 0; j < group; ++j) m = comp(m, max[g][j]) ? max[g][j] : m;
+      }
+      for(std::ptrdiff_t j = i; j < size; ++j) m = comp(m, block_ptr[j]) ? block_ptr[j] : m;
+
+      if(comp(vmax, m))
+      {
+        vmax = m;
+        imax = b + find_max(ptr + b, size, m, comp);
+      }
+    }
+  }
+
+  return thrust::make_pair(imin, imax);
+}
+
+
+template<bool FindMin, bool FindMax, typename RandomAccessIterator, typename Size, typename BinaryPredicate>
+  thrust::pair<Size,Size> extrema_in_tile(RandomAccessIterator first, Size begin, Size end, BinaryPredicate comp,
+                                          thrust::detail::true_type) // is_vectorizable_extrema
+{
+  thrust::pair<std::ptrdiff_t,std::ptrdiff_t> result =
+    vectorized_extrema<FindMin,FindMax>(thrust::raw_pointer_cast(&*(first + begin)), end - begin, comp);
+
+  return thrust::make_pair(begin + static_cast<Size>(result.first), begin + static_cast<Size>(result.second));
+}
+
+
+template<bool FindMin, bool FindMax, typename RandomAccessIterator, typename Size, typename BinaryPredicate>
+  thrust::pair<Size,Size> extrema_in_tile(RandomAccessIterator first, Size begin, Size end, BinaryPredicate comp,
+                                          thrust::detail::false_type) // is_vectorizable_extrema
+{
+  if(FindMin && FindMax)
+  {
+    thrust::pair<RandomAccessIterator,RandomAccessIterator> result =
+      thrust::minmax_element(thrust::seq, first + begin, first + end, comp);
+
+    return thrust::make_pair(static_cast<Size>(result.first - first), static_cast<Size>(result.second - first));
+  }
+
+  Size result = static_cast<Size>((FindMin ? thrust::min_element(thrust::seq, first + begin, first + end, comp)
+                                           : thrust::max_element(thrust::seq, first + begin, first + end, comp)) - first);
+
+  return thrust::make_pair(result, result);
+}
+
+
+} // end extrema_detail
+
+
+// returns the positions of the first minimum and of the first maximum of
+// [first + begin, first + end), begin < end; only the requested ones are meaningful
+template<bool FindMin, bool FindMax, typename RandomAccessIterator, typename Size, typename BinaryPredicate>
+  thrust::pair<Size,Size> extrema_in_tile(RandomAccessIterator first, Size begin, Size end, BinaryPredicate comp)
+{
+  return extrema_detail::extrema_in_tile<FindMin,FindMax>(first, begin, end, comp,
+    typename is_vectorizable_extrema<RandomAccessIterator,BinaryPredicate>::type());
+}
+
+
+// merges the extrema of a tile into those of the tiles in front of it
+template<bool FindMin, bool FindMax, typename RandomAccessIterator, typename Size, typename BinaryPredicate>
+  void merge_extrema(RandomAccessIterator first, thrust::pair<Size,Size> &front, const thrust::pair<Size,Size> &back,
+                     BinaryPredicate comp)
+{
+  if(FindMin && comp(first[back.first], first[front.first]))
+  {
+    front.first = back.first;
+  }
+
+  if(FindMax && comp(first[front.second], first[back.second]))
+  {
+    front.second = back.second;
+  }
+}
+
+
+} // end namespace internal
+} // end namespace detail
+} // end namespace system
+} // end namespace thrust
+
@@ -0,0 +1,85 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file find_tiles.h
+ *  \brief Tile-level building blocks for parallel find_if with early exit on
+ *         the host.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/find.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/minmax.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace detail
+{
+namespace internal
+{
+
+// A parallel find_if with early exit hands out tiles of the input in
+// increasing order from a shared counter. Every worker scans the tiles it
+// claims with the sequential find_if, and lowers a shared "best match so far"
+// to the position of any match it finds. Since tiles are claimed in order,
+// once a worker claims a tile which begins at or past the best match, so does
+// every later claim, and the worker stops. Every tile in front of the best
+// match is scanned to its end, so when all workers have stopped, the best
+// match is the first one.
+//
+// The claims are the only synchronization: a match found early in a large
+// range is returned after little more than the work preceding it.
+
+// enough tiles per worker to balance the load and to stop soon after a match
+const std::size_t find_tiles_per_worker = 64;
+
+// none so large that a match near the front waits for long scans to finish
+const std::size_t max_find_tile_size = std::size_t(1) << 16;
+
+
+template<typename Size>
+  Size find_tile_size(Size n, std::size_t num_workers, std::size_t min_tile_size)
+{
+  std::size_t result = static_cast<std::size_t>(n) / (thrust::max<std::size_t>(1, num_workers) * find_tiles_per_worker);
+
+  result = thrust::min<std::size_t>(result, max_find_tile_size);
+  result = thrust::max<std::size_t>(result, thrust::max<std::size_t>(1, min_tile_size));
+
+  return static_cast<Size>(result);
+}
+
+
+// scans tile number tile of the input, and returns the position of its first
+// match, or the end of the tile if it has none
+template<typename RandomAccessIterator, typename Size, typename Predicate>
+  Size find_in_tile(RandomAccessIterator first, Size n, Size tile_size, Size tile, Predicate pred)
+{
+  const Size begin = tile * tile_size;
+  const Size end   = thrust::min<Size>(n, begin + tile_size);
+
+  return thrust::find_if(thrust::seq, first + begin, first + end, pred) - first;
+}
+
+
+} // end internal
+} // end detail
+} // end system
+} // end thrust
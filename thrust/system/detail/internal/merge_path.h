@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file merge_path.h
+ *  \brief Merge path partitioning of two sorted ranges.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/detail/minmax.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace detail
+{
+namespace internal
+{
+
+
+// Returns the number of elements of [first1, first1 + n1) among the first
+// diag elements of the stable merge of [first1, first1 + n1) and
+// [first2, first2 + n2). The remaining diag - result elements come from
+// the second range. Equivalent elements of the first range precede those
+// of the second, which matches thrust::merge.
+//
+// Partitioning the output of a merge at several diagonals with merge_path
+// splits it into independent sequential merges of any desired size.
+template<typename RandomAccessIterator1,
+         typename RandomAccessIterator2,
+         typename Size,
+         typename Compare>
+  Size merge_path(RandomAccessIterator1 first1,
+                  Size n1,
+                  RandomAccessIterator2 first2,
+                  Size n2,
+                  Size diag,
+                  Compare comp)
+{
+  Size lo = thrust::max<Size>(0, diag - n2);
+  Size hi = thrust::min<Size>(diag, n1);
+
+  while(lo < hi)
+  {
+    Size mid = lo + (hi - lo) / 2;
+
+    if(!comp(first2[diag - 1 - mid], first1[mid]))
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+
+} // end namespace internal
+} // end namespace detail
+} // end namespace system
+} // end namespace thrust
+
@@ -0,0 +1,194 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file radix_sort_tiles.h
+ *  \brief Tile-level building blocks for parallel LSD radix sort on the host.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/functional.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/detail/type_traits.h>
+#include <thrust/system/detail/sequential/stable_radix_sort.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace detail
+{
+namespace internal
+{
+
+// A parallel LSD radix sort performs one pass per RadixBits-wide digit of
+// the encoded key. Each pass is performed in three steps over a set of
+// tiles which partition the input:
+//
+//   1. radix_sort_tile_histogram runs on every tile in parallel and counts
+//      the keys of the tile falling in each bucket
+//   2. radix_sort_tile_offsets runs sequentially over the O(tiles * buckets)
+//      histograms and turns them into each tile's first output position in
+//      each bucket
+//   3. radix_sort_tile_scatter runs on every tile in parallel and moves the
+//      tile's keys (and values) to their positions in the other buffer
+//
+// Tiles are visited in order within each bucket, so every pass is stable.
+
+template<typename KeyType, typename Compare>
+struct use_parallel_radix_sort
+  : thrust::detail::and_<
+      thrust::detail::is_arithmetic<KeyType>,
+      thrust::detail::not_<
+        thrust::detail::is_same<KeyType, bool>
+      >,
+      thrust::detail::or_<
+        thrust::detail::is_same<Compare, thrust::less<KeyType> >,
+        thrust::detail::is_same<Compare, thrust::greater<KeyType> >
+      >
+    >
+{};
+
+
+template<typename KeyType, typename Compare>
+struct radix_sort_needs_reverse
+  : thrust::detail::integral_constant<
+      bool,
+      thrust::detail::is_same<Compare, thrust::greater<KeyType> >::value
+    >
+{};
+
+
+template<typename KeyType>
+struct radix_sort_traits
+{
+  typedef thrust::system::detail::sequential::radix_sort_detail::RadixEncoder<KeyType> encoder_type;
+  typedef typename encoder_type::result_type                                           encoded_type;
+
+  static const unsigned int radix_bits     = 8;
+  static const unsigned int histogram_size = 1 << radix_bits;
+  static const unsigned int num_passes     = (8 * sizeof(encoded_type) + (radix_bits - 1)) / radix_bits;
+
+  static unsigned int bucket(const KeyType &key, unsigned int pass)
+  {
+    const encoded_type x = encoder_type()(key);
+    return static_cast<unsigned int>((x >> (radix_bits * pass)) & static_cast<encoded_type>(histogram_size - 1));
+  }
+};
+
+
+template<typename RandomAccessIterator,
+         typename Size>
+  void radix_sort_tile_histogram(RandomAccessIterator keys,
+                                 Size begin,
+                                 Size end,
+                                 unsigned int pass,
+                                 size_t *histogram)
+{
+  typedef typename thrust::iterator_value<RandomAccessIterator>::type KeyType;
+  typedef radix_sort_traits<KeyType>                                  traits;
+
+  for(unsigned int i = 0; i < traits::histogram_size; ++i)
+  {
+    histogram[i] = 0;
+  }
+
+  for(Size i = begin; i < end; ++i)
+  {
+    ++histogram[traits::bucket(keys[i], pass)];
+  }
+}
+
+
+// histograms holds num_tiles consecutive histograms of histogram_size buckets
+// returns false if the pass may be skipped because every key shares a bucket
+template<typename KeyType,
+         typename Size>
+  bool radix_sort_tile_offsets(size_t *histograms,
+                               Size num_tiles,
+                               size_t n)
+{
+  typedef radix_sort_traits<KeyType> traits;
+
+  size_t sum = 0;
+
+  for(unsigned int bucket = 0; bucket < traits::histogram_size; ++bucket)
+  {
+    size_t bucket_size = 0;
+
+    for(Size tile = 0; tile < num_tiles; ++tile)
+    {
+      size_t &count = histograms[tile * traits::histogram_size + bucket];
+
+      bucket_size += count;
+
+      size_t tmp = count;
+      count = sum;
+      sum += tmp;
+    }
+
+    if(bucket_size == n)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+template<bool HasValues,
+         typename RandomAccessIterator1,
+         typename RandomAccessIterator2,
+         typename RandomAccessIterator3,
+         typename RandomAccessIterator4,
+         typename Size>
+  void radix_sort_tile_scatter(RandomAccessIterator1 keys_first,
+                               RandomAccessIterator2 values_first,
+                               Size begin,
+                               Size end,
+                               RandomAccessIterator3 keys_result,
+                               RandomAccessIterator4 values_result,
+                               unsigned int pass,
+                               size_t *offsets)
+{
+  typedef typename thrust::iterator_value<RandomAccessIterator1>::type KeyType;
+  typedef radix_sort_traits<KeyType>                                   traits;
+
+  for(Size i = begin; i < end; ++i)
+  {
+    KeyType key = keys_first[i];
+
+    // note that we mutate the offsets here
+    const size_t position = offsets[traits::bucket(key, pass)]++;
+
+    keys_result[position] = key;
+
+    if(HasValues)
+    {
+      values_result[position] = values_first[i];
+    }
+  }
+}
+
+
+} // end namespace internal
+} // end namespace detail
+} // end namespace system
+} // end namespace thrust
+
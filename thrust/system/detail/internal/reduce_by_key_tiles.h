@@ -0,0 +1,283 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file reduce_by_key_tiles.h
+ *  \brief Tile-level building blocks for parallel reduce_by_key on the host.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/pair.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/detail/type_traits/algorithm/intermediate_type.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace detail
+{
+namespace internal
+{
+
+// A parallel reduce_by_key is performed in three steps over a set of
+// tiles which partition the input:
+//
+//   1. reduce_by_key_tile_upsweep runs on every tile in parallel and counts
+//      the segments which end inside the tile, along with the reduction of
+//      the segment left open at the end of the tile
+//   2. reduce_by_key_tile_carries runs sequentially over the O(tiles)
+//      summaries and computes each tile's output offset and the partial
+//      segment carried into it
+//   3. reduce_by_key_tile_downsweep runs on every tile in parallel and
+//      writes the segments which end inside the tile
+//
+// A segment ends at position i if i is the last position or if
+// binary_pred(keys[i], keys[i + 1]) is false. Only O(tiles) temporary
+// storage is required.
+
+template<typename Size, typename Key, typename Value>
+  struct reduce_by_key_tile
+{
+  typedef Size  size_type;
+  typedef Key   key_type;
+  typedef Value value_type;
+
+  // the number of segments which end inside the tile
+  Size num_segments;
+
+  // the position of the first element of the segment left open at the
+  // end of the tile
+  Size open_begin;
+
+  // the position of this tile's first output
+  Size output_offset;
+
+  // the partial segment carried into the tile
+  bool  has_carry;
+  Key   carry_key;
+  Value carry_value;
+
+  // the partial segment left open at the end of the tile
+  bool  has_open;
+  Key   open_key;
+  Value open_value;
+};
+
+
+template<typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator2,
+         typename BinaryFunction>
+  struct reduce_by_key_tile_type
+{
+  typedef typename thrust::iterator_difference<InputIterator1>::type size_type;
+  typedef typename thrust::iterator_value<InputIterator1>::type      key_type;
+
+  typedef typename thrust::detail::intermediate_type_from_function_and_iterators<
+    InputIterator2,
+    OutputIterator2,
+    BinaryFunction
+  >::type value_type;
+
+  typedef reduce_by_key_tile<size_type,key_type,value_type> type;
+};
+
+
+template<typename Tile,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename Size,
+         typename BinaryPredicate,
+         typename BinaryFunction>
+  void reduce_by_key_tile_upsweep(Tile &tile,
+                                  InputIterator1 keys_first,
+                                  InputIterator2 values_first,
+                                  Size n,
+                                  Size begin,
+                                  Size end,
+                                  BinaryPredicate binary_pred,
+                                  BinaryFunction binary_op)
+{
+  typedef typename Tile::key_type key_type;
+
+  tile.num_segments = 0;
+  tile.open_begin   = begin;
+
+  // count the segments which end inside the tile
+  key_type key = keys_first[begin];
+
+  for(Size i = begin; i < end; ++i)
+  {
+    bool is_tail = (i + 1 == n);
+
+    if(!is_tail)
+    {
+      key_type next_key = keys_first[i + 1];
+      is_tail = !binary_pred(key, next_key);
+      key = next_key;
+    }
+
+    if(is_tail)
+    {
+      ++tile.num_segments;
+      tile.open_begin = i + 1;
+    }
+  }
+
+  // reduce the segment left open at the end of the tile
+  tile.has_open = tile.open_begin < end;
+
+  if(tile.has_open)
+  {
+    InputIterator2 iter = values_first + tile.open_begin;
+
+    tile.open_key   = keys_first[tile.open_begin];
+    tile.open_value = *iter;
+
+    for(++iter; iter != values_first + end; ++iter)
+    {
+      tile.open_value = binary_op(tile.open_value, *iter);
+    }
+  }
+}
+
+
+template<typename Tile,
+         typename Size,
+         typename BinaryFunction>
+  Size reduce_by_key_tile_carries(Tile *tiles,
+                                  Size num_tiles,
+                                  BinaryFunction binary_op)
+{
+  Size output_offset = 0;
+
+  if(num_tiles == 0) return output_offset;
+
+  tiles[0].has_carry = false;
+
+  for(Size i = 0; i < num_tiles; ++i)
+  {
+    Tile &tile = tiles[i];
+
+    tile.output_offset = output_offset;
+    output_offset += tile.num_segments;
+
+    if(i + 1 < num_tiles)
+    {
+      Tile &next = tiles[i + 1];
+
+      if(tile.num_segments == 0 && tile.has_carry)
+      {
+        // the whole tile belongs to the segment carried into it
+        next.has_carry   = true;
+        next.carry_key   = tile.carry_key;
+        next.carry_value = binary_op(tile.carry_value, tile.open_value);
+      }
+      else
+      {
+        next.has_carry = tile.has_open;
+
+        if(tile.has_open)
+        {
+          next.carry_key   = tile.open_key;
+          next.carry_value = tile.open_value;
+        }
+      }
+    }
+  }
+
+  return output_offset;
+}
+
+
+template<typename Tile,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator1,
+         typename OutputIterator2,
+         typename Size,
+         typename BinaryPredicate,
+         typename BinaryFunction>
+  void reduce_by_key_tile_downsweep(const Tile &tile,
+                                    InputIterator1 keys_first,
+                                    InputIterator2 values_first,
+                                    OutputIterator1 keys_output,
+                                    OutputIterator2 values_output,
+                                    Size n,
+                                    Size begin,
+                                    BinaryPredicate binary_pred,
+                                    BinaryFunction binary_op)
+{
+  typedef typename Tile::key_type   key_type;
+  typedef typename Tile::value_type value_type;
+
+  if(tile.num_segments == 0) return;
+
+  keys_output   += tile.output_offset;
+  values_output += tile.output_offset;
+
+  // the carry is only meaningful when is_open is set
+  bool       is_open      = tile.has_carry;
+  key_type   result_key   = tile.carry_key;
+  value_type result_value = tile.carry_value;
+
+  key_type key = keys_first[begin];
+
+  // only the segments which end inside the tile are written
+  for(Size i = begin; i < tile.open_begin; ++i)
+  {
+    if(is_open)
+    {
+      result_value = binary_op(result_value, values_first[i]);
+    }
+    else
+    {
+      result_key   = key;
+      result_value = values_first[i];
+      is_open      = true;
+    }
+
+    bool is_tail = (i + 1 == n);
+
+    if(!is_tail)
+    {
+      key_type next_key = keys_first[i + 1];
+      is_tail = !binary_pred(key, next_key);
+      key = next_key;
+    }
+
+    if(is_tail)
+    {
+      *keys_output   = result_key;
+      *values_output = result_value;
+
+      ++keys_output;
+      ++values_output;
+
+      is_open = false;
+    }
+  }
+}
+
+
+} // end namespace internal
+} // end namespace detail
+} // end namespace system
+} // end namespace thrust
+
@@ -0,0 +1,261 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file scan_by_key_tiles.h
+ *  \brief Tile-level building blocks for parallel scan_by_key on the host.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/iterator/iterator_traits.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace detail
+{
+namespace internal
+{
+
+// A parallel scan_by_key is performed in three steps over a set of tiles
+// which partition the input:
+//
+//   1. scan_by_key_tile_upsweep runs on every tile in parallel and reduces
+//      the segment left open at the end of the tile
+//   2. scan_by_key_tile_carries runs sequentially over the O(tiles)
+//      summaries and computes the partial segment carried into each tile
+//   3. inclusive_scan_by_key_tile_downsweep or
+//      exclusive_scan_by_key_tile_downsweep runs on every tile in parallel
+//      and scans the tile seeded with its carry
+//
+// A new segment begins at position i if binary_pred(keys[i - 1], keys[i])
+// is false. Only O(tiles) temporary storage is required.
+
+template<typename Size, typename Value>
+  struct scan_by_key_tile
+{
+  typedef Size  size_type;
+  typedef Value value_type;
+
+  // whether the first element of the tile continues the segment of the
+  // element before it
+  bool continues;
+
+  // whether the segment left open at the end of the tile begins at the
+  // first element of the tile
+  bool open_is_whole_tile;
+
+  // the partial segment carried into the tile
+  bool  has_carry;
+  Value carry_value;
+
+  // the reduction of the segment left open at the end of the tile
+  Value open_value;
+};
+
+
+template<typename Tile,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename Size,
+         typename BinaryPredicate,
+         typename BinaryFunction>
+  void scan_by_key_tile_upsweep(Tile &tile,
+                                InputIterator1 keys_first,
+                                InputIterator2 values_first,
+                                Size begin,
+                                Size end,
+                                BinaryPredicate binary_pred,
+                                BinaryFunction binary_op)
+{
+  tile.continues = (begin > 0) && binary_pred(keys_first[begin - 1], keys_first[begin]);
+
+  // find the beginning of the last segment by walking backward
+  Size open_begin = begin;
+
+  for(Size i = end - 1; i > begin; --i)
+  {
+    if(!binary_pred(keys_first[i - 1], keys_first[i]))
+    {
+      open_begin = i;
+      break;
+    }
+  }
+
+  tile.open_is_whole_tile = (open_begin == begin);
+
+  InputIterator2 iter = values_first + open_begin;
+
+  tile.open_value = *iter;
+
+  for(++iter; iter != values_first + end; ++iter)
+  {
+    tile.open_value = binary_op(tile.open_value, *iter);
+  }
+}
+
+
+template<typename Tile,
+         typename Size,
+         typename BinaryFunction>
+  void scan_by_key_tile_carries(Tile *tiles,
+                                Size num_tiles,
+                                BinaryFunction binary_op)
+{
+  if(num_tiles == 0) return;
+
+  tiles[0].has_carry = false;
+
+  for(Size i = 0; i + 1 < num_tiles; ++i)
+  {
+    Tile &tile = tiles[i];
+    Tile &next = tiles[i + 1];
+
+    next.has_carry = next.continues;
+
+    if(next.continues)
+    {
+      if(tile.open_is_whole_tile && tile.has_carry)
+      {
+        next.carry_value = binary_op(tile.carry_value, tile.open_value);
+      }
+      else
+      {
+        next.carry_value = tile.open_value;
+      }
+    }
+  }
+}
+
+
+template<typename Tile,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator,
+         typename Size,
+         typename BinaryPredicate,
+         typename BinaryFunction>
+  void inclusive_scan_by_key_tile_downsweep(const Tile &tile,
+                                            InputIterator1 keys_first,
+                                            InputIterator2 values_first,
+                                            OutputIterator result,
+                                            Size begin,
+                                            Size end,
+                                            BinaryPredicate binary_pred,
+                                            BinaryFunction binary_op)
+{
+  typedef typename thrust::iterator_value<InputIterator1>::type KeyType;
+  typedef typename Tile::value_type                             ValueType;
+
+  InputIterator1 first1 = keys_first   + begin;
+  InputIterator1 last1  = keys_first   + end;
+  InputIterator2 first2 = values_first + begin;
+  result += begin;
+
+  KeyType   prev_key   = *first1;
+  ValueType prev_value = *first2;
+
+  if(tile.has_carry)
+  {
+    prev_value = binary_op(tile.carry_value, prev_value);
+  }
+
+  *result = prev_value;
+
+  for(++first1, ++first2, ++result;
+      first1 != last1;
+      ++first1, ++first2, ++result)
+  {
+    KeyType key = *first1;
+
+    if(binary_pred(prev_key, key))
+      *result = prev_value = binary_op(prev_value, *first2);
+    else
+      *result = prev_value = *first2;
+
+    prev_key = key;
+  }
+}
+
+
+template<typename Tile,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator,
+         typename Size,
+         typename T,
+         typename BinaryPredicate,
+         typename BinaryFunction>
+  void exclusive_scan_by_key_tile_downsweep(const Tile &tile,
+                                            InputIterator1 keys_first,
+                                            InputIterator2 values_first,
+                                            OutputIterator result,
+                                            Size begin,
+                                            Size end,
+                                            T init,
+                                            BinaryPredicate binary_pred,
+                                            BinaryFunction binary_op)
+{
+  typedef typename thrust::iterator_value<InputIterator1>::type KeyType;
+  typedef typename Tile::value_type                             ValueType;
+
+  InputIterator1 first1 = keys_first   + begin;
+  InputIterator1 last1  = keys_first   + end;
+  InputIterator2 first2 = values_first + begin;
+  result += begin;
+
+  KeyType   temp_key   = *first1;
+  ValueType temp_value = *first2;
+
+  ValueType next = init;
+
+  if(tile.has_carry)
+  {
+    next = binary_op(next, tile.carry_value);
+  }
+
+  *result = next;
+
+  next = binary_op(next, temp_value);
+
+  for(++first1, ++first2, ++result;
+      first1 != last1;
+      ++first1, ++first2, ++result)
+  {
+    KeyType key = *first1;
+
+    // use temp to permit in-place scans
+    temp_value = *first2;
+
+    if(!binary_pred(temp_key, key))
+      next = init;  // reset sum
+
+    *result = next;
+    next = binary_op(next, temp_value);
+
+    temp_key = key;
+  }
+}
+
+
+} // end namespace internal
+} // end namespace detail
+} // end namespace system
+} // end namespace thrust
+
@@ -0,0 +1,284 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file set_operation_tiles.h
+ *  \brief Tile-level building blocks for parallel set operations on the host.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/pair.h>
+#include <thrust/set_operations.h>
+#include <thrust/binary_search.h>
+#include <thrust/iterator/discard_iterator.h>
+#include <thrust/detail/minmax.h>
+#include <thrust/detail/seq.h>
+#include <thrust/system/detail/internal/merge_path.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace detail
+{
+namespace internal
+{
+
+// A parallel set operation is performed in three steps over a set of tiles
+// which partition the merged sequence of both inputs:
+//
+//   1. set_operation_tile_upsweep runs on every tile in parallel, finds the
+//      subranges of both inputs which belong to the tile and counts the
+//      outputs the sequential set operation produces from them
+//   2. set_operation_tile_offsets runs sequentially over the O(tiles)
+//      counts and computes each tile's output offset
+//   3. set_operation_tile_downsweep runs on every tile in parallel and
+//      writes the tile's outputs
+//
+// The *_by_key set operations are implemented generically on top of the
+// plain ones over zipped keys and values, so they need no separate engine.
+
+template<typename Size>
+  struct set_operation_tile
+{
+  typedef Size size_type;
+
+  // the tile's subranges of the first and second input
+  Size begin1, end1;
+  Size begin2, end2;
+
+  // the number of outputs produced by the tile
+  Size num_outputs;
+
+  // the position of this tile's first output
+  Size output_offset;
+};
+
+
+// Returns the positions in [first1, first1 + n1) and [first2, first2 + n2)
+// at which to split a set operation near diagonal diag of their merge.
+//
+// A plain merge path may separate equivalent elements of the two ranges
+// which a set operation must match against each other. Within a run of
+// equivalent elements the split is balanced instead: the k-th equivalent
+// element of the first range falls on the same side as the k-th of the
+// second, and only the unmatched surplus of the longer run is divided
+// freely. Each side may then be processed by an independent sequential
+// set operation, and the splits are nondecreasing in diag.
+template<typename RandomAccessIterator1,
+         typename RandomAccessIterator2,
+         typename Size,
+         typename T,
+         typename Compare>
+  thrust::pair<Size,Size>
+    balanced_path_split(RandomAccessIterator1 first1,
+                        Size n1,
+                        RandomAccessIterator2 first2,
+                        Size n2,
+                        Size i,
+                        Size j,
+                        const T &pivot,
+                        Compare comp)
+{
+  // the run of elements equivalent to pivot in each range; everything
+  // before (i, j) is no greater than pivot
+  const Size run_begin1 = thrust::lower_bound(thrust::seq, first1, first1 + i, pivot, comp) - first1;
+  const Size run_begin2 = thrust::lower_bound(thrust::seq, first2, first2 + j, pivot, comp) - first2;
+  const Size run_end1   = thrust::upper_bound(thrust::seq, first1 + i, first1 + n1, pivot, comp) - first1;
+  const Size run_end2   = thrust::upper_bound(thrust::seq, first2 + j, first2 + n2, pivot, comp) - first2;
+
+  const Size run1 = run_end1 - run_begin1;
+  const Size run2 = run_end2 - run_begin2;
+
+  // the number of equivalent elements the merge path places before diag
+  const Size count = (i - run_begin1) + (j - run_begin2);
+
+  const Size matched = thrust::min<Size>(run1, run2);
+
+  Size advance1 = count / 2;
+  Size advance2 = count / 2;
+
+  if(count > 2 * matched)
+  {
+    // every matched pair goes first; the surplus comes from the longer run
+    const Size surplus = count - 2 * matched;
+
+    advance1 = (run1 > run2) ? matched + surplus : matched;
+    advance2 = (run1 > run2) ? matched : matched + surplus;
+  }
+
+  return thrust::make_pair(run_begin1 + advance1, run_begin2 + advance2);
+}
+
+
+template<typename RandomAccessIterator1,
+         typename RandomAccessIterator2,
+         typename Size,
+         typename Compare>
+  thrust::pair<Size,Size>
+    balanced_path(RandomAccessIterator1 first1,
+                  Size n1,
+                  RandomAccessIterator2 first2,
+                  Size n2,
+                  Size diag,
+                  Compare comp)
+{
+  const Size i = merge_path(first1, n1, first2, n2, diag, comp);
+  const Size j = diag - i;
+
+  if(i == n1 && j == n2)
+  {
+    return thrust::make_pair(i, j);
+  }
+
+  // split around the next element of the merge
+  if(j == n2 || (i < n1 && !comp(first2[j], first1[i])))
+  {
+    return balanced_path_split(first1, n1, first2, n2, i, j, first1[i], comp);
+  }
+
+  return balanced_path_split(first1, n1, first2, n2, i, j, first2[j], comp);
+}
+
+
+// sequential set operations applied to each tile
+
+struct set_difference_op
+{
+  template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare>
+    OutputIterator operator()(InputIterator1 first1, InputIterator1 last1,
+                              InputIterator2 first2, InputIterator2 last2,
+                              OutputIterator result, Compare comp) const
+  {
+    return thrust::set_difference(thrust::seq, first1, last1, first2, last2, result, comp);
+  }
+};
+
+
+struct set_intersection_op
+{
+  template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare>
+    OutputIterator operator()(InputIterator1 first1, InputIterator1 last1,
+                              InputIterator2 first2, InputIterator2 last2,
+                              OutputIterator result, Compare comp) const
+  {
+    return thrust::set_intersection(thrust::seq, first1, last1, first2, last2, result, comp);
+  }
+};
+
+
+struct set_symmetric_difference_op
+{
+  template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare>
+    OutputIterator operator()(InputIterator1 first1, InputIterator1 last1,
+                              InputIterator2 first2, InputIterator2 last2,
+                              OutputIterator result, Compare comp) const
+  {
+    return thrust::set_symmetric_difference(thrust::seq, first1, last1, first2, last2, result, comp);
+  }
+};
+
+
+struct set_union_op
+{
+  template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare>
+    OutputIterator operator()(InputIterator1 first1, InputIterator1 last1,
+                              InputIterator2 first2, InputIterator2 last2,
+                              OutputIterator result, Compare comp) const
+  {
+    return thrust::set_union(thrust::seq, first1, last1, first2, last2, result, comp);
+  }
+};
+
+
+template<typename Size,
+         typename RandomAccessIterator1,
+         typename RandomAccessIterator2,
+         typename Compare,
+         typename SetOperation>
+  void set_operation_tile_upsweep(set_operation_tile<Size> &tile,
+                                  RandomAccessIterator1 first1,
+                                  Size n1,
+                                  RandomAccessIterator2 first2,
+                                  Size n2,
+                                  Size begin,
+                                  Size end,
+                                  Compare comp,
+                                  SetOperation op)
+{
+  const thrust::pair<Size,Size> first_split = balanced_path(first1, n1, first2, n2, begin, comp);
+  const thrust::pair<Size,Size> last_split  = balanced_path(first1, n1, first2, n2, end,   comp);
+
+  tile.begin1 = first_split.first;
+  tile.end1   = last_split.first;
+  tile.begin2 = first_split.second;
+  tile.end2   = last_split.second;
+
+  thrust::discard_iterator<> discard;
+
+  tile.num_outputs = op(first1 + tile.begin1, first1 + tile.end1,
+                        first2 + tile.begin2, first2 + tile.end2,
+                        discard,
+                        comp) - discard;
+}
+
+
+// computes the output offset of each tile and returns the total number of outputs
+template<typename Tile>
+  typename Tile::size_type
+    set_operation_tile_offsets(Tile *tiles, typename Tile::size_type num_tiles)
+{
+  typedef typename Tile::size_type Size;
+
+  Size offset = 0;
+
+  for(Size i = 0; i < num_tiles; ++i)
+  {
+    tiles[i].output_offset = offset;
+    offset += tiles[i].num_outputs;
+  }
+
+  return offset;
+}
+
+
+template<typename Size,
+         typename RandomAccessIterator1,
+         typename RandomAccessIterator2,
+         typename RandomAccessIterator3,
+         typename Compare,
+         typename SetOperation>
+  void set_operation_tile_downsweep(const set_operation_tile<Size> &tile,
+                                    RandomAccessIterator1 first1,
+                                    RandomAccessIterator2 first2,
+                                    RandomAccessIterator3 result,
+                                    Compare comp,
+                                    SetOperation op)
+{
+  op(first1 + tile.begin1, first1 + tile.end1,
+     first2 + tile.begin2, first2 + tile.end2,
+     result + tile.output_offset,
+     comp);
+}
+
+
+} // end namespace internal
+} // end namespace detail
+} // end namespace system
+} // end namespace thrust
+
@@ -0,0 +1,223 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file sorted_search.h
+ *  \brief Vectorized binary search which exploits sorted queries on the host.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/detail/function.h>
+#include <thrust/detail/minmax.h>
+#include <thrust/detail/type_traits.h>
+#include <thrust/detail/type_traits/minimum_type.h>
+#include <thrust/iterator/iterator_traits.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace detail
+{
+namespace internal
+{
+
+// The vectorized lower_bound, upper_bound and binary_search answer each query
+// with the position of the partition point of the haystack with respect to
+// "the element precedes the query". When the queries are sorted, so are the
+// answers, and sorted_search_tile finds each answer by galloping forward from
+// the previous one: a query whose answer is d positions further costs
+// O(log d) comparisons over memory close to the previous answer, instead of
+// O(log n) comparisons spread all over the haystack. Dense sorted queries are
+// answered in O(n + m) overall, sparse ones in O(m log(n / m)).
+//
+// The queries are never compared with each other, only with the haystack, as
+// in a plain binary search. Unsorted queries are detected when an answer lies
+// before the previous one; the rest of the tile is then answered by plain
+// binary searches. Tiles of queries are independent, and can be processed in
+// parallel.
+
+
+// the sorted search needs random access to the haystack, the queries and the
+// output; systems leave other iterators to the generic implementation
+template<typename RandomAccessIterator1, typename RandomAccessIterator2, typename RandomAccessIterator3, typename T>
+  struct enable_if_sorted_search
+    : thrust::detail::enable_if<
+        thrust::detail::is_convertible<
+          typename thrust::detail::minimum_type<
+            typename thrust::iterator_traversal<RandomAccessIterator1>::type,
+            typename thrust::iterator_traversal<RandomAccessIterator2>::type,
+            typename thrust::iterator_traversal<RandomAccessIterator3>::type
+          >::type,
+          thrust::random_access_traversal_tag
+        >::value,
+        T
+      >
+{};
+
+
+template<typename StrictWeakOrdering>
+  struct sorted_lower_bound
+{
+  thrust::detail::wrapped_function<StrictWeakOrdering,bool> comp;
+
+  sorted_lower_bound(StrictWeakOrdering comp)
+    : comp(comp)
+  {}
+
+  template<typename T1, typename T2>
+  bool precedes(const T1 &element, const T2 &value)
+  {
+    return comp(element, value);
+  }
+
+  template<typename RandomAccessIterator, typename Size, typename T>
+  Size result(RandomAccessIterator, Size, Size position, const T &)
+  {
+    return position;
+  }
+};
+
+
+template<typename StrictWeakOrdering>
+  struct sorted_upper_bound
+{
+  thrust::detail::wrapped_function<StrictWeakOrdering,bool> comp;
+
+  sorted_upper_bound(StrictWeakOrdering comp)
+    : comp(comp)
+  {}
+
+  template<typename T1, typename T2>
+  bool precedes(const T1 &element, const T2 &value)
+  {
+    return !comp(value, element);
+  }
+
+  template<typename RandomAccessIterator, typename Size, typename T>
+  Size result(RandomAccessIterator, Size, Size position, const T &)
+  {
+    return position;
+  }
+};
+
+
+template<typename StrictWeakOrdering>
+  struct sorted_binary_search
+{
+  thrust::detail::wrapped_function<StrictWeakOrdering,bool> comp;
+
+  sorted_binary_search(StrictWeakOrdering comp)
+    : comp(comp)
+  {}
+
+  template<typename T1, typename T2>
+  bool precedes(const T1 &element, const T2 &value)
+  {
+    return comp(element, value);
+  }
+
+  template<typename RandomAccessIterator, typename Size, typename T>
+  bool result(RandomAccessIterator haystack, Size n, Size position, const T &value)
+  {
+    return position < n && !comp(value, haystack[position]);
+  }
+};
+
+
+// the first position in [lo, hi) whose element does not precede value, or hi
+template<typename RandomAccessIterator, typename Size, typename T, typename Search>
+  Size sorted_search_partition(RandomAccessIterator haystack, Size lo, Size hi, const T &value, Search &search)
+{
+  while(lo < hi)
+  {
+    const Size mid = lo + (hi - lo) / 2;
+
+    if(search.precedes(haystack[mid], value))
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+
+// answers queries [queries_begin, queries_end), writing the answer to the
+// query at position i to output[i]
+template<typename RandomAccessIterator1,
+         typename Size,
+         typename RandomAccessIterator2,
+         typename RandomAccessIterator3,
+         typename Search>
+  void sorted_search_tile(RandomAccessIterator1 haystack,
+                          Size n,
+                          RandomAccessIterator2 queries,
+                          Size queries_begin,
+                          Size queries_end,
+                          RandomAccessIterator3 output,
+                          Search search)
+{
+  if(queries_begin == queries_end) return;
+
+  // the first query of a tile has nothing to gallop from
+  Size finger = sorted_search_partition(haystack, Size(0), n, queries[queries_begin], search);
+  output[queries_begin] = search.result(haystack, n, finger, queries[queries_begin]);
+
+  Size i = queries_begin + 1;
+
+  for(; i < queries_end; ++i)
+  {
+    // the answer lies before the previous one: the queries aren't sorted
+    if(finger > 0 && !search.precedes(haystack[finger - 1], queries[i]))
+    {
+      break;
+    }
+
+    // every element before lo precedes the query; gallop until one doesn't
+    Size lo = finger;
+    Size hi = finger;
+
+    for(Size step = 1; ; step *= 2)
+    {
+      hi = (n - lo > step) ? lo + step : n;
+
+      if(hi == n || !search.precedes(haystack[hi - 1], queries[i])) break;
+
+      lo = hi;
+    }
+
+    finger = sorted_search_partition(haystack, lo, hi, queries[i], search);
+    output[i] = search.result(haystack, n, finger, queries[i]);
+  }
+
+  for(; i < queries_end; ++i)
+  {
+    output[i] = search.result(haystack, n, sorted_search_partition(haystack, Size(0), n, queries[i], search), queries[i]);
+  }
+}
+
+
+} // end internal
+} // end detail
+} // end system
+} // end thrust
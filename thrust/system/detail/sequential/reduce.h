@@ -24,6 +24,7 @@
 #include <thrust/detail/config.h>
 #include <thrust/detail/function.h>
 #include <thrust/system/detail/sequential/execution_policy.h>
+#include <thrust/system/detail/sequential/vectorized_reduce.h>
 
 namespace thrust
 {
@@ -35,17 +36,20 @@ namespace sequential
 {
 
 
+namespace reduce_detail
+{
+
+
 __thrust_exec_check_disable__
-template<typename DerivedPolicy,
-         typename InputIterator, 
+template<typename InputIterator, 
          typename OutputType,
          typename BinaryFunction>
 __host__ __device__
-  OutputType reduce(sequential::execution_policy<DerivedPolicy> &,
-                    InputIterator begin,
+  OutputType reduce(InputIterator begin,
                     InputIterator end,
                     OutputType init,
-                    BinaryFunction binary_op)
+                    BinaryFunction binary_op,
+                    thrust::detail::false_type) // is_vectorizable_reduction
 {
   // wrap binary_op
   thrust::detail::wrapped_function<
@@ -66,6 +70,45 @@ __host__ __device__
 }
 
 
+__thrust_exec_check_disable__
+template<typename InputIterator, 
+         typename OutputType,
+         typename BinaryFunction>
+__host__ __device__
+  OutputType reduce(InputIterator begin,
+                    InputIterator end,
+                    OutputType init,
+                    BinaryFunction binary_op,
+                    thrust::detail::true_type) // is_vectorizable_reduction
+{
+#if !defined(__CUDA_ARCH__) && !defined(__HIP_DEVICE_COMPILE__)
+  return thrust::system::detail::sequential::reduce_detail::vectorized_reduce(begin, end, init, binary_op);
+#else
+  return thrust::system::detail::sequential::reduce_detail::reduce(begin, end, init, binary_op, thrust::detail::false_type());
+#endif
+}
+
+
+} // end namespace reduce_detail
+
+
+__thrust_exec_check_disable__
+template<typename DerivedPolicy,
+         typename InputIterator, 
+         typename OutputType,
+         typename BinaryFunction>
+__host__ __device__
+  OutputType reduce(sequential::execution_policy<DerivedPolicy> &,
+                    InputIterator begin,
+                    InputIterator end,
+                    OutputType init,
+                    BinaryFunction binary_op)
+{
+  return thrust::system::detail::sequential::reduce_detail::reduce(begin, end, init, binary_op,
+    typename thrust::system::detail::sequential::reduce_detail::is_vectorizable_reduction<InputIterator,OutputType,BinaryFunction>::type());
+}
+
+
 } // end namespace sequential
 } // end namespace detail
 } // end namespace system
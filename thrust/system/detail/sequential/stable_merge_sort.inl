@@ -21,6 +21,7 @@
 #include <thrust/merge.h>
 #include <thrust/system/detail/sequential/insertion_sort.h>
 #include <thrust/detail/minmax.h>
+#include <thrust/tuning.h>
 
 namespace thrust
 {
@@ -317,9 +318,10 @@ __host__ __device__
 void recursive_stable_merge_sort(sequential::execution_policy<DerivedPolicy> &exec,
                                  RandomAccessIterator first,
                                  RandomAccessIterator last,
-                                 StrictWeakOrdering comp)
+                                 StrictWeakOrdering comp,
+                                 std::size_t partition_size)
 {
-  if(last - first <= 32)
+  if(static_cast<std::size_t>(last - first) <= partition_size)
   {
     thrust::system::detail::sequential::insertion_sort(first, last, comp);
   } // end if
@@ -327,8 +329,8 @@ void recursive_stable_merge_sort(sequential::execution_policy<DerivedPolicy> &ex
   {
     RandomAccessIterator middle = first + (last - first) / 2;
 
-    stable_merge_sort_detail::recursive_stable_merge_sort(exec, first, middle, comp);
-    stable_merge_sort_detail::recursive_stable_merge_sort(exec, middle,  last, comp);
+    stable_merge_sort_detail::recursive_stable_merge_sort(exec, first, middle, comp, partition_size);
+    stable_merge_sort_detail::recursive_stable_merge_sort(exec, middle,  last, comp, partition_size);
     stable_merge_sort_detail::inplace_merge(exec, first, middle, last, comp);
   } // end else
 } // end recursive_stable_merge_sort()
@@ -343,9 +345,10 @@ void recursive_stable_merge_sort_by_key(sequential::execution_policy<DerivedPoli
                                         RandomAccessIterator1 first1,
                                         RandomAccessIterator1 last1,
                                         RandomAccessIterator2 first2,
-                                        StrictWeakOrdering comp)
+                                        StrictWeakOrdering comp,
+                                        std::size_t partition_size)
 {
-  if(last1 - first1 <= 32)
+  if(static_cast<std::size_t>(last1 - first1) <= partition_size)
   {
     thrust::system::detail::sequential::insertion_sort_by_key(first1, last1, first2, comp);
   } // end if
@@ -354,8 +357,8 @@ void recursive_stable_merge_sort_by_key(sequential::execution_policy<DerivedPoli
     RandomAccessIterator1 middle1 = first1 + (last1 - first1) / 2;
     RandomAccessIterator2 middle2 = first2 + (last1 - first1) / 2;
 
-    stable_merge_sort_detail::recursive_stable_merge_sort_by_key(exec, first1, middle1, first2,  comp);
-    stable_merge_sort_detail::recursive_stable_merge_sort_by_key(exec, middle1,  last1, middle2, comp);
+    stable_merge_sort_detail::recursive_stable_merge_sort_by_key(exec, first1, middle1, first2,  comp, partition_size);
+    stable_merge_sort_detail::recursive_stable_merge_sort_by_key(exec, middle1,  last1, middle2, comp, partition_size);
     stable_merge_sort_detail::inplace_merge_by_key(exec, first1, middle1, last1, first2, comp);
   } // end else
 } // end recursive_stable_merge_sort_by_key()
@@ -377,7 +380,11 @@ void stable_merge_sort(sequential::execution_policy<DerivedPolicy> &exec,
 #if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__)
   stable_merge_sort_detail::iterative_stable_merge_sort(exec, first, last, comp);
 #else
-  stable_merge_sort_detail::recursive_stable_merge_sort(exec, first, last, comp);
+  // the size of the partitions sorted by insertion can be tuned on the host, see thrust::tuning::merge_sort_partition_size
+  typedef typename thrust::iterator_value<RandomAccessIterator>::type value_type;
+  const std::size_t partition_size = thrust::tuning::get<value_type>(thrust::tuning::merge_sort_partition_size);
+
+  stable_merge_sort_detail::recursive_stable_merge_sort(exec, first, last, comp, partition_size);
 #endif
 }
 
@@ -397,7 +404,11 @@ void stable_merge_sort_by_key(sequential::execution_policy<DerivedPolicy> &exec,
 #if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__)
   stable_merge_sort_detail::iterative_stable_merge_sort_by_key(exec, first1, last1, first2, comp);
 #else
-  stable_merge_sort_detail::recursive_stable_merge_sort_by_key(exec, first1, last1, first2, comp);
+  // the size of the partitions sorted by insertion can be tuned on the host, see thrust::tuning::merge_sort_partition_size
+  typedef typename thrust::iterator_value<RandomAccessIterator1>::type value_type;
+  const std::size_t partition_size = thrust::tuning::get<value_type>(thrust::tuning::merge_sort_partition_size);
+
+  stable_merge_sort_detail::recursive_stable_merge_sort_by_key(exec, first1, last1, first2, comp, partition_size);
 #endif
 }
 
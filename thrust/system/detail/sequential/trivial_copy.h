@@ -42,7 +42,11 @@ __host__ __device__
                     T *result)
 {
 #if !defined(__CUDA_ARCH__) && !defined(__HIP_DEVICE_COMPILE__)
-  std::memmove(result, first, n * sizeof(T));
+  // empty ranges may be null, which memmove does not allow even for a zero size
+  if(n > 0)
+  {
+    std::memmove(result, first, n * sizeof(T));
+  }
   return result + n;
 #else
   return thrust::system::detail::sequential::general_copy_n(first, n, result);
@@ -0,0 +1,339 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+
+/*! \file vectorized_reduce.h
+ *  \brief Sequential reduction of contiguous arithmetic ranges in a form
+ *         the compiler can vectorize.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/detail/type_traits.h>
+#include <thrust/detail/internal_functional.h>
+#include <thrust/detail/raw_pointer_cast.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+#include <thrust/iterator/detail/is_trivial_iterator.h>
+#include <thrust/system/cpp/detail/execution_policy.h>
+#include <thrust/functional.h>
+#include <cstddef>
+
+// the width in bytes of the widest vector register targeted by the host compiler
+#ifndef THRUST_SEQUENTIAL_VECTOR_BYTES
+#  if defined(__AVX512F__)
+#    define THRUST_SEQUENTIAL_VECTOR_BYTES 64
+#  elif defined(__AVX__)
+#    define THRUST_SEQUENTIAL_VECTOR_BYTES 32
+#  else
+#    define THRUST_SEQUENTIAL_VECTOR_BYTES 16
+#  endif
+#endif // THRUST_SEQUENTIAL_VECTOR_BYTES
+
+namespace thrust
+{
+namespace system
+{
+namespace detail
+{
+namespace sequential
+{
+namespace reduce_detail
+{
+
+// A reduction carried by a single accumulator is a chain of dependent
+// operations, and the compiler may not reassociate it for floating point
+// types. vectorized_reduce instead keeps one accumulator per lane, enough
+// lanes to fill several vector registers, and combines them at the end. Each
+// lane is independent, so the inner loop vectorizes for whichever instruction
+// set the compiler targets and hides the latency of the vector unit.
+//
+// The lanes are split into a fixed number of groups of about a vector register
+// each, and the inner loop updates every group with a loop of its own. Each of
+// those loops vectorizes into whole vector operations on a group at a constant
+// address, which the compiler keeps in a register across the iterations. A
+// single loop over an array of all the lanes instead makes it load and store
+// the lanes on every iteration.
+//
+// This changes the order in which binary_op is applied, which reduce permits
+// because binary_op is required to be associative.
+
+const int num_lane_groups = 4;
+
+// the number of lanes in a group; at least 4, so that a group is a loop the
+// compiler vectorizes rather than a few scalar operations
+template<typename T>
+  struct lane_group_size
+{
+  static const int value = THRUST_SEQUENTIAL_VECTOR_BYTES / sizeof(T) > 4 ?
+                           THRUST_SEQUENTIAL_VECTOR_BYTES / sizeof(T) : 4;
+};
+
+template<typename T>
+  struct num_lanes
+{
+  static const int value = num_lane_groups * lane_group_size<T>::value;
+};
+
+
+// the reduction operators with a vector equivalent
+template<typename BinaryFunction, typename T>
+  struct is_vectorizable_operator
+    : thrust::detail::false_type
+{};
+
+template<typename T>
+  struct is_vectorizable_operator<thrust::plus<T>, T>
+    : thrust::detail::is_arithmetic<T>
+{};
+
+template<typename T>
+  struct is_vectorizable_operator<thrust::minimum<T>, T>
+    : thrust::detail::is_arithmetic<T>
+{};
+
+template<typename T>
+  struct is_vectorizable_operator<thrust::maximum<T>, T>
+    : thrust::detail::is_arithmetic<T>
+{};
+
+
+// a trivial iterator into memory the host reads directly: its system is the
+// standard C++ system or one derived from it, such as OpenMP and TBB. A
+// device_ptr into the memory of a device system is trivial too, but is only
+// read through its references.
+template<typename Iterator>
+  struct is_host_trivial_iterator
+    : thrust::detail::integral_constant<
+        bool,
+        thrust::detail::is_trivial_iterator<Iterator>::value &&
+        thrust::detail::is_convertible<
+          typename thrust::iterator_system<Iterator>::type *,
+          thrust::system::cpp::detail::execution_policy<typename thrust::iterator_system<Iterator>::type> *
+        >::value
+      >
+{};
+
+
+// provides indexed access to the values reduced from a range with a
+// contiguous layout in memory, or declares the range unsuitable
+template<typename Iterator, typename OutputType, typename Enable = void>
+  struct contiguous_source
+{
+  typedef thrust::detail::false_type is_contiguous;
+};
+
+
+// a range of trivial host iterators
+template<typename Iterator, typename OutputType>
+  struct contiguous_source<
+    Iterator,
+    OutputType,
+    typename thrust::detail::enable_if<
+      is_host_trivial_iterator<Iterator>::value
+    >::type
+  >
+{
+  typedef thrust::detail::true_type is_contiguous;
+
+  const typename thrust::iterator_value<Iterator>::type *ptr;
+
+  contiguous_source(Iterator first)
+    : ptr(thrust::raw_pointer_cast(&*first))
+  {}
+
+  OutputType operator[](std::ptrdiff_t i) const
+  {
+    return static_cast<OutputType>(ptr[i]);
+  }
+};
+
+
+// a transform_iterator over a range of trivial host iterators, as produced by transform_reduce
+template<typename UnaryFunction, typename Iterator, typename Reference, typename Value, typename OutputType>
+  struct contiguous_source<
+    thrust::transform_iterator<UnaryFunction,Iterator,Reference,Value>,
+    OutputType,
+    typename thrust::detail::enable_if<
+      is_host_trivial_iterator<Iterator>::value
+    >::type
+  >
+{
+  typedef thrust::detail::true_type is_contiguous;
+
+  typedef thrust::transform_iterator<UnaryFunction,Iterator,Reference,Value> iterator;
+  typedef typename thrust::iterator_reference<iterator>::type                 reference;
+  typedef typename thrust::iterator_value<Iterator>::type                     input_type;
+
+  const input_type *ptr;
+  mutable UnaryFunction f;
+
+  contiguous_source(iterator first)
+    : ptr(thrust::raw_pointer_cast(&*first.base())), f(first.functor())
+  {}
+
+  OutputType operator[](std::ptrdiff_t i) const
+  {
+    // like transform_iterator, pass f a copy of the element
+    input_type x = ptr[i];
+    return static_cast<OutputType>(static_cast<reference>(f(x)));
+  }
+};
+
+
+// a transform_iterator zipping two ranges of trivial host iterators, as produced by inner_product
+template<typename ResultType, typename BinaryFunction, typename Iterator1, typename Iterator2, typename Reference, typename Value, typename OutputType>
+  struct contiguous_source<
+    thrust::transform_iterator<
+      thrust::detail::zipped_binary_op<ResultType,BinaryFunction>,
+      thrust::zip_iterator<thrust::tuple<Iterator1,Iterator2> >,
+      Reference,
+      Value
+    >,
+    OutputType,
+    typename thrust::detail::enable_if<
+      is_host_trivial_iterator<Iterator1>::value &&
+      is_host_trivial_iterator<Iterator2>::value
+    >::type
+  >
+{
+  typedef thrust::detail::true_type is_contiguous;
+
+  typedef thrust::transform_iterator<
+    thrust::detail::zipped_binary_op<ResultType,BinaryFunction>,
+    thrust::zip_iterator<thrust::tuple<Iterator1,Iterator2> >,
+    Reference,
+    Value
+  > iterator;
+  typedef typename thrust::iterator_reference<iterator>::type reference;
+  typedef typename thrust::iterator_value<Iterator1>::type    input_type1;
+  typedef typename thrust::iterator_value<Iterator2>::type    input_type2;
+
+  const input_type1 *ptr1;
+  const input_type2 *ptr2;
+  mutable BinaryFunction f;
+
+  contiguous_source(iterator first)
+    : ptr1(thrust::raw_pointer_cast(&*thrust::get<0>(first.base().get_iterator_tuple()))),
+      ptr2(thrust::raw_pointer_cast(&*thrust::get<1>(first.base().get_iterator_tuple()))),
+      f(first.functor().m_binary_op)
+  {}
+
+  OutputType operator[](std::ptrdiff_t i) const
+  {
+    // like zip_iterator, pass f lvalues
+    input_type1 x = ptr1[i];
+    input_type2 y = ptr2[i];
+    return static_cast<OutputType>(static_cast<reference>(static_cast<ResultType>(f(x, y))));
+  }
+};
+
+
+template<typename InputIterator, typename OutputType, typename BinaryFunction>
+  struct is_vectorizable_reduction
+    : thrust::detail::integral_constant<
+        bool,
+        is_vectorizable_operator<BinaryFunction,OutputType>::value &&
+        contiguous_source<InputIterator,OutputType>::is_contiguous::value
+      >
+{};
+
+
+// reduces the elements src[i, i + GroupSize) into the lanes of a group
+template<int GroupSize, typename Source, typename OutputType, typename BinaryFunction>
+  void reduce_lane_group(OutputType (&group)[GroupSize],
+                         const Source &src,
+                         std::ptrdiff_t i,
+                         BinaryFunction &binary_op)
+{
+  for(std::ptrdiff_t j = 0; j < GroupSize; ++j)
+  {
+    group[j] = binary_op(group[j], src[i + j]);
+  }
+}
+
+
+template<typename InputIterator, typename OutputType, typename BinaryFunction>
+  OutputType vectorized_reduce(InputIterator first,
+                               InputIterator last,
+                               OutputType init,
+                               BinaryFunction binary_op)
+{
+  const int            group = lane_group_size<OutputType>::value;
+  const std::ptrdiff_t lanes = num_lanes<OutputType>::value;
+  const std::ptrdiff_t n     = last - first;
+
+  OutputType result = init;
+
+  if(n < 2 * lanes)
+  {
+    for(; first != last; ++first)
+    {
+      result = binary_op(result, *first);
+    }
+
+    return result;
+  }
+
+  contiguous_source<InputIterator,OutputType> src(first);
+
+  // there is no identity for minimum and maximum, so seed the lanes with the first elements
+  OutputType acc[num_lane_groups][group];
+
+  for(int g = 0; g < num_lane_groups; ++g)
+  {
+    for(std::ptrdiff_t j = 0; j < group; ++j)
+    {
+      acc[g][j] = src[g * group + j];
+    }
+  }
+
+  std::ptrdiff_t i = lanes;
+
+  // one call per group, each at a constant address
+  for(; i + lanes <= n; i += lanes)
+  {
+    reduce_lane_group(acc[0], src, i,             binary_op);
+    reduce_lane_group(acc[1], src, i + group,     binary_op);
+    reduce_lane_group(acc[2], src, i + 2 * group, binary_op);
+    reduce_lane_group(acc[3], src, i + 3 * group, binary_op);
+  }
+
+  for(int g = 0; g < num_lane_groups; ++g)
+  {
+    for(std::ptrdiff_t j = 0; j < group; ++j)
+    {
+      result = binary_op(result, acc[g][j]);
+    }
+  }
+
+  for(; i < n; ++i)
+  {
+    result = binary_op(result, src[i]);
+  }
+
+  return result;
+}
+
+
+} // end namespace reduce_detail
+} // end namespace sequential
+} // end namespace detail
+} // end namespace system
+} // end namespace thrust
@@ -19,6 +19,9 @@
 #include <thrust/detail/config.h>
 #include <thrust/system/omp/detail/execution_policy.h>
 #include <thrust/system/detail/generic/binary_search.h>
+#include <thrust/system/detail/internal/sorted_search.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
+#include <thrust/detail/static_assert.h>
 
 namespace thrust
 {
@@ -66,6 +69,106 @@ bool binary_search(execution_policy<DerivedPolicy> &exec,
 }
 
 
+namespace binary_search_detail
+{
+
+
+template<typename DerivedPolicy, typename RandomAccessIterator1, typename RandomAccessIterator2, typename RandomAccessIterator3, typename Search>
+RandomAccessIterator3 sorted_search(execution_policy<DerivedPolicy> &exec,
+                                    RandomAccessIterator1 begin,
+                                    RandomAccessIterator1 end,
+                                    RandomAccessIterator2 values_begin,
+                                    RandomAccessIterator2 values_end,
+                                    RandomAccessIterator3 output,
+                                    Search search)
+{
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<RandomAccessIterator1,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef typename thrust::iterator_difference<RandomAccessIterator1>::type Size;
+
+  const Size n = end - begin;
+  const Size m = values_end - values_begin;
+
+  // every thread answers a contiguous tile of the queries
+  thrust::system::detail::internal::uniform_decomposition<Size> decomp = thrust::system::omp::detail::default_decomposition(exec, m);
+
+  if(decomp.size() <= 1)
+  {
+    thrust::system::detail::internal::sorted_search_tile(begin, n, values_begin, Size(0), m, output, search);
+    return output + m;
+  }
+
+  const Size num_tiles = static_cast<Size>(decomp.size());
+
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+  for(Size i = 0; i < num_tiles; ++i)
+  {
+    thrust::system::detail::internal::sorted_search_tile(begin, n, values_begin, decomp[i].begin(), decomp[i].end(), output, search);
+  }
+
+  return output + m;
+}
+
+
+} // end binary_search_detail
+
+
+// the vectorized searches answer a tile of the queries per thread, galloping
+// from one answer to the next when the queries are sorted
+
+template <typename DerivedPolicy, typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+typename thrust::system::detail::internal::enable_if_sorted_search<ForwardIterator,InputIterator,OutputIterator,OutputIterator>::type
+  lower_bound(execution_policy<DerivedPolicy> &exec,
+              ForwardIterator begin,
+              ForwardIterator end,
+              InputIterator values_begin,
+              InputIterator values_end,
+              OutputIterator output,
+              StrictWeakOrdering comp)
+{
+  return binary_search_detail::sorted_search(exec, begin, end, values_begin, values_end, output,
+    thrust::system::detail::internal::sorted_lower_bound<StrictWeakOrdering>(comp));
+}
+
+
+template <typename DerivedPolicy, typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+typename thrust::system::detail::internal::enable_if_sorted_search<ForwardIterator,InputIterator,OutputIterator,OutputIterator>::type
+  upper_bound(execution_policy<DerivedPolicy> &exec,
+              ForwardIterator begin,
+              ForwardIterator end,
+              InputIterator values_begin,
+              InputIterator values_end,
+              OutputIterator output,
+              StrictWeakOrdering comp)
+{
+  return binary_search_detail::sorted_search(exec, begin, end, values_begin, values_end, output,
+    thrust::system::detail::internal::sorted_upper_bound<StrictWeakOrdering>(comp));
+}
+
+
+template <typename DerivedPolicy, typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+typename thrust::system::detail::internal::enable_if_sorted_search<ForwardIterator,InputIterator,OutputIterator,OutputIterator>::type
+  binary_search(execution_policy<DerivedPolicy> &exec,
+                ForwardIterator begin,
+                ForwardIterator end,
+                InputIterator values_begin,
+                InputIterator values_end,
+                OutputIterator output,
+                StrictWeakOrdering comp)
+{
+  return binary_search_detail::sorted_search(exec, begin, end, values_begin, values_end, output,
+    thrust::system::detail::internal::sorted_binary_search<StrictWeakOrdering>(comp));
+}
+
+
 } // end detail
 } // end omp
 } // end system
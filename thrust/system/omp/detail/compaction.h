@@ -0,0 +1,129 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file compaction.h
+ *  \brief Moves the survivors of tiles compacted in place by the OpenMP
+ *         backend to their final position.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/system/omp/detail/execution_policy.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
+#include <thrust/system/detail/internal/compaction_tiles.h>
+#include <thrust/detail/cstdint.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/temporary_array.h>
+#include <thrust/copy.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/detail/minmax.h>
+
+// the number of grains each thread moves per sweep when moving compacted
+// tiles, which bounds the temporary storage to this many grains per thread
+#ifndef THRUST_OMP_COMPACTION_GRAINS_PER_CHUNK
+#  define THRUST_OMP_COMPACTION_GRAINS_PER_CHUNK 64
+#endif
+
+namespace thrust
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+
+
+template<typename DerivedPolicy,
+         typename Tile,
+         typename RandomAccessIterator>
+  void move_compacted_tiles(execution_policy<DerivedPolicy> &exec,
+                            Tile *tiles,
+                            typename Tile::size_type num_tiles,
+                            RandomAccessIterator first)
+{
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<RandomAccessIterator,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef typename thrust::iterator_value<RandomAccessIterator>::type value_type;
+  typedef thrust::detail::intptr_t index_type;
+
+  const index_type n = static_cast<index_type>(num_tiles);
+
+  const index_type first_moved = thrust::system::detail::internal::compaction_tile_first_moved(tiles, num_tiles);
+
+  if(first_moved == n) return;
+
+  // the survivors from the first tile which moves on
+  const index_type begin = tiles[first_moved].output_offset;
+  const index_type end   = tiles[n - 1].output_offset + tiles[n - 1].num_survivors;
+
+  // the output moves in windows of one chunk per thread
+  const index_type grain_size  = static_cast<index_type>(thrust::max<std::size_t>(1, get_grain_size(thrust::detail::derived_cast(exec))));
+  const index_type chunk_size  = grain_size * THRUST_OMP_COMPACTION_GRAINS_PER_CHUNK;
+  const index_type num_threads = static_cast<index_type>(thrust::system::omp::detail::default_num_threads(exec));
+  const index_type window_size = thrust::min<index_type>(end - begin, chunk_size * num_threads);
+
+  thrust::detail::temporary_array<value_type,DerivedPolicy> buffer_storage(exec, window_size);
+  value_type *buffer = thrust::raw_pointer_cast(buffer_storage.data());
+
+  for(index_type window_begin = begin; window_begin < end; window_begin += window_size)
+  {
+    const index_type window_end = thrust::min<index_type>(window_begin + window_size, end);
+    const index_type num_chunks = (window_end - window_begin + chunk_size - 1) / chunk_size;
+
+    // every thread gathers the survivors bound for its chunk of the window
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+    for(index_type i = 0; i < num_chunks; ++i)
+    {
+      const index_type chunk_begin = window_begin + i * chunk_size;
+      const index_type chunk_end   = thrust::min<index_type>(chunk_begin + chunk_size, window_end);
+
+      thrust::system::detail::internal::compaction_tiles_gather(tiles, num_tiles, first,
+                                                                static_cast<typename Tile::size_type>(chunk_begin),
+                                                                static_cast<typename Tile::size_type>(chunk_end),
+                                                                buffer + i * chunk_size);
+    }
+
+    // every thread copies its chunk back over the window
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+    for(index_type i = 0; i < num_chunks; ++i)
+    {
+      const index_type chunk_begin = window_begin + i * chunk_size;
+      const index_type chunk_end   = thrust::min<index_type>(chunk_begin + chunk_size, window_end);
+
+      thrust::copy(thrust::seq, buffer + i * chunk_size, buffer + (chunk_end - window_begin), first + chunk_begin);
+    }
+  }
+} // end move_compacted_tiles()
+
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace thrust
+
@@ -18,6 +18,8 @@
 
 #include <thrust/detail/config.h>
 #include <thrust/system/omp/detail/copy.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
+#include <thrust/distance.h>
 #include <thrust/system/detail/generic/copy.h>
 #include <thrust/system/detail/sequential/copy.h>
 #include <thrust/detail/type_traits/minimum_type.h>
@@ -57,6 +59,12 @@ template<typename DerivedPolicy,
                       OutputIterator result,
                       thrust::random_access_traversal_tag)
 {
+  // small copies run sequentially rather than through a parallel transform
+  if(thrust::system::omp::detail::default_decomposition(exec, thrust::distance(first, last)).size() <= 1)
+  {
+    return thrust::system::detail::sequential::copy(exec, first, last, result);
+  }
+
   return thrust::system::detail::generic::copy(exec, first, last, result);
 } // end copy()
 
@@ -85,6 +93,12 @@ template<typename DerivedPolicy,
                         OutputIterator result,
                         thrust::random_access_traversal_tag)
 {
+  // small copies run sequentially rather than through a parallel transform
+  if(thrust::system::omp::detail::default_decomposition(exec, n).size() <= 1)
+  {
+    return thrust::system::detail::sequential::copy_n(exec, first, n, result);
+  }
+
   return thrust::system::detail::generic::copy_n(exec, first, n, result);
 } // end copy_n()
 
@@ -23,6 +23,7 @@
 
 #include <thrust/detail/config.h>
 #include <thrust/system/detail/internal/decompose.h>
+#include <thrust/system/omp/detail/par.h>
 
 namespace thrust
 {
@@ -36,6 +37,15 @@ namespace detail
 template <typename IndexType>
 thrust::system::detail::internal::uniform_decomposition<IndexType> default_decomposition(IndexType n);
 
+// as above, but with at least the policy's grain size of work per interval
+// and no more intervals than the policy's number of threads
+template <typename DerivedPolicy, typename IndexType>
+thrust::system::detail::internal::uniform_decomposition<IndexType> default_decomposition(execution_policy<DerivedPolicy> &exec, IndexType n);
+
+// the number of threads to request for the policy's parallel regions
+template <typename DerivedPolicy>
+int default_num_threads(execution_policy<DerivedPolicy> &exec);
+
 } // end namespace detail
 } // end namespace omp
 } // end namespace system
@@ -16,6 +16,7 @@
 
 #include <thrust/detail/config.h>
 #include <thrust/system/omp/detail/default_decomposition.h>
+#include <thrust/detail/minmax.h>
 
 // don't attempt to #include this file without omp support
 #if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
@@ -49,6 +50,46 @@ thrust::system::detail::internal::uniform_decomposition<IndexType> default_decom
 #endif
 }
 
+template <typename DerivedPolicy, typename IndexType>
+thrust::system::detail::internal::uniform_decomposition<IndexType> default_decomposition(execution_policy<DerivedPolicy> &exec, IndexType n)
+{
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to OpenMP support in your compiler.                         X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<IndexType,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  const std::size_t grain_size = thrust::max<std::size_t>(1, get_grain_size(thrust::detail::derived_cast(exec)));
+
+  const int num_threads = get_num_threads(thrust::detail::derived_cast(exec));
+
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+  const std::size_t num_procs = (num_threads > 0) ? num_threads : omp_get_num_procs();
+#else
+  const std::size_t num_procs = 1;
+#endif
+
+  // no more intervals than processors, and none smaller than a grain
+  const std::size_t num_grains = (n > 0) ? static_cast<std::size_t>(n) / grain_size : 0;
+  const IndexType max_intervals = static_cast<IndexType>(thrust::max<std::size_t>(1, thrust::min(num_procs, num_grains)));
+
+  return thrust::system::detail::internal::uniform_decomposition<IndexType>(n, 1, max_intervals);
+}
+
+template <typename DerivedPolicy>
+int default_num_threads(execution_policy<DerivedPolicy> &exec)
+{
+  const int num_threads = get_num_threads(thrust::detail::derived_cast(exec));
+
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+  return (num_threads > 0) ? num_threads : omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
 } // end namespace detail
 } // end namespace omp
 } // end namespace system
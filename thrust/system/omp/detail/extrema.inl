@@ -0,0 +1,169 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/detail/static_assert.h>
+#include <thrust/detail/temporary_array.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/distance.h>
+#include <thrust/system/omp/detail/extrema.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
+#include <thrust/system/detail/generic/extrema.h>
+#include <thrust/system/detail/internal/extrema_tiles.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+namespace dispatch
+{
+
+
+template<bool FindMin, bool FindMax, typename DerivedPolicy, typename ForwardIterator, typename BinaryPredicate>
+  thrust::pair<ForwardIterator,ForwardIterator> extrema(execution_policy<DerivedPolicy> &exec,
+                                                        ForwardIterator first,
+                                                        ForwardIterator last,
+                                                        BinaryPredicate comp,
+                                                        thrust::forward_traversal_tag)
+{
+  if(FindMin && FindMax)
+  {
+    return thrust::system::detail::generic::minmax_element(exec, first, last, comp);
+  }
+
+  ForwardIterator result = FindMin ? thrust::system::detail::generic::min_element(exec, first, last, comp)
+                                   : thrust::system::detail::generic::max_element(exec, first, last, comp);
+
+  return thrust::make_pair(result, result);
+} // end extrema()
+
+
+template<bool FindMin, bool FindMax, typename DerivedPolicy, typename RandomAccessIterator, typename BinaryPredicate>
+  thrust::pair<RandomAccessIterator,RandomAccessIterator> extrema(execution_policy<DerivedPolicy> &exec,
+                                                                  RandomAccessIterator first,
+                                                                  RandomAccessIterator last,
+                                                                  BinaryPredicate comp,
+                                                                  thrust::random_access_traversal_tag)
+{
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<RandomAccessIterator,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef typename thrust::iterator_difference<RandomAccessIterator>::type Size;
+  typedef thrust::pair<Size,Size>                                          Extrema;
+
+  const Size n = thrust::distance(first, last);
+
+  if(n == 0)
+  {
+    return thrust::make_pair(last, last);
+  }
+
+  thrust::system::detail::internal::uniform_decomposition<Size> decomp = thrust::system::omp::detail::default_decomposition(exec, n);
+
+  // a single interval needs neither the threads nor the partial results
+  if(decomp.size() <= 1)
+  {
+    Extrema result = thrust::system::detail::internal::extrema_in_tile<FindMin,FindMax>(first, Size(0), n, comp);
+
+    return thrust::make_pair(first + result.first, first + result.second);
+  }
+
+  thrust::detail::temporary_array<Extrema,DerivedPolicy> partial_extrema(exec, decomp.size());
+
+  Extrema *partial = thrust::raw_pointer_cast(partial_extrema.data());
+
+  const Size num_intervals = decomp.size();
+
+// do not attempt to compile the body of this function, which depends on #pragma omp,
+// without support from the compiler
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+  #pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  for(Size i = 0; i < num_intervals; ++i)
+  {
+    partial[i] = thrust::system::detail::internal::extrema_in_tile<FindMin,FindMax>(first, decomp[i].begin(), decomp[i].end(), comp);
+  }
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+
+  // keep the first extrema, in interval order
+  Extrema result = partial[0];
+
+  for(Size i = 1; i < num_intervals; ++i)
+  {
+    thrust::system::detail::internal::merge_extrema<FindMin,FindMax>(first, result, partial[i], comp);
+  }
+
+  return thrust::make_pair(first + result.first, first + result.second);
+} // end extrema()
+
+
+} // end dispatch
+
+
+template <typename DerivedPolicy, typename ForwardIterator, typename BinaryPredicate>
+ForwardIterator max_element(execution_policy<DerivedPolicy> &exec,
+                            ForwardIterator first,
+                            ForwardIterator last,
+                            BinaryPredicate comp)
+{
+  typedef typename thrust::iterator_traversal<ForwardIterator>::type traversal;
+
+  // dispatch on traversal
+  return thrust::system::omp::detail::dispatch::extrema<false,true>(exec, first, last, comp, traversal()).second;
+} // end max_element()
+
+
+template <typename DerivedPolicy, typename ForwardIterator, typename BinaryPredicate>
+ForwardIterator min_element(execution_policy<DerivedPolicy> &exec,
+                            ForwardIterator first,
+                            ForwardIterator last,
+                            BinaryPredicate comp)
+{
+  typedef typename thrust::iterator_traversal<ForwardIterator>::type traversal;
+
+  // dispatch on traversal
+  return thrust::system::omp::detail::dispatch::extrema<true,false>(exec, first, last, comp, traversal()).first;
+} // end min_element()
+
+
+template <typename DerivedPolicy, typename ForwardIterator, typename BinaryPredicate>
+thrust::pair<ForwardIterator,ForwardIterator> minmax_element(execution_policy<DerivedPolicy> &exec,
+                                                             ForwardIterator first,
+                                                             ForwardIterator last,
+                                                             BinaryPredicate comp)
+{
+  typedef typename thrust::iterator_traversal<ForwardIterator>::type traversal;
+
+  // dispatch on traversal, and find both extrema in a single pass
+  return thrust::system::omp::detail::dispatch::extrema<true,true>(exec, first, last, comp, traversal());
+} // end minmax_element()
+
+
+} // end detail
+} // end omp
+} // end system
+} // end thrust
+
@@ -22,7 +22,6 @@
 #pragma once
 
 #include <thrust/detail/config.h>
-#include <thrust/system/detail/generic/find.h>
 #include <thrust/system/omp/detail/execution_policy.h>
 
 namespace thrust
@@ -34,18 +33,18 @@ namespace omp
 namespace detail
 {
 
+// mismatch, equal, is_sorted_until, all_of, any_of and none_of reach this
+// through their generic implementations
 template <typename DerivedPolicy, typename InputIterator, typename Predicate>
 InputIterator find_if(execution_policy<DerivedPolicy> &exec,
                       InputIterator first,
                       InputIterator last,
-                      Predicate pred)
-{
-  // omp prefers generic::find_if to cpp::find_if
-  return thrust::system::detail::generic::find_if(exec, first, last, pred);
-}
+                      Predicate pred);
 
 } // end namespace detail
 } // end namespace omp
 } // end namespace system
 } // end namespace thrust
 
+#include <thrust/system/omp/detail/find.inl>
+
@@ -0,0 +1,149 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/detail/static_assert.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/distance.h>
+#include <thrust/find.h>
+#include <thrust/detail/seq.h>
+#include <thrust/system/omp/detail/find.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
+#include <thrust/system/detail/internal/find_tiles.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+namespace dispatch
+{
+
+
+template<typename DerivedPolicy, typename InputIterator, typename Predicate>
+  InputIterator find_if(execution_policy<DerivedPolicy> &,
+                        InputIterator first,
+                        InputIterator last,
+                        Predicate pred,
+                        thrust::incrementable_traversal_tag)
+{
+  return thrust::find_if(thrust::seq, first, last, pred);
+} // end find_if()
+
+
+template<typename DerivedPolicy, typename RandomAccessIterator, typename Predicate>
+  RandomAccessIterator find_if(execution_policy<DerivedPolicy> &exec,
+                               RandomAccessIterator first,
+                               RandomAccessIterator last,
+                               Predicate pred,
+                               thrust::random_access_traversal_tag)
+{
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<RandomAccessIterator,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef typename thrust::iterator_difference<RandomAccessIterator>::type Size;
+
+  const Size n = thrust::distance(first, last);
+
+  // don't bother forking threads for less than a single interval of work
+  const Size num_workers = thrust::system::omp::detail::default_decomposition(exec, n).size();
+
+  if(num_workers <= 1)
+  {
+    return thrust::find_if(thrust::seq, first, last, pred);
+  }
+
+  const Size tile_size = thrust::system::detail::internal::find_tile_size(n, num_workers, get_grain_size(thrust::detail::derived_cast(exec)));
+  const Size num_tiles = (n + tile_size - 1) / tile_size;
+
+  // the next tile to claim, and the position of the first match found so far
+  Size next_tile = 0;
+  Size best = n;
+
+// do not attempt to compile the body of this function, which depends on #pragma omp,
+// without support from the compiler
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+  #pragma omp parallel num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  {
+    while(true)
+    {
+      Size tile;
+      #pragma omp atomic capture
+      tile = next_tile++;
+
+      Size current_best;
+      #pragma omp atomic read
+      current_best = best;
+
+      // every later tile begins past this one
+      if(tile >= num_tiles || tile * tile_size >= current_best) break;
+
+      const Size match = thrust::system::detail::internal::find_in_tile(first, n, tile_size, tile, pred);
+
+      if(match < thrust::min<Size>(n, (tile + 1) * tile_size))
+      {
+        #pragma omp critical (thrust_omp_find_if)
+        {
+          if(match < best)
+          {
+            #pragma omp atomic write
+            best = match;
+          }
+        }
+
+        // every later tile begins past this match
+        break;
+      }
+    }
+  }
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+
+  return first + best;
+} // end find_if()
+
+
+} // end dispatch
+
+
+template <typename DerivedPolicy, typename InputIterator, typename Predicate>
+InputIterator find_if(execution_policy<DerivedPolicy> &exec,
+                      InputIterator first,
+                      InputIterator last,
+                      Predicate pred)
+{
+  typedef typename thrust::iterator_traversal<InputIterator>::type traversal;
+
+  // dispatch on traversal
+  return thrust::system::omp::detail::dispatch::find_if(exec, first, last, pred, traversal());
+} // end find_if()
+
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace thrust
+
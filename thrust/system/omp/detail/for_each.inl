@@ -26,6 +26,9 @@
 #include <thrust/iterator/iterator_traits.h>
 #include <thrust/distance.h>
 #include <thrust/for_each.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/minmax.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
 
 namespace thrust
 {
@@ -40,7 +43,7 @@ template<typename DerivedPolicy,
          typename RandomAccessIterator,
          typename Size,
          typename UnaryFunction>
-RandomAccessIterator for_each_n(execution_policy<DerivedPolicy> &,
+RandomAccessIterator for_each_n(execution_policy<DerivedPolicy> &exec,
                                 RandomAccessIterator first,
                                 Size n,
                                 UnaryFunction f)
@@ -55,6 +58,14 @@ RandomAccessIterator for_each_n(execution_policy<DerivedPolicy> &,
 
   if (n <= 0) return first;  //empty range
 
+  // don't bother forking threads for less than a single interval of work
+  const Size num_intervals = thrust::system::omp::detail::default_decomposition(exec, n).size();
+
+  if (num_intervals <= 1)
+  {
+    return thrust::for_each_n(thrust::seq, first, n, f);
+  }
+
   // create a wrapped function for f
   thrust::detail::wrapped_function<UnaryFunction,void> wrapped_f(f);
 
@@ -65,7 +76,12 @@ RandomAccessIterator for_each_n(execution_policy<DerivedPolicy> &,
   // use a signed type for the iteration variable or suffer the consequences of warnings
   typedef typename thrust::iterator_difference<RandomAccessIterator>::type DifferenceType;
   DifferenceType signed_n = n;
-#pragma omp parallel for
+
+  // the elements are split evenly between the threads, so use no more threads than intervals, lest a thread get
+  // less than a grain of work
+  const int num_threads = thrust::min<int>(thrust::system::omp::detail::default_num_threads(exec), static_cast<int>(num_intervals));
+
+#pragma omp parallel for num_threads(num_threads)
   for(DifferenceType i = 0;
       i < signed_n;
       ++i)
@@ -0,0 +1,173 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <thrust/detail/config.h>
+#include <thrust/system/omp/detail/merge.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
+#include <thrust/system/detail/internal/merge_path.h>
+#include <thrust/merge.h>
+#include <thrust/distance.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/cstdint.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+
+
+template<typename DerivedPolicy,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator,
+         typename StrictWeakOrdering>
+OutputIterator merge(execution_policy<DerivedPolicy> &exec,
+                     InputIterator1 first1,
+                     InputIterator1 last1,
+                     InputIterator2 first2,
+                     InputIterator2 last2,
+                     OutputIterator result,
+                     StrictWeakOrdering comp)
+{
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<InputIterator1,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef thrust::detail::intptr_t index_type;
+
+  const index_type n1 = thrust::distance(first1, last1);
+  const index_type n2 = thrust::distance(first2, last2);
+
+  // every interval of the output is produced by an independent sequential merge
+  thrust::system::detail::internal::uniform_decomposition<index_type> decomp = thrust::system::omp::detail::default_decomposition(exec, n1 + n2);
+
+  if(decomp.size() <= 1)
+  {
+    return thrust::merge(thrust::seq, first1, last1, first2, last2, result, comp);
+  }
+
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+  const index_type num_intervals = decomp.size();
+
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  for(index_type i = 0; i < num_intervals; ++i)
+  {
+    const index_type diag0 = decomp[i].begin();
+    const index_type diag1 = decomp[i].end();
+
+    // find where the merge path crosses the interval's boundaries
+    const index_type split0 = thrust::system::detail::internal::merge_path(first1, n1, first2, n2, diag0, comp);
+    const index_type split1 = thrust::system::detail::internal::merge_path(first1, n1, first2, n2, diag1, comp);
+
+    thrust::merge(thrust::seq,
+                  first1 + split0,           first1 + split1,
+                  first2 + (diag0 - split0), first2 + (diag1 - split1),
+                  result + diag0,
+                  comp);
+  }
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+
+  return result + (n1 + n2);
+} // end merge()
+
+
+template <typename DerivedPolicy,
+          typename InputIterator1,
+          typename InputIterator2,
+          typename InputIterator3,
+          typename InputIterator4,
+          typename OutputIterator1,
+          typename OutputIterator2,
+          typename StrictWeakOrdering>
+thrust::pair<OutputIterator1,OutputIterator2>
+  merge_by_key(execution_policy<DerivedPolicy> &exec,
+               InputIterator1 keys_first1,
+               InputIterator1 keys_last1,
+               InputIterator2 keys_first2,
+               InputIterator2 keys_last2,
+               InputIterator3 values_first1,
+               InputIterator4 values_first2,
+               OutputIterator1 keys_result,
+               OutputIterator2 values_result,
+               StrictWeakOrdering comp)
+{
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<InputIterator1,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef thrust::detail::intptr_t index_type;
+
+  const index_type n1 = thrust::distance(keys_first1, keys_last1);
+  const index_type n2 = thrust::distance(keys_first2, keys_last2);
+
+  // every interval of the output is produced by an independent sequential merge
+  thrust::system::detail::internal::uniform_decomposition<index_type> decomp = thrust::system::omp::detail::default_decomposition(exec, n1 + n2);
+
+  if(decomp.size() <= 1)
+  {
+    return thrust::merge_by_key(thrust::seq,
+                                keys_first1, keys_last1,
+                                keys_first2, keys_last2,
+                                values_first1, values_first2,
+                                keys_result, values_result,
+                                comp);
+  }
+
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+  const index_type num_intervals = decomp.size();
+
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  for(index_type i = 0; i < num_intervals; ++i)
+  {
+    const index_type diag0 = decomp[i].begin();
+    const index_type diag1 = decomp[i].end();
+
+    // find where the merge path crosses the interval's boundaries
+    const index_type split0 = thrust::system::detail::internal::merge_path(keys_first1, n1, keys_first2, n2, diag0, comp);
+    const index_type split1 = thrust::system::detail::internal::merge_path(keys_first1, n1, keys_first2, n2, diag1, comp);
+
+    thrust::merge_by_key(thrust::seq,
+                         keys_first1 + split0,           keys_first1 + split1,
+                         keys_first2 + (diag0 - split0), keys_first2 + (diag1 - split1),
+                         values_first1 + split0,         values_first2 + (diag0 - split0),
+                         keys_result + diag0,            values_result + diag0,
+                         comp);
+  }
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+
+  return thrust::make_pair(keys_result + (n1 + n2), values_result + (n1 + n2));
+} // end merge_by_key()
+
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace thrust
+
@@ -19,6 +19,13 @@
 #include <thrust/detail/config.h>
 #include <thrust/detail/allocator_aware_execution_policy.h>
 #include <thrust/system/omp/detail/execution_policy.h>
+#include <cstddef>
+
+// the smallest number of elements worth handing to a single OpenMP thread;
+// inputs smaller than two grains are processed sequentially
+#ifndef THRUST_OMP_DEFAULT_GRAIN_SIZE
+#  define THRUST_OMP_DEFAULT_GRAIN_SIZE 1024
+#endif
 
 namespace thrust
 {
@@ -30,12 +37,96 @@ namespace detail
 {
 
 
+template<typename Derived>
+__host__ __device__
+  std::size_t get_grain_size(execution_policy<Derived> &)
+{
+  return THRUST_OMP_DEFAULT_GRAIN_SIZE;
+}
+
+
+// zero requests the OpenMP runtime's default number of threads
+template<typename Derived>
+__host__ __device__
+  int get_num_threads(execution_policy<Derived> &)
+{
+  return 0;
+}
+
+
+template<typename Derived>
+  struct execute_with_parameters_base
+    : thrust::system::omp::detail::execution_policy<Derived>
+{
+  private:
+    std::size_t grain_size;
+    int num_threads;
+
+  public:
+    __host__ __device__
+    execute_with_parameters_base()
+      : grain_size(THRUST_OMP_DEFAULT_GRAIN_SIZE),
+        num_threads(0)
+    {}
+
+    // returns a copy of this policy which hands at least grain_size
+    // elements to each thread
+    __host__ __device__
+    Derived with_grain_size(std::size_t grain_size_) const
+    {
+      Derived result = thrust::detail::derived_cast(*this);
+      result.grain_size = grain_size_;
+      return result;
+    }
+
+    // returns a copy of this policy which runs its parallel regions on
+    // num_threads threads and decomposes work for that many threads
+    __host__ __device__
+    Derived with_threads(int num_threads_) const
+    {
+      Derived result = thrust::detail::derived_cast(*this);
+      result.num_threads = num_threads_;
+      return result;
+    }
+
+  private:
+    friend __host__ __device__
+      std::size_t get_grain_size(const execute_with_parameters_base &exec)
+    {
+      return exec.grain_size;
+    }
+
+    friend __host__ __device__
+      int get_num_threads(const execute_with_parameters_base &exec)
+    {
+      return exec.num_threads;
+    }
+};
+
+
+struct execute_with_parameters
+  : execute_with_parameters_base<execute_with_parameters>
+{};
+
+
 struct par_t : thrust::system::omp::detail::execution_policy<par_t>,
   thrust::detail::allocator_aware_execution_policy<
-    thrust::system::omp::detail::execution_policy>
+    thrust::system::omp::detail::execute_with_parameters_base>
 {
   __host__ __device__
   par_t() : thrust::system::omp::detail::execution_policy<par_t>() {}
+
+  __host__ __device__
+  execute_with_parameters with_grain_size(std::size_t grain_size) const
+  {
+    return execute_with_parameters().with_grain_size(grain_size);
+  }
+
+  __host__ __device__
+  execute_with_parameters with_threads(int num_threads) const
+  {
+    return execute_with_parameters().with_threads(num_threads);
+  }
 };
 
 
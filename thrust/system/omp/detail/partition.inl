@@ -23,7 +23,18 @@
 
 #include <thrust/detail/config.h>
 #include <thrust/system/omp/detail/partition.h>
+#include <thrust/system/omp/detail/compaction.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
 #include <thrust/system/detail/generic/partition.h>
+#include <thrust/system/detail/internal/compaction_tiles.h>
+#include <thrust/partition.h>
+#include <thrust/count.h>
+#include <thrust/copy.h>
+#include <thrust/distance.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/cstdint.h>
+#include <thrust/detail/temporary_array.h>
 
 namespace thrust
 {
@@ -43,8 +54,70 @@ template<typename DerivedPolicy,
                                    ForwardIterator last,
                                    Predicate pred)
 {
-  // omp prefers generic::stable_partition to cpp::stable_partition
-  return thrust::system::detail::generic::stable_partition(exec, first, last, pred);
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<ForwardIterator,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef typename thrust::iterator_value<ForwardIterator>::type value_type;
+  typedef thrust::detail::intptr_t index_type;
+  typedef thrust::system::detail::internal::compaction_tile<index_type> tile_type;
+
+  const index_type n = thrust::distance(first, last);
+
+  thrust::system::detail::internal::uniform_decomposition<index_type> decomp = thrust::system::omp::detail::default_decomposition(exec, n);
+
+  if(decomp.size() <= 1)
+  {
+    return thrust::stable_partition(thrust::seq, first, last, pred);
+  }
+
+  const index_type num_tiles = static_cast<index_type>(decomp.size());
+
+  thrust::detail::temporary_array<tile_type,DerivedPolicy> tile_storage(exec, num_tiles);
+  tile_type *tiles = thrust::raw_pointer_cast(tile_storage.data());
+
+  // count the elements of every tile which satisfy pred
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    const index_type begin = decomp[i].begin();
+    const index_type end   = decomp[i].end();
+
+    tiles[i].survivors_begin = begin;
+    tiles[i].num_survivors   = thrust::count_if(thrust::seq, first + begin, first + end, pred);
+  }
+
+  const index_type num_true = thrust::system::detail::internal::compaction_tile_offsets(tiles, num_tiles);
+
+  // only the elements which fail pred need to be buffered
+  thrust::detail::temporary_array<value_type,DerivedPolicy> false_storage(exec, n - num_true);
+  value_type *falses = thrust::raw_pointer_cast(false_storage.data());
+
+  // the sequential stable_partition_copy never writes out_true ahead of
+  // the element being read, so each tile may keep its true elements in place
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    const index_type begin = decomp[i].begin();
+    const index_type end   = decomp[i].end();
+
+    thrust::stable_partition_copy(thrust::seq, first + begin, first + end, first + begin, falses + (begin - tiles[i].output_offset), pred);
+  }
+
+  // close the gaps between tiles
+  thrust::system::omp::detail::move_compacted_tiles(exec, tiles, num_tiles, first);
+
+  thrust::copy(exec, false_storage.begin(), false_storage.end(), first + num_true);
+
+  return first + num_true;
 } // end stable_partition()
 
 
@@ -58,8 +131,70 @@ template<typename DerivedPolicy,
                                    InputIterator stencil,
                                    Predicate pred)
 {
-  // omp prefers generic::stable_partition to cpp::stable_partition
-  return thrust::system::detail::generic::stable_partition(exec, first, last, stencil, pred);
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<ForwardIterator,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef typename thrust::iterator_value<ForwardIterator>::type value_type;
+  typedef thrust::detail::intptr_t index_type;
+  typedef thrust::system::detail::internal::compaction_tile<index_type> tile_type;
+
+  const index_type n = thrust::distance(first, last);
+
+  thrust::system::detail::internal::uniform_decomposition<index_type> decomp = thrust::system::omp::detail::default_decomposition(exec, n);
+
+  if(decomp.size() <= 1)
+  {
+    return thrust::stable_partition(thrust::seq, first, last, stencil, pred);
+  }
+
+  const index_type num_tiles = static_cast<index_type>(decomp.size());
+
+  thrust::detail::temporary_array<tile_type,DerivedPolicy> tile_storage(exec, num_tiles);
+  tile_type *tiles = thrust::raw_pointer_cast(tile_storage.data());
+
+  // count the elements of every tile which satisfy pred
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    const index_type begin = decomp[i].begin();
+    const index_type end   = decomp[i].end();
+
+    tiles[i].survivors_begin = begin;
+    tiles[i].num_survivors   = thrust::count_if(thrust::seq, stencil + begin, stencil + end, pred);
+  }
+
+  const index_type num_true = thrust::system::detail::internal::compaction_tile_offsets(tiles, num_tiles);
+
+  // only the elements which fail pred need to be buffered
+  thrust::detail::temporary_array<value_type,DerivedPolicy> false_storage(exec, n - num_true);
+  value_type *falses = thrust::raw_pointer_cast(false_storage.data());
+
+  // the sequential stable_partition_copy never writes out_true ahead of
+  // the element being read, so each tile may keep its true elements in place
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    const index_type begin = decomp[i].begin();
+    const index_type end   = decomp[i].end();
+
+    thrust::stable_partition_copy(thrust::seq, first + begin, first + end, stencil + begin, first + begin, falses + (begin - tiles[i].output_offset), pred);
+  }
+
+  // close the gaps between tiles
+  thrust::system::omp::detail::move_compacted_tiles(exec, tiles, num_tiles, first);
+
+  thrust::copy(exec, false_storage.begin(), false_storage.end(), first + num_true);
+
+  return first + num_true;
 } // end stable_partition()
 
 
@@ -19,6 +19,8 @@
 #include <thrust/system/omp/detail/reduce.h>
 #include <thrust/system/omp/detail/default_decomposition.h>
 #include <thrust/system/omp/detail/reduce_intervals.h>
+#include <thrust/reduce.h>
+#include <thrust/detail/seq.h>
 
 namespace thrust
 {
@@ -45,7 +47,14 @@ template<typename DerivedPolicy,
   const difference_type n = thrust::distance(first,last);
 
   // determine first and second level decomposition
-  thrust::system::detail::internal::uniform_decomposition<difference_type> decomp1 = thrust::system::omp::detail::default_decomposition(n);
+  thrust::system::detail::internal::uniform_decomposition<difference_type> decomp1 = thrust::system::omp::detail::default_decomposition(exec, n);
+
+  // a single interval needs neither the threads nor the partial sums
+  if(decomp1.size() <= 1)
+  {
+    return thrust::reduce(thrust::seq, first, last, init, binary_op);
+  }
+
   thrust::system::detail::internal::uniform_decomposition<difference_type> decomp2(decomp1.size() + 1, 1, 1);
 
   // allocate storage for the initializer and partial sums
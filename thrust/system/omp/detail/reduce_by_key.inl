@@ -16,8 +16,13 @@
 
 #include <thrust/detail/config.h>
 #include <thrust/system/omp/detail/reduce_by_key.h>
-#include <thrust/system/detail/generic/reduce_by_key.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
+#include <thrust/system/detail/internal/reduce_by_key_tiles.h>
+#include <thrust/reduce.h>
 #include <thrust/distance.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/cstdint.h>
+#include <thrust/detail/temporary_array.h>
 
 namespace thrust
 {
@@ -45,8 +50,61 @@ template <typename DerivedPolicy,
                   BinaryPredicate binary_pred,
                   BinaryFunction binary_op)
 {
-  // omp prefers generic::reduce_by_key to cpp::reduce_by_key
-  return thrust::system::detail::generic::reduce_by_key(exec, keys_first, keys_last, values_first, keys_output, values_output, binary_pred, binary_op);
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<InputIterator1,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef typename thrust::system::detail::internal::reduce_by_key_tile_type<
+    InputIterator1,
+    InputIterator2,
+    OutputIterator2,
+    BinaryFunction
+  >::type tile_type;
+
+  typedef typename thrust::iterator_difference<InputIterator1>::type difference_type;
+
+  const difference_type n = thrust::distance(keys_first, keys_last);
+
+  thrust::system::detail::internal::uniform_decomposition<difference_type> decomp = thrust::system::omp::detail::default_decomposition(exec, n);
+
+  // a single tile gains nothing from the extra counting pass
+  if(decomp.size() <= 1)
+  {
+    return thrust::reduce_by_key(thrust::seq, keys_first, keys_last, values_first, keys_output, values_output, binary_pred, binary_op);
+  }
+
+  difference_type num_segments = 0;
+
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+  typedef thrust::detail::intptr_t index_type;
+
+  const index_type num_tiles = static_cast<index_type>(decomp.size());
+
+  thrust::detail::temporary_array<tile_type,DerivedPolicy> tile_storage(exec, num_tiles);
+  tile_type *tiles = thrust::raw_pointer_cast(tile_storage.data());
+
+  // count the segments ending in each tile and reduce the open segment (upsweep)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    thrust::system::detail::internal::reduce_by_key_tile_upsweep(tiles[i], keys_first, values_first, n, decomp[i].begin(), decomp[i].end(), binary_pred, binary_op);
+  }
+
+  num_segments = thrust::system::detail::internal::reduce_by_key_tile_carries(tiles, num_tiles, binary_op);
+
+  // reduce the segments ending in each tile seeded with its carry (downsweep)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    thrust::system::detail::internal::reduce_by_key_tile_downsweep(tiles[i], keys_first, values_first, keys_output, values_output, n, decomp[i].begin(), binary_pred, binary_op);
+  }
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+
+  return thrust::make_pair(keys_output + num_segments, values_output + num_segments);
 } // end reduce_by_key()
 
 
@@ -17,8 +17,11 @@
 
 #include <thrust/detail/config.h>
 #include <thrust/system/omp/detail/reduce_intervals.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
 #include <thrust/iterator/iterator_traits.h>
-#include <thrust/detail/function.h>
+#include <thrust/detail/raw_reference_cast.h>
+#include <thrust/reduce.h>
+#include <thrust/detail/seq.h>
 #include <thrust/detail/cstdint.h>
 
 namespace thrust
@@ -35,7 +38,7 @@ template <typename DerivedPolicy,
           typename OutputIterator,
           typename BinaryFunction,
           typename Decomposition>
-void reduce_intervals(execution_policy<DerivedPolicy> &,
+void reduce_intervals(execution_policy<DerivedPolicy> &exec,
                       InputIterator input,
                       OutputIterator output,
                       BinaryFunction binary_op,
@@ -52,15 +55,12 @@ void reduce_intervals(execution_policy<DerivedPolicy> &,
 #if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
   typedef typename thrust::iterator_value<OutputIterator>::type OutputType;
 
-  // wrap binary_op
-  thrust::detail::wrapped_function<BinaryFunction,OutputType> wrapped_binary_op(binary_op);
-
   typedef thrust::detail::intptr_t index_type;
 
   index_type n = static_cast<index_type>(decomp.size());
 
 #if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
-# pragma omp parallel for
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
 #endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
   for(index_type i = 0; i < n; i++)
   {
@@ -73,11 +73,8 @@ void reduce_intervals(execution_policy<DerivedPolicy> &,
 
       ++begin;
 
-      while (begin != end)
-      {
-        sum = wrapped_binary_op(sum, *begin);
-        ++begin;
-      }
+      // the sequential reduction vectorizes contiguous arithmetic ranges
+      sum = thrust::reduce(thrust::seq, begin, end, sum, binary_op);
 
       OutputIterator tmp = output + i;
       *tmp = sum;
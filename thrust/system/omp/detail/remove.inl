@@ -18,7 +18,15 @@
 
 #include <thrust/detail/config.h>
 #include <thrust/system/omp/detail/remove.h>
+#include <thrust/system/omp/detail/compaction.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
 #include <thrust/system/detail/generic/remove.h>
+#include <thrust/system/detail/internal/compaction_tiles.h>
+#include <thrust/remove.h>
+#include <thrust/distance.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/cstdint.h>
+#include <thrust/detail/temporary_array.h>
 
 namespace thrust
 {
@@ -37,8 +45,50 @@ template<typename DerivedPolicy,
                             ForwardIterator last,
                             Predicate pred)
 {
-  // omp prefers generic::remove_if to cpp::remove_if
-  return thrust::system::detail::generic::remove_if(exec, first, last, pred);
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<ForwardIterator,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef thrust::detail::intptr_t index_type;
+  typedef thrust::system::detail::internal::compaction_tile<index_type> tile_type;
+
+  const index_type n = thrust::distance(first, last);
+
+  thrust::system::detail::internal::uniform_decomposition<index_type> decomp = thrust::system::omp::detail::default_decomposition(exec, n);
+
+  if(decomp.size() <= 1)
+  {
+    return thrust::remove_if(thrust::seq, first, last, pred);
+  }
+
+  const index_type num_tiles = static_cast<index_type>(decomp.size());
+
+  thrust::detail::temporary_array<tile_type,DerivedPolicy> tile_storage(exec, num_tiles);
+  tile_type *tiles = thrust::raw_pointer_cast(tile_storage.data());
+
+  // compact every tile in place
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    const index_type begin = decomp[i].begin();
+    const index_type end   = decomp[i].end();
+
+    tiles[i].survivors_begin = begin;
+    tiles[i].num_survivors   = thrust::remove_if(thrust::seq, first + begin, first + end, pred) - (first + begin);
+  }
+
+  const index_type num_survivors = thrust::system::detail::internal::compaction_tile_offsets(tiles, num_tiles);
+
+  // close the gaps between tiles
+  thrust::system::omp::detail::move_compacted_tiles(exec, tiles, num_tiles, first);
+
+  return first + num_survivors;
 }
 
 
@@ -52,8 +102,50 @@ template<typename DerivedPolicy,
                             InputIterator stencil,
                             Predicate pred)
 {
-  // omp prefers generic::remove_if to cpp::remove_if
-  return thrust::system::detail::generic::remove_if(exec, first, last, stencil, pred);
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<ForwardIterator,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef thrust::detail::intptr_t index_type;
+  typedef thrust::system::detail::internal::compaction_tile<index_type> tile_type;
+
+  const index_type n = thrust::distance(first, last);
+
+  thrust::system::detail::internal::uniform_decomposition<index_type> decomp = thrust::system::omp::detail::default_decomposition(exec, n);
+
+  if(decomp.size() <= 1)
+  {
+    return thrust::remove_if(thrust::seq, first, last, stencil, pred);
+  }
+
+  const index_type num_tiles = static_cast<index_type>(decomp.size());
+
+  thrust::detail::temporary_array<tile_type,DerivedPolicy> tile_storage(exec, num_tiles);
+  tile_type *tiles = thrust::raw_pointer_cast(tile_storage.data());
+
+  // compact every tile in place
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    const index_type begin = decomp[i].begin();
+    const index_type end   = decomp[i].end();
+
+    tiles[i].survivors_begin = begin;
+    tiles[i].num_survivors   = thrust::remove_if(thrust::seq, first + begin, first + end, stencil + begin, pred) - (first + begin);
+  }
+
+  const index_type num_survivors = thrust::system::detail::internal::compaction_tile_offsets(tiles, num_tiles);
+
+  // close the gaps between tiles
+  thrust::system::omp::detail::move_compacted_tiles(exec, tiles, num_tiles, first);
+
+  return first + num_survivors;
 }
 
 
@@ -0,0 +1,228 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <thrust/detail/config.h>
+#include <thrust/system/omp/detail/scan.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
+#include <thrust/system/omp/detail/reduce_intervals.h>
+#include <thrust/scan.h>
+#include <thrust/distance.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/function.h>
+#include <thrust/detail/cstdint.h>
+#include <thrust/detail/temporary_array.h>
+#include <thrust/detail/type_traits.h>
+#include <thrust/detail/type_traits/function_traits.h>
+#include <thrust/detail/type_traits/iterator/is_output_iterator.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+namespace scan_detail
+{
+
+
+// the pseudocode for deducing the type of the temporary used below:
+//
+// if BinaryFunction is AdaptableBinaryFunction
+//   TemporaryType = AdaptableBinaryFunction::result_type
+// else if OutputIterator is a "pure" output iterator
+//   TemporaryType = InputIterator::value_type
+// else
+//   TemporaryType = OutputIterator::value_type
+//
+// this matches the deduction performed by the sequential scan
+template<typename InputIterator,
+         typename OutputIterator,
+         typename BinaryFunction>
+  struct scan_value_type
+    : thrust::detail::eval_if<
+        thrust::detail::has_result_type<BinaryFunction>::value,
+        thrust::detail::result_type<BinaryFunction>,
+        thrust::detail::eval_if<
+          thrust::detail::is_output_iterator<OutputIterator>::value,
+          thrust::iterator_value<InputIterator>,
+          thrust::iterator_value<OutputIterator>
+        >
+      >
+{};
+
+
+} // end namespace scan_detail
+
+
+template<typename DerivedPolicy,
+         typename InputIterator,
+         typename OutputIterator,
+         typename BinaryFunction>
+  OutputIterator inclusive_scan(execution_policy<DerivedPolicy> &exec,
+                                InputIterator first,
+                                InputIterator last,
+                                OutputIterator result,
+                                BinaryFunction binary_op)
+{
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<InputIterator,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef typename scan_detail::scan_value_type<
+    InputIterator,
+    OutputIterator,
+    BinaryFunction
+  >::type ValueType;
+
+  typedef typename thrust::iterator_difference<InputIterator>::type difference_type;
+
+  const difference_type n = thrust::distance(first, last);
+
+  thrust::system::detail::internal::uniform_decomposition<difference_type> decomp = thrust::system::omp::detail::default_decomposition(exec, n);
+
+  // a single interval gains nothing from the extra reduction pass
+  if(decomp.size() <= 1)
+  {
+    return thrust::inclusive_scan(thrust::seq, first, last, result, binary_op);
+  }
+
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+  // reduce each interval independently (upsweep)
+  thrust::detail::temporary_array<ValueType,DerivedPolicy> sums(exec, decomp.size());
+  thrust::system::omp::detail::reduce_intervals(exec, first, sums.begin(), binary_op, decomp);
+
+  // scan the interval sums to find the carry into each interval; there are
+  // only as many intervals as processors, so do this sequentially
+  thrust::inclusive_scan(thrust::seq, sums.begin(), sums.end(), sums.begin(), binary_op);
+
+  // wrap binary_op
+  thrust::detail::wrapped_function<BinaryFunction,ValueType> wrapped_binary_op(binary_op);
+
+  typedef thrust::detail::intptr_t index_type;
+
+  const index_type num_intervals = static_cast<index_type>(decomp.size());
+  const ValueType *carries = thrust::raw_pointer_cast(sums.data());
+
+  // rescan each interval seeded with its carry (downsweep)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  for(index_type i = 0; i < num_intervals; ++i)
+  {
+    InputIterator  begin = first  + decomp[i].begin();
+    InputIterator  end   = first  + decomp[i].end();
+    OutputIterator out   = result + decomp[i].begin();
+
+    if(i == 0)
+    {
+      thrust::inclusive_scan(thrust::seq, begin, end, out, binary_op);
+    }
+    else
+    {
+      ValueType sum = carries[i - 1];
+
+      for(; begin != end; ++begin, ++out)
+      {
+        *out = sum = wrapped_binary_op(sum, *begin);
+      }
+    }
+  }
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+
+  return result + n;
+} // end inclusive_scan()
+
+
+template<typename DerivedPolicy,
+         typename InputIterator,
+         typename OutputIterator,
+         typename T,
+         typename BinaryFunction>
+  OutputIterator exclusive_scan(execution_policy<DerivedPolicy> &exec,
+                                InputIterator first,
+                                InputIterator last,
+                                OutputIterator result,
+                                T init,
+                                BinaryFunction binary_op)
+{
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<InputIterator,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef typename scan_detail::scan_value_type<
+    InputIterator,
+    OutputIterator,
+    BinaryFunction
+  >::type ValueType;
+
+  typedef typename thrust::iterator_difference<InputIterator>::type difference_type;
+
+  const difference_type n = thrust::distance(first, last);
+
+  thrust::system::detail::internal::uniform_decomposition<difference_type> decomp = thrust::system::omp::detail::default_decomposition(exec, n);
+
+  // a single interval gains nothing from the extra reduction pass
+  if(decomp.size() <= 1)
+  {
+    return thrust::exclusive_scan(thrust::seq, first, last, result, init, binary_op);
+  }
+
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+  // reduce each interval independently (upsweep)
+  thrust::detail::temporary_array<ValueType,DerivedPolicy> sums(exec, decomp.size());
+  thrust::system::omp::detail::reduce_intervals(exec, first, sums.begin(), binary_op, decomp);
+
+  // scan the interval sums to find the carry into each interval; there are
+  // only as many intervals as processors, so do this sequentially
+  thrust::exclusive_scan(thrust::seq, sums.begin(), sums.end(), sums.begin(), ValueType(init), binary_op);
+
+  typedef thrust::detail::intptr_t index_type;
+
+  const index_type num_intervals = static_cast<index_type>(decomp.size());
+  const ValueType *carries = thrust::raw_pointer_cast(sums.data());
+
+  // rescan each interval seeded with its carry (downsweep)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  for(index_type i = 0; i < num_intervals; ++i)
+  {
+    thrust::exclusive_scan(thrust::seq,
+                           first  + decomp[i].begin(),
+                           first  + decomp[i].end(),
+                           result + decomp[i].begin(),
+                           carries[i],
+                           binary_op);
+  }
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+
+  return result + n;
+} // end exclusive_scan()
+
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace thrust
+
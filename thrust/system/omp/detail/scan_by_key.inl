@@ -0,0 +1,182 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <thrust/detail/config.h>
+#include <thrust/system/omp/detail/scan_by_key.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
+#include <thrust/system/detail/internal/scan_by_key_tiles.h>
+#include <thrust/scan.h>
+#include <thrust/distance.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/function.h>
+#include <thrust/detail/cstdint.h>
+#include <thrust/detail/temporary_array.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+
+
+template<typename DerivedPolicy,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator,
+         typename BinaryPredicate,
+         typename BinaryFunction>
+  OutputIterator inclusive_scan_by_key(execution_policy<DerivedPolicy> &exec,
+                                       InputIterator1 first1,
+                                       InputIterator1 last1,
+                                       InputIterator2 first2,
+                                       OutputIterator result,
+                                       BinaryPredicate binary_pred,
+                                       BinaryFunction binary_op)
+{
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<InputIterator1,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef typename thrust::iterator_difference<InputIterator1>::type difference_type;
+  typedef typename thrust::iterator_traits<OutputIterator>::value_type ValueType;
+  typedef thrust::system::detail::internal::scan_by_key_tile<difference_type,ValueType> tile_type;
+
+  const difference_type n = thrust::distance(first1, last1);
+
+  thrust::system::detail::internal::uniform_decomposition<difference_type> decomp = thrust::system::omp::detail::default_decomposition(exec, n);
+
+  // a single tile gains nothing from the extra reduction pass
+  if(decomp.size() <= 1)
+  {
+    return thrust::inclusive_scan_by_key(thrust::seq, first1, last1, first2, result, binary_pred, binary_op);
+  }
+
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+  // wrap binary_op
+  thrust::detail::wrapped_function<BinaryFunction,ValueType> wrapped_binary_op(binary_op);
+
+  typedef thrust::detail::intptr_t index_type;
+
+  const index_type num_tiles = static_cast<index_type>(decomp.size());
+
+  thrust::detail::temporary_array<tile_type,DerivedPolicy> tile_storage(exec, num_tiles);
+  tile_type *tiles = thrust::raw_pointer_cast(tile_storage.data());
+
+  // reduce the last segment of each tile (upsweep)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    thrust::system::detail::internal::scan_by_key_tile_upsweep(tiles[i], first1, first2, decomp[i].begin(), decomp[i].end(), binary_pred, wrapped_binary_op);
+  }
+
+  thrust::system::detail::internal::scan_by_key_tile_carries(tiles, num_tiles, wrapped_binary_op);
+
+  // scan each tile seeded with its carry (downsweep)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    thrust::system::detail::internal::inclusive_scan_by_key_tile_downsweep(tiles[i], first1, first2, result, decomp[i].begin(), decomp[i].end(), binary_pred, wrapped_binary_op);
+  }
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+
+  return result + n;
+} // end inclusive_scan_by_key()
+
+
+template<typename DerivedPolicy,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator,
+         typename T,
+         typename BinaryPredicate,
+         typename BinaryFunction>
+  OutputIterator exclusive_scan_by_key(execution_policy<DerivedPolicy> &exec,
+                                       InputIterator1 first1,
+                                       InputIterator1 last1,
+                                       InputIterator2 first2,
+                                       OutputIterator result,
+                                       T init,
+                                       BinaryPredicate binary_pred,
+                                       BinaryFunction binary_op)
+{
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<InputIterator1,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef typename thrust::iterator_difference<InputIterator1>::type difference_type;
+  typedef typename thrust::iterator_traits<OutputIterator>::value_type ValueType;
+  typedef thrust::system::detail::internal::scan_by_key_tile<difference_type,ValueType> tile_type;
+
+  const difference_type n = thrust::distance(first1, last1);
+
+  thrust::system::detail::internal::uniform_decomposition<difference_type> decomp = thrust::system::omp::detail::default_decomposition(exec, n);
+
+  // a single tile gains nothing from the extra reduction pass
+  if(decomp.size() <= 1)
+  {
+    return thrust::exclusive_scan_by_key(thrust::seq, first1, last1, first2, result, init, binary_pred, binary_op);
+  }
+
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+  // wrap binary_op
+  thrust::detail::wrapped_function<BinaryFunction,ValueType> wrapped_binary_op(binary_op);
+
+  typedef thrust::detail::intptr_t index_type;
+
+  const index_type num_tiles = static_cast<index_type>(decomp.size());
+
+  thrust::detail::temporary_array<tile_type,DerivedPolicy> tile_storage(exec, num_tiles);
+  tile_type *tiles = thrust::raw_pointer_cast(tile_storage.data());
+
+  // reduce the last segment of each tile (upsweep)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    thrust::system::detail::internal::scan_by_key_tile_upsweep(tiles[i], first1, first2, decomp[i].begin(), decomp[i].end(), binary_pred, wrapped_binary_op);
+  }
+
+  thrust::system::detail::internal::scan_by_key_tile_carries(tiles, num_tiles, wrapped_binary_op);
+
+  // scan each tile seeded with its carry (downsweep)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    thrust::system::detail::internal::exclusive_scan_by_key_tile_downsweep(tiles[i], first1, first2, result, decomp[i].begin(), decomp[i].end(), init, binary_pred, wrapped_binary_op);
+  }
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+
+  return result + n;
+} // end exclusive_scan_by_key()
+
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace thrust
+
@@ -24,9 +24,16 @@
 
 #include <thrust/iterator/iterator_traits.h>
 #include <thrust/system/detail/generic/select_system.h>
+#include <thrust/system/detail/internal/merge_path.h>
+#include <thrust/system/detail/internal/radix_sort_tiles.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
 #include <thrust/sort.h>
 #include <thrust/merge.h>
+#include <thrust/copy.h>
+#include <thrust/reverse.h>
 #include <thrust/detail/seq.h>
+#include <thrust/detail/minmax.h>
+#include <thrust/detail/cstdint.h>
 #include <thrust/detail/temporary_array.h>
 
 namespace thrust
@@ -41,21 +48,241 @@ namespace sort_detail
 {
 
 
+// In the round of merges which combines runs of width tiles pairwise, find
+// the subranges of the pair of runs covering tile i whose merge lands on
+// tile i of the output. Every tile of the output is produced independently.
+template<typename RandomAccessIterator,
+         typename Decomposition,
+         typename StrictWeakOrdering>
+void merge_path_partition(RandomAccessIterator keys,
+                          const Decomposition &decomp,
+                          typename Decomposition::index_type i,
+                          typename Decomposition::index_type width,
+                          StrictWeakOrdering comp,
+                          typename Decomposition::index_type &first1,
+                          typename Decomposition::index_type &last1,
+                          typename Decomposition::index_type &first2,
+                          typename Decomposition::index_type &last2)
+{
+  typedef typename Decomposition::index_type IndexType;
+
+  const IndexType nseg = decomp.size();
+
+  const IndexType pair_first = (i / (2 * width)) * (2 * width);
+  const IndexType pair_mid   = thrust::min<IndexType>(pair_first + width,     nseg);
+  const IndexType pair_last  = thrust::min<IndexType>(pair_first + 2 * width, nseg);
+
+  const IndexType begin = decomp[pair_first].begin();
+  const IndexType end   = decomp[pair_last - 1].end();
+  const IndexType mid   = (pair_mid < nseg) ? decomp[pair_mid].begin() : end;
+
+  // the diagonals of this pair's merge which bound tile i
+  const IndexType diag0 = decomp[i].begin() - begin;
+  const IndexType diag1 = decomp[i].end()   - begin;
+
+  const IndexType split0 = thrust::system::detail::internal::merge_path(keys + begin, mid - begin, keys + mid, end - mid, diag0, comp);
+  const IndexType split1 = thrust::system::detail::internal::merge_path(keys + begin, mid - begin, keys + mid, end - mid, diag1, comp);
+
+  first1 = begin + split0;
+  last1  = begin + split1;
+  first2 = mid + (diag0 - split0);
+  last2  = mid + (diag1 - split1);
+}
+
+
+template<typename RandomAccessIterator1,
+         typename RandomAccessIterator2,
+         typename Decomposition,
+         typename StrictWeakOrdering>
+void merge_tile(RandomAccessIterator1 src,
+                RandomAccessIterator2 dst,
+                const Decomposition &decomp,
+                typename Decomposition::index_type i,
+                typename Decomposition::index_type width,
+                StrictWeakOrdering comp)
+{
+  typedef typename Decomposition::index_type IndexType;
+
+  IndexType first1, last1, first2, last2;
+  sort_detail::merge_path_partition(src, decomp, i, width, comp, first1, last1, first2, last2);
+
+  thrust::merge(thrust::seq,
+                src + first1, src + last1,
+                src + first2, src + last2,
+                dst + decomp[i].begin(),
+                comp);
+}
+
+
+template<typename RandomAccessIterator1,
+         typename RandomAccessIterator2,
+         typename RandomAccessIterator3,
+         typename RandomAccessIterator4,
+         typename Decomposition,
+         typename StrictWeakOrdering>
+void merge_tile_by_key(RandomAccessIterator1 keys_src,
+                       RandomAccessIterator2 values_src,
+                       RandomAccessIterator3 keys_dst,
+                       RandomAccessIterator4 values_dst,
+                       const Decomposition &decomp,
+                       typename Decomposition::index_type i,
+                       typename Decomposition::index_type width,
+                       StrictWeakOrdering comp)
+{
+  typedef typename Decomposition::index_type IndexType;
+
+  IndexType first1, last1, first2, last2;
+  sort_detail::merge_path_partition(keys_src, decomp, i, width, comp, first1, last1, first2, last2);
+
+  thrust::merge_by_key(thrust::seq,
+                       keys_src + first1, keys_src + last1,
+                       keys_src + first2, keys_src + last2,
+                       values_src + first1, values_src + first2,
+                       keys_dst + decomp[i].begin(), values_dst + decomp[i].begin(),
+                       comp);
+}
+
+
+// returns false if every key falls in the same bucket and nothing was moved
+template<bool HasValues,
+         typename DerivedPolicy,
+         typename RandomAccessIterator1,
+         typename RandomAccessIterator2,
+         typename RandomAccessIterator3,
+         typename RandomAccessIterator4,
+         typename Decomposition>
+bool radix_sort_pass(execution_policy<DerivedPolicy> &exec,
+                     RandomAccessIterator1 keys_first,
+                     RandomAccessIterator2 values_first,
+                     RandomAccessIterator3 keys_result,
+                     RandomAccessIterator4 values_result,
+                     Decomposition decomp,
+                     unsigned int pass,
+                     size_t *histograms)
+{
+  typedef typename thrust::iterator_value<RandomAccessIterator1>::type KeyType;
+  typedef thrust::system::detail::internal::radix_sort_traits<KeyType> traits;
+  typedef thrust::detail::intptr_t index_type;
+
+  const index_type num_tiles = static_cast<index_type>(decomp.size());
+  const size_t n = decomp[num_tiles - 1].end();
+
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+  // every tile counts its keys per bucket
+  #pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    thrust::system::detail::internal::radix_sort_tile_histogram(keys_first,
+                                                                decomp[i].begin(),
+                                                                decomp[i].end(),
+                                                                pass,
+                                                                histograms + i * traits::histogram_size);
+  }
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+
+  if(!thrust::system::detail::internal::radix_sort_tile_offsets<KeyType>(histograms, num_tiles, n))
+  {
+    return false;
+  }
+
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+  // every tile scatters its keys to their global positions
+  #pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    thrust::system::detail::internal::radix_sort_tile_scatter<HasValues>(keys_first,
+                                                                         values_first,
+                                                                         decomp[i].begin(),
+                                                                         decomp[i].end(),
+                                                                         keys_result,
+                                                                         values_result,
+                                                                         pass,
+                                                                         histograms + i * traits::histogram_size);
+  }
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+
+  return true;
+}
+
+
+template<bool HasValues,
+         typename DerivedPolicy,
+         typename RandomAccessIterator1,
+         typename RandomAccessIterator2,
+         typename RandomAccessIterator3,
+         typename RandomAccessIterator4,
+         typename Decomposition>
+void radix_sort(execution_policy<DerivedPolicy> &exec,
+                RandomAccessIterator1 keys1,
+                RandomAccessIterator2 keys2,
+                RandomAccessIterator3 vals1,
+                RandomAccessIterator4 vals2,
+                Decomposition decomp)
+{
+  typedef typename thrust::iterator_value<RandomAccessIterator1>::type KeyType;
+  typedef thrust::system::detail::internal::radix_sort_traits<KeyType> traits;
+
+  const typename Decomposition::index_type n = decomp[decomp.size() - 1].end();
+
+  thrust::detail::temporary_array<size_t,DerivedPolicy> histograms(exec, decomp.size() * traits::histogram_size);
+
+  // false if most recent data is stored in (keys1,vals1)
+  bool flip = false;
+
+  for(unsigned int pass = 0; pass < traits::num_passes; ++pass)
+  {
+    bool moved = flip ?
+      radix_sort_pass<HasValues>(exec, keys2, vals2, keys1, vals1, decomp, pass, thrust::raw_pointer_cast(histograms.data())) :
+      radix_sort_pass<HasValues>(exec, keys1, vals1, keys2, vals2, decomp, pass, thrust::raw_pointer_cast(histograms.data()));
+
+    if(moved)
+    {
+      flip = !flip;
+    }
+  }
+
+  // ensure final values are in (keys1,vals1)
+  if(flip)
+  {
+    thrust::copy(exec, keys2, keys2 + n, keys1);
+
+    if(HasValues)
+    {
+      thrust::copy(exec, vals2, vals2 + n, vals1);
+    }
+  }
+}
+
+
 template<typename DerivedPolicy,
          typename RandomAccessIterator,
          typename StrictWeakOrdering>
-void inplace_merge(execution_policy<DerivedPolicy> &exec,
-                   RandomAccessIterator first,
-                   RandomAccessIterator middle,
-                   RandomAccessIterator last,
-                   StrictWeakOrdering comp)
+void stable_sort(execution_policy<DerivedPolicy> &exec,
+                 RandomAccessIterator first,
+                 RandomAccessIterator last,
+                 StrictWeakOrdering comp,
+                 thrust::detail::true_type)
 {
-  typedef typename thrust::iterator_value<RandomAccessIterator>::type value_type;
+  typedef typename thrust::iterator_value<RandomAccessIterator>::type KeyType;
+  typedef typename thrust::iterator_difference<RandomAccessIterator>::type IndexType;
+
+  thrust::system::detail::internal::uniform_decomposition<IndexType> decomp = thrust::system::omp::detail::default_decomposition(exec, static_cast<IndexType>(last - first));
+
+  if(decomp.size() <= 1)
+  {
+    thrust::stable_sort(thrust::seq, first, last, comp);
+    return;
+  }
+
+  thrust::detail::temporary_array<KeyType,DerivedPolicy> temp(exec, last - first);
 
-  thrust::detail::temporary_array<value_type,DerivedPolicy> a(exec, first, middle);
-  thrust::detail::temporary_array<value_type,DerivedPolicy> b(exec, middle, last);
+  sort_detail::radix_sort<false>(exec, first, temp.begin(), static_cast<int *>(0), static_cast<int *>(0), decomp);
 
-  thrust::merge(thrust::seq, a.begin(), a.end(), b.begin(), b.end(), first, comp);
+  // if comp is greater<T> then reverse the keys
+  if(thrust::system::detail::internal::radix_sort_needs_reverse<KeyType,StrictWeakOrdering>::value)
+  {
+    thrust::reverse(exec, first, last);
+  }
 }
 
 
@@ -63,34 +290,48 @@ template<typename DerivedPolicy,
          typename RandomAccessIterator1,
          typename RandomAccessIterator2,
          typename StrictWeakOrdering>
-void inplace_merge_by_key(execution_policy<DerivedPolicy> &exec,
-                          RandomAccessIterator1 first1,
-                          RandomAccessIterator1 middle1,
-                          RandomAccessIterator1 last1,
-                          RandomAccessIterator2 first2,
-                          StrictWeakOrdering comp)
+void stable_sort_by_key(execution_policy<DerivedPolicy> &exec,
+                        RandomAccessIterator1 keys_first,
+                        RandomAccessIterator1 keys_last,
+                        RandomAccessIterator2 values_first,
+                        StrictWeakOrdering comp,
+                        thrust::detail::true_type)
 {
-  typedef typename thrust::iterator_value<RandomAccessIterator1>::type value_type1;
-  typedef typename thrust::iterator_value<RandomAccessIterator2>::type value_type2;
+  typedef typename thrust::iterator_value<RandomAccessIterator1>::type KeyType;
+  typedef typename thrust::iterator_value<RandomAccessIterator2>::type ValueType;
+  typedef typename thrust::iterator_difference<RandomAccessIterator1>::type IndexType;
 
-  RandomAccessIterator2 middle2 = first2 + (middle1 - first1);
-  RandomAccessIterator2 last2   = first2 + (last1   - first1);
+  const IndexType n = keys_last - keys_first;
 
-  thrust::detail::temporary_array<value_type1,DerivedPolicy> lhs1(exec, first1, middle1);
-  thrust::detail::temporary_array<value_type1,DerivedPolicy> rhs1(exec, middle1, last1);
-  thrust::detail::temporary_array<value_type2,DerivedPolicy> lhs2(exec, first2, middle2);
-  thrust::detail::temporary_array<value_type2,DerivedPolicy> rhs2(exec, middle2, last2);
+  thrust::system::detail::internal::uniform_decomposition<IndexType> decomp = thrust::system::omp::detail::default_decomposition(exec, n);
 
-  thrust::merge_by_key(thrust::seq,
-                       lhs1.begin(), lhs1.end(),
-                       rhs1.begin(), rhs1.end(),
-                       lhs2.begin(), rhs2.begin(),
-                       first1, first2,
-                       comp);
-}
+  if(decomp.size() <= 1)
+  {
+    thrust::stable_sort_by_key(thrust::seq, keys_first, keys_last, values_first, comp);
+    return;
+  }
 
+  const bool needs_reverse = thrust::system::detail::internal::radix_sort_needs_reverse<KeyType,StrictWeakOrdering>::value;
 
-} // end sort_detail
+  // if comp is greater<T> then reverse the keys and values
+  // note, we also have to reverse the (unordered) input to preserve stability
+  if(needs_reverse)
+  {
+    thrust::reverse(exec, keys_first, keys_last);
+    thrust::reverse(exec, values_first, values_first + n);
+  }
+
+  thrust::detail::temporary_array<KeyType,DerivedPolicy>   temp1(exec, n);
+  thrust::detail::temporary_array<ValueType,DerivedPolicy> temp2(exec, n);
+
+  sort_detail::radix_sort<true>(exec, keys_first, temp1.begin(), values_first, temp2.begin(), decomp);
+
+  if(needs_reverse)
+  {
+    thrust::reverse(exec, keys_first, keys_last);
+    thrust::reverse(exec, values_first, values_first + n);
+  }
+}
 
 
 template<typename DerivedPolicy,
@@ -99,7 +340,8 @@ template<typename DerivedPolicy,
 void stable_sort(execution_policy<DerivedPolicy> &exec,
                  RandomAccessIterator first,
                  RandomAccessIterator last,
-                 StrictWeakOrdering comp)
+                 StrictWeakOrdering comp,
+                 thrust::detail::false_type)
 {
   // we're attempting to launch an omp kernel, assert we're compiling with omp support
   // ========================================================================
@@ -115,7 +357,20 @@ void stable_sort(execution_policy<DerivedPolicy> &exec,
   if(first == last)
     return;
 
-  #pragma omp parallel
+  // don't bother forking threads for less than a single interval of work
+  if(thrust::system::omp::detail::default_decomposition(exec, static_cast<IndexType>(last - first)).size() <= 1)
+  {
+    thrust::stable_sort(thrust::seq, first, last, comp);
+    return;
+  }
+
+  typedef typename thrust::iterator_value<RandomAccessIterator>::type value_type;
+
+  // a single buffer to ping-pong between in every round of merges
+  thrust::detail::temporary_array<value_type,DerivedPolicy> temp(exec, last - first);
+  value_type *buffer = thrust::raw_pointer_cast(temp.data());
+
+  #pragma omp parallel num_threads(thrust::system::omp::detail::default_num_threads(exec))
   {
     thrust::system::detail::internal::uniform_decomposition<IndexType> decomp(last - first, 1, omp_get_num_threads());
 
@@ -136,34 +391,38 @@ void stable_sort(execution_policy<DerivedPolicy> &exec,
     // XXX For some reason, MSVC 2015 yields an error unless we include this meaningless semicolon here
     ;
 
-    IndexType nseg = decomp.size();
-    IndexType h = 2;
-
-    // keep track of which sub-range we're processing
-    IndexType a=p_i, b=p_i, c=p_i+1;
+    // false if most recent data is stored in [first, last)
+    bool flip = false;
 
-    while(nseg>1)
+    // every round merges pairs of sorted runs of width tiles, and every
+    // thread produces the slice of the output at its own tile's position
+    for(IndexType width = 1; width < decomp.size(); width *= 2)
     {
-      if(c >= decomp.size())
-        c = decomp.size() - 1;
-
-      if((p_i % h) == 0 && c > b)
+      if(p_i < decomp.size())
       {
-        sort_detail::inplace_merge(exec,
-                                   first + decomp[a].begin(),
-                                   first + decomp[b].end(),
-                                   first + decomp[c].end(),
-                                   comp);
-
-        b = c;
-        c += h;
+        if(flip)
+        {
+          sort_detail::merge_tile(buffer, first, decomp, p_i, width, comp);
+        }
+        else
+        {
+          sort_detail::merge_tile(first, buffer, decomp, p_i, width, comp);
+        }
       }
 
-      nseg = (nseg + 1) / 2;
-      h *= 2;
+      flip = !flip;
 
       #pragma omp barrier
     }
+
+    // ensure final values are in [first, last)
+    if(flip && p_i < decomp.size())
+    {
+      thrust::copy(thrust::seq,
+                   buffer + decomp[p_i].begin(),
+                   buffer + decomp[p_i].end(),
+                   first  + decomp[p_i].begin());
+    }
   }
 #endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
 }
@@ -177,7 +436,8 @@ void stable_sort_by_key(execution_policy<DerivedPolicy> &exec,
                         RandomAccessIterator1 keys_first,
                         RandomAccessIterator1 keys_last,
                         RandomAccessIterator2 values_first,
-                        StrictWeakOrdering comp)
+                        StrictWeakOrdering comp,
+                        thrust::detail::false_type)
 {
   // we're attempting to launch an omp kernel, assert we're compiling with omp support
   // ========================================================================
@@ -193,7 +453,23 @@ void stable_sort_by_key(execution_policy<DerivedPolicy> &exec,
   if(keys_first == keys_last)
     return;
 
-  #pragma omp parallel
+  // don't bother forking threads for less than a single interval of work
+  if(thrust::system::omp::detail::default_decomposition(exec, static_cast<IndexType>(keys_last - keys_first)).size() <= 1)
+  {
+    thrust::stable_sort_by_key(thrust::seq, keys_first, keys_last, values_first, comp);
+    return;
+  }
+
+  typedef typename thrust::iterator_value<RandomAccessIterator1>::type key_type;
+  typedef typename thrust::iterator_value<RandomAccessIterator2>::type value_type;
+
+  // a single pair of buffers to ping-pong between in every round of merges
+  thrust::detail::temporary_array<key_type,DerivedPolicy>   temp1(exec, keys_last - keys_first);
+  thrust::detail::temporary_array<value_type,DerivedPolicy> temp2(exec, keys_last - keys_first);
+  key_type   *keys_buffer   = thrust::raw_pointer_cast(temp1.data());
+  value_type *values_buffer = thrust::raw_pointer_cast(temp2.data());
+
+  #pragma omp parallel num_threads(thrust::system::omp::detail::default_num_threads(exec))
   {
     thrust::system::detail::internal::uniform_decomposition<IndexType> decomp(keys_last - keys_first, 1, omp_get_num_threads());
 
@@ -215,40 +491,87 @@ void stable_sort_by_key(execution_policy<DerivedPolicy> &exec,
     // XXX For some reason, MSVC 2015 yields an error unless we include this meaningless semicolon here
     ;
 
-    IndexType nseg = decomp.size();
-    IndexType h = 2;
-
-    // keep track of which sub-range we're processing
-    IndexType a=p_i, b=p_i, c=p_i+1;
+    // false if most recent data is stored in [keys_first, keys_last)
+    bool flip = false;
 
-    while(nseg>1)
+    // every round merges pairs of sorted runs of width tiles, and every
+    // thread produces the slice of the output at its own tile's position
+    for(IndexType width = 1; width < decomp.size(); width *= 2)
     {
-      if(c >= decomp.size())
-        c = decomp.size() - 1;
-
-      if((p_i % h) == 0 && c > b)
+      if(p_i < decomp.size())
       {
-        sort_detail::inplace_merge_by_key(exec,
-                                          keys_first + decomp[a].begin(),
-                                          keys_first + decomp[b].end(),
-                                          keys_first + decomp[c].end(),
-                                          values_first + decomp[a].begin(),
-                                          comp);
-
-        b = c;
-        c += h;
+        if(flip)
+        {
+          sort_detail::merge_tile_by_key(keys_buffer, values_buffer, keys_first, values_first, decomp, p_i, width, comp);
+        }
+        else
+        {
+          sort_detail::merge_tile_by_key(keys_first, values_first, keys_buffer, values_buffer, decomp, p_i, width, comp);
+        }
       }
 
-      nseg = (nseg + 1) / 2;
-      h *= 2;
+      flip = !flip;
 
       #pragma omp barrier
     }
+
+    // ensure final values are in [keys_first, keys_last)
+    if(flip && p_i < decomp.size())
+    {
+      thrust::copy(thrust::seq,
+                   keys_buffer + decomp[p_i].begin(),
+                   keys_buffer + decomp[p_i].end(),
+                   keys_first  + decomp[p_i].begin());
+
+      thrust::copy(thrust::seq,
+                   values_buffer + decomp[p_i].begin(),
+                   values_buffer + decomp[p_i].end(),
+                   values_first  + decomp[p_i].begin());
+    }
   }
 #endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
 }
 
 
+} // end sort_detail
+
+
+template<typename DerivedPolicy,
+         typename RandomAccessIterator,
+         typename StrictWeakOrdering>
+void stable_sort(execution_policy<DerivedPolicy> &exec,
+                 RandomAccessIterator first,
+                 RandomAccessIterator last,
+                 StrictWeakOrdering comp)
+{
+  typedef typename thrust::iterator_value<RandomAccessIterator>::type KeyType;
+
+  // use a parallel radix sort for primitive keys compared with less or greater
+  thrust::system::detail::internal::use_parallel_radix_sort<KeyType,StrictWeakOrdering> use_radix_sort;
+
+  sort_detail::stable_sort(exec, first, last, comp, use_radix_sort);
+}
+
+
+template<typename DerivedPolicy,
+         typename RandomAccessIterator1,
+         typename RandomAccessIterator2,
+         typename StrictWeakOrdering>
+void stable_sort_by_key(execution_policy<DerivedPolicy> &exec,
+                        RandomAccessIterator1 keys_first,
+                        RandomAccessIterator1 keys_last,
+                        RandomAccessIterator2 values_first,
+                        StrictWeakOrdering comp)
+{
+  typedef typename thrust::iterator_value<RandomAccessIterator1>::type KeyType;
+
+  // use a parallel radix sort for primitive keys compared with less or greater
+  thrust::system::detail::internal::use_parallel_radix_sort<KeyType,StrictWeakOrdering> use_radix_sort;
+
+  sort_detail::stable_sort_by_key(exec, keys_first, keys_last, values_first, comp, use_radix_sort);
+}
+
+
 } // end namespace detail
 } // end namespace omp
 } // end namespace system
@@ -19,6 +19,14 @@
 #include <thrust/detail/config.h>
 #include <thrust/system/omp/detail/unique.h>
 #include <thrust/system/detail/generic/unique.h>
+#include <thrust/system/omp/detail/compaction.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
+#include <thrust/system/detail/internal/compaction_tiles.h>
+#include <thrust/distance.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/cstdint.h>
+#include <thrust/detail/temporary_array.h>
+#include <thrust/unique.h>
 #include <thrust/pair.h>
 
 namespace thrust
@@ -39,8 +47,57 @@ template<typename DerivedPolicy,
                          ForwardIterator last,
                          BinaryPredicate binary_pred)
 {
-  // omp prefers generic::unique to cpp::unique
-  return thrust::system::detail::generic::unique(exec,first,last,binary_pred);
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<ForwardIterator,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef thrust::detail::intptr_t index_type;
+  typedef thrust::system::detail::internal::compaction_tile<index_type> tile_type;
+
+  const index_type n = thrust::distance(first, last);
+
+  thrust::system::detail::internal::uniform_decomposition<index_type> decomp = thrust::system::omp::detail::default_decomposition(exec, n);
+
+  if(decomp.size() <= 1)
+  {
+    return thrust::unique(thrust::seq, first, last, binary_pred);
+  }
+
+  const index_type num_tiles = static_cast<index_type>(decomp.size());
+
+  thrust::detail::temporary_array<tile_type,DerivedPolicy> tile_storage(exec, num_tiles);
+  tile_type *tiles = thrust::raw_pointer_cast(tile_storage.data());
+
+  // a tile whose first element continues the previous tile's last group drops
+  // it; decide this before any tile is compacted
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    const index_type begin = decomp[i].begin();
+
+    tiles[i].survivors_begin = (i > 0 && binary_pred(first[begin - 1], first[begin])) ? begin + 1 : begin;
+  }
+
+  // compact every tile in place
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    ForwardIterator tile_end = thrust::unique(thrust::seq, first + decomp[i].begin(), first + decomp[i].end(), binary_pred);
+
+    tiles[i].num_survivors = tile_end - (first + tiles[i].survivors_begin);
+  }
+
+  const index_type num_survivors = thrust::system::detail::internal::compaction_tile_offsets(tiles, num_tiles);
+
+  // close the gaps between tiles
+  thrust::system::omp::detail::move_compacted_tiles(exec, tiles, num_tiles, first);
+
+  return first + num_survivors;
 } // end unique()
 
 
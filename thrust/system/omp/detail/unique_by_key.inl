@@ -19,6 +19,15 @@
 #include <thrust/detail/config.h>
 #include <thrust/system/omp/detail/unique_by_key.h>
 #include <thrust/system/detail/generic/unique_by_key.h>
+#include <thrust/system/omp/detail/compaction.h>
+#include <thrust/system/omp/detail/default_decomposition.h>
+#include <thrust/system/detail/internal/compaction_tiles.h>
+#include <thrust/iterator/zip_iterator.h>
+#include <thrust/distance.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/cstdint.h>
+#include <thrust/detail/temporary_array.h>
+#include <thrust/unique.h>
 #include <thrust/pair.h>
 
 namespace thrust
@@ -42,8 +51,60 @@ template<typename DerivedPolicy,
                   ForwardIterator2 values_first,
                   BinaryPredicate binary_pred)
 {
-  // omp prefers generic::unique_by_key to cpp::unique_by_key
-  return thrust::system::detail::generic::unique_by_key(exec,keys_first,keys_last,values_first,binary_pred);
+  // we're attempting to launch an omp kernel, assert we're compiling with omp support
+  // ========================================================================
+  // X Note to the user: If you've found this line due to a compiler error, X
+  // X you need to enable OpenMP support in your compiler.                  X
+  // ========================================================================
+  THRUST_STATIC_ASSERT( (thrust::detail::depend_on_instantiation<ForwardIterator1,
+                        (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)>::value) );
+
+  typedef thrust::detail::intptr_t index_type;
+  typedef thrust::system::detail::internal::compaction_tile<index_type> tile_type;
+
+  const index_type n = thrust::distance(keys_first, keys_last);
+
+  thrust::system::detail::internal::uniform_decomposition<index_type> decomp = thrust::system::omp::detail::default_decomposition(exec, n);
+
+  if(decomp.size() <= 1)
+  {
+    return thrust::unique_by_key(thrust::seq, keys_first, keys_last, values_first, binary_pred);
+  }
+
+  const index_type num_tiles = static_cast<index_type>(decomp.size());
+
+  thrust::detail::temporary_array<tile_type,DerivedPolicy> tile_storage(exec, num_tiles);
+  tile_type *tiles = thrust::raw_pointer_cast(tile_storage.data());
+
+  // a tile whose first key continues the previous tile's last group drops
+  // it; decide this before any tile is compacted
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    const index_type begin = decomp[i].begin();
+
+    tiles[i].survivors_begin = (i > 0 && binary_pred(keys_first[begin - 1], keys_first[begin])) ? begin + 1 : begin;
+  }
+
+  // compact every tile in place
+#if (THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE == THRUST_TRUE)
+# pragma omp parallel for num_threads(thrust::system::omp::detail::default_num_threads(exec))
+#endif // THRUST_DEVICE_COMPILER_IS_OMP_CAPABLE
+  for(index_type i = 0; i < num_tiles; ++i)
+  {
+    const index_type begin = decomp[i].begin();
+    const index_type end   = decomp[i].end();
+
+    ForwardIterator1 tile_end = thrust::unique_by_key(thrust::seq, keys_first + begin, keys_first + end, values_first + begin, binary_pred).first;
+
+    tiles[i].num_survivors = tile_end - (keys_first + tiles[i].survivors_begin);
+  }
+
+  const index_type num_survivors = thrust::system::detail::internal::compaction_tile_offsets(tiles, num_tiles);
+
+  // close the gaps between tiles, moving keys and values together
+  thrust::system::omp::detail::move_compacted_tiles(exec, tiles, num_tiles, thrust::make_zip_iterator(thrust::make_tuple(keys_first, values_first)));
+
+  return thrust::make_pair(keys_first + num_survivors, values_first + num_survivors);
 } // end unique_by_key()
 
 
@@ -18,6 +18,7 @@
 
 #include <thrust/detail/config.h>
 #include <thrust/mr/new.h>
+#include <thrust/mr/mmap.h>
 #include <thrust/mr/fancy_pointer_resource.h>
 
 #include <thrust/system/omp/pointer.h>
@@ -41,6 +42,14 @@ typedef detail::native_resource memory_resource;
 typedef detail::native_resource universal_memory_resource;
 typedef detail::native_resource host_pinned_memory_resource;
 
+/*! A memory resource mapping large allocations directly from the operating system, with transparent huge pages; see
+ *      \p thrust::mr::mmap_memory_resource.
+ */
+typedef thrust::mr::fancy_pointer_resource<
+    thrust::mr::mmap_memory_resource,
+    thrust::omp::pointer<void>
+> mmap_memory_resource;
+
 }
 }
 }
@@ -0,0 +1,197 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file thrust/system/tbb/calibrate.h
+ *  \brief Measures the thresholds of \p thrust::tuning used by the TBB system
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+
+#if __cplusplus >= 201103L
+
+#include <thrust/sort.h>
+#include <thrust/reduce.h>
+#include <thrust/functional.h>
+#include <thrust/tuning.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/static_assert.h>
+#include <thrust/detail/type_traits.h>
+#include <thrust/system/tbb/execution_policy.h>
+#include <thrust/system/cpp/calibrate.h>
+#include <thrust/system/detail/internal/calibrate.h>
+#include <cstddef>
+#include <vector>
+
+namespace thrust
+{
+namespace system
+{
+namespace tbb
+{
+namespace detail
+{
+namespace calibrate_detail
+{
+
+
+// the sizes between which the crossovers are searched
+const std::size_t min_size = std::size_t(1) << 10;
+const std::size_t max_size = std::size_t(1) << 20;
+
+
+// returns the smallest of the sizes min_size, 2 * min_size, ..., max_size from which parallel_op is
+// faster than sequential_op, or 2 * max_size if it is not faster at max_size
+template<typename Generator, typename SequentialOperation, typename ParallelOperation>
+  std::size_t crossover(Generator generate, SequentialOperation sequential_op, ParallelOperation parallel_op)
+{
+  std::size_t result = 2 * max_size;
+
+  // search from the largest size down, so that an outlier at a small size does not hide the crossover
+  for(std::size_t n = max_size; n >= min_size; n /= 2)
+  {
+    const auto input = generate(n);
+
+    const double sequential_time = thrust::system::detail::internal::calibration_time(input, sequential_op);
+    const double parallel_time   = thrust::system::detail::internal::calibration_time(input, parallel_op);
+
+    if(parallel_time >= sequential_time) break;
+
+    result = n;
+  }
+
+  return result;
+}
+
+
+} // end calibrate_detail
+} // end detail
+
+
+/*! \addtogroup utility
+ *  \{
+ */
+
+/*! \p calibrate measures, on this machine, the values of the parameters of \p thrust::tuning used by the TBB system
+ *      for elements of type \p T, and sets them in the table for elements of the size of \p T.
+ *
+ *  This sets \p thrust::tuning::tbb_merge_sort_leaf_size to the power of two, between 1024 and 1048576, for which
+ *      sorting 1048576 elements with a comparison sort is fastest. It sets \p thrust::tuning::tbb_radix_sort_threshold
+ *      to the size, in the same range, from which the parallel radix sort of keys compared with \p thrust::less is
+ *      faster than the sequential sort, and \p thrust::tuning::tbb_reduce_by_key_threshold to the size from which the
+ *      parallel \p reduce_by_key is faster than the sequential one; the latter is also used by the scans by key and
+ *      the set operations. It first calls \p thrust::cpp::calibrate, whose sequential sort the TBB system uses on
+ *      small ranges. It takes a few seconds; the results can be kept with \p thrust::tuning::save.
+ *
+ *  \tparam T An arithmetic type.
+ *
+ *  \see thrust::tuning
+ */
+template<typename T>
+void calibrate()
+{
+  THRUST_STATIC_ASSERT( thrust::detail::is_arithmetic<T>::value );
+
+  thrust::system::cpp::calibrate<T>();
+
+  // the leaf size is the size of the pieces the merge sort sorts sequentially, so time the merge sort itself with
+  // each candidate, from min_size to max_size, which includes the default; a comparison other than less keeps the
+  // keys off the radix sort
+  const std::vector<T> sort_input = thrust::system::detail::internal::calibration_input<T>(detail::calibrate_detail::max_size);
+
+  std::size_t best_leaf_size = detail::calibrate_detail::min_size;
+  double best_sort_time = 0;
+
+  for(std::size_t leaf_size = detail::calibrate_detail::min_size; leaf_size <= detail::calibrate_detail::max_size; leaf_size *= 2)
+  {
+    thrust::tuning::set(thrust::tuning::tbb_merge_sort_leaf_size, sizeof(T), leaf_size);
+
+    const double time = thrust::system::detail::internal::calibration_time(sort_input, [](std::vector<T> &keys)
+    {
+      thrust::stable_sort(thrust::tbb::par, keys.begin(), keys.end(), thrust::system::cpp::detail::calibrate_detail::comparison_less<T>());
+    });
+
+    if(leaf_size == detail::calibrate_detail::min_size || time < best_sort_time)
+    {
+      best_leaf_size = leaf_size;
+      best_sort_time = time;
+    }
+  }
+
+  thrust::tuning::set(thrust::tuning::tbb_merge_sort_leaf_size, sizeof(T), best_leaf_size);
+
+  // the radix sort is a cutoff rather than a leaf size: compare it, at every size, with the sequential sort it falls
+  // back on
+  thrust::tuning::set(thrust::tuning::tbb_radix_sort_threshold, sizeof(T), 1);
+
+  const std::size_t radix_sort_threshold = detail::calibrate_detail::crossover(
+    [](std::size_t n)
+    {
+      return thrust::system::detail::internal::calibration_input<T>(n);
+    },
+    [](std::vector<T> &keys)
+    {
+      thrust::stable_sort(thrust::seq, keys.begin(), keys.end(), thrust::less<T>());
+    },
+    [](std::vector<T> &keys)
+    {
+      thrust::stable_sort(thrust::tbb::par, keys.begin(), keys.end(), thrust::less<T>());
+    });
+
+  thrust::tuning::set(thrust::tuning::tbb_radix_sort_threshold, sizeof(T), radix_sort_threshold);
+
+  // reduce runs of 8 equal keys
+  thrust::tuning::set(thrust::tuning::tbb_reduce_by_key_threshold, sizeof(T), 1);
+
+  const std::size_t max_size = detail::calibrate_detail::max_size;
+  std::vector<T> values(max_size, T(1)), keys_result(max_size), values_result(max_size);
+
+  const std::size_t reduce_by_key_threshold = detail::calibrate_detail::crossover(
+    [](std::size_t n)
+    {
+      std::vector<T> keys(n);
+      for(std::size_t i = 0; i < n; ++i) keys[i] = static_cast<T>(i / 8);
+      return keys;
+    },
+    [&](std::vector<T> &keys)
+    {
+      thrust::reduce_by_key(thrust::seq, keys.begin(), keys.end(), values.begin(), keys_result.begin(), values_result.begin());
+    },
+    [&](std::vector<T> &keys)
+    {
+      thrust::reduce_by_key(thrust::tbb::par, keys.begin(), keys.end(), values.begin(), keys_result.begin(), values_result.begin());
+    });
+
+  thrust::tuning::set(thrust::tuning::tbb_reduce_by_key_threshold, sizeof(T), reduce_by_key_threshold);
+} // end calibrate()
+
+/*! \}
+ */
+
+} // end tbb
+} // end system
+
+namespace tbb
+{
+
+using thrust::system::tbb::calibrate;
+
+} // end tbb
+} // end thrust
+
+#endif // __cplusplus >= 201103L
+
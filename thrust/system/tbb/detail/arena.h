@@ -0,0 +1,206 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file arena.h
+ *  \brief Runs TBB parallel algorithms in the task arena attached to an
+ *         execution policy.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/system/tbb/detail/execution_policy.h>
+#include <thrust/system/tbb/detail/par.h>
+#include <thrust/detail/minmax.h>
+#include <tbb/task_arena.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/parallel_scan.h>
+#include <tbb/parallel_invoke.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace tbb
+{
+namespace detail
+{
+namespace arena_detail
+{
+
+
+template<typename Range, typename Body>
+  struct parallel_for_closure
+{
+  const Range &range;
+  const Body &body;
+
+  parallel_for_closure(const Range &range, const Body &body)
+    : range(range), body(body)
+  {}
+
+  void operator()(void) const
+  {
+    ::tbb::parallel_for(range, body);
+  }
+};
+
+
+template<typename Range, typename Body>
+  struct simple_parallel_for_closure
+{
+  const Range &range;
+  const Body &body;
+
+  simple_parallel_for_closure(const Range &range, const Body &body)
+    : range(range), body(body)
+  {}
+
+  void operator()(void) const
+  {
+    ::tbb::parallel_for(range, body, ::tbb::simple_partitioner());
+  }
+};
+
+
+template<typename Range, typename Body>
+  struct parallel_reduce_closure
+{
+  const Range &range;
+  Body &body;
+
+  parallel_reduce_closure(const Range &range, Body &body)
+    : range(range), body(body)
+  {}
+
+  void operator()(void) const
+  {
+    ::tbb::parallel_reduce(range, body);
+  }
+};
+
+
+template<typename Range, typename Body>
+  struct parallel_scan_closure
+{
+  const Range &range;
+  Body &body;
+
+  parallel_scan_closure(const Range &range, Body &body)
+    : range(range), body(body)
+  {}
+
+  void operator()(void) const
+  {
+    ::tbb::parallel_scan(range, body);
+  }
+};
+
+
+template<typename Function1, typename Function2>
+  struct parallel_invoke_closure
+{
+  const Function1 &f1;
+  const Function2 &f2;
+
+  parallel_invoke_closure(const Function1 &f1, const Function2 &f2)
+    : f1(f1), f2(f2)
+  {}
+
+  void operator()(void) const
+  {
+    ::tbb::parallel_invoke(f1, f2);
+  }
+};
+
+
+template<typename DerivedPolicy, typename Closure>
+  void execute(execution_policy<DerivedPolicy> &exec, const Closure &closure)
+{
+  ::tbb::task_arena *arena = get_arena(thrust::detail::derived_cast(exec));
+
+  if(arena)
+  {
+    arena->execute(closure);
+  }
+  else
+  {
+    closure();
+  }
+}
+
+
+} // end arena_detail
+
+
+// the number of threads available to the policy's parallel algorithms
+template<typename DerivedPolicy>
+  unsigned int concurrency(execution_policy<DerivedPolicy> &exec)
+{
+  ::tbb::task_arena *arena = get_arena(thrust::detail::derived_cast(exec));
+
+  const int result = arena ? arena->max_concurrency() : ::tbb::this_task_arena::max_concurrency();
+
+  return thrust::max<int>(1, result);
+}
+
+
+// the following mirror the TBB algorithms of the same name, but run in the
+// policy's arena. They must always be called qualified, lest argument
+// dependent lookup find the TBB originals.
+
+template<typename DerivedPolicy, typename Range, typename Body>
+  void parallel_for(execution_policy<DerivedPolicy> &exec, const Range &range, const Body &body)
+{
+  arena_detail::execute(exec, arena_detail::parallel_for_closure<Range,Body>(range, body));
+}
+
+
+template<typename DerivedPolicy, typename Range, typename Body>
+  void parallel_for(execution_policy<DerivedPolicy> &exec, const Range &range, const Body &body, const ::tbb::simple_partitioner &)
+{
+  arena_detail::execute(exec, arena_detail::simple_parallel_for_closure<Range,Body>(range, body));
+}
+
+
+template<typename DerivedPolicy, typename Range, typename Body>
+  void parallel_reduce(execution_policy<DerivedPolicy> &exec, const Range &range, Body &body)
+{
+  arena_detail::execute(exec, arena_detail::parallel_reduce_closure<Range,Body>(range, body));
+}
+
+
+template<typename DerivedPolicy, typename Range, typename Body>
+  void parallel_scan(execution_policy<DerivedPolicy> &exec, const Range &range, Body &body)
+{
+  arena_detail::execute(exec, arena_detail::parallel_scan_closure<Range,Body>(range, body));
+}
+
+
+template<typename DerivedPolicy, typename Function1, typename Function2>
+  void parallel_invoke(execution_policy<DerivedPolicy> &exec, const Function1 &f1, const Function2 &f2)
+{
+  arena_detail::execute(exec, arena_detail::parallel_invoke_closure<Function1,Function2>(f1, f2));
+}
+
+
+} // end detail
+} // end tbb
+} // end system
+} // end thrust
+
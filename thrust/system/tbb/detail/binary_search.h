@@ -18,6 +18,120 @@
 
 #include <thrust/detail/config.h>
 
-// this system inherits binary_search
+// this system inherits the scalar binary search algorithms
 #include <thrust/system/cpp/detail/binary_search.h>
+#include <thrust/system/detail/internal/sorted_search.h>
+#include <thrust/system/tbb/detail/execution_policy.h>
+#include <thrust/system/tbb/detail/arena.h>
+#include <tbb/blocked_range.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace tbb
+{
+namespace detail
+{
+namespace binary_search_detail
+{
+
+
+template<typename RandomAccessIterator1, typename RandomAccessIterator2, typename RandomAccessIterator3, typename Search>
+struct body
+{
+  RandomAccessIterator1 begin;
+  typename thrust::iterator_difference<RandomAccessIterator1>::type n;
+  RandomAccessIterator2 values_begin;
+  RandomAccessIterator3 output;
+  Search search;
+
+  body(RandomAccessIterator1 begin, RandomAccessIterator1 end, RandomAccessIterator2 values_begin, RandomAccessIterator3 output, Search search)
+    : begin(begin), n(end - begin), values_begin(values_begin), output(output), search(search)
+  {}
+
+  template<typename Size>
+  void operator()(const ::tbb::blocked_range<Size> &r) const
+  {
+    thrust::system::detail::internal::sorted_search_tile(begin, n, values_begin, r.begin(), r.end(), output, search);
+  }
+};
+
+
+template<typename DerivedPolicy, typename RandomAccessIterator1, typename RandomAccessIterator2, typename RandomAccessIterator3, typename Search>
+RandomAccessIterator3 sorted_search(execution_policy<DerivedPolicy> &exec,
+                                    RandomAccessIterator1 begin,
+                                    RandomAccessIterator1 end,
+                                    RandomAccessIterator2 values_begin,
+                                    RandomAccessIterator2 values_end,
+                                    RandomAccessIterator3 output,
+                                    Search search)
+{
+  typedef typename thrust::iterator_difference<RandomAccessIterator1>::type Size;
+
+  const Size m = values_end - values_begin;
+
+  // every task answers a contiguous range of the queries
+  body<RandomAccessIterator1,RandomAccessIterator2,RandomAccessIterator3,Search> search_body(begin, end, values_begin, output, search);
+  thrust::system::tbb::detail::parallel_for(exec, ::tbb::blocked_range<Size>(0, m), search_body);
+
+  return output + m;
+}
+
+
+} // end binary_search_detail
+
+
+// the vectorized searches answer ranges of the queries in parallel, galloping
+// from one answer to the next when the queries are sorted
+
+template <typename DerivedPolicy, typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+typename thrust::system::detail::internal::enable_if_sorted_search<ForwardIterator,InputIterator,OutputIterator,OutputIterator>::type
+  lower_bound(execution_policy<DerivedPolicy> &exec,
+              ForwardIterator begin,
+              ForwardIterator end,
+              InputIterator values_begin,
+              InputIterator values_end,
+              OutputIterator output,
+              StrictWeakOrdering comp)
+{
+  return binary_search_detail::sorted_search(exec, begin, end, values_begin, values_end, output,
+    thrust::system::detail::internal::sorted_lower_bound<StrictWeakOrdering>(comp));
+}
+
+
+template <typename DerivedPolicy, typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+typename thrust::system::detail::internal::enable_if_sorted_search<ForwardIterator,InputIterator,OutputIterator,OutputIterator>::type
+  upper_bound(execution_policy<DerivedPolicy> &exec,
+              ForwardIterator begin,
+              ForwardIterator end,
+              InputIterator values_begin,
+              InputIterator values_end,
+              OutputIterator output,
+              StrictWeakOrdering comp)
+{
+  return binary_search_detail::sorted_search(exec, begin, end, values_begin, values_end, output,
+    thrust::system::detail::internal::sorted_upper_bound<StrictWeakOrdering>(comp));
+}
+
+
+template <typename DerivedPolicy, typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+typename thrust::system::detail::internal::enable_if_sorted_search<ForwardIterator,InputIterator,OutputIterator,OutputIterator>::type
+  binary_search(execution_policy<DerivedPolicy> &exec,
+                ForwardIterator begin,
+                ForwardIterator end,
+                InputIterator values_begin,
+                InputIterator values_end,
+                OutputIterator output,
+                StrictWeakOrdering comp)
+{
+  return binary_search_detail::sorted_search(exec, begin, end, values_begin, values_end, output,
+    thrust::system::detail::internal::sorted_binary_search<StrictWeakOrdering>(comp));
+}
+
+
+} // end detail
+} // end tbb
+} // end system
+} // end thrust
 
@@ -21,8 +21,8 @@
 #include <thrust/system/tbb/detail/copy_if.h>
 #include <thrust/iterator/iterator_traits.h>
 #include <thrust/distance.h>
+#include <thrust/system/tbb/detail/arena.h>
 #include <tbb/blocked_range.h>
-#include <tbb/parallel_scan.h>
 
 namespace thrust
 {
@@ -98,11 +98,12 @@ struct body
 
 } // end copy_if_detail
 
-template<typename InputIterator1,
+template<typename DerivedPolicy,
+         typename InputIterator1,
          typename InputIterator2,
          typename OutputIterator,
          typename Predicate>
-  OutputIterator copy_if(tag,
+  OutputIterator copy_if(execution_policy<DerivedPolicy> &exec,
                          InputIterator1 first,
                          InputIterator1 last,
                          InputIterator2 stencil,
@@ -117,7 +118,7 @@ template<typename InputIterator1,
   if (n != 0)
   {
     Body body(first, stencil, result, pred);
-    ::tbb::parallel_scan(::tbb::blocked_range<Size>(0,n), body);
+    thrust::system::tbb::detail::parallel_scan(exec, ::tbb::blocked_range<Size>(0,n), body);
     thrust::advance(result, body.sum);
   }
 
@@ -14,11 +14,15 @@
  *  limitations under the License.
  */
 
+/*! \file extrema.h
+ *  \brief TBB implementation of min_element, max_element and minmax_element.
+ */
+
 #pragma once
 
 #include <thrust/detail/config.h>
 #include <thrust/system/tbb/detail/execution_policy.h>
-#include <thrust/system/detail/generic/extrema.h>
+#include <thrust/pair.h>
 
 namespace thrust
 {
@@ -33,35 +37,24 @@ template <typename DerivedPolicy, typename ForwardIterator, typename BinaryPredi
 ForwardIterator max_element(execution_policy<DerivedPolicy> &exec,
                             ForwardIterator first, 
                             ForwardIterator last,
-                            BinaryPredicate comp)
-{
-  // tbb prefers generic::max_element to cpp::max_element
-  return thrust::system::detail::generic::max_element(exec, first, last, comp);
-} // end max_element()
+                            BinaryPredicate comp);
 
 template <typename DerivedPolicy, typename ForwardIterator, typename BinaryPredicate>
 ForwardIterator min_element(execution_policy<DerivedPolicy> &exec,
                             ForwardIterator first, 
                             ForwardIterator last,
-                            BinaryPredicate comp)
-{
-  // tbb prefers generic::min_element to cpp::min_element
-  return thrust::system::detail::generic::min_element(exec, first, last, comp);
-} // end min_element()
+                            BinaryPredicate comp);
 
 template <typename DerivedPolicy, typename ForwardIterator, typename BinaryPredicate>
 thrust::pair<ForwardIterator,ForwardIterator> minmax_element(execution_policy<DerivedPolicy> &exec,
                                                              ForwardIterator first, 
                                                              ForwardIterator last,
-                                                             BinaryPredicate comp)
-{
-  // tbb prefers generic::minmax_element to cpp::minmax_element
-  return thrust::system::detail::generic::minmax_element(exec, first, last, comp);
-} // end minmax_element()
+                                                             BinaryPredicate comp);
 
 } // end detail
 } // end tbb
 } // end system
 } // end thrust
 
+#include <thrust/system/tbb/detail/extrema.inl>
 
@@ -0,0 +1,191 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/distance.h>
+#include <thrust/system/tbb/detail/extrema.h>
+#include <thrust/system/tbb/detail/arena.h>
+#include <thrust/system/detail/generic/extrema.h>
+#include <thrust/system/detail/internal/extrema_tiles.h>
+#include <tbb/blocked_range.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace tbb
+{
+namespace detail
+{
+namespace extrema_detail
+{
+
+
+template<bool FindMin, bool FindMax, typename RandomAccessIterator, typename Size, typename BinaryPredicate>
+struct body
+{
+  typedef thrust::pair<Size,Size> Extrema;
+
+  RandomAccessIterator first;
+  BinaryPredicate comp;
+  Extrema result;
+  bool first_call;  // TBB can invoke operator() multiple times on the same body
+
+  body(RandomAccessIterator first, BinaryPredicate comp)
+    : first(first), comp(comp), result(0, 0), first_call(true)
+  {}
+
+  body(body& b, ::tbb::split)
+    : first(b.first), comp(b.comp), result(b.result), first_call(true)
+  {}
+
+  void operator()(const ::tbb::blocked_range<Size> &r)
+  {
+    if (r.empty()) return; // nothing to do
+
+    Extrema temp = thrust::system::detail::internal::extrema_in_tile<FindMin,FindMax>(first, r.begin(), r.end(), comp);
+
+    if (first_call)
+    {
+      // first time body has been invoked
+      first_call = false;
+      result = temp;
+    }
+    else
+    {
+      // body has been previously invoked on a range in front of r
+      thrust::system::detail::internal::merge_extrema<FindMin,FindMax>(first, result, temp, comp);
+    }
+  } // end operator()()
+
+  // b covers the range behind this body's
+  void join(body& b)
+  {
+    if (b.first_call) return; // b has seen nothing
+
+    if (first_call)
+    {
+      first_call = false;
+      result = b.result;
+    }
+    else
+    {
+      thrust::system::detail::internal::merge_extrema<FindMin,FindMax>(first, result, b.result, comp);
+    }
+  }
+}; // end body
+
+
+} // end extrema_detail
+
+
+namespace dispatch
+{
+
+
+template<bool FindMin, bool FindMax, typename DerivedPolicy, typename ForwardIterator, typename BinaryPredicate>
+  thrust::pair<ForwardIterator,ForwardIterator> extrema(execution_policy<DerivedPolicy> &exec,
+                                                        ForwardIterator first,
+                                                        ForwardIterator last,
+                                                        BinaryPredicate comp,
+                                                        thrust::forward_traversal_tag)
+{
+  if(FindMin && FindMax)
+  {
+    return thrust::system::detail::generic::minmax_element(exec, first, last, comp);
+  }
+
+  ForwardIterator result = FindMin ? thrust::system::detail::generic::min_element(exec, first, last, comp)
+                                   : thrust::system::detail::generic::max_element(exec, first, last, comp);
+
+  return thrust::make_pair(result, result);
+} // end extrema()
+
+
+template<bool FindMin, bool FindMax, typename DerivedPolicy, typename RandomAccessIterator, typename BinaryPredicate>
+  thrust::pair<RandomAccessIterator,RandomAccessIterator> extrema(execution_policy<DerivedPolicy> &exec,
+                                                                  RandomAccessIterator first,
+                                                                  RandomAccessIterator last,
+                                                                  BinaryPredicate comp,
+                                                                  thrust::random_access_traversal_tag)
+{
+  typedef typename thrust::iterator_difference<RandomAccessIterator>::type Size;
+
+  const Size n = thrust::distance(first, last);
+
+  if(n == 0)
+  {
+    return thrust::make_pair(last, last);
+  }
+
+  extrema_detail::body<FindMin,FindMax,RandomAccessIterator,Size,BinaryPredicate> extrema_body(first, comp);
+
+  thrust::system::tbb::detail::parallel_reduce(exec, ::tbb::blocked_range<Size>(0, n), extrema_body);
+
+  return thrust::make_pair(first + extrema_body.result.first, first + extrema_body.result.second);
+} // end extrema()
+
+
+} // end dispatch
+
+
+template <typename DerivedPolicy, typename ForwardIterator, typename BinaryPredicate>
+ForwardIterator max_element(execution_policy<DerivedPolicy> &exec,
+                            ForwardIterator first,
+                            ForwardIterator last,
+                            BinaryPredicate comp)
+{
+  typedef typename thrust::iterator_traversal<ForwardIterator>::type traversal;
+
+  // dispatch on traversal
+  return thrust::system::tbb::detail::dispatch::extrema<false,true>(exec, first, last, comp, traversal()).second;
+} // end max_element()
+
+
+template <typename DerivedPolicy, typename ForwardIterator, typename BinaryPredicate>
+ForwardIterator min_element(execution_policy<DerivedPolicy> &exec,
+                            ForwardIterator first,
+                            ForwardIterator last,
+                            BinaryPredicate comp)
+{
+  typedef typename thrust::iterator_traversal<ForwardIterator>::type traversal;
+
+  // dispatch on traversal
+  return thrust::system::tbb::detail::dispatch::extrema<true,false>(exec, first, last, comp, traversal()).first;
+} // end min_element()
+
+
+template <typename DerivedPolicy, typename ForwardIterator, typename BinaryPredicate>
+thrust::pair<ForwardIterator,ForwardIterator> minmax_element(execution_policy<DerivedPolicy> &exec,
+                                                             ForwardIterator first,
+                                                             ForwardIterator last,
+                                                             BinaryPredicate comp)
+{
+  typedef typename thrust::iterator_traversal<ForwardIterator>::type traversal;
+
+  // dispatch on traversal, and find both extrema in a single pass
+  return thrust::system::tbb::detail::dispatch::extrema<true,true>(exec, first, last, comp, traversal());
+} // end minmax_element()
+
+
+} // end detail
+} // end tbb
+} // end system
+} // end thrust
+
@@ -14,10 +14,10 @@
  *  limitations under the License.
  */
 
+
 #pragma once
 
 #include <thrust/detail/config.h>
-#include <thrust/system/detail/generic/find.h>
 #include <thrust/system/tbb/detail/execution_policy.h>
 
 namespace thrust
@@ -29,18 +29,18 @@ namespace tbb
 namespace detail
 {
 
+// mismatch, equal, is_sorted_until, all_of, any_of and none_of reach this
+// through their generic implementations
 template <typename DerivedPolicy, typename InputIterator, typename Predicate>
 InputIterator find_if(execution_policy<DerivedPolicy> &exec,
                       InputIterator first,
                       InputIterator last,
-                      Predicate pred)
-{
-  // tbb prefers generic::find_if to cpp::find_if
-  return thrust::system::detail::generic::find_if(exec, first, last, pred);
-}
+                      Predicate pred);
 
 } // end namespace detail
 } // end namespace tbb
 } // end namespace system
 } // end namespace thrust
 
+#include <thrust/system/tbb/detail/find.inl>
+
@@ -0,0 +1,168 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/distance.h>
+#include <thrust/find.h>
+#include <thrust/detail/seq.h>
+#include <thrust/system/tbb/detail/find.h>
+#include <thrust/system/tbb/detail/arena.h>
+#include <thrust/system/detail/internal/find_tiles.h>
+#include <tbb/blocked_range.h>
+#include <atomic>
+
+namespace thrust
+{
+namespace system
+{
+namespace tbb
+{
+namespace detail
+{
+namespace find_if_detail
+{
+
+
+// the smallest tile worth claiming
+const std::size_t min_tile_size = 1024;
+
+
+// every worker claims tiles in order until it finds a match, or reaches a
+// tile past the best match so far
+template<typename RandomAccessIterator, typename Size, typename Predicate>
+struct body
+{
+  RandomAccessIterator first;
+  Size n;
+  Size tile_size;
+  Size num_tiles;
+  Predicate pred;
+  std::atomic<Size> &next_tile;
+  std::atomic<Size> &best;
+
+  body(RandomAccessIterator first, Size n, Size tile_size, Predicate pred,
+       std::atomic<Size> &next_tile, std::atomic<Size> &best)
+    : first(first), n(n), tile_size(tile_size), num_tiles((n + tile_size - 1) / tile_size),
+      pred(pred), next_tile(next_tile), best(best)
+  {}
+
+  void operator()(const ::tbb::blocked_range<Size> &r) const
+  {
+    for(Size worker = r.begin(); worker != r.end(); ++worker)
+    {
+      while(true)
+      {
+        const Size tile = next_tile.fetch_add(1);
+
+        // every later tile begins past this one
+        if(tile >= num_tiles || tile * tile_size >= best) break;
+
+        const Size match = thrust::system::detail::internal::find_in_tile(first, n, tile_size, tile, pred);
+
+        if(match < thrust::min<Size>(n, (tile + 1) * tile_size))
+        {
+          // lower best to match; a failed exchange reloads current
+          Size current = best.load();
+          while(match < current && !best.compare_exchange_weak(current, match))
+          {
+          }
+
+          // every later tile begins past this match
+          break;
+        }
+      }
+    }
+  }
+}; // end body
+
+
+} // end find_if_detail
+
+
+namespace dispatch
+{
+
+
+template<typename DerivedPolicy, typename InputIterator, typename Predicate>
+  InputIterator find_if(execution_policy<DerivedPolicy> &,
+                        InputIterator first,
+                        InputIterator last,
+                        Predicate pred,
+                        thrust::incrementable_traversal_tag)
+{
+  return thrust::find_if(thrust::seq, first, last, pred);
+} // end find_if()
+
+
+template<typename DerivedPolicy, typename RandomAccessIterator, typename Predicate>
+  RandomAccessIterator find_if(execution_policy<DerivedPolicy> &exec,
+                               RandomAccessIterator first,
+                               RandomAccessIterator last,
+                               Predicate pred,
+                               thrust::random_access_traversal_tag)
+{
+  typedef typename thrust::iterator_difference<RandomAccessIterator>::type Size;
+
+  const Size n = thrust::distance(first, last);
+
+  const Size num_workers = thrust::system::tbb::detail::concurrency(exec);
+
+  // don't bother spawning tasks for less than a tile per worker
+  if(num_workers <= 1 || n <= static_cast<Size>(find_if_detail::min_tile_size))
+  {
+    return thrust::find_if(thrust::seq, first, last, pred);
+  }
+
+  const Size tile_size = thrust::system::detail::internal::find_tile_size(n, num_workers, find_if_detail::min_tile_size);
+
+  // the next tile to claim, and the position of the first match found so far
+  std::atomic<Size> next_tile(0);
+  std::atomic<Size> best(n);
+
+  // one task per worker, which claims tiles dynamically
+  typedef find_if_detail::body<RandomAccessIterator,Size,Predicate> Body;
+  Body find_body(first, n, tile_size, pred, next_tile, best);
+  thrust::system::tbb::detail::parallel_for(exec, ::tbb::blocked_range<Size>(0, num_workers, 1), find_body, ::tbb::simple_partitioner());
+
+  return first + best.load();
+} // end find_if()
+
+
+} // end dispatch
+
+
+template <typename DerivedPolicy, typename InputIterator, typename Predicate>
+InputIterator find_if(execution_policy<DerivedPolicy> &exec,
+                      InputIterator first,
+                      InputIterator last,
+                      Predicate pred)
+{
+  typedef typename thrust::iterator_traversal<InputIterator>::type traversal;
+
+  // dispatch on traversal
+  return thrust::system::tbb::detail::dispatch::find_if(exec, first, last, pred, traversal());
+} // end find_if()
+
+
+} // end namespace detail
+} // end namespace tbb
+} // end namespace system
+} // end namespace thrust
+
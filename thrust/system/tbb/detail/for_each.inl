@@ -20,8 +20,8 @@
 #include <thrust/iterator/iterator_traits.h>
 #include <thrust/distance.h>
 #include <thrust/system/detail/sequential/execution_policy.h>
+#include <thrust/system/tbb/detail/arena.h>
 #include <tbb/blocked_range.h>
-#include <tbb/parallel_for.h>
 
 namespace thrust
 {
@@ -69,12 +69,12 @@ template<typename DerivedPolicy,
          typename RandomAccessIterator,
          typename Size,
          typename UnaryFunction>
-RandomAccessIterator for_each_n(execution_policy<DerivedPolicy> &,
+RandomAccessIterator for_each_n(execution_policy<DerivedPolicy> &exec,
                                 RandomAccessIterator first,
                                 Size n,
                                 UnaryFunction f)
 {
-  ::tbb::parallel_for(::tbb::blocked_range<Size>(0,n), for_each_detail::make_body<Size>(first,f));
+  thrust::system::tbb::detail::parallel_for(exec, ::tbb::blocked_range<Size>(0,n), for_each_detail::make_body<Size>(first,f));
 
   // return the end of the range
   return first + n;
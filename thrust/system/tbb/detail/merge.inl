@@ -20,7 +20,7 @@
 #include <thrust/merge.h>
 #include <thrust/binary_search.h>
 #include <thrust/detail/seq.h>
-#include <tbb/parallel_for.h>
+#include <thrust/system/tbb/detail/arena.h>
 
 namespace thrust
 {
@@ -238,7 +238,7 @@ OutputIterator merge(execution_policy<DerivedPolicy> &exec,
   Range range(first1, last1, first2, last2, result, comp);
   Body  body;
 
-  ::tbb::parallel_for(range, body);
+  thrust::system::tbb::detail::parallel_for(exec, range, body);
 
   thrust::advance(result, thrust::distance(first1, last1) + thrust::distance(first2, last2));
 
@@ -271,7 +271,7 @@ thrust::pair<OutputIterator1,OutputIterator2>
   Range range(keys_first1, keys_last1, keys_first2, keys_last2, values_first3, values_first4, keys_result, values_result, comp);
   Body  body;
 
-  ::tbb::parallel_for(range, body);
+  thrust::system::tbb::detail::parallel_for(exec, range, body);
 
   thrust::advance(keys_result,   thrust::distance(keys_first1, keys_last1) + thrust::distance(keys_first2, keys_last2));
   thrust::advance(values_result, thrust::distance(keys_first1, keys_last1) + thrust::distance(keys_first2, keys_last2));
@@ -19,6 +19,7 @@
 #include <thrust/detail/config.h>
 #include <thrust/detail/allocator_aware_execution_policy.h>
 #include <thrust/system/tbb/detail/execution_policy.h>
+#include <tbb/task_arena.h>
 
 namespace thrust
 {
@@ -30,12 +31,72 @@ namespace detail
 {
 
 
+// a null arena requests the calling thread's current arena
+template<typename Derived>
+__host__ __device__
+  ::tbb::task_arena *get_arena(execution_policy<Derived> &)
+{
+  return 0;
+}
+
+
+template<typename Derived>
+  struct execute_on_arena_base
+    : thrust::system::tbb::detail::execution_policy<Derived>
+{
+  private:
+    ::tbb::task_arena *arena;
+
+  public:
+    __host__ __device__
+    execute_on_arena_base(::tbb::task_arena *arena_ = 0)
+      : arena(arena_)
+    {}
+
+    // returns a copy of this policy whose parallel algorithms run in arena
+    // and decompose work for arena's concurrency
+    __host__ __device__
+    Derived on(::tbb::task_arena &arena_) const
+    {
+      Derived result = thrust::detail::derived_cast(*this);
+      result.arena = &arena_;
+      return result;
+    }
+
+  private:
+    friend __host__ __device__
+      ::tbb::task_arena *get_arena(const execute_on_arena_base &exec)
+    {
+      return exec.arena;
+    }
+};
+
+
+struct execute_on_arena
+  : execute_on_arena_base<execute_on_arena>
+{
+  typedef execute_on_arena_base<execute_on_arena> base_t;
+
+  __host__ __device__
+  execute_on_arena() : base_t() {}
+
+  __host__ __device__
+  execute_on_arena(::tbb::task_arena &arena) : base_t(&arena) {}
+};
+
+
 struct par_t : thrust::system::tbb::detail::execution_policy<par_t>,
   thrust::detail::allocator_aware_execution_policy<
-    thrust::system::tbb::detail::execution_policy>
+    thrust::system::tbb::detail::execute_on_arena_base>
 {
   __host__ __device__
   par_t() : thrust::system::tbb::detail::execution_policy<par_t>() {}
+
+  __host__ __device__
+  execute_on_arena on(::tbb::task_arena &arena) const
+  {
+    return execute_on_arena(arena);
+  }
 };
 
 
@@ -23,8 +23,9 @@
 #include <thrust/iterator/iterator_traits.h>
 #include <thrust/distance.h>
 #include <thrust/reduce.h>
+#include <thrust/detail/seq.h>
+#include <thrust/system/tbb/detail/arena.h>
 #include <tbb/blocked_range.h>
-#include <tbb/parallel_reduce.h>
 
 namespace thrust
 {
@@ -70,8 +71,8 @@ struct body
 
     ++iter;
 
-    for (Size i = r.begin() + 1; i != r.end(); ++i, ++iter)
-      temp = binary_op(temp, *iter);
+    // the sequential reduction vectorizes contiguous arithmetic ranges
+    temp = thrust::reduce(thrust::seq, iter, first + r.end(), temp, binary_op.m_f);
 
 
     if (first_call)
@@ -118,7 +119,7 @@ template<typename DerivedPolicy,
   {
     typedef typename reduce_detail::body<InputIterator,OutputType,BinaryFunction> Body;
     Body reduce_body(begin, init, binary_op);
-    ::tbb::parallel_reduce(::tbb::blocked_range<Size>(0,n), reduce_body);
+    thrust::system::tbb::detail::parallel_reduce(exec, ::tbb::blocked_range<Size>(0,n), reduce_body);
     return binary_op(init, reduce_body.sum);
   }
 }
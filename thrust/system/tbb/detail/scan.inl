@@ -25,8 +25,8 @@
 #include <thrust/detail/type_traits.h>
 #include <thrust/detail/type_traits/function_traits.h>
 #include <thrust/detail/type_traits/iterator/is_output_iterator.h>
+#include <thrust/system/tbb/detail/arena.h>
 #include <tbb/blocked_range.h>
-#include <tbb/parallel_scan.h>
 
 namespace thrust
 {
@@ -102,14 +102,20 @@ struct inclusive_body
     first_call = false;
   }
 
+  // b covers the range in front of this body's; either may have seen nothing
   void reverse_join(inclusive_body& b)
   {
-    sum = binary_op(b.sum, sum);
+    if (b.first_call) return;
+
+    sum = first_call ? b.sum : binary_op(b.sum, sum);
+
+    first_call = false;
   } 
 
   void assign(inclusive_body& b)
   {
     sum = b.sum;
+    first_call = b.first_call;
   } 
 };
 
@@ -123,15 +129,17 @@ struct exclusive_body
   InputIterator input;
   OutputIterator output;
   thrust::detail::wrapped_function<BinaryFunction,ValueType> binary_op;
-  ValueType sum;
-  bool first_call;
+  ValueType init;
+  ValueType sum;    // the sum of the elements seen so far, preceded by init if they start at the front of the input
+  bool first_call;  // true while sum is meaningless
 
   exclusive_body(InputIterator input, OutputIterator output, BinaryFunction binary_op, ValueType init)
-    : input(input), output(output), binary_op(binary_op), sum(init), first_call(true)
+    : input(input), output(output), binary_op(binary_op), init(init), sum(init), first_call(true)
   {}
     
+  // a split body has seen nothing, so init is not carried over into its sum
   exclusive_body(exclusive_body& b, ::tbb::split)
-    : input(b.input), output(b.output), binary_op(b.binary_op), sum(b.sum), first_call(true)
+    : input(b.input), output(b.output), binary_op(b.binary_op), init(b.init), sum(b.init), first_call(true)
   {}
 
   template<typename Size> 
@@ -146,10 +154,12 @@ struct exclusive_body
     for (Size i = r.begin() + 1; i != r.end(); ++i, ++iter)
       temp = binary_op(temp, *iter);
 
-    if (first_call && r.begin() > 0)
-      sum = temp;
-    else
+    if (!first_call)
       sum = binary_op(sum, temp);
+    else if (r.begin() == 0)
+      sum = binary_op(init, temp);
+    else
+      sum = temp;
       
     first_call = false;
   }
@@ -160,6 +170,10 @@ struct exclusive_body
     InputIterator  iter1 = input  + r.begin();
     OutputIterator iter2 = output + r.begin();
 
+    // a body without a sum scans the front of the input
+    if (first_call)
+      sum = init;
+
     for (Size i = r.begin(); i != r.end(); ++i, ++iter1, ++iter2)
     {
       ValueType temp = binary_op(sum, *iter1);
@@ -170,14 +184,20 @@ struct exclusive_body
     first_call = false;
   }
 
+  // b covers the range in front of this body's; either may have seen nothing
   void reverse_join(exclusive_body& b)
   {
-    sum = binary_op(b.sum, sum);
+    if (b.first_call) return;
+
+    sum = first_call ? b.sum : binary_op(b.sum, sum);
+
+    first_call = false;
   } 
 
   void assign(exclusive_body& b)
   {
     sum = b.sum;
+    first_call = b.first_call;
   } 
 };
 
@@ -185,10 +205,11 @@ struct exclusive_body
 
 
 
-template<typename InputIterator,
+template<typename DerivedPolicy,
+         typename InputIterator,
          typename OutputIterator,
          typename BinaryFunction>
-  OutputIterator inclusive_scan(tag,
+  OutputIterator inclusive_scan(execution_policy<DerivedPolicy> &exec,
                                 InputIterator first,
                                 InputIterator last,
                                 OutputIterator result,
@@ -226,7 +247,7 @@ template<typename InputIterator,
   {
     typedef typename scan_detail::inclusive_body<InputIterator,OutputIterator,BinaryFunction,ValueType> Body;
     Body scan_body(first, result, binary_op, *first);
-    ::tbb::parallel_scan(::tbb::blocked_range<Size>(0,n), scan_body);
+    thrust::system::tbb::detail::parallel_scan(exec, ::tbb::blocked_range<Size>(0,n), scan_body);
   }
  
   thrust::advance(result, n);
@@ -235,11 +256,12 @@ template<typename InputIterator,
 }
 
 
-template<typename InputIterator,
+template<typename DerivedPolicy,
+         typename InputIterator,
          typename OutputIterator,
          typename T,
          typename BinaryFunction>
-  OutputIterator exclusive_scan(tag,
+  OutputIterator exclusive_scan(execution_policy<DerivedPolicy> &exec,
                                 InputIterator first,
                                 InputIterator last,
                                 OutputIterator result,
@@ -278,7 +300,7 @@ template<typename InputIterator,
   {
     typedef typename scan_detail::exclusive_body<InputIterator,OutputIterator,BinaryFunction,ValueType> Body;
     Body scan_body(first, result, binary_op, init);
-    ::tbb::parallel_scan(::tbb::blocked_range<Size>(0,n), scan_body);
+    thrust::system::tbb::detail::parallel_scan(exec, ::tbb::blocked_range<Size>(0,n), scan_body);
   }
  
   thrust::advance(result, n);
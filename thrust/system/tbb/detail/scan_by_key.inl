@@ -0,0 +1,299 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/system/tbb/detail/scan_by_key.h>
+#include <thrust/system/tbb/detail/execution_policy.h>
+#include <thrust/system/detail/internal/decompose.h>
+#include <thrust/system/detail/internal/scan_by_key_tiles.h>
+#include <thrust/scan.h>
+#include <thrust/distance.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/detail/seq.h>
+#include <thrust/detail/function.h>
+#include <thrust/detail/minmax.h>
+#include <thrust/detail/temporary_array.h>
+#include <thrust/system/tbb/detail/arena.h>
+#include <thrust/system/tbb/detail/tiles.h>
+#include <tbb/blocked_range.h>
+#include <cassert>
+
+namespace thrust
+{
+namespace system
+{
+namespace tbb
+{
+namespace detail
+{
+namespace scan_by_key_detail
+{
+
+
+template<typename Tile, typename Iterator1, typename Iterator2, typename Decomposition, typename BinaryPredicate, typename BinaryFunction>
+  struct upsweep_body
+{
+  typedef typename Decomposition::index_type size_type;
+
+  Tile *tiles;
+  Iterator1 keys_first;
+  Iterator2 values_first;
+  Decomposition decomp;
+  BinaryPredicate binary_pred;
+  BinaryFunction binary_op;
+
+  upsweep_body(Tile *tiles, Iterator1 keys_first, Iterator2 values_first, Decomposition decomp, BinaryPredicate binary_pred, BinaryFunction binary_op)
+    : tiles(tiles),
+      keys_first(keys_first),
+      values_first(values_first),
+      decomp(decomp),
+      binary_pred(binary_pred),
+      binary_op(binary_op)
+  {}
+
+  void operator()(const ::tbb::blocked_range<size_type> &r) const
+  {
+    assert(r.size() == 1);
+
+    const size_type tile_idx = r.begin();
+
+    thrust::system::detail::internal::scan_by_key_tile_upsweep(tiles[tile_idx],
+                                                               keys_first,
+                                                               values_first,
+                                                               decomp[tile_idx].begin(),
+                                                               decomp[tile_idx].end(),
+                                                               binary_pred,
+                                                               binary_op);
+  }
+};
+
+
+template<typename Tile, typename Iterator1, typename Iterator2, typename Iterator3, typename Decomposition, typename BinaryPredicate, typename BinaryFunction>
+  struct inclusive_downsweep_body
+{
+  typedef typename Decomposition::index_type size_type;
+
+  const Tile *tiles;
+  Iterator1 keys_first;
+  Iterator2 values_first;
+  Iterator3 result;
+  Decomposition decomp;
+  BinaryPredicate binary_pred;
+  BinaryFunction binary_op;
+
+  inclusive_downsweep_body(const Tile *tiles, Iterator1 keys_first, Iterator2 values_first, Iterator3 result, Decomposition decomp, BinaryPredicate binary_pred, BinaryFunction binary_op)
+    : tiles(tiles),
+      keys_first(keys_first),
+      values_first(values_first),
+      result(result),
+      decomp(decomp),
+      binary_pred(binary_pred),
+      binary_op(binary_op)
+  {}
+
+  void operator()(const ::tbb::blocked_range<size_type> &r) const
+  {
+    assert(r.size() == 1);
+
+    const size_type tile_idx = r.begin();
+
+    thrust::system::detail::internal::inclusive_scan_by_key_tile_downsweep(tiles[tile_idx],
+                                                                           keys_first,
+                                                                           values_first,
+                                                                           result,
+                                                                           decomp[tile_idx].begin(),
+                                                                           decomp[tile_idx].end(),
+                                                                           binary_pred,
+                                                                           binary_op);
+  }
+};
+
+
+template<typename Tile, typename Iterator1, typename Iterator2, typename Iterator3, typename T, typename Decomposition, typename BinaryPredicate, typename BinaryFunction>
+  struct exclusive_downsweep_body
+{
+  typedef typename Decomposition::index_type size_type;
+
+  const Tile *tiles;
+  Iterator1 keys_first;
+  Iterator2 values_first;
+  Iterator3 result;
+  T init;
+  Decomposition decomp;
+  BinaryPredicate binary_pred;
+  BinaryFunction binary_op;
+
+  exclusive_downsweep_body(const Tile *tiles, Iterator1 keys_first, Iterator2 values_first, Iterator3 result, T init, Decomposition decomp, BinaryPredicate binary_pred, BinaryFunction binary_op)
+    : tiles(tiles),
+      keys_first(keys_first),
+      values_first(values_first),
+      result(result),
+      init(init),
+      decomp(decomp),
+      binary_pred(binary_pred),
+      binary_op(binary_op)
+  {}
+
+  void operator()(const ::tbb::blocked_range<size_type> &r) const
+  {
+    assert(r.size() == 1);
+
+    const size_type tile_idx = r.begin();
+
+    thrust::system::detail::internal::exclusive_scan_by_key_tile_downsweep(tiles[tile_idx],
+                                                                           keys_first,
+                                                                           values_first,
+                                                                           result,
+                                                                           decomp[tile_idx].begin(),
+                                                                           decomp[tile_idx].end(),
+                                                                           init,
+                                                                           binary_pred,
+                                                                           binary_op);
+  }
+};
+
+
+} // end scan_by_key_detail
+
+
+template<typename DerivedPolicy,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator,
+         typename BinaryPredicate,
+         typename BinaryFunction>
+  OutputIterator inclusive_scan_by_key(execution_policy<DerivedPolicy> &exec,
+                                       InputIterator1 first1,
+                                       InputIterator1 last1,
+                                       InputIterator2 first2,
+                                       OutputIterator result,
+                                       BinaryPredicate binary_pred,
+                                       BinaryFunction binary_op)
+{
+  typedef typename thrust::iterator_difference<InputIterator1>::type Size;
+  typedef typename thrust::iterator_traits<OutputIterator>::value_type ValueType;
+  typedef thrust::system::detail::internal::scan_by_key_tile<Size,ValueType> tile_type;
+  typedef thrust::system::detail::internal::uniform_decomposition<Size> decomposition_type;
+
+  Size n = thrust::distance(first1, last1);
+
+  typedef typename thrust::iterator_value<InputIterator1>::type key_type;
+
+  if(n < thrust::system::tbb::detail::tiled_parallelism_threshold<key_type,Size>())
+  {
+    // don't bother parallelizing for small n
+    return thrust::inclusive_scan_by_key(thrust::seq, first1, last1, first2, result, binary_pred, binary_op);
+  }
+
+  decomposition_type decomp = thrust::system::tbb::detail::make_tile_decomposition(exec, n);
+
+  // wrap binary_op
+  typedef thrust::detail::wrapped_function<BinaryFunction,ValueType> wrapped_function_type;
+  wrapped_function_type wrapped_binary_op(binary_op);
+
+  // only O(P) tile summaries are stored, never a temporary the size of the input
+  thrust::detail::temporary_array<tile_type, DerivedPolicy> tile_storage(exec, decomp.size());
+  tile_type *tiles = thrust::raw_pointer_cast(tile_storage.data());
+
+  // reduce the segment left open at the end of each tile
+  // force grainsize == 1 with simple_partioner()
+  typedef scan_by_key_detail::upsweep_body<tile_type,InputIterator1,InputIterator2,decomposition_type,BinaryPredicate,wrapped_function_type> upsweep_body_type;
+  thrust::system::tbb::detail::parallel_for(exec, ::tbb::blocked_range<Size>(0, decomp.size(), 1),
+    upsweep_body_type(tiles, first1, first2, decomp, binary_pred, wrapped_binary_op),
+    ::tbb::simple_partitioner());
+
+  // sequentially compute the carry into each tile
+  thrust::system::detail::internal::scan_by_key_tile_carries(tiles, decomp.size(), wrapped_binary_op);
+
+  // scan each tile serially, seeded with its carry
+  typedef scan_by_key_detail::inclusive_downsweep_body<tile_type,InputIterator1,InputIterator2,OutputIterator,decomposition_type,BinaryPredicate,wrapped_function_type> downsweep_body_type;
+  thrust::system::tbb::detail::parallel_for(exec, ::tbb::blocked_range<Size>(0, decomp.size(), 1),
+    downsweep_body_type(tiles, first1, first2, result, decomp, binary_pred, wrapped_binary_op),
+    ::tbb::simple_partitioner());
+
+  return result + n;
+}
+
+
+template<typename DerivedPolicy,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator,
+         typename T,
+         typename BinaryPredicate,
+         typename BinaryFunction>
+  OutputIterator exclusive_scan_by_key(execution_policy<DerivedPolicy> &exec,
+                                       InputIterator1 first1,
+                                       InputIterator1 last1,
+                                       InputIterator2 first2,
+                                       OutputIterator result,
+                                       T init,
+                                       BinaryPredicate binary_pred,
+                                       BinaryFunction binary_op)
+{
+  typedef typename thrust::iterator_difference<InputIterator1>::type Size;
+  typedef typename thrust::iterator_traits<OutputIterator>::value_type ValueType;
+  typedef thrust::system::detail::internal::scan_by_key_tile<Size,ValueType> tile_type;
+  typedef thrust::system::detail::internal::uniform_decomposition<Size> decomposition_type;
+
+  Size n = thrust::distance(first1, last1);
+
+  typedef typename thrust::iterator_value<InputIterator1>::type key_type;
+
+  if(n < thrust::system::tbb::detail::tiled_parallelism_threshold<key_type,Size>())
+  {
+    // don't bother parallelizing for small n
+    return thrust::exclusive_scan_by_key(thrust::seq, first1, last1, first2, result, init, binary_pred, binary_op);
+  }
+
+  decomposition_type decomp = thrust::system::tbb::detail::make_tile_decomposition(exec, n);
+
+  // wrap binary_op
+  typedef thrust::detail::wrapped_function<BinaryFunction,ValueType> wrapped_function_type;
+  wrapped_function_type wrapped_binary_op(binary_op);
+
+  // only O(P) tile summaries are stored, never a temporary the size of the input
+  thrust::detail::temporary_array<tile_type, DerivedPolicy> tile_storage(exec, decomp.size());
+  tile_type *tiles = thrust::raw_pointer_cast(tile_storage.data());
+
+  // reduce the segment left open at the end of each tile
+  // force grainsize == 1 with simple_partioner()
+  typedef scan_by_key_detail::upsweep_body<tile_type,InputIterator1,InputIterator2,decomposition_type,BinaryPredicate,wrapped_function_type> upsweep_body_type;
+  thrust::system::tbb::detail::parallel_for(exec, ::tbb::blocked_range<Size>(0, decomp.size(), 1),
+    upsweep_body_type(tiles, first1, first2, decomp, binary_pred, wrapped_binary_op),
+    ::tbb::simple_partitioner());
+
+  // sequentially compute the carry into each tile
+  thrust::system::detail::internal::scan_by_key_tile_carries(tiles, decomp.size(), wrapped_binary_op);
+
+  // scan each tile serially, seeded with its carry
+  typedef scan_by_key_detail::exclusive_downsweep_body<tile_type,InputIterator1,InputIterator2,OutputIterator,T,decomposition_type,BinaryPredicate,wrapped_function_type> downsweep_body_type;
+  thrust::system::tbb::detail::parallel_for(exec, ::tbb::blocked_range<Size>(0, decomp.size(), 1),
+    downsweep_body_type(tiles, first1, first2, result, init, decomp, binary_pred, wrapped_binary_op),
+    ::tbb::simple_partitioner());
+
+  return result + n;
+}
+
+
+} // end namespace detail
+} // end namespace tbb
+} // end namespace system
+} // end namespace thrust
+
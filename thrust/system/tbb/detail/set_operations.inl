@@ -0,0 +1,264 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/system/tbb/detail/set_operations.h>
+#include <thrust/system/tbb/detail/execution_policy.h>
+#include <thrust/system/detail/internal/decompose.h>
+#include <thrust/system/detail/internal/set_operation_tiles.h>
+#include <thrust/distance.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/detail/minmax.h>
+#include <thrust/detail/temporary_array.h>
+#include <thrust/system/tbb/detail/arena.h>
+#include <thrust/system/tbb/detail/tiles.h>
+#include <tbb/blocked_range.h>
+#include <cassert>
+
+
+namespace thrust
+{
+namespace system
+{
+namespace tbb
+{
+namespace detail
+{
+namespace set_operations_detail
+{
+
+
+template<typename Tile, typename Iterator1, typename Iterator2, typename Decomposition, typename Compare, typename SetOperation>
+  struct upsweep_body
+{
+  typedef typename Decomposition::index_type size_type;
+
+  Tile *tiles;
+  Iterator1 first1;
+  size_type n1;
+  Iterator2 first2;
+  size_type n2;
+  Decomposition decomp;
+  Compare comp;
+  SetOperation op;
+
+  upsweep_body(Tile *tiles, Iterator1 first1, size_type n1, Iterator2 first2, size_type n2, Decomposition decomp, Compare comp, SetOperation op)
+    : tiles(tiles),
+      first1(first1),
+      n1(n1),
+      first2(first2),
+      n2(n2),
+      decomp(decomp),
+      comp(comp),
+      op(op)
+  {}
+
+  void operator()(const ::tbb::blocked_range<size_type> &r) const
+  {
+    assert(r.size() == 1);
+
+    const size_type tile_idx = r.begin();
+
+    thrust::system::detail::internal::set_operation_tile_upsweep(tiles[tile_idx],
+                                                                 first1, n1,
+                                                                 first2, n2,
+                                                                 decomp[tile_idx].begin(),
+                                                                 decomp[tile_idx].end(),
+                                                                 comp,
+                                                                 op);
+  }
+};
+
+
+template<typename Tile, typename Iterator1, typename Iterator2, typename Iterator3, typename Compare, typename SetOperation>
+  struct downsweep_body
+{
+  typedef typename Tile::size_type size_type;
+
+  const Tile *tiles;
+  Iterator1 first1;
+  Iterator2 first2;
+  Iterator3 result;
+  Compare comp;
+  SetOperation op;
+
+  downsweep_body(const Tile *tiles, Iterator1 first1, Iterator2 first2, Iterator3 result, Compare comp, SetOperation op)
+    : tiles(tiles),
+      first1(first1),
+      first2(first2),
+      result(result),
+      comp(comp),
+      op(op)
+  {}
+
+  void operator()(const ::tbb::blocked_range<size_type> &r) const
+  {
+    assert(r.size() == 1);
+
+    thrust::system::detail::internal::set_operation_tile_downsweep(tiles[r.begin()], first1, first2, result, comp, op);
+  }
+};
+
+
+template<typename Tile, typename Iterator1, typename Iterator2, typename Decomposition, typename Compare, typename SetOperation>
+  upsweep_body<Tile,Iterator1,Iterator2,Decomposition,Compare,SetOperation>
+    make_upsweep_body(Tile *tiles, Iterator1 first1, typename Decomposition::index_type n1, Iterator2 first2, typename Decomposition::index_type n2, Decomposition decomp, Compare comp, SetOperation op)
+{
+  return upsweep_body<Tile,Iterator1,Iterator2,Decomposition,Compare,SetOperation>(tiles, first1, n1, first2, n2, decomp, comp, op);
+}
+
+
+template<typename Tile, typename Iterator1, typename Iterator2, typename Iterator3, typename Compare, typename SetOperation>
+  downsweep_body<Tile,Iterator1,Iterator2,Iterator3,Compare,SetOperation>
+    make_downsweep_body(const Tile *tiles, Iterator1 first1, Iterator2 first2, Iterator3 result, Compare comp, SetOperation op)
+{
+  return downsweep_body<Tile,Iterator1,Iterator2,Iterator3,Compare,SetOperation>(tiles, first1, first2, result, comp, op);
+}
+
+
+template<typename DerivedPolicy,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator,
+         typename StrictWeakOrdering,
+         typename SetOperation>
+  OutputIterator set_operation(execution_policy<DerivedPolicy> &exec,
+                               InputIterator1 first1,
+                               InputIterator1 last1,
+                               InputIterator2 first2,
+                               InputIterator2 last2,
+                               OutputIterator result,
+                               StrictWeakOrdering comp,
+                               SetOperation op)
+{
+  typedef typename thrust::iterator_difference<InputIterator1>::type difference_type;
+
+  const difference_type n1 = thrust::distance(first1, last1);
+  const difference_type n2 = thrust::distance(first2, last2);
+
+  typedef typename thrust::iterator_value<InputIterator1>::type key_type;
+
+  if(n1 + n2 < thrust::system::tbb::detail::tiled_parallelism_threshold<key_type,difference_type>())
+  {
+    // don't bother parallelizing for small n
+    return op(first1, last1, first2, last2, result, comp);
+  }
+
+  // generate O(P) tiles of sequential work over the merge of both inputs
+  typedef thrust::system::detail::internal::uniform_decomposition<difference_type> decomposition_type;
+  decomposition_type decomp = thrust::system::tbb::detail::make_tile_decomposition(exec, n1 + n2);
+
+  typedef thrust::system::detail::internal::set_operation_tile<difference_type> tile_type;
+  thrust::detail::temporary_array<tile_type, DerivedPolicy> tile_storage(exec, decomp.size());
+  tile_type *tiles = thrust::raw_pointer_cast(tile_storage.data());
+
+  // partition the inputs and count each tile's outputs
+  // force grainsize == 1 with simple_partioner()
+  thrust::system::tbb::detail::parallel_for(exec, ::tbb::blocked_range<difference_type>(0, decomp.size(), 1),
+    set_operations_detail::make_upsweep_body(tiles, first1, n1, first2, n2, decomp, comp, op),
+    ::tbb::simple_partitioner());
+
+  // sequentially compute each tile's output offset
+  difference_type size_of_result = thrust::system::detail::internal::set_operation_tile_offsets(tiles, decomp.size());
+
+  // write each tile's outputs at its offset
+  thrust::system::tbb::detail::parallel_for(exec, ::tbb::blocked_range<difference_type>(0, decomp.size(), 1),
+    set_operations_detail::make_downsweep_body(tiles, first1, first2, result, comp, op),
+    ::tbb::simple_partitioner());
+
+  return result + size_of_result;
+} // end set_operation()
+
+
+} // end set_operations_detail
+
+
+template<typename DerivedPolicy,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator,
+         typename StrictWeakOrdering>
+  OutputIterator set_difference(execution_policy<DerivedPolicy> &exec,
+                                InputIterator1 first1,
+                                InputIterator1 last1,
+                                InputIterator2 first2,
+                                InputIterator2 last2,
+                                OutputIterator result,
+                                StrictWeakOrdering comp)
+{
+  return set_operations_detail::set_operation(exec, first1, last1, first2, last2, result, comp, thrust::system::detail::internal::set_difference_op());
+} // end set_difference()
+
+
+template<typename DerivedPolicy,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator,
+         typename StrictWeakOrdering>
+  OutputIterator set_intersection(execution_policy<DerivedPolicy> &exec,
+                                  InputIterator1 first1,
+                                  InputIterator1 last1,
+                                  InputIterator2 first2,
+                                  InputIterator2 last2,
+                                  OutputIterator result,
+                                  StrictWeakOrdering comp)
+{
+  return set_operations_detail::set_operation(exec, first1, last1, first2, last2, result, comp, thrust::system::detail::internal::set_intersection_op());
+} // end set_intersection()
+
+
+template<typename DerivedPolicy,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator,
+         typename StrictWeakOrdering>
+  OutputIterator set_symmetric_difference(execution_policy<DerivedPolicy> &exec,
+                                          InputIterator1 first1,
+                                          InputIterator1 last1,
+                                          InputIterator2 first2,
+                                          InputIterator2 last2,
+                                          OutputIterator result,
+                                          StrictWeakOrdering comp)
+{
+  return set_operations_detail::set_operation(exec, first1, last1, first2, last2, result, comp, thrust::system::detail::internal::set_symmetric_difference_op());
+} // end set_symmetric_difference()
+
+
+template<typename DerivedPolicy,
+         typename InputIterator1,
+         typename InputIterator2,
+         typename OutputIterator,
+         typename StrictWeakOrdering>
+  OutputIterator set_union(execution_policy<DerivedPolicy> &exec,
+                           InputIterator1 first1,
+                           InputIterator1 last1,
+                           InputIterator2 first2,
+                           InputIterator2 last2,
+                           OutputIterator result,
+                           StrictWeakOrdering comp)
+{
+  return set_operations_detail::set_operation(exec, first1, last1, first2, last2, result, comp, thrust::system::detail::internal::set_union_op());
+} // end set_union()
+
+
+} // end detail
+} // end tbb
+} // end system
+} // end thrust
+
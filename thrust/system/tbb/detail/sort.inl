@@ -20,8 +20,15 @@
 #include <thrust/iterator/iterator_traits.h>
 #include <thrust/distance.h>
 #include <thrust/merge.h>
+#include <thrust/reverse.h>
 #include <thrust/detail/seq.h>
-#include <tbb/parallel_invoke.h>
+#include <thrust/detail/minmax.h>
+#include <thrust/tuning.h>
+#include <thrust/system/detail/internal/decompose.h>
+#include <thrust/system/detail/internal/radix_sort_tiles.h>
+#include <thrust/system/tbb/detail/arena.h>
+#include <tbb/blocked_range.h>
+#include <cassert>
 
 namespace thrust
 {
@@ -35,8 +42,22 @@ namespace sort_detail
 {
 
 
-// TODO tune this based on data type and comp
-const static int threshold = 128 * 1024;
+// the size below which the merge sort sorts a range of T sequentially, see thrust::tuning::tbb_merge_sort_leaf_size
+template<typename T>
+std::ptrdiff_t merge_sort_leaf_size()
+{
+  // the merge sort splits larger ranges in two, which must make progress
+  return static_cast<std::ptrdiff_t>(thrust::max<std::size_t>(2, thrust::tuning::get<T>(thrust::tuning::tbb_merge_sort_leaf_size)));
+}
+
+
+// the size below which keys of type T are sorted sequentially rather than by the radix sort, see
+// thrust::tuning::tbb_radix_sort_threshold
+template<typename T>
+std::ptrdiff_t radix_sort_threshold()
+{
+  return static_cast<std::ptrdiff_t>(thrust::tuning::get<T>(thrust::tuning::tbb_radix_sort_threshold));
+}
 
   
 template<typename DerivedPolicy, typename Iterator1, typename Iterator2, typename StrictWeakOrdering>
@@ -70,7 +91,7 @@ void merge_sort(execution_policy<DerivedPolicy> &exec, Iterator1 first1, Iterato
 
   difference_type n = thrust::distance(first1, last1);
 
-  if (n < threshold)
+  if (n < merge_sort_leaf_size<typename thrust::iterator_value<Iterator1>::type>())
   {
     thrust::stable_sort(thrust::seq, first1, last1, comp);
     
@@ -91,7 +112,7 @@ void merge_sort(execution_policy<DerivedPolicy> &exec, Iterator1 first1, Iterato
   Closure left (exec, first1, mid1,  first2, comp, !inplace);
   Closure right(exec, mid1,   last1, mid2,   comp, !inplace);
 
-  ::tbb::parallel_invoke(left, right);
+  thrust::system::tbb::detail::parallel_invoke(exec, left, right);
 
   if(inplace) thrust::merge(exec, first2, mid2, mid2, last2, first1, comp);
   else	      thrust::merge(exec, first1, mid1, mid1, last1, first2, comp);
@@ -105,10 +126,6 @@ namespace sort_by_key_detail
 {
 
 
-// TODO tune this based on data type and comp
-const static int threshold = 128 * 1024;
-
-  
 template<typename DerivedPolicy,
          typename Iterator1,
          typename Iterator2,
@@ -185,7 +202,7 @@ void merge_sort_by_key(execution_policy<DerivedPolicy> &exec,
   Iterator2 last2 = first2 + n;
   Iterator3 last3 = first3 + n;
 
-  if (n < threshold)
+  if (n < sort_detail::merge_sort_leaf_size<typename thrust::iterator_value<Iterator1>::type>())
   {
     thrust::stable_sort_by_key(thrust::seq, first1, last1, first2, comp);
     
@@ -203,7 +220,7 @@ void merge_sort_by_key(execution_policy<DerivedPolicy> &exec,
   Closure left (exec, first1, mid1,  first2, first3, first4, comp, !inplace);
   Closure right(exec, mid1,   last1, mid2,   mid3,   mid4,   comp, !inplace);
 
-  ::tbb::parallel_invoke(left, right);
+  thrust::system::tbb::detail::parallel_invoke(exec, left, right);
 
   if(inplace)
   {
@@ -219,6 +236,235 @@ void merge_sort_by_key(execution_policy<DerivedPolicy> &exec,
 } // end namespace sort_detail
 
 
+namespace radix_sort_detail
+{
+
+
+template<typename RandomAccessIterator, typename Decomposition>
+struct histogram_body
+{
+  typedef typename Decomposition::index_type size_type;
+  typedef typename thrust::iterator_value<RandomAccessIterator>::type key_type;
+  typedef thrust::system::detail::internal::radix_sort_traits<key_type> traits;
+
+  RandomAccessIterator keys_first;
+  Decomposition decomp;
+  unsigned int pass;
+  size_t *histograms;
+
+  histogram_body(RandomAccessIterator keys_first, Decomposition decomp, unsigned int pass, size_t *histograms)
+    : keys_first(keys_first), decomp(decomp), pass(pass), histograms(histograms)
+  {}
+
+  void operator()(const ::tbb::blocked_range<size_type> &r) const
+  {
+    assert(r.size() == 1);
+
+    const size_type i = r.begin();
+
+    thrust::system::detail::internal::radix_sort_tile_histogram(keys_first,
+                                                                decomp[i].begin(),
+                                                                decomp[i].end(),
+                                                                pass,
+                                                                histograms + i * traits::histogram_size);
+  }
+};
+
+
+template<bool HasValues, typename Iterator1, typename Iterator2, typename Iterator3, typename Iterator4, typename Decomposition>
+struct scatter_body
+{
+  typedef typename Decomposition::index_type size_type;
+  typedef typename thrust::iterator_value<Iterator1>::type key_type;
+  typedef thrust::system::detail::internal::radix_sort_traits<key_type> traits;
+
+  Iterator1 keys_first;
+  Iterator2 values_first;
+  Iterator3 keys_result;
+  Iterator4 values_result;
+  Decomposition decomp;
+  unsigned int pass;
+  size_t *offsets;
+
+  scatter_body(Iterator1 keys_first, Iterator2 values_first, Iterator3 keys_result, Iterator4 values_result, Decomposition decomp, unsigned int pass, size_t *offsets)
+    : keys_first(keys_first), values_first(values_first), keys_result(keys_result), values_result(values_result), decomp(decomp), pass(pass), offsets(offsets)
+  {}
+
+  void operator()(const ::tbb::blocked_range<size_type> &r) const
+  {
+    assert(r.size() == 1);
+
+    const size_type i = r.begin();
+
+    thrust::system::detail::internal::radix_sort_tile_scatter<HasValues>(keys_first,
+                                                                         values_first,
+                                                                         decomp[i].begin(),
+                                                                         decomp[i].end(),
+                                                                         keys_result,
+                                                                         values_result,
+                                                                         pass,
+                                                                         offsets + i * traits::histogram_size);
+  }
+};
+
+
+// returns false if every key falls in the same bucket and nothing was moved
+template<bool HasValues, typename DerivedPolicy, typename Iterator1, typename Iterator2, typename Iterator3, typename Iterator4, typename Decomposition>
+bool radix_sort_pass(execution_policy<DerivedPolicy> &exec, Iterator1 keys_first, Iterator2 values_first, Iterator3 keys_result, Iterator4 values_result, Decomposition decomp, unsigned int pass, size_t *histograms)
+{
+  typedef typename Decomposition::index_type size_type;
+  typedef typename thrust::iterator_value<Iterator1>::type key_type;
+
+  const size_type num_tiles = decomp.size();
+
+  // force grainsize == 1 with simple_partioner()
+  thrust::system::tbb::detail::parallel_for(exec, ::tbb::blocked_range<size_type>(0, num_tiles, 1),
+                      histogram_body<Iterator1,Decomposition>(keys_first, decomp, pass, histograms),
+                      ::tbb::simple_partitioner());
+
+  if(!thrust::system::detail::internal::radix_sort_tile_offsets<key_type>(histograms, num_tiles, decomp[num_tiles - 1].end()))
+  {
+    return false;
+  }
+
+  thrust::system::tbb::detail::parallel_for(exec, ::tbb::blocked_range<size_type>(0, num_tiles, 1),
+                      scatter_body<HasValues,Iterator1,Iterator2,Iterator3,Iterator4,Decomposition>(keys_first, values_first, keys_result, values_result, decomp, pass, histograms),
+                      ::tbb::simple_partitioner());
+
+  return true;
+}
+
+
+template<bool HasValues, typename DerivedPolicy, typename Iterator1, typename Iterator2, typename Iterator3, typename Iterator4>
+void radix_sort(execution_policy<DerivedPolicy> &exec, Iterator1 keys1, Iterator2 keys2, Iterator3 vals1, Iterator4 vals2, typename thrust::iterator_difference<Iterator1>::type n)
+{
+  typedef typename thrust::iterator_difference<Iterator1>::type difference_type;
+  typedef typename thrust::iterator_value<Iterator1>::type key_type;
+  typedef thrust::system::detail::internal::radix_sort_traits<key_type> traits;
+
+  // generate O(P) tiles of sequential work
+  const unsigned int p = thrust::system::tbb::detail::concurrency(exec);
+  thrust::system::detail::internal::uniform_decomposition<difference_type> decomp(n, 1, p);
+
+  thrust::detail::temporary_array<size_t, DerivedPolicy> histograms(exec, decomp.size() * traits::histogram_size);
+
+  // false if most recent data is stored in (keys1,vals1)
+  bool flip = false;
+
+  for(unsigned int pass = 0; pass < traits::num_passes; ++pass)
+  {
+    bool moved = flip ?
+      radix_sort_pass<HasValues>(exec, keys2, vals2, keys1, vals1, decomp, pass, thrust::raw_pointer_cast(histograms.data())) :
+      radix_sort_pass<HasValues>(exec, keys1, vals1, keys2, vals2, decomp, pass, thrust::raw_pointer_cast(histograms.data()));
+
+    if(moved)
+    {
+      flip = !flip;
+    }
+  }
+
+  // ensure final values are in (keys1,vals1)
+  if(flip)
+  {
+    thrust::copy(exec, keys2, keys2 + n, keys1);
+
+    if(HasValues)
+    {
+      thrust::copy(exec, vals2, vals2 + n, vals1);
+    }
+  }
+}
+
+
+template<typename DerivedPolicy, typename RandomAccessIterator, typename StrictWeakOrdering>
+void stable_sort(execution_policy<DerivedPolicy> &exec, RandomAccessIterator first, RandomAccessIterator last, StrictWeakOrdering comp, thrust::detail::true_type)
+{
+  typedef typename thrust::iterator_value<RandomAccessIterator>::type key_type;
+
+  if(thrust::distance(first, last) < sort_detail::radix_sort_threshold<key_type>())
+  {
+    thrust::stable_sort(thrust::seq, first, last, comp);
+    return;
+  }
+
+  thrust::detail::temporary_array<key_type, DerivedPolicy> temp(exec, thrust::distance(first, last));
+
+  radix_sort<false>(exec, first, temp.begin(), static_cast<int *>(0), static_cast<int *>(0), thrust::distance(first, last));
+
+  // if comp is greater<T> then reverse the keys
+  if(thrust::system::detail::internal::radix_sort_needs_reverse<key_type,StrictWeakOrdering>::value)
+  {
+    thrust::reverse(exec, first, last);
+  }
+}
+
+
+template<typename DerivedPolicy, typename RandomAccessIterator, typename StrictWeakOrdering>
+void stable_sort(execution_policy<DerivedPolicy> &exec, RandomAccessIterator first, RandomAccessIterator last, StrictWeakOrdering comp, thrust::detail::false_type)
+{
+  typedef typename thrust::iterator_value<RandomAccessIterator>::type key_type;
+
+  thrust::detail::temporary_array<key_type, DerivedPolicy> temp(exec, first, last);
+
+  sort_detail::merge_sort(exec, first, last, temp.begin(), comp, true);
+}
+
+
+template<typename DerivedPolicy, typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering>
+void stable_sort_by_key(execution_policy<DerivedPolicy> &exec, RandomAccessIterator1 first1, RandomAccessIterator1 last1, RandomAccessIterator2 first2, StrictWeakOrdering comp, thrust::detail::true_type)
+{
+  typedef typename thrust::iterator_value<RandomAccessIterator1>::type key_type;
+  typedef typename thrust::iterator_value<RandomAccessIterator2>::type val_type;
+
+  typename thrust::iterator_difference<RandomAccessIterator1>::type n = thrust::distance(first1, last1);
+
+  if(n < sort_detail::radix_sort_threshold<key_type>())
+  {
+    thrust::stable_sort_by_key(thrust::seq, first1, last1, first2, comp);
+    return;
+  }
+
+  const bool needs_reverse = thrust::system::detail::internal::radix_sort_needs_reverse<key_type,StrictWeakOrdering>::value;
+
+  // if comp is greater<T> then reverse the keys and values
+  // note, we also have to reverse the (unordered) input to preserve stability
+  if(needs_reverse)
+  {
+    thrust::reverse(exec, first1, last1);
+    thrust::reverse(exec, first2, first2 + n);
+  }
+
+  thrust::detail::temporary_array<key_type, DerivedPolicy> temp1(exec, n);
+  thrust::detail::temporary_array<val_type, DerivedPolicy> temp2(exec, n);
+
+  radix_sort<true>(exec, first1, temp1.begin(), first2, temp2.begin(), n);
+
+  if(needs_reverse)
+  {
+    thrust::reverse(exec, first1, last1);
+    thrust::reverse(exec, first2, first2 + n);
+  }
+}
+
+
+template<typename DerivedPolicy, typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering>
+void stable_sort_by_key(execution_policy<DerivedPolicy> &exec, RandomAccessIterator1 first1, RandomAccessIterator1 last1, RandomAccessIterator2 first2, StrictWeakOrdering comp, thrust::detail::false_type)
+{
+  typedef typename thrust::iterator_value<RandomAccessIterator1>::type key_type;
+  typedef typename thrust::iterator_value<RandomAccessIterator2>::type val_type;
+
+  RandomAccessIterator2 last2 = first2 + thrust::distance(first1, last1);
+
+  thrust::detail::temporary_array<key_type, DerivedPolicy> temp1(exec, first1, last1);
+  thrust::detail::temporary_array<val_type, DerivedPolicy> temp2(exec, first2, last2);
+
+  sort_by_key_detail::merge_sort_by_key(exec, first1, last1, first2, temp1.begin(), temp2.begin(), comp, true);
+}
+
+
+} // end namespace radix_sort_detail
+
+
 template<typename DerivedPolicy,
          typename RandomAccessIterator,
          typename StrictWeakOrdering>
@@ -229,9 +475,10 @@ void stable_sort(execution_policy<DerivedPolicy> &exec,
 {
   typedef typename thrust::iterator_value<RandomAccessIterator>::type key_type;
 
-  thrust::detail::temporary_array<key_type, DerivedPolicy> temp(exec, first, last);
+  // use a parallel radix sort for primitive keys compared with less or greater
+  thrust::system::detail::internal::use_parallel_radix_sort<key_type,StrictWeakOrdering> use_radix_sort;
 
-  sort_detail::merge_sort(exec, first, last, temp.begin(), comp, true);
+  radix_sort_detail::stable_sort(exec, first, last, comp, use_radix_sort);
 }
 
 
@@ -246,14 +493,11 @@ template<typename DerivedPolicy,
                           StrictWeakOrdering comp)
 {
   typedef typename thrust::iterator_value<RandomAccessIterator1>::type key_type;
-  typedef typename thrust::iterator_value<RandomAccessIterator2>::type val_type;
-
-  RandomAccessIterator2 last2 = first2 + thrust::distance(first1, last1);
 
-  thrust::detail::temporary_array<key_type, DerivedPolicy> temp1(exec, first1, last1);
-  thrust::detail::temporary_array<val_type, DerivedPolicy> temp2(exec, first2, last2);
+  // use a parallel radix sort for primitive keys compared with less or greater
+  thrust::system::detail::internal::use_parallel_radix_sort<key_type,StrictWeakOrdering> use_radix_sort;
 
-  sort_by_key_detail::merge_sort_by_key(exec, first1, last1, first2, temp1.begin(), temp2.begin(), comp, true);
+  radix_sort_detail::stable_sort_by_key(exec, first1, last1, first2, comp, use_radix_sort);
 }
 
 
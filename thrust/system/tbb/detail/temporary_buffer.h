@@ -18,5 +18,6 @@
 
 #include <thrust/detail/config.h>
 
-// this system has no special temporary buffer functions
+// this system inherits the temporary buffer functions of cpp
+#include <thrust/system/cpp/detail/temporary_buffer.h>
 
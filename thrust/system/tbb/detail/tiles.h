@@ -0,0 +1,67 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file tiles.h
+ *  \brief The decomposition shared by the TBB algorithms which split their
+ *         input into O(P) tiles of sequential work.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <thrust/system/tbb/detail/execution_policy.h>
+#include <thrust/system/tbb/detail/arena.h>
+#include <thrust/system/detail/internal/decompose.h>
+#include <thrust/tuning.h>
+
+namespace thrust
+{
+namespace system
+{
+namespace tbb
+{
+namespace detail
+{
+
+
+// the size below which the tiled algorithms run sequentially, for keys of type Key;
+// see thrust::tuning::tbb_reduce_by_key_threshold
+template<typename Key, typename Size>
+  Size tiled_parallelism_threshold()
+{
+  return static_cast<Size>(thrust::tuning::get<Key>(thrust::tuning::tbb_reduce_by_key_threshold));
+}
+
+
+// decomposes n elements into one tile of sequential work per processor
+template<typename DerivedPolicy, typename Size>
+  thrust::system::detail::internal::uniform_decomposition<Size>
+    make_tile_decomposition(execution_policy<DerivedPolicy> &exec, Size n)
+{
+  // XXX oversubscribing is a tuning opportunity
+  const unsigned int subscription_rate = 1;
+
+  const unsigned int p = thrust::system::tbb::detail::concurrency(exec);
+
+  return thrust::system::detail::internal::uniform_decomposition<Size>(n, 1, subscription_rate * p);
+}
+
+
+} // end namespace detail
+} // end namespace tbb
+} // end namespace system
+} // end namespace thrust
+
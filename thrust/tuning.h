@@ -0,0 +1,140 @@
+/*
+ *  Copyright 2018 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file tuning.h
+ *  \brief A process-wide table of the size thresholds used by the host implementations of algorithms
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+#include <cstddef>
+
+namespace thrust
+{
+
+/*! \p thrust::tuning holds the size thresholds at which the host implementations of some algorithms change strategy,
+ *      e.g. from a sequential to a parallel algorithm. The best values depend on the machine and on the type of the
+ *      elements, so each one can be set per element size, from the environment, from a file, or by measuring them with
+ *      \p thrust::cpp::calibrate and \p thrust::tbb::calibrate.
+ *
+ *  A value is looked up for an element size rounded up to 1, 2, 4, 8 or 16 bytes; larger elements use the 16 byte
+ *      value. Values that are not set are the built-in defaults.
+ *
+ *  When first used, the table reads the file named by the \p THRUST_TUNING_FILE environment variable, and then the
+ *      entries listed in the \p THRUST_TUNING environment variable, separated by commas, semicolons or whitespace.
+ *      Both use the entries written by \p save: <tt>name=value</tt> sets a parameter for every element size, and
+ *      <tt>name.size=value</tt> for one of them, e.g.
+ *      <tt>THRUST_TUNING=tbb_radix_sort_threshold=65536,merge_sort_partition_size.8=48</tt>.
+ *
+ *  The table is not synchronized: change it before algorithms which read it are running in other threads.
+ *      The table is not used by device code, which keeps the defaults.
+ */
+namespace tuning
+{
+
+/*! \addtogroup utility
+ *  \{
+ */
+
+/*! The tunable parameters.
+ */
+enum parameter
+{
+  /*! The size below which the merge sort of \p thrust::tbb sorts a piece sequentially rather than splitting it in
+   *      two. The merge sort is used for comparisons other than \p less and \p greater, and for keys which are not
+   *      arithmetic. Defaults to 131072.
+   */
+  tbb_merge_sort_leaf_size,
+
+  /*! The size below which \p thrust::tbb sorts arithmetic keys compared with \p less or \p greater sequentially
+   *      rather than with its parallel radix sort. Defaults to 131072.
+   */
+  tbb_radix_sort_threshold,
+
+  /*! The size below which \p thrust::tbb reduces by key, scans by key and performs set operations sequentially,
+   *      with the size of the keys, or of the elements of the first input of a set operation. Defaults to 10000.
+   */
+  tbb_reduce_by_key_threshold,
+
+  /*! The size of the intervals searched one after the other by the generic \p find_if, which is used by systems
+   *      without a \p find_if of their own. The host systems have their own, so this applies to none of them, and
+   *      it is not measured by \p calibrate. Defaults to 1048576.
+   */
+  generic_find_interval_size,
+
+  /*! The size of the ranges the sequential merge sort sorts by insertion on the host. Defaults to 32.
+   */
+  merge_sort_partition_size,
+
+  num_parameters
+};
+
+/*! \returns the name of a parameter, as used in the environment and in files
+ */
+inline const char * name(parameter p);
+
+/*! \returns the value of parameter \p p for elements of \p element_size bytes
+ */
+inline std::size_t get(parameter p, std::size_t element_size);
+
+/*! \returns the value of parameter \p p for elements of type \p T
+ */
+template<typename T>
+inline std::size_t get(parameter p)
+{
+  return get(p, sizeof(T));
+}
+
+/*! Sets parameter \p p for elements of every size. A \p value of 0 restores the default.
+ */
+inline void set(parameter p, std::size_t value);
+
+/*! Sets parameter \p p for elements of \p element_size bytes. A \p value of 0 restores the default.
+ */
+inline void set(parameter p, std::size_t element_size, std::size_t value);
+
+/*! Restores the default of every parameter.
+ */
+inline void reset();
+
+/*! Applies a list of entries such as <tt>name=value</tt> or <tt>name.size=value</tt>, separated by commas,
+ *      semicolons or whitespace.
+ *
+ *  \returns \c false if an entry could not be parsed; the other entries are still applied
+ */
+inline bool parse(const char * entries);
+
+/*! Applies the entries of a file written by \p save. Lines starting with \c # are ignored.
+ *
+ *  \returns \c false if the file could not be read or an entry could not be parsed
+ */
+inline bool load(const char * path);
+
+/*! Writes every value that is not a default to a file, which \p load and \p THRUST_TUNING_FILE read.
+ *
+ *  \returns \c false if the file could not be written
+ */
+inline bool save(const char * path);
+
+/*! \}
+ */
+
+} // end tuning
+} // end thrust
+
+#include <thrust/detail/tuning.inl>
+